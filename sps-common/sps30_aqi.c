@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sensirion_arch_config.h"
+#include "sensirion_common.h"
+#include "sps30_aqi.h"
+
+#define SPS30_AQI_SECONDS_PER_HOUR 3600
+#define SPS30_AQI_NUM_BREAKPOINTS 6
+
+struct sps30_aqi_breakpoint {
+    float c_low;
+    float c_high;
+    uint16_t i_low;
+    uint16_t i_high;
+};
+
+static const struct sps30_aqi_breakpoint
+    sps30_aqi_breakpoints[SPS30_AQI_NUM_POLLUTANTS]
+                         [SPS30_AQI_NUM_BREAKPOINTS] = {
+        /* PM2.5, 24-hour, [µg/m³] */
+        {
+            {0.0f, 9.0f, 0, 50},
+            {9.1f, 35.4f, 51, 100},
+            {35.5f, 55.4f, 101, 150},
+            {55.5f, 125.4f, 151, 200},
+            {125.5f, 225.4f, 201, 300},
+            {225.5f, 325.4f, 301, 500},
+        },
+        /* PM10, 24-hour, [µg/m³] */
+        {
+            {0.0f, 54.0f, 0, 50},
+            {55.0f, 154.0f, 51, 100},
+            {155.0f, 254.0f, 101, 150},
+            {255.0f, 354.0f, 151, 200},
+            {355.0f, 424.0f, 201, 300},
+            {425.0f, 604.0f, 301, 500},
+        },
+};
+
+/* resolution the concentrations are truncated to, as 1 / step */
+static const float sps30_aqi_resolution[SPS30_AQI_NUM_POLLUTANTS] = {10.0f,
+                                                                     1.0f};
+
+static float sps30_aqi_truncate(uint8_t pollutant, float concentration) {
+    const float resolution = sps30_aqi_resolution[pollutant];
+
+    if (concentration <= 0.0f)
+        return 0.0f;
+    return (float)(uint32_t)(concentration * resolution) / resolution;
+}
+
+uint16_t sps30_aqi_from_concentration(uint8_t pollutant, float concentration) {
+    const struct sps30_aqi_breakpoint* bp;
+    float index;
+    uint8_t i;
+
+    concentration = sps30_aqi_truncate(pollutant, concentration);
+    for (i = 0; i < SPS30_AQI_NUM_BREAKPOINTS; ++i) {
+        bp = &sps30_aqi_breakpoints[pollutant][i];
+        if (concentration > bp->c_high)
+            continue;
+
+        /* concentrations between two ranges belong to the upper one */
+        if (concentration < bp->c_low)
+            concentration = bp->c_low;
+        index = (float)(bp->i_high - bp->i_low) / (bp->c_high - bp->c_low) *
+                    (concentration - bp->c_low) +
+                (float)bp->i_low;
+        return (uint16_t)(index + 0.5f);
+    }
+    return 500;
+}
+
+static void sps30_aqi_push_hour(struct sps30_aqi* aqi, uint8_t valid) {
+    uint8_t p;
+
+    if (++aqi->newest == SPS30_AQI_HOURS)
+        aqi->newest = 0;
+
+    aqi->valid_hours = (uint16_t)(aqi->valid_hours << 1);
+    if (valid) {
+        aqi->valid_hours |= 1;
+        for (p = 0; p < SPS30_AQI_NUM_POLLUTANTS; ++p)
+            aqi->hourly[p][aqi->newest] = aqi->sum[p] / (float)aqi->count;
+    }
+}
+
+static void sps30_aqi_finish_hour(struct sps30_aqi* aqi, uint32_t hour) {
+    uint32_t missing = hour - aqi->hour - 1;
+
+    sps30_aqi_push_hour(aqi, aqi->count > 0 && aqi->count >= aqi->min_samples);
+    if (missing > SPS30_AQI_HOURS)
+        missing = SPS30_AQI_HOURS;
+    while (missing--)
+        sps30_aqi_push_hour(aqi, 0);
+
+    aqi->hour = hour;
+    aqi->sum[SPS30_AQI_PM2P5] = 0.0f;
+    aqi->sum[SPS30_AQI_PM10] = 0.0f;
+    aqi->count = 0;
+}
+
+void sps30_aqi_init(struct sps30_aqi* aqi, uint32_t min_samples) {
+    aqi->sum[SPS30_AQI_PM2P5] = 0.0f;
+    aqi->sum[SPS30_AQI_PM10] = 0.0f;
+    aqi->count = 0;
+    aqi->min_samples = min_samples;
+    aqi->hour = 0;
+    aqi->valid_hours = 0;
+    aqi->newest = 0;
+    aqi->started = 0;
+}
+
+void sps30_aqi_add(struct sps30_aqi* aqi, uint32_t timestamp,
+                   const struct sps30_measurement* measurement) {
+    const uint32_t hour = timestamp / SPS30_AQI_SECONDS_PER_HOUR;
+
+    if (!aqi->started) {
+        aqi->hour = hour;
+        aqi->started = 1;
+    } else if (hour > aqi->hour) {
+        sps30_aqi_finish_hour(aqi, hour);
+    }
+
+    aqi->sum[SPS30_AQI_PM2P5] += measurement->mc_2p5;
+    aqi->sum[SPS30_AQI_PM10] += measurement->mc_10p0;
+    aqi->count++;
+}
+
+static float sps30_aqi_nowcast(const struct sps30_aqi* aqi, uint8_t pollutant) {
+    const float* hourly = aqi->hourly[pollutant];
+    float min = 0.0f;
+    float max = 0.0f;
+    float weight;
+    float factor = 1.0f;
+    float sum = 0.0f;
+    float weights = 0.0f;
+    uint8_t found = 0;
+    uint8_t age;
+    uint8_t i;
+
+    for (age = 0; age < SPS30_AQI_HOURS; ++age) {
+        if (!(aqi->valid_hours & (1u << age)))
+            continue;
+        i = (uint8_t)((aqi->newest + SPS30_AQI_HOURS - age) % SPS30_AQI_HOURS);
+        if (!found || hourly[i] < min)
+            min = hourly[i];
+        if (!found || hourly[i] > max)
+            max = hourly[i];
+        found = 1;
+    }
+
+    weight = max > 0.0f ? min / max : 1.0f;
+    if (weight < 0.5f)
+        weight = 0.5f;
+
+    for (age = 0; age < SPS30_AQI_HOURS; ++age, factor *= weight) {
+        if (!(aqi->valid_hours & (1u << age)))
+            continue;
+        i = (uint8_t)((aqi->newest + SPS30_AQI_HOURS - age) % SPS30_AQI_HOURS);
+        sum += factor * hourly[i];
+        weights += factor;
+    }
+    return sps30_aqi_truncate(pollutant, sum / weights);
+}
+
+int16_t sps30_aqi_get(const struct sps30_aqi* aqi,
+                      struct sps30_aqi_result* result) {
+    const uint16_t recent = aqi->valid_hours & 0x7;
+
+    /* two of the three most recent hours are required */
+    if (recent == 0 || (recent & (recent - 1)) == 0)
+        return STATUS_FAIL;
+
+    result->nowcast_pm2p5 = sps30_aqi_nowcast(aqi, SPS30_AQI_PM2P5);
+    result->nowcast_pm10 = sps30_aqi_nowcast(aqi, SPS30_AQI_PM10);
+    result->aqi_pm2p5 =
+        sps30_aqi_from_concentration(SPS30_AQI_PM2P5, result->nowcast_pm2p5);
+    result->aqi_pm10 =
+        sps30_aqi_from_concentration(SPS30_AQI_PM10, result->nowcast_pm10);
+    result->aqi = result->aqi_pm2p5 > result->aqi_pm10 ? result->aqi_pm2p5
+                                                       : result->aqi_pm10;
+    return NO_ERROR;
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SPS30_AQI_H
+#define SPS30_AQI_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "sensirion_arch_config.h"
+#include "sps30.h"
+
+/*
+ * US EPA NowCast and AQI for PM2.5 and PM10
+ *
+ * Samples are averaged per hour (aligned to the timestamp, i.e. to wall clock
+ * hours when fed with UNIX time) and the last SPS30_AQI_HOURS complete hours
+ * are kept. The NowCast weights these hourly averages by
+ * max(min / max, 0.5) ^ age and is valid once at least two of the three most
+ * recent hours are available. The AQI is derived from the NowCast with the
+ * EPA breakpoints (PM2.5 as revised in 2024).
+ *
+ * Adding a sample costs constant time, computing the NowCast one pass over
+ * the SPS30_AQI_HOURS hours.
+ */
+
+#define SPS30_AQI_HOURS 12
+
+#define SPS30_AQI_PM2P5 0
+#define SPS30_AQI_PM10 1
+#define SPS30_AQI_NUM_POLLUTANTS 2
+
+/**
+ * struct sps30_aqi - NowCast state, the members are private
+ */
+struct sps30_aqi {
+    float hourly[SPS30_AQI_NUM_POLLUTANTS][SPS30_AQI_HOURS];
+    float sum[SPS30_AQI_NUM_POLLUTANTS];
+    uint32_t count;
+    uint32_t min_samples;
+    uint32_t hour;
+    uint16_t valid_hours;
+    uint8_t newest;
+    uint8_t started;
+};
+
+/**
+ * struct sps30_aqi_result - NowCast and AQI
+ *
+ * @nowcast_pm2p5:  NowCast of mc_2p5 [µg/m³], truncated to 0.1
+ * @nowcast_pm10:   NowCast of mc_10p0 [µg/m³], truncated to 1
+ * @aqi_pm2p5:      AQI of PM2.5
+ * @aqi_pm10:       AQI of PM10
+ * @aqi:            Overall AQI, the maximum of the pollutant AQIs
+ */
+struct sps30_aqi_result {
+    float nowcast_pm2p5;
+    float nowcast_pm10;
+    uint16_t aqi_pm2p5;
+    uint16_t aqi_pm10;
+    uint16_t aqi;
+};
+
+/**
+ * sps30_aqi_init() - initialize the NowCast state
+ *
+ * @aqi:            NowCast state
+ * @min_samples:    Minimum number of samples for an hour to be valid, e.g.
+ *                  2700 to require 75% coverage at 1Hz
+ */
+void sps30_aqi_init(struct sps30_aqi* aqi, uint32_t min_samples);
+
+/**
+ * sps30_aqi_add() - add a measurement
+ *
+ * Timestamps must not decrease.
+ *
+ * @aqi:            NowCast state
+ * @timestamp:      Time of the measurement in seconds
+ * @measurement:    Measurement as read by sps30_read_measurement()
+ */
+void sps30_aqi_add(struct sps30_aqi* aqi, uint32_t timestamp,
+                   const struct sps30_measurement* measurement);
+
+/**
+ * sps30_aqi_get() - compute NowCast and AQI from the complete hours
+ *
+ * @aqi:    NowCast state
+ * @result: Memory where NowCast and AQI are stored
+ * Return:  0 on success, STATUS_FAIL if less than two of the three most
+ *          recent hours are valid
+ */
+int16_t sps30_aqi_get(const struct sps30_aqi* aqi,
+                      struct sps30_aqi_result* result);
+
+/**
+ * sps30_aqi_from_concentration() - AQI of a concentration
+ *
+ * @pollutant:      SPS30_AQI_PM2P5 or SPS30_AQI_PM10
+ * @concentration:  Concentration [µg/m³], truncated as in struct
+ *                  sps30_aqi_result
+ * Return:          AQI from 0 to 500, concentrations beyond the last
+ *                  breakpoint are reported as 500
+ */
+uint16_t sps30_aqi_from_concentration(uint8_t pollutant, float concentration);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPS30_AQI_H */
@@ -0,0 +1,286 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stddef.h>  // size_t
+#include <string.h>  // memcpy
+
+#include "sensirion_arch_config.h"
+#include "sps30_batch.h"
+
+#if defined(SPS30_BATCH_NO_SIMD)
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define SPS30_BATCH_AVX2
+#define SPS30_BATCH_SSE2
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
+#define SPS30_BATCH_SSE2
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define SPS30_BATCH_NEON
+#endif
+
+#define SPS30_BATCH_FIELD_SIZE 4
+
+static void sps30_batch_decode1(const uint8_t* payload, float* dst,
+                                size_t stride) {
+    uint32_t raw;
+    uint8_t c;
+
+    for (c = 0; c < SPS30_BATCH_NUM_COLUMNS; ++c) {
+        raw = (uint32_t)payload[0] << 24 | (uint32_t)payload[1] << 16 |
+              (uint32_t)payload[2] << 8 | (uint32_t)payload[3];
+        memcpy(&dst[c * stride], &raw, sizeof(raw));
+        payload += SPS30_BATCH_FIELD_SIZE;
+    }
+}
+
+#ifdef SPS30_BATCH_SSE2
+
+static __m128i sps30_batch_bswap(__m128i v) {
+#ifdef __SSSE3__
+    const __m128i order =
+        _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+
+    return _mm_shuffle_epi8(v, order);
+#else
+    v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+    v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+    return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+#endif
+}
+
+static __m128i sps30_batch_load4(const uint8_t* payload, size_t offset) {
+    return sps30_batch_bswap(
+        _mm_loadu_si128((const __m128i*)(const void*)&payload[offset]));
+}
+
+static __m128i sps30_batch_load2(const uint8_t* payload, size_t offset) {
+    return sps30_batch_bswap(
+        _mm_loadl_epi64((const __m128i*)(const void*)&payload[offset]));
+}
+
+/**
+ * sps30_batch_decode4() - decode four samples: 4x4 transpositions of the
+ * fields 0-3 and 4-7, a 4x2 transposition of the fields 8-9
+ */
+static void sps30_batch_decode4(const uint8_t* p, float* dst, size_t stride) {
+    const size_t n = SPS30_BATCH_PAYLOAD_SIZE;
+    __m128 r0, r1, r2, r3;
+    __m128i t0, t1;
+    size_t c;
+
+    for (c = 0; c < 8; c += 4) {
+        r0 = _mm_castsi128_ps(sps30_batch_load4(p, c * 4));
+        r1 = _mm_castsi128_ps(sps30_batch_load4(p, n + c * 4));
+        r2 = _mm_castsi128_ps(sps30_batch_load4(p, 2 * n + c * 4));
+        r3 = _mm_castsi128_ps(sps30_batch_load4(p, 3 * n + c * 4));
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        _mm_storeu_ps(&dst[c * stride], r0);
+        _mm_storeu_ps(&dst[(c + 1) * stride], r1);
+        _mm_storeu_ps(&dst[(c + 2) * stride], r2);
+        _mm_storeu_ps(&dst[(c + 3) * stride], r3);
+    }
+
+    t0 = _mm_unpacklo_epi32(sps30_batch_load2(p, 32),
+                            sps30_batch_load2(p, n + 32));
+    t1 = _mm_unpacklo_epi32(sps30_batch_load2(p, 2 * n + 32),
+                            sps30_batch_load2(p, 3 * n + 32));
+    _mm_storeu_ps(&dst[8 * stride],
+                  _mm_castsi128_ps(_mm_unpacklo_epi64(t0, t1)));
+    _mm_storeu_ps(&dst[9 * stride],
+                  _mm_castsi128_ps(_mm_unpackhi_epi64(t0, t1)));
+}
+
+#endif /* SPS30_BATCH_SSE2 */
+
+#ifdef SPS30_BATCH_AVX2
+
+/* samples i in the lower and i + 4 in the upper lane */
+static __m256i sps30_batch_pair(__m128i lower, __m128i upper) {
+    const __m256i order = _mm256_set_epi8(
+        12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3, 12, 13, 14, 15,
+        8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+
+    return _mm256_shuffle_epi8(
+        _mm256_inserti128_si256(_mm256_castsi128_si256(lower), upper, 1),
+        order);
+}
+
+static __m256 sps30_batch_load8(const uint8_t* p, size_t offset) {
+    const size_t n = SPS30_BATCH_PAYLOAD_SIZE;
+
+    return _mm256_castsi256_ps(sps30_batch_pair(
+        _mm_loadu_si128((const __m128i*)(const void*)&p[offset]),
+        _mm_loadu_si128((const __m128i*)(const void*)&p[4 * n + offset])));
+}
+
+static __m256i sps30_batch_load8_2(const uint8_t* p, size_t offset) {
+    const size_t n = SPS30_BATCH_PAYLOAD_SIZE;
+
+    return sps30_batch_pair(
+        _mm_loadl_epi64((const __m128i*)(const void*)&p[offset]),
+        _mm_loadl_epi64((const __m128i*)(const void*)&p[4 * n + offset]));
+}
+
+/**
+ * sps30_batch_decode8() - decode eight samples, the transpositions of
+ * sps30_batch_decode4() in both lanes at once
+ */
+static void sps30_batch_decode8(const uint8_t* p, float* dst, size_t stride) {
+    const size_t n = SPS30_BATCH_PAYLOAD_SIZE;
+    __m256 t0, t1, t2, t3;
+    __m256i u0, u1;
+    size_t c;
+
+    for (c = 0; c < 8; c += 4) {
+        t0 = sps30_batch_load8(p, c * 4);
+        t1 = sps30_batch_load8(p, n + c * 4);
+        t2 = sps30_batch_load8(p, 2 * n + c * 4);
+        t3 = sps30_batch_load8(p, 3 * n + c * 4);
+        u0 = _mm256_castps_si256(_mm256_unpacklo_ps(t0, t1));
+        u1 = _mm256_castps_si256(_mm256_unpacklo_ps(t2, t3));
+        t0 = _mm256_unpackhi_ps(t0, t1);
+        t2 = _mm256_unpackhi_ps(t2, t3);
+        _mm256_storeu_ps(&dst[c * stride], _mm256_castsi256_ps(
+                                               _mm256_unpacklo_epi64(u0, u1)));
+        _mm256_storeu_ps(
+            &dst[(c + 1) * stride],
+            _mm256_castsi256_ps(_mm256_unpackhi_epi64(u0, u1)));
+        u0 = _mm256_castps_si256(t0);
+        u1 = _mm256_castps_si256(t2);
+        _mm256_storeu_ps(
+            &dst[(c + 2) * stride],
+            _mm256_castsi256_ps(_mm256_unpacklo_epi64(u0, u1)));
+        _mm256_storeu_ps(
+            &dst[(c + 3) * stride],
+            _mm256_castsi256_ps(_mm256_unpackhi_epi64(u0, u1)));
+    }
+
+    u0 = _mm256_unpacklo_epi32(sps30_batch_load8_2(p, 32),
+                               sps30_batch_load8_2(p, n + 32));
+    u1 = _mm256_unpacklo_epi32(sps30_batch_load8_2(p, 2 * n + 32),
+                               sps30_batch_load8_2(p, 3 * n + 32));
+    _mm256_storeu_ps(&dst[8 * stride],
+                     _mm256_castsi256_ps(_mm256_unpacklo_epi64(u0, u1)));
+    _mm256_storeu_ps(&dst[9 * stride],
+                     _mm256_castsi256_ps(_mm256_unpackhi_epi64(u0, u1)));
+}
+
+#endif /* SPS30_BATCH_AVX2 */
+
+#ifdef SPS30_BATCH_NEON
+
+static uint32x4_t sps30_batch_load4(const uint8_t* payload, size_t offset) {
+    return vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(&payload[offset])));
+}
+
+static uint32x2_t sps30_batch_load2(const uint8_t* payload, size_t offset) {
+    return vreinterpret_u32_u8(vrev32_u8(vld1_u8(&payload[offset])));
+}
+
+static void sps30_batch_store(float* dst, uint32x4_t v) {
+    vst1q_f32(dst, vreinterpretq_f32_u32(v));
+}
+
+/**
+ * sps30_batch_decode4() - decode four samples: 4x4 transpositions of the
+ * fields 0-3 and 4-7, a 4x2 transposition of the fields 8-9
+ */
+static void sps30_batch_decode4(const uint8_t* p, float* dst, size_t stride) {
+    const size_t n = SPS30_BATCH_PAYLOAD_SIZE;
+    uint32x4x2_t t01, t23;
+    uint32x2x2_t s01, s23;
+    size_t c;
+
+    for (c = 0; c < 8; c += 4) {
+        t01 = vtrnq_u32(sps30_batch_load4(p, c * 4),
+                        sps30_batch_load4(p, n + c * 4));
+        t23 = vtrnq_u32(sps30_batch_load4(p, 2 * n + c * 4),
+                        sps30_batch_load4(p, 3 * n + c * 4));
+        sps30_batch_store(&dst[c * stride],
+                          vcombine_u32(vget_low_u32(t01.val[0]),
+                                       vget_low_u32(t23.val[0])));
+        sps30_batch_store(&dst[(c + 1) * stride],
+                          vcombine_u32(vget_low_u32(t01.val[1]),
+                                       vget_low_u32(t23.val[1])));
+        sps30_batch_store(&dst[(c + 2) * stride],
+                          vcombine_u32(vget_high_u32(t01.val[0]),
+                                       vget_high_u32(t23.val[0])));
+        sps30_batch_store(&dst[(c + 3) * stride],
+                          vcombine_u32(vget_high_u32(t01.val[1]),
+                                       vget_high_u32(t23.val[1])));
+    }
+
+    s01 = vtrn_u32(sps30_batch_load2(p, 32), sps30_batch_load2(p, n + 32));
+    s23 = vtrn_u32(sps30_batch_load2(p, 2 * n + 32),
+                   sps30_batch_load2(p, 3 * n + 32));
+    sps30_batch_store(&dst[8 * stride], vcombine_u32(s01.val[0], s23.val[0]));
+    sps30_batch_store(&dst[9 * stride], vcombine_u32(s01.val[1], s23.val[1]));
+}
+
+#endif /* SPS30_BATCH_NEON */
+
+void sps30_batch_decode(const uint8_t* payloads, uint32_t count, float* columns,
+                        uint32_t stride) {
+    uint32_t i = 0;
+
+#ifdef SPS30_BATCH_AVX2
+    for (; i + 8 <= count; i += 8)
+        sps30_batch_decode8(&payloads[(size_t)i * SPS30_BATCH_PAYLOAD_SIZE],
+                            &columns[i], stride);
+#endif
+#if defined(SPS30_BATCH_SSE2) || defined(SPS30_BATCH_NEON)
+    for (; i + 4 <= count; i += 4)
+        sps30_batch_decode4(&payloads[(size_t)i * SPS30_BATCH_PAYLOAD_SIZE],
+                            &columns[i], stride);
+#endif
+    for (; i < count; ++i)
+        sps30_batch_decode1(&payloads[(size_t)i * SPS30_BATCH_PAYLOAD_SIZE],
+                            &columns[i], stride);
+}
+
+const char* sps30_batch_implementation(void) {
+#if defined(SPS30_BATCH_AVX2)
+    return "avx2";
+#elif defined(SPS30_BATCH_SSE2) && defined(__SSSE3__)
+    return "ssse3";
+#elif defined(SPS30_BATCH_SSE2)
+    return "sse2";
+#elif defined(SPS30_BATCH_NEON)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SPS30_BATCH_H
+#define SPS30_BATCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "sensirion_arch_config.h"
+
+/*
+ * Batch decoding of float measurements
+ *
+ * For replaying logs or aggregating the sensors of a gateway, many
+ * measurements are decoded at once into one column per field (structure of
+ * arrays) instead of one struct sps30_measurement per sample. The input are
+ * the data bytes of read measurement responses in SPS30_FORMAT_FLOAT with the
+ * CRCs removed, i.e. ten big-endian IEEE 754 floats per sample.
+ *
+ * The byte swap and the transposition into columns are vectorized for the
+ * instruction set the file is compiled for: AVX2, SSE2 (with SSSE3 if
+ * available), or NEON, with a portable fallback for other targets or when
+ * SPS30_BATCH_NO_SIMD is defined. Enable the instruction sets with the usual
+ * compiler flags, e.g. -mavx2 or -march=native.
+ */
+
+/** Data bytes of a read measurement response in SPS30_FORMAT_FLOAT */
+#define SPS30_BATCH_PAYLOAD_SIZE 40
+
+/* Columns in the order of the fields in the response */
+#define SPS30_BATCH_MC_1P0 0
+#define SPS30_BATCH_MC_2P5 1
+#define SPS30_BATCH_MC_4P0 2
+#define SPS30_BATCH_MC_10P0 3
+#define SPS30_BATCH_NC_0P5 4
+#define SPS30_BATCH_NC_1P0 5
+#define SPS30_BATCH_NC_2P5 6
+#define SPS30_BATCH_NC_4P0 7
+#define SPS30_BATCH_NC_10P0 8
+#define SPS30_BATCH_TYPICAL_PARTICLE_SIZE 9
+#define SPS30_BATCH_NUM_COLUMNS 10
+
+/**
+ * sps30_batch_decode() - decode measurement payloads into columns
+ *
+ * Field c of sample i is stored at columns[c * stride + i]. The values are
+ * copied bit by bit, NaNs included.
+ *
+ * @payloads:   @count payloads of SPS30_BATCH_PAYLOAD_SIZE bytes each
+ * @count:      Number of samples
+ * @columns:    SPS30_BATCH_NUM_COLUMNS columns of @stride floats
+ * @stride:     Distance between the columns in floats, at least @count
+ */
+void sps30_batch_decode(const uint8_t* payloads, uint32_t count, float* columns,
+                        uint32_t stride);
+
+/**
+ * sps30_batch_implementation() - name of the compiled implementation
+ *
+ * Return:  "avx2", "ssse3", "sse2", "neon" or "scalar"
+ */
+const char* sps30_batch_implementation(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPS30_BATCH_H */
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sensirion_arch_config.h"
+#include "sps30_cleaning.h"
+
+#define SPS30_CLEANING_US_PER_S 1000000
+
+static void sps30_cleaning_open(struct sps30_cleaning* cleaning,
+                                uint8_t window, uint32_t end_us) {
+    cleaning->window = window;
+    cleaning->window_end_us = end_us;
+    cleaning->cleanings++;
+}
+
+/**
+ * sps30_cleaning_count() - count the measuring time up to @now_us towards the
+ * automatic cleaning interval
+ */
+static void sps30_cleaning_count(struct sps30_cleaning* cleaning,
+                                 uint32_t now_us) {
+    uint32_t overshoot_us;
+
+    if (!cleaning->measuring)
+        return;
+
+    cleaning->counted_us += now_us - cleaning->counted_at_us;
+    cleaning->counted_at_us = now_us;
+    cleaning->counted_s += cleaning->counted_us / SPS30_CLEANING_US_PER_S;
+    cleaning->counted_us %= SPS30_CLEANING_US_PER_S;
+
+    if (!cleaning->interval_s || cleaning->counted_s < cleaning->interval_s)
+        return;
+
+    /* the cleaning started when the interval was reached */
+    cleaning->counted_s -= cleaning->interval_s;
+    if (cleaning->counted_s >=
+        SPS30_CLEANING_WINDOW_US / SPS30_CLEANING_US_PER_S) {
+        cleaning->cleanings++; /* already over */
+        return;
+    }
+    overshoot_us =
+        cleaning->counted_s * SPS30_CLEANING_US_PER_S + cleaning->counted_us;
+    sps30_cleaning_open(cleaning, SPS30_CLEANING_AUTO,
+                        now_us - overshoot_us + SPS30_CLEANING_WINDOW_US);
+}
+
+void sps30_cleaning_init(struct sps30_cleaning* cleaning,
+                         uint32_t interval_seconds) {
+    cleaning->cleanings = 0;
+    cleaning->flagged = 0;
+    cleaning->interval_s = interval_seconds;
+    cleaning->counted_s = 0;
+    cleaning->counted_us = 0;
+    cleaning->counted_at_us = 0;
+    cleaning->window_end_us = 0;
+    cleaning->window = SPS30_CLEANING_NONE;
+    cleaning->measuring = 0;
+}
+
+void sps30_cleaning_set_interval(struct sps30_cleaning* cleaning,
+                                 uint32_t interval_seconds) {
+    cleaning->interval_s = interval_seconds;
+}
+
+void sps30_cleaning_start(struct sps30_cleaning* cleaning, uint32_t now_us) {
+    if (cleaning->measuring)
+        return;
+
+    cleaning->measuring = 1;
+    cleaning->counted_at_us = now_us;
+}
+
+void sps30_cleaning_stop(struct sps30_cleaning* cleaning, uint32_t now_us) {
+    sps30_cleaning_count(cleaning, now_us);
+    cleaning->measuring = 0;
+    cleaning->window = SPS30_CLEANING_NONE;
+}
+
+void sps30_cleaning_manual(struct sps30_cleaning* cleaning, uint32_t now_us) {
+    sps30_cleaning_count(cleaning, now_us);
+    sps30_cleaning_open(cleaning, SPS30_CLEANING_MANUAL,
+                        now_us + SPS30_CLEANING_WINDOW_US);
+}
+
+uint8_t sps30_cleaning_check(struct sps30_cleaning* cleaning, uint32_t now_us) {
+    sps30_cleaning_count(cleaning, now_us);
+    if (cleaning->window == SPS30_CLEANING_NONE)
+        return SPS30_CLEANING_NONE;
+
+    if ((int32_t)(now_us - cleaning->window_end_us) >= 0) {
+        cleaning->window = SPS30_CLEANING_NONE;
+        return SPS30_CLEANING_NONE;
+    }
+    cleaning->flagged++;
+    return cleaning->window;
+}
+
+uint32_t sps30_cleaning_next_auto_s(const struct sps30_cleaning* cleaning) {
+    if (!cleaning->interval_s || cleaning->counted_s >= cleaning->interval_s)
+        return 0;
+
+    return cleaning->interval_s - cleaning->counted_s;
+}
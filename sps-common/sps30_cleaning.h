@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SPS30_CLEANING_H
+#define SPS30_CLEANING_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "sensirion_arch_config.h"
+#include "sps30.h"
+
+/*
+ * Fan cleaning windows
+ *
+ * While the fan is cleaned, it runs at maximum speed for about 10s and the
+ * measurements are not representative. The sensor does not report the
+ * cleaning, so the tracker follows the commands sent to the sensor: a manual
+ * cleaning starts when it is requested, an automatic one after the configured
+ * interval of measuring time. The samples read until one measurement interval
+ * after the end of the cleaning are flagged.
+ *
+ * The automatic cleanings are predicted assuming that the sensor counts the
+ * time spent in measurement mode since the tracker was initialized, i.e. the
+ * tracker should be initialized when the sensor is powered up or reset.
+ *
+ * All times are in microseconds on any free running 32 bit clock, e.g. the one
+ * passed to the non-blocking sps30_dev_issue_*() functions. While measuring,
+ * sps30_cleaning_check() must be called at least every 2^31 microseconds.
+ */
+
+#define SPS30_CLEANING_DURATION_US 10000000
+/* the first sample after the cleaning still contains data taken during it */
+#define SPS30_CLEANING_WINDOW_US \
+    (SPS30_CLEANING_DURATION_US + SPS30_MEASUREMENT_DURATION_USEC)
+
+#define SPS30_CLEANING_NONE 0
+#define SPS30_CLEANING_MANUAL 1
+#define SPS30_CLEANING_AUTO 2
+
+/**
+ * struct sps30_cleaning - tracker state
+ *
+ * Besides the fields below, which may be read, the members are private.
+ *
+ * @cleanings:  Number of manual and automatic cleanings
+ * @flagged:    Number of samples flagged by sps30_cleaning_check()
+ */
+struct sps30_cleaning {
+    uint32_t cleanings;
+    uint32_t flagged;
+
+    uint32_t interval_s;
+    uint32_t counted_s;
+    uint32_t counted_us;
+    uint32_t counted_at_us;
+    uint32_t window_end_us;
+    uint8_t window;
+    uint8_t measuring;
+};
+
+/**
+ * sps30_cleaning_init() - set up a tracker for an idle sensor
+ *
+ * @cleaning:           Tracker to initialize
+ * @interval_seconds:   Automatic cleaning interval of the sensor, see
+ *                      sps30_get_fan_auto_cleaning_interval(), 0 if disabled
+ */
+void sps30_cleaning_init(struct sps30_cleaning* cleaning,
+                         uint32_t interval_seconds);
+
+/**
+ * sps30_cleaning_set_interval() - the automatic cleaning interval was changed
+ *
+ * The measuring time counted so far is kept.
+ */
+void sps30_cleaning_set_interval(struct sps30_cleaning* cleaning,
+                                 uint32_t interval_seconds);
+
+/**
+ * sps30_cleaning_start() - the measurement was started at @now_us
+ */
+void sps30_cleaning_start(struct sps30_cleaning* cleaning, uint32_t now_us);
+
+/**
+ * sps30_cleaning_stop() - the measurement was stopped at @now_us
+ *
+ * Stopping the measurement ends a running cleaning.
+ */
+void sps30_cleaning_stop(struct sps30_cleaning* cleaning, uint32_t now_us);
+
+/**
+ * sps30_cleaning_manual() - a manual cleaning was started at @now_us
+ */
+void sps30_cleaning_manual(struct sps30_cleaning* cleaning, uint32_t now_us);
+
+/**
+ * sps30_cleaning_check() - whether a sample is affected by a cleaning
+ *
+ * @cleaning:   Tracker
+ * @now_us:     Time at which the sample was read
+ * Return:      SPS30_CLEANING_MANUAL or SPS30_CLEANING_AUTO if the sample was
+ *              taken during a cleaning, SPS30_CLEANING_NONE otherwise
+ */
+uint8_t sps30_cleaning_check(struct sps30_cleaning* cleaning, uint32_t now_us);
+
+/**
+ * sps30_cleaning_next_auto_s() - measuring time until the next automatic
+ * cleaning
+ *
+ * Return:  Seconds of measuring time as of the last call to the tracker, 0 if
+ *          the automatic cleaning is disabled or due
+ */
+uint32_t sps30_cleaning_next_auto_s(const struct sps30_cleaning* cleaning);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPS30_CLEANING_H */
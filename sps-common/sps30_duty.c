@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <string.h>  // memset
+
+#include "sensirion_arch_config.h"
+#include "sensirion_common.h"
+#include "sps30_duty.h"
+
+#if !defined(SPS30_NO_SLEEP) && !defined(SPS30_NO_FLOAT)
+
+static void sps30_duty_add(struct sps30_measurement* sum,
+                           const struct sps30_measurement* m) {
+    sum->mc_1p0 += m->mc_1p0;
+    sum->mc_2p5 += m->mc_2p5;
+    sum->mc_4p0 += m->mc_4p0;
+    sum->mc_10p0 += m->mc_10p0;
+    sum->nc_0p5 += m->nc_0p5;
+    sum->nc_1p0 += m->nc_1p0;
+    sum->nc_2p5 += m->nc_2p5;
+    sum->nc_4p0 += m->nc_4p0;
+    sum->nc_10p0 += m->nc_10p0;
+    sum->typical_particle_size += m->typical_particle_size;
+}
+
+static void sps30_duty_scale(struct sps30_measurement* m, float factor) {
+    m->mc_1p0 *= factor;
+    m->mc_2p5 *= factor;
+    m->mc_4p0 *= factor;
+    m->mc_10p0 *= factor;
+    m->nc_0p5 *= factor;
+    m->nc_1p0 *= factor;
+    m->nc_2p5 *= factor;
+    m->nc_4p0 *= factor;
+    m->nc_10p0 *= factor;
+    m->typical_particle_size *= factor;
+}
+
+/* wait for the command just issued to complete */
+static void sps30_duty_wait_for_dev(struct sps30_duty* duty) {
+    duty->next_us = sps30_dev_ready_at(duty->dev) + SPS30_DUTY_MARGIN_US;
+}
+
+static int16_t sps30_duty_wake_up(struct sps30_duty* duty, uint32_t now_us) {
+    int16_t ret;
+
+    memset(&duty->report, 0, sizeof(duty->report));
+    duty->cycle_start_us = now_us;
+    duty->awake_since_us = now_us;
+
+    if (duty->dev->state == SPS30_STATE_SLEEPING) {
+        ret = sps30_dev_issue_wake_up(duty->dev, now_us);
+        if (ret != NO_ERROR)
+            return ret;
+        sps30_duty_wait_for_dev(duty);
+    }
+    duty->state = SPS30_DUTY_STATE_WAKING_UP;
+    return SPS30_ERR_NOT_READY;
+}
+
+static int16_t sps30_duty_start(struct sps30_duty* duty, uint32_t now_us) {
+    int16_t ret;
+
+    ret = sps30_dev_issue_start_measurement(duty->dev, now_us);
+    if (ret != NO_ERROR)
+        return ret;
+
+    duty->measuring_since_us = now_us;
+    sps30_cleaning_start(&duty->cleaning, now_us);
+    sps30_duty_wait_for_dev(duty);
+    if (duty->config.clean_every &&
+        duty->cycles % duty->config.clean_every == 0) {
+        duty->state = SPS30_DUTY_STATE_CLEANING;
+        return SPS30_ERR_NOT_READY;
+    }
+    if ((int32_t)(now_us + duty->config.warm_up_us - duty->next_us) > 0)
+        duty->next_us = now_us + duty->config.warm_up_us;
+    duty->state = SPS30_DUTY_STATE_WARMING_UP;
+    return SPS30_ERR_NOT_READY;
+}
+
+#ifndef SPS30_NO_FAN_CLEANING
+/* clean the fan during the warm-up, whose samples are discarded anyway */
+static int16_t sps30_duty_clean(struct sps30_duty* duty, uint32_t now_us) {
+    uint32_t warm_up_end_us;
+    int16_t ret;
+
+    ret = sps30_dev_issue_start_manual_fan_cleaning(duty->dev, now_us);
+    if (ret != NO_ERROR)
+        return ret;
+
+    sps30_cleaning_manual(&duty->cleaning, now_us);
+    duty->report.cleaned = 1;
+    warm_up_end_us = duty->measuring_since_us + duty->config.warm_up_us;
+    duty->next_us = now_us + SPS30_CLEANING_WINDOW_US;
+    if ((int32_t)(warm_up_end_us - duty->next_us) > 0)
+        duty->next_us = warm_up_end_us;
+    duty->state = SPS30_DUTY_STATE_WARMING_UP;
+    return SPS30_ERR_NOT_READY;
+}
+#endif /* SPS30_NO_FAN_CLEANING */
+
+/* discard the sample produced during the warm-up, if any */
+static int16_t sps30_duty_end_warm_up(struct sps30_duty* duty,
+                                      uint32_t now_us) {
+    struct sps30_measurement m;
+    uint16_t data_ready;
+    int16_t ret;
+
+    ret = sps30_dev_read_data_ready(duty->dev, &data_ready);
+    if (ret == NO_ERROR && data_ready) {
+        ret = sps30_dev_read_measurement(duty->dev, &m);
+        duty->report.discarded++;
+    }
+    if (ret != NO_ERROR)
+        return ret;
+
+    sps30_phase_init_from_start(&duty->phase, now_us,
+                                duty->measuring_since_us);
+    duty->next_us = sps30_phase_next_poll_us(&duty->phase);
+    duty->state = SPS30_DUTY_STATE_SAMPLING;
+    return SPS30_ERR_NOT_READY;
+}
+
+static int16_t sps30_duty_sample(struct sps30_duty* duty, uint32_t now_us) {
+    struct sps30_measurement m;
+    int16_t ret;
+
+    ret = sps30_phase_poll(&duty->phase, duty->dev, now_us, &m);
+    duty->next_us = sps30_phase_next_poll_us(&duty->phase);
+    if (ret != NO_ERROR)
+        return ret;
+
+    if (sps30_cleaning_check(&duty->cleaning, now_us) != SPS30_CLEANING_NONE) {
+        duty->report.cleaning_discarded++;
+        return SPS30_ERR_NOT_READY;
+    }
+    sps30_duty_add(&duty->report.mean, &m);
+    if (++duty->report.num_samples == duty->config.num_samples) {
+        duty->report.polls = duty->phase.polls;
+        duty->state = SPS30_DUTY_STATE_STOPPING;
+        duty->next_us = now_us;
+    }
+    return SPS30_ERR_NOT_READY;
+}
+
+static int16_t sps30_duty_stop(struct sps30_duty* duty, uint32_t now_us) {
+    int16_t ret;
+
+    ret = sps30_dev_issue_stop_measurement(duty->dev, now_us);
+    if (ret != NO_ERROR)
+        return ret;
+
+    duty->report.measuring_ms = (now_us - duty->measuring_since_us) / 1000;
+    sps30_cleaning_stop(&duty->cleaning, now_us);
+    sps30_duty_wait_for_dev(duty);
+    duty->state = SPS30_DUTY_STATE_GOING_TO_SLEEP;
+    return SPS30_ERR_NOT_READY;
+}
+
+static int16_t sps30_duty_sleep(struct sps30_duty* duty, uint32_t now_us,
+                                struct sps30_duty_report* report) {
+    int16_t ret;
+
+    ret = sps30_dev_issue_sleep(duty->dev, now_us);
+    if (ret != NO_ERROR)
+        return ret;
+
+    duty->report.awake_ms = (now_us - duty->awake_since_us) / 1000;
+    sps30_duty_scale(&duty->report.mean,
+                     1.0f / (float)duty->report.num_samples);
+    *report = duty->report;
+    duty->cycles++;
+
+    duty->next_us = duty->cycle_start_us + duty->config.period_us;
+    if ((int32_t)(duty->next_us - now_us) < 0)
+        duty->next_us = now_us; /* overrun, start the next cycle right away */
+    duty->state = SPS30_DUTY_STATE_IDLE;
+    return NO_ERROR;
+}
+
+int16_t sps30_duty_init(struct sps30_duty* duty, struct sps30_dev* dev,
+                        const struct sps30_duty_config* config) {
+    if (config->num_samples == 0 || config->period_us == 0 ||
+        config->period_us > SPS30_DUTY_MAX_PERIOD_US)
+        return STATUS_FAIL;
+#ifdef SPS30_NO_FAN_CLEANING
+    if (config->clean_every)
+        return STATUS_FAIL;
+#endif
+
+    memset(duty, 0, sizeof(*duty));
+    duty->dev = dev;
+    duty->config = *config;
+    sps30_cleaning_init(&duty->cleaning, config->fan_auto_cleaning_interval);
+    duty->state = SPS30_DUTY_STATE_IDLE;
+    duty->next_us = 0;
+    return NO_ERROR;
+}
+
+uint32_t sps30_duty_next_us(const struct sps30_duty* duty) {
+    return duty->next_us;
+}
+
+static int16_t sps30_duty_step(struct sps30_duty* duty, uint32_t now_us,
+                               struct sps30_duty_report* report) {
+    switch (duty->state) {
+        case SPS30_DUTY_STATE_IDLE:
+            return sps30_duty_wake_up(duty, now_us);
+        case SPS30_DUTY_STATE_WAKING_UP:
+            return sps30_duty_start(duty, now_us);
+        case SPS30_DUTY_STATE_WARMING_UP:
+            return sps30_duty_end_warm_up(duty, now_us);
+        case SPS30_DUTY_STATE_SAMPLING:
+            return sps30_duty_sample(duty, now_us);
+        case SPS30_DUTY_STATE_STOPPING:
+            return sps30_duty_stop(duty, now_us);
+#ifndef SPS30_NO_FAN_CLEANING
+        case SPS30_DUTY_STATE_CLEANING:
+            return sps30_duty_clean(duty, now_us);
+#endif
+        default:
+            return sps30_duty_sleep(duty, now_us, report);
+    }
+}
+
+int16_t sps30_duty_run(struct sps30_duty* duty, uint32_t now_us,
+                       struct sps30_duty_report* report) {
+    int16_t ret;
+
+    if ((int32_t)(now_us - duty->next_us) < 0)
+        return SPS30_ERR_NOT_READY;
+
+    ret = sps30_duty_step(duty, now_us, report);
+
+    if (ret != NO_ERROR && ret != SPS30_ERR_NOT_READY)
+        duty->next_us = now_us + SPS30_DUTY_RETRY_US;
+    return ret;
+}
+
+#endif /* !SPS30_NO_SLEEP && !SPS30_NO_FLOAT */
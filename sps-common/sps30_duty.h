@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SPS30_DUTY_H
+#define SPS30_DUTY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "sensirion_arch_config.h"
+#include "sps30.h"
+#include "sps30_cleaning.h"
+#include "sps30_phase.h"
+
+#if !defined(SPS30_NO_SLEEP) && !defined(SPS30_NO_FLOAT)
+
+/*
+ * Duty-cycled measurement
+ *
+ * For battery powered nodes which need a reading every few minutes, the
+ * scheduler runs the sequence
+ *
+ *     wake up, start measurement, warm up, read and average, stop, sleep
+ *
+ * once per period and keeps the sensor in sleep mode in between. The bus is
+ * left alone during the warm-up; the samples are then read as soon as they
+ * appear, tracked with sps30_phase from the start of the measurement, so the
+ * sensor is awake only for the warm-up plus about one second per averaged
+ * sample.
+ *
+ * The fan can be cleaned during the warm-up of every n-th cycle, when the
+ * samples are discarded anyway, instead of in the automatic cleaning interval
+ * of the sensor. Samples taken during an automatic cleaning, as predicted by
+ * sps30_cleaning, are discarded.
+ *
+ * The scheduler does not block. sps30_duty_run() performs the step which is
+ * due and tells when it wants to be called next, so the host can sleep in
+ * between. Times are in microseconds of a free running 32 bit clock as for the
+ * non-blocking sps30_dev_issue_*() functions, which limits the period to
+ * SPS30_DUTY_MAX_PERIOD_US.
+ */
+
+#define SPS30_DUTY_MAX_PERIOD_US 0x7fffffff
+/* added to command delays to cover the transfer of the command */
+#define SPS30_DUTY_MARGIN_US 1000
+/* delay before a failed step is retried */
+#define SPS30_DUTY_RETRY_US 100000
+
+#define SPS30_DUTY_STATE_IDLE 0
+#define SPS30_DUTY_STATE_WAKING_UP 1
+#define SPS30_DUTY_STATE_WARMING_UP 2
+#define SPS30_DUTY_STATE_SAMPLING 3
+#define SPS30_DUTY_STATE_STOPPING 4
+#define SPS30_DUTY_STATE_GOING_TO_SLEEP 5
+#define SPS30_DUTY_STATE_CLEANING 6
+
+/**
+ * struct sps30_duty_config - duty cycle parameters
+ *
+ * @period_us:      Time from the start of one cycle to the next
+ * @warm_up_us:     Time after starting the measurement during which samples
+ *                  are discarded
+ * @num_samples:    Number of samples to average per cycle, at least 1
+ * @clean_every:    Start a manual fan cleaning after starting the measurement
+ *                  in every n-th cycle, beginning with the first; the warm-up
+ *                  is extended to SPS30_CLEANING_WINDOW_US if it is shorter.
+ *                  0 to leave the cleaning to the sensor.
+ * @fan_auto_cleaning_interval: Automatic cleaning interval of the sensor in
+ *                  seconds, to discard the samples taken during an automatic
+ *                  cleaning; 0 if disabled
+ */
+struct sps30_duty_config {
+    uint32_t period_us;
+    uint32_t warm_up_us;
+    uint16_t num_samples;
+    uint16_t clean_every;
+    uint32_t fan_auto_cleaning_interval;
+};
+
+/**
+ * struct sps30_duty_report - result of a cycle
+ *
+ * @mean:           Mean of the samples read
+ * @num_samples:    Number of samples averaged
+ * @discarded:      Number of samples discarded because they were produced
+ *                  during the warm-up
+ * @cleaning_discarded: Number of samples discarded because they were taken
+ *                  during a fan cleaning
+ * @cleaned:        1 if a manual fan cleaning was started in the cycle
+ * @polls:          Number of data-ready polls
+ * @awake_ms:       Time the sensor was out of sleep mode, from the wake-up to
+ *                  the sleep command
+ * @measuring_ms:   Time the fan and laser were running, from the start to the
+ *                  stop command
+ */
+struct sps30_duty_report {
+    struct sps30_measurement mean;
+    uint16_t num_samples;
+    uint16_t discarded;
+    uint16_t cleaning_discarded;
+    uint8_t cleaned;
+    uint32_t polls;
+    uint32_t awake_ms;
+    uint32_t measuring_ms;
+};
+
+/**
+ * struct sps30_duty - scheduler state, the members are private
+ */
+struct sps30_duty {
+    struct sps30_dev* dev;
+    struct sps30_duty_config config;
+    struct sps30_phase phase;
+    struct sps30_cleaning cleaning;
+    struct sps30_duty_report report;
+    uint32_t cycles;
+    uint8_t state;
+    uint32_t next_us;
+    uint32_t cycle_start_us;
+    uint32_t awake_since_us;
+    uint32_t measuring_since_us;
+};
+
+/**
+ * sps30_duty_init() - set up duty-cycled measurements of a sensor
+ *
+ * The first cycle starts at the first call to sps30_duty_run(). The sensor
+ * must be idle, or sleeping after having been sent to sleep through @dev.
+ *
+ * @duty:   Scheduler to initialize
+ * @dev:    Sensor handle, not used by anybody else while the scheduler runs
+ * @config: Duty cycle parameters, copied
+ * Return:  0 on success, STATUS_FAIL on invalid parameters or if
+ *          @config->clean_every is set in a build without fan cleaning
+ */
+int16_t sps30_duty_init(struct sps30_duty* duty, struct sps30_dev* dev,
+                        const struct sps30_duty_config* config);
+
+/**
+ * sps30_duty_next_us() - time at which sps30_duty_run() wants to be called
+ * next
+ */
+uint32_t sps30_duty_next_us(const struct sps30_duty* duty);
+
+/**
+ * sps30_duty_run() - perform the next step if it is due
+ *
+ * Only one step is performed per call, so that @now_us is accurate for the
+ * delays which follow it. When the next step is due right away,
+ * sps30_duty_next_us() is not later than @now_us. A failed step is
+ * retried after SPS30_DUTY_RETRY_US.
+ *
+ * @duty:   Scheduler
+ * @now_us: Current time
+ * @report: Memory where the result of a finished cycle is stored
+ * Return:  0 if a cycle finished and @report was filled, SPS30_ERR_NOT_READY
+ *          if the cycle is still in progress, an error code otherwise
+ */
+int16_t sps30_duty_run(struct sps30_duty* duty, uint32_t now_us,
+                       struct sps30_duty_report* report);
+
+#endif /* !SPS30_NO_SLEEP && !SPS30_NO_FLOAT */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPS30_DUTY_H */
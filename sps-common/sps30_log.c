@@ -0,0 +1,767 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <string.h>  // memcpy, memset
+
+#include "sensirion_arch_config.h"
+#include "sensirion_common.h"
+#include "sps30_log.h"
+
+#if defined(SPS30_LOG_NO_SIMD)
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define SPS30_LOG_SSE2
+#endif
+
+#define SPS30_LOG_BLOCK_MAGIC 0x4b4c4253 /* "SBLK" */
+#define SPS30_LOG_MAX_RECORD_SIZE (1 + 10 + SPS30_LOG_NUM_FIELDS * 5)
+/* bytes loaded at once when unpacking the codes of a record in a block */
+#define SPS30_LOG_UNPACK_SIZE 16
+
+#define SPS30_LOG_TAG_MODE_MASK 0x03
+#define SPS30_LOG_TAG_MODE_ZERO 0x00
+#define SPS30_LOG_TAG_MODE_NIBBLE 0x01
+#define SPS30_LOG_TAG_MODE_BYTE 0x02
+#define SPS30_LOG_TAG_MODE_VARINT 0x03
+#define SPS30_LOG_TAG_TIMESTAMP 0x04
+
+static const uint8_t sps30_log_magic[8] = {'S', 'P', 'S', '3',
+                                           '0', 'L', 'O', 'G'};
+
+static void sps30_log_put_u16(uint8_t* buf, uint16_t value) {
+    buf[0] = (uint8_t)value;
+    buf[1] = (uint8_t)(value >> 8);
+}
+
+static void sps30_log_put_u32(uint8_t* buf, uint32_t value) {
+    sps30_log_put_u16(buf, (uint16_t)value);
+    sps30_log_put_u16(buf + 2, (uint16_t)(value >> 16));
+}
+
+static void sps30_log_put_u64(uint8_t* buf, uint64_t value) {
+    sps30_log_put_u32(buf, (uint32_t)value);
+    sps30_log_put_u32(buf + 4, (uint32_t)(value >> 32));
+}
+
+static uint16_t sps30_log_get_u16(const uint8_t* buf) {
+    return (uint16_t)(buf[0] | (buf[1] << 8));
+}
+
+static uint32_t sps30_log_get_u32(const uint8_t* buf) {
+    return (uint32_t)sps30_log_get_u16(buf) |
+           ((uint32_t)sps30_log_get_u16(buf + 2) << 16);
+}
+
+static uint64_t sps30_log_get_u64(const uint8_t* buf) {
+    return (uint64_t)sps30_log_get_u32(buf) |
+           ((uint64_t)sps30_log_get_u32(buf + 4) << 32);
+}
+
+static uint8_t sps30_log_put_varint(uint8_t* buf, uint64_t value) {
+    uint8_t n = 0;
+
+    while (value >= 0x80) {
+        buf[n++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    buf[n++] = (uint8_t)value;
+    return n;
+}
+
+/* returns the number of bytes consumed, 0 if the varint is truncated */
+static uint8_t sps30_log_get_varint(const uint8_t* buf, const uint8_t* end,
+                                    uint64_t* value) {
+    uint64_t v = 0;
+    uint8_t n;
+
+    for (n = 0; n < 10 && buf + n < end; ++n) {
+        v |= (uint64_t)(buf[n] & 0x7f) << (7 * n);
+        if (!(buf[n] & 0x80)) {
+            *value = v;
+            return (uint8_t)(n + 1);
+        }
+    }
+    return 0;
+}
+
+/* Differences are computed modulo 2^32 resp. 2^64 and zigzag encoded, so that
+ * small positive and negative differences map to small codes. */
+static uint32_t sps30_log_zigzag32(uint32_t diff) {
+    return (diff << 1) ^ (0u - (diff >> 31));
+}
+
+static uint32_t sps30_log_unzigzag32(uint32_t code) {
+    return (code >> 1) ^ (0u - (code & 1));
+}
+
+static uint64_t sps30_log_zigzag64(uint64_t diff) {
+    return (diff << 1) ^ (0u - (diff >> 63));
+}
+
+static uint64_t sps30_log_unzigzag64(uint64_t code) {
+    return (code >> 1) ^ (0u - (code & 1));
+}
+
+static void sps30_log_to_fields(const struct sps30_measurement* m,
+                                float* fields) {
+    fields[0] = m->mc_1p0;
+    fields[1] = m->mc_2p5;
+    fields[2] = m->mc_4p0;
+    fields[3] = m->mc_10p0;
+    fields[4] = m->nc_0p5;
+    fields[5] = m->nc_1p0;
+    fields[6] = m->nc_2p5;
+    fields[7] = m->nc_4p0;
+    fields[8] = m->nc_10p0;
+    fields[9] = m->typical_particle_size;
+}
+
+static void sps30_log_from_fields(const float* fields,
+                                  struct sps30_measurement* m) {
+    m->mc_1p0 = fields[0];
+    m->mc_2p5 = fields[1];
+    m->mc_4p0 = fields[2];
+    m->mc_10p0 = fields[3];
+    m->nc_0p5 = fields[4];
+    m->nc_1p0 = fields[5];
+    m->nc_2p5 = fields[6];
+    m->nc_4p0 = fields[7];
+    m->nc_10p0 = fields[8];
+    m->typical_particle_size = fields[9];
+}
+
+/* resolution of each field in 10^-6 units */
+static void sps30_log_field_resolutions(const struct sps30_log_info* info,
+                                        uint32_t* resolutions) {
+    uint8_t i;
+
+    for (i = 0; i < 4; ++i)
+        resolutions[i] = info->resolution_mc;
+    for (i = 4; i < 9; ++i)
+        resolutions[i] = info->resolution_nc;
+    resolutions[9] = info->resolution_size;
+}
+
+static int32_t sps30_log_quantize(float value, float scale) {
+    float q = value * scale;
+
+    if (q >= 2147483520.0f)
+        return 2147483647;
+    if (q <= -2147483520.0f)
+        return -2147483647;
+    return (int32_t)(q >= 0.0f ? q + 0.5f : q - 0.5f);
+}
+
+void sps30_log_info_init(struct sps30_log_info* info, uint32_t period_ms) {
+    memset(info, 0, sizeof(*info));
+    info->period_ms = period_ms;
+    info->resolution_mc = SPS30_LOG_DEFAULT_RESOLUTION_MC;
+    info->resolution_nc = SPS30_LOG_DEFAULT_RESOLUTION_NC;
+    info->resolution_size = SPS30_LOG_DEFAULT_RESOLUTION_SIZE;
+}
+
+static int16_t sps30_log_writer_setup(struct sps30_log_writer* writer,
+                                      const struct sps30_log_info* info,
+                                      sps30_log_write_fn write,
+                                      void* context) {
+    uint32_t resolutions[SPS30_LOG_NUM_FIELDS];
+    uint8_t i;
+
+    if (!info->resolution_mc || !info->resolution_nc ||
+        !info->resolution_size)
+        return STATUS_FAIL;
+
+    sps30_log_field_resolutions(info, resolutions);
+    for (i = 0; i < SPS30_LOG_NUM_FIELDS; ++i)
+        writer->scale[i] = 1000000.0f / (float)resolutions[i];
+    writer->write = write;
+    writer->context = context;
+    writer->period_ms = info->period_ms;
+    writer->timestamp = 0;
+    writer->block_used = 0;
+    memset(writer->values, 0, sizeof(writer->values));
+    return NO_ERROR;
+}
+
+int16_t sps30_log_writer_init(struct sps30_log_writer* writer,
+                              const struct sps30_log_info* info,
+                              sps30_log_write_fn write, void* context) {
+    uint8_t header[SPS30_LOG_HEADER_SIZE];
+    int16_t ret;
+
+    ret = sps30_log_writer_setup(writer, info, write, context);
+    if (ret)
+        return ret;
+
+    memset(header, 0, sizeof(header));
+    memcpy(header, sps30_log_magic, sizeof(sps30_log_magic));
+    sps30_log_put_u16(&header[8], SPS30_LOG_VERSION);
+    sps30_log_put_u16(&header[10], SPS30_LOG_BLOCK_SIZE);
+    sps30_log_put_u32(&header[12], info->period_ms);
+    sps30_log_put_u32(&header[16], info->resolution_mc);
+    sps30_log_put_u32(&header[20], info->resolution_nc);
+    sps30_log_put_u32(&header[24], info->resolution_size);
+    header[28] = info->firmware_major;
+    header[29] = info->firmware_minor;
+    memcpy(&header[32], info->serial, SPS30_MAX_SERIAL_LEN);
+    header[SPS30_LOG_HEADER_SIZE - 1] = '\0';
+    return write(context, header, sizeof(header));
+}
+
+static int16_t sps30_log_pad_block(struct sps30_log_writer* writer) {
+    static const uint8_t zeros[64] = {0};
+    const uint8_t end_of_block = SPS30_LOG_END_OF_BLOCK;
+    uint16_t remaining = (uint16_t)(SPS30_LOG_BLOCK_SIZE - writer->block_used);
+    uint16_t n;
+    int16_t ret;
+
+    if (remaining) {
+        ret = writer->write(writer->context, &end_of_block, 1);
+        if (ret)
+            return ret;
+        remaining--;
+    }
+    while (remaining) {
+        n = remaining < sizeof(zeros) ? remaining : sizeof(zeros);
+        ret = writer->write(writer->context, zeros, n);
+        if (ret)
+            return ret;
+        remaining = (uint16_t)(remaining - n);
+    }
+    writer->block_used = 0;
+    return NO_ERROR;
+}
+
+int16_t sps30_log_writer_resume(struct sps30_log_writer* writer,
+                                const struct sps30_log_info* info,
+                                sps30_log_write_fn write, void* context,
+                                size_t size) {
+    int16_t ret;
+
+    if (size < SPS30_LOG_HEADER_SIZE)
+        return STATUS_FAIL;
+
+    ret = sps30_log_writer_setup(writer, info, write, context);
+    if (ret)
+        return ret;
+
+    writer->block_used =
+        (uint16_t)((size - SPS30_LOG_HEADER_SIZE) % SPS30_LOG_BLOCK_SIZE);
+    if (!writer->block_used)
+        return NO_ERROR;
+    return sps30_log_pad_block(writer);
+}
+
+/* encode the difference to the previous sample, returns the length */
+static uint8_t sps30_log_encode_record(const struct sps30_log_writer* writer,
+                                       uint64_t timestamp,
+                                       const int32_t* values, uint8_t* buf) {
+    uint32_t codes[SPS30_LOG_NUM_FIELDS];
+    uint32_t max_code = 0;
+    uint64_t dt;
+    uint8_t n = 1;
+    uint8_t i;
+
+    for (i = 0; i < SPS30_LOG_NUM_FIELDS; ++i) {
+        codes[i] = sps30_log_zigzag32((uint32_t)values[i] -
+                                      (uint32_t)writer->values[i]);
+        if (codes[i] > max_code)
+            max_code = codes[i];
+    }
+
+    buf[0] = 0;
+    dt = timestamp - writer->timestamp - writer->period_ms;
+    if (dt) {
+        buf[0] |= SPS30_LOG_TAG_TIMESTAMP;
+        n += sps30_log_put_varint(&buf[n], sps30_log_zigzag64(dt));
+    }
+
+    if (max_code == 0) {
+        buf[0] |= SPS30_LOG_TAG_MODE_ZERO;
+    } else if (max_code < 0x10) {
+        buf[0] |= SPS30_LOG_TAG_MODE_NIBBLE;
+        for (i = 0; i < SPS30_LOG_NUM_FIELDS; i += 2)
+            buf[n++] = (uint8_t)(codes[i] | (codes[i + 1] << 4));
+    } else if (max_code < 0x100) {
+        buf[0] |= SPS30_LOG_TAG_MODE_BYTE;
+        for (i = 0; i < SPS30_LOG_NUM_FIELDS; ++i)
+            buf[n++] = (uint8_t)codes[i];
+    } else {
+        buf[0] |= SPS30_LOG_TAG_MODE_VARINT;
+        for (i = 0; i < SPS30_LOG_NUM_FIELDS; ++i)
+            n += sps30_log_put_varint(&buf[n], codes[i]);
+    }
+    return n;
+}
+
+int16_t sps30_log_append(struct sps30_log_writer* writer, uint64_t timestamp_ms,
+                         const struct sps30_measurement* measurement) {
+    uint8_t buf[SPS30_LOG_BLOCK_HEADER_SIZE > SPS30_LOG_MAX_RECORD_SIZE
+                    ? SPS30_LOG_BLOCK_HEADER_SIZE
+                    : SPS30_LOG_MAX_RECORD_SIZE];
+    float fields[SPS30_LOG_NUM_FIELDS];
+    int32_t values[SPS30_LOG_NUM_FIELDS];
+    uint8_t n;
+    uint8_t i;
+    int16_t ret;
+
+    sps30_log_to_fields(measurement, fields);
+    for (i = 0; i < SPS30_LOG_NUM_FIELDS; ++i)
+        values[i] = sps30_log_quantize(fields[i], writer->scale[i]);
+
+    n = 0;
+    if (writer->block_used) {
+        n = sps30_log_encode_record(writer, timestamp_ms, values, buf);
+        if (writer->block_used + n > SPS30_LOG_BLOCK_SIZE) {
+            ret = sps30_log_pad_block(writer);
+            if (ret)
+                return ret;
+        }
+    }
+
+    /* the first sample of a block is stored in the block header */
+    if (!writer->block_used) {
+        sps30_log_put_u32(buf, SPS30_LOG_BLOCK_MAGIC);
+        sps30_log_put_u64(&buf[4], timestamp_ms);
+        for (i = 0; i < SPS30_LOG_NUM_FIELDS; ++i)
+            sps30_log_put_u32(&buf[12 + 4 * i], (uint32_t)values[i]);
+        n = SPS30_LOG_BLOCK_HEADER_SIZE;
+    }
+
+    ret = writer->write(writer->context, buf, n);
+    if (ret)
+        return ret;
+
+    writer->block_used = (uint16_t)(writer->block_used + n);
+    writer->timestamp = timestamp_ms;
+    memcpy(writer->values, values, sizeof(values));
+    return NO_ERROR;
+}
+
+int16_t sps30_log_reader_init(struct sps30_log_reader* reader,
+                              const uint8_t* data, size_t size) {
+    struct sps30_log_info* info = &reader->info;
+    uint32_t resolutions[SPS30_LOG_NUM_FIELDS];
+    uint8_t i;
+
+    if (size < SPS30_LOG_HEADER_SIZE ||
+        memcmp(data, sps30_log_magic, sizeof(sps30_log_magic)) != 0 ||
+        sps30_log_get_u16(&data[8]) != SPS30_LOG_VERSION ||
+        sps30_log_get_u16(&data[10]) != SPS30_LOG_BLOCK_SIZE)
+        return SPS30_ERR_FORMAT;
+
+    info->period_ms = sps30_log_get_u32(&data[12]);
+    info->resolution_mc = sps30_log_get_u32(&data[16]);
+    info->resolution_nc = sps30_log_get_u32(&data[20]);
+    info->resolution_size = sps30_log_get_u32(&data[24]);
+    info->firmware_major = data[28];
+    info->firmware_minor = data[29];
+    memcpy(info->serial, &data[32], SPS30_MAX_SERIAL_LEN);
+    info->serial[SPS30_MAX_SERIAL_LEN - 1] = '\0';
+
+    sps30_log_field_resolutions(info, resolutions);
+    for (i = 0; i < SPS30_LOG_NUM_FIELDS; ++i)
+        reader->resolution[i] = (float)resolutions[i] / 1000000.0f;
+
+    reader->data = data;
+    reader->size = size;
+    reader->num_blocks = (size - SPS30_LOG_HEADER_SIZE + SPS30_LOG_BLOCK_SIZE -
+                          1) /
+                         SPS30_LOG_BLOCK_SIZE;
+    reader->block = 0;
+    reader->offset = SPS30_LOG_HEADER_SIZE;
+    reader->timestamp = 0;
+    memset(reader->values, 0, sizeof(reader->values));
+    return NO_ERROR;
+}
+
+static size_t sps30_log_block_start(size_t block) {
+    return SPS30_LOG_HEADER_SIZE + block * SPS30_LOG_BLOCK_SIZE;
+}
+
+static void sps30_log_goto_block(struct sps30_log_reader* reader,
+                                 size_t block) {
+    reader->block = block;
+    reader->offset = sps30_log_block_start(block);
+}
+
+/*
+ * Byte offset, shift and mask of the code of each field in the zero, nibble
+ * and byte modes, so that they are unpacked without branches
+ */
+static const uint8_t sps30_log_code_offset[3][SPS30_LOG_NUM_FIELDS] = {
+    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {0, 0, 1, 1, 2, 2, 3, 3, 4, 4},
+    {0, 1, 2, 3, 4, 5, 6, 7, 8, 9}};
+static const uint8_t sps30_log_code_shift[3][SPS30_LOG_NUM_FIELDS] = {
+    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {0, 4, 0, 4, 0, 4, 0, 4, 0, 4},
+    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}};
+static const uint32_t sps30_log_code_mask[3] = {0x00, 0x0f, 0xff};
+
+/* size of the codes in the zero, nibble and byte modes: 0, 5 and 10 bytes */
+static size_t sps30_log_code_size(uint8_t mode) {
+    return (size_t)mode * (SPS30_LOG_NUM_FIELDS / 2);
+}
+
+/*
+ * add the differences of a record in the zero, nibble or byte mode, @codes
+ * must be followed by SPS30_LOG_NUM_FIELDS readable bytes
+ */
+static void sps30_log_add_packed(uint32_t* values, const uint8_t* codes,
+                                 uint8_t mode) {
+    const uint8_t* offset = sps30_log_code_offset[mode];
+    const uint8_t* shift = sps30_log_code_shift[mode];
+    const uint32_t mask = sps30_log_code_mask[mode];
+    uint8_t i;
+
+    for (i = 0; i < SPS30_LOG_NUM_FIELDS; ++i)
+        values[i] += sps30_log_unzigzag32(
+            ((uint32_t)codes[offset[i]] >> shift[i]) & mask);
+}
+
+/*
+ * decode a record into @values and @timestamp, returns its length or 0 if it
+ * is truncated
+ */
+static size_t sps30_log_decode_record(uint32_t* values, uint64_t* timestamp,
+                                      uint32_t period_ms, const uint8_t* buf,
+                                      const uint8_t* end) {
+    uint32_t codes[SPS30_LOG_NUM_FIELDS];
+    uint8_t tail[SPS30_LOG_NUM_FIELDS];
+    uint64_t code;
+    uint64_t dt = 0;
+    const uint8_t tag = buf[0];
+    const uint8_t mode = tag & SPS30_LOG_TAG_MODE_MASK;
+    size_t n = 1;
+    uint8_t len;
+    uint8_t i;
+
+    if (tag & SPS30_LOG_TAG_TIMESTAMP) {
+        len = sps30_log_get_varint(&buf[n], end, &code);
+        if (!len)
+            return 0;
+        dt = sps30_log_unzigzag64(code);
+        n += len;
+    }
+
+    /* the modes are checked for truncation before any state is changed */
+    if (mode != SPS30_LOG_TAG_MODE_VARINT) {
+        if (end - buf >= (ptrdiff_t)(n + SPS30_LOG_NUM_FIELDS)) {
+            sps30_log_add_packed(values, &buf[n], mode);
+        } else {
+            /* at the end of a truncated log */
+            if (end - buf < (ptrdiff_t)(n + sps30_log_code_size(mode)))
+                return 0;
+            memset(tail, 0, sizeof(tail));
+            memcpy(tail, &buf[n], sps30_log_code_size(mode));
+            sps30_log_add_packed(values, tail, mode);
+        }
+        n += sps30_log_code_size(mode);
+    } else {
+        for (i = 0; i < SPS30_LOG_NUM_FIELDS; ++i) {
+            len = sps30_log_get_varint(&buf[n], end, &code);
+            if (!len)
+                return 0;
+            codes[i] = (uint32_t)code;
+            n += len;
+        }
+        for (i = 0; i < SPS30_LOG_NUM_FIELDS; ++i)
+            values[i] += sps30_log_unzigzag32(codes[i]);
+    }
+
+    *timestamp += period_ms + dt;
+    return n;
+}
+
+#ifdef SPS30_LOG_SSE2
+
+/* the ten values are held in three vectors, the last two lanes are unused */
+struct sps30_log_state {
+    __m128i v[3];
+};
+
+static void sps30_log_state_load(struct sps30_log_state* state,
+                                 const int32_t* values) {
+    state->v[0] = _mm_loadu_si128((const __m128i*)&values[0]);
+    state->v[1] = _mm_loadu_si128((const __m128i*)&values[4]);
+    state->v[2] = _mm_loadl_epi64((const __m128i*)&values[8]);
+}
+
+static void sps30_log_state_store(const struct sps30_log_state* state,
+                                  int32_t* values) {
+    _mm_storeu_si128((__m128i*)&values[0], state->v[0]);
+    _mm_storeu_si128((__m128i*)&values[4], state->v[1]);
+    _mm_storel_epi64((__m128i*)&values[8], state->v[2]);
+}
+
+/* sign extend the low half of 16 bit lanes to 32 bit lanes */
+static __m128i sps30_log_widen_lo_epi16(__m128i words) {
+    return _mm_srai_epi32(_mm_unpacklo_epi16(words, words), 16);
+}
+
+static __m128i sps30_log_widen_hi_epi16(__m128i words) {
+    return _mm_srai_epi32(_mm_unpackhi_epi16(words, words), 16);
+}
+
+/* lanes selected from the nibbles and from the bytes in each mode */
+#define SPS30_LOG_LANES_NONE \
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }
+#define SPS30_LOG_LANES_FIELDS \
+    { -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 0, 0, 0, 0, 0 }
+static const int8_t sps30_log_nibble_lanes[3][16] = {
+    SPS30_LOG_LANES_NONE, SPS30_LOG_LANES_FIELDS, SPS30_LOG_LANES_NONE};
+static const int8_t sps30_log_byte_lanes[3][16] = {
+    SPS30_LOG_LANES_NONE, SPS30_LOG_LANES_NONE, SPS30_LOG_LANES_FIELDS};
+
+/*
+ * spread the nibbles of the first five bytes to one byte each, select the
+ * nibbles or the bytes by mode, undo the zigzag encoding of the ten codes and
+ * sign extend them to the lanes of the three vectors
+ */
+static void sps30_log_state_add(struct sps30_log_state* state,
+                                const uint8_t* codes, uint8_t mode) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i low = _mm_set1_epi8(0x0f);
+    const __m128i nibble_lanes =
+        _mm_loadu_si128((const __m128i*)sps30_log_nibble_lanes[mode]);
+    const __m128i byte_lanes =
+        _mm_loadu_si128((const __m128i*)sps30_log_byte_lanes[mode]);
+    const __m128i raw = _mm_loadu_si128((const __m128i*)codes);
+    const __m128i nibbles =
+        _mm_unpacklo_epi8(_mm_and_si128(raw, low),
+                          _mm_and_si128(_mm_srli_epi16(raw, 4), low));
+    const __m128i bytes = _mm_or_si128(_mm_and_si128(nibbles, nibble_lanes),
+                                       _mm_and_si128(raw, byte_lanes));
+    /* the codes are at most 8 bit wide, the differences fit into a byte */
+    const __m128i diffs = _mm_xor_si128(
+        _mm_and_si128(_mm_srli_epi16(bytes, 1), _mm_set1_epi8(0x7f)),
+        _mm_sub_epi8(zero, _mm_and_si128(bytes, _mm_set1_epi8(1))));
+    const __m128i lo = _mm_srai_epi16(_mm_unpacklo_epi8(diffs, diffs), 8);
+    const __m128i hi = _mm_srai_epi16(_mm_unpackhi_epi8(diffs, diffs), 8);
+
+    state->v[0] = _mm_add_epi32(state->v[0], sps30_log_widen_lo_epi16(lo));
+    state->v[1] = _mm_add_epi32(state->v[1], sps30_log_widen_hi_epi16(lo));
+    state->v[2] = _mm_add_epi32(state->v[2], sps30_log_widen_lo_epi16(hi));
+}
+
+#else
+
+struct sps30_log_state {
+    uint32_t v[SPS30_LOG_NUM_FIELDS];
+};
+
+static void sps30_log_state_load(struct sps30_log_state* state,
+                                 const int32_t* values) {
+    memcpy(state->v, values, sizeof(state->v));
+}
+
+static void sps30_log_state_store(const struct sps30_log_state* state,
+                                  int32_t* values) {
+    memcpy(values, state->v, sizeof(state->v));
+}
+
+static void sps30_log_state_add(struct sps30_log_state* state,
+                                const uint8_t* codes, uint8_t mode) {
+    sps30_log_add_packed(state->v, codes, mode);
+}
+
+#endif /* SPS30_LOG_SSE2 */
+
+/*
+ * decode the records of the current block up to @end, stops at the end of
+ * the block, before a truncated record or after @max_samples, returns the
+ * number of samples
+ */
+static size_t sps30_log_decode_block(struct sps30_log_reader* reader,
+                                     size_t end, uint64_t* timestamps_ms,
+                                     int32_t* values, size_t max_samples) {
+    struct sps30_log_state state;
+    const uint8_t* buf = &reader->data[reader->offset];
+    const uint8_t* block_end = &reader->data[end];
+    const uint32_t period_ms = reader->info.period_ms;
+    uint64_t timestamp = reader->timestamp;
+    size_t count = 0;
+    size_t n;
+
+    sps30_log_state_load(&state, reader->values);
+    while (count < max_samples) {
+        if (block_end - buf > SPS30_LOG_UNPACK_SIZE &&
+            buf[0] < SPS30_LOG_TAG_MODE_VARINT) {
+            /* no timestamp difference and packed, the tag is the mode */
+            sps30_log_state_add(&state, &buf[1], buf[0]);
+            n = 1 + sps30_log_code_size(buf[0]);
+            timestamp += period_ms;
+        } else {
+            if (buf >= block_end || buf[0] == SPS30_LOG_END_OF_BLOCK)
+                break;
+            sps30_log_state_store(&state, reader->values);
+            reader->timestamp = timestamp;
+            n = sps30_log_decode_record((uint32_t*)reader->values,
+                                        &reader->timestamp, period_ms, buf,
+                                        block_end);
+            if (!n)
+                break;
+            sps30_log_state_load(&state, reader->values);
+            timestamp = reader->timestamp;
+        }
+        buf += n;
+        timestamps_ms[count] = timestamp;
+        sps30_log_state_store(&state, &values[count * SPS30_LOG_NUM_FIELDS]);
+        ++count;
+    }
+
+    sps30_log_state_store(&state, reader->values);
+    reader->timestamp = timestamp;
+    reader->offset = (size_t)(buf - reader->data);
+    return count;
+}
+
+int16_t sps30_log_read_raw(struct sps30_log_reader* reader,
+                           uint64_t* timestamp_ms, int32_t* values) {
+    const uint8_t* block;
+    size_t start;
+    size_t end;
+    size_t n;
+    uint8_t i;
+
+    while (reader->block < reader->num_blocks) {
+        start = sps30_log_block_start(reader->block);
+        end = start + SPS30_LOG_BLOCK_SIZE;
+        if (end > reader->size)
+            end = reader->size;
+        block = &reader->data[start];
+
+        if (reader->offset == start) {
+            if (end - start < SPS30_LOG_BLOCK_HEADER_SIZE ||
+                sps30_log_get_u32(block) != SPS30_LOG_BLOCK_MAGIC) {
+                sps30_log_goto_block(reader, reader->block + 1);
+                continue;
+            }
+            reader->timestamp = sps30_log_get_u64(&block[4]);
+            for (i = 0; i < SPS30_LOG_NUM_FIELDS; ++i)
+                reader->values[i] =
+                    (int32_t)sps30_log_get_u32(&block[12 + 4 * i]);
+            reader->offset += SPS30_LOG_BLOCK_HEADER_SIZE;
+            break;
+        }
+
+        n = 0;
+        if (reader->offset < end &&
+            reader->data[reader->offset] != SPS30_LOG_END_OF_BLOCK)
+            n = sps30_log_decode_record(
+                (uint32_t*)reader->values, &reader->timestamp,
+                reader->info.period_ms, &reader->data[reader->offset],
+                &reader->data[end]);
+        if (n) {
+            reader->offset += n;
+            break;
+        }
+        sps30_log_goto_block(reader, reader->block + 1);
+    }
+
+    if (reader->block >= reader->num_blocks)
+        return STATUS_FAIL;
+
+    *timestamp_ms = reader->timestamp;
+    memcpy(values, reader->values, sizeof(reader->values));
+    return NO_ERROR;
+}
+
+size_t sps30_log_read_raw_many(struct sps30_log_reader* reader,
+                               uint64_t* timestamps_ms, int32_t* values,
+                               size_t max_samples) {
+    size_t count = 0;
+    size_t end;
+
+    /* the block headers and transitions are left to sps30_log_read_raw() */
+    while (count < max_samples &&
+           sps30_log_read_raw(reader, &timestamps_ms[count],
+                              &values[count * SPS30_LOG_NUM_FIELDS]) ==
+               NO_ERROR) {
+        ++count;
+        end = sps30_log_block_start(reader->block) + SPS30_LOG_BLOCK_SIZE;
+        if (end > reader->size)
+            end = reader->size;
+        count += sps30_log_decode_block(
+            reader, end, &timestamps_ms[count],
+            &values[count * SPS30_LOG_NUM_FIELDS], max_samples - count);
+    }
+    return count;
+}
+
+int16_t sps30_log_read(struct sps30_log_reader* reader, uint64_t* timestamp_ms,
+                       struct sps30_measurement* measurement) {
+    int32_t values[SPS30_LOG_NUM_FIELDS];
+    float fields[SPS30_LOG_NUM_FIELDS];
+    int16_t ret;
+    uint8_t i;
+
+    ret = sps30_log_read_raw(reader, timestamp_ms, values);
+    if (ret)
+        return ret;
+
+    for (i = 0; i < SPS30_LOG_NUM_FIELDS; ++i)
+        fields[i] = (float)values[i] * reader->resolution[i];
+    sps30_log_from_fields(fields, measurement);
+    return NO_ERROR;
+}
+
+int16_t sps30_log_seek(struct sps30_log_reader* reader, uint64_t timestamp_ms) {
+    struct sps30_log_reader next;
+    int32_t values[SPS30_LOG_NUM_FIELDS];
+    uint64_t timestamp;
+    size_t start;
+    size_t low = 0;
+    size_t high = reader->num_blocks;
+    size_t mid;
+
+    /* find the last complete block header at or before the timestamp */
+    while (high - low > 1) {
+        mid = low + (high - low) / 2;
+        start = sps30_log_block_start(mid);
+        if (reader->size - start >= SPS30_LOG_BLOCK_HEADER_SIZE &&
+            sps30_log_get_u64(&reader->data[start + 4]) <= timestamp_ms)
+            low = mid;
+        else
+            high = mid;
+    }
+    sps30_log_goto_block(reader, low);
+
+    for (;;) {
+        next = *reader;
+        if (sps30_log_read_raw(&next, &timestamp, values))
+            return STATUS_FAIL;
+        if (timestamp >= timestamp_ms)
+            return NO_ERROR;
+        *reader = next;
+    }
+}
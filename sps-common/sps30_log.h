@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SPS30_LOG_H
+#define SPS30_LOG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>  // size_t
+
+#include "sensirion_arch_config.h"
+#include "sps30.h"
+
+/*
+ * Compact append-only binary log of measurements
+ *
+ * File layout (all integers little endian):
+ *
+ *   header     SPS30_LOG_HEADER_SIZE bytes: magic, version, sampling period,
+ *              quantization, serial number and firmware version
+ *   blocks     SPS30_LOG_BLOCK_SIZE bytes each
+ *
+ * Each block starts with the timestamp and quantized values of its first
+ * sample, followed by records holding the difference to the previous sample.
+ * A record is a tag byte, the timestamp difference if it deviates from the
+ * sampling period, and the ten value differences packed as zero, 4 bit, 8 bit
+ * or varint, whichever is smallest. A tag of SPS30_LOG_END_OF_BLOCK ends a
+ * block early.
+ *
+ * With a slowly changing signal a record takes 1 to 6 bytes. As blocks have a
+ * fixed size, a reader finds the block of a timestamp by binary search and
+ * never has to decode more than one block to seek.
+ *
+ * The encoder and decoder work on a write callback and on memory respectively
+ * and do not depend on a file system; map the file (e.g. with mmap()) to read
+ * it.
+ */
+
+#define SPS30_LOG_VERSION 1
+#define SPS30_LOG_HEADER_SIZE 64
+#define SPS30_LOG_BLOCK_SIZE 4096
+#define SPS30_LOG_BLOCK_HEADER_SIZE 52
+#define SPS30_LOG_END_OF_BLOCK 0xff
+#define SPS30_LOG_NUM_FIELDS 10
+
+/** Default resolution of the mass concentrations: 0.1µg/m³ */
+#define SPS30_LOG_DEFAULT_RESOLUTION_MC 100000
+/** Default resolution of the number concentrations: 0.1#/cm³ */
+#define SPS30_LOG_DEFAULT_RESOLUTION_NC 100000
+/** Default resolution of the typical particle size: 0.001µm */
+#define SPS30_LOG_DEFAULT_RESOLUTION_SIZE 1000
+
+/**
+ * struct sps30_log_info - log header
+ *
+ * @serial:             Serial number as read by sps30_get_serial()
+ * @firmware_major:     Firmware version as read by
+ * @firmware_minor:     sps30_read_firmware_version()
+ * @period_ms:          Nominal sampling period in milliseconds
+ * @resolution_mc:      Quantization of the mass concentrations, in 10^-6
+ *                      µg/m³
+ * @resolution_nc:      Quantization of the number concentrations, in 10^-6
+ *                      #/cm³
+ * @resolution_size:    Quantization of the typical particle size, in 10^-6 µm
+ */
+struct sps30_log_info {
+    char serial[SPS30_MAX_SERIAL_LEN];
+    uint8_t firmware_major;
+    uint8_t firmware_minor;
+    uint32_t period_ms;
+    uint32_t resolution_mc;
+    uint32_t resolution_nc;
+    uint32_t resolution_size;
+};
+
+/**
+ * sps30_log_write_fn - append data to the log
+ *
+ * Return:  0 on success, an error code otherwise
+ */
+typedef int16_t (*sps30_log_write_fn)(void* context, const uint8_t* data,
+                                      uint16_t length);
+
+/**
+ * struct sps30_log_writer - encoder state, the members are private
+ */
+struct sps30_log_writer {
+    sps30_log_write_fn write;
+    void* context;
+    float scale[SPS30_LOG_NUM_FIELDS];
+    int32_t values[SPS30_LOG_NUM_FIELDS];
+    uint64_t timestamp;
+    uint32_t period_ms;
+    uint16_t block_used;
+};
+
+/**
+ * struct sps30_log_reader - decoder state, the members are private except for
+ * @info
+ */
+struct sps30_log_reader {
+    struct sps30_log_info info;
+    const uint8_t* data;
+    size_t size;
+    size_t num_blocks;
+    size_t block;
+    size_t offset;
+    float resolution[SPS30_LOG_NUM_FIELDS];
+    int32_t values[SPS30_LOG_NUM_FIELDS];
+    uint64_t timestamp;
+};
+
+/**
+ * sps30_log_info_init() - initialize a log header with default quantization
+ *
+ * The serial number and firmware version are left empty.
+ *
+ * @info:       Log header
+ * @period_ms:  Nominal sampling period in milliseconds
+ */
+void sps30_log_info_init(struct sps30_log_info* info, uint32_t period_ms);
+
+/**
+ * sps30_log_writer_init() - start a new log and write its header
+ *
+ * @writer:     Encoder state
+ * @info:       Log header
+ * @write:      Callback appending to the log
+ * @context:    Passed to @write
+ * Return:      0 on success, STATUS_FAIL if a resolution is 0 or the error of
+ *              @write
+ */
+int16_t sps30_log_writer_init(struct sps30_log_writer* writer,
+                              const struct sps30_log_info* info,
+                              sps30_log_write_fn write, void* context);
+
+/**
+ * sps30_log_writer_resume() - continue an existing log
+ *
+ * Pads the last block and continues with a new one. @info must match the
+ * header of the existing log.
+ *
+ * @writer:     Encoder state
+ * @info:       Log header
+ * @write:      Callback appending to the log
+ * @context:    Passed to @write
+ * @size:       Current size of the log in bytes
+ * Return:      0 on success, STATUS_FAIL if @size is smaller than the header
+ *              or a resolution is 0, or the error of @write
+ */
+int16_t sps30_log_writer_resume(struct sps30_log_writer* writer,
+                                const struct sps30_log_info* info,
+                                sps30_log_write_fn write, void* context,
+                                size_t size);
+
+/**
+ * sps30_log_append() - append a measurement
+ *
+ * @writer:         Encoder state
+ * @timestamp_ms:   Time of the measurement in milliseconds, e.g. since the
+ *                  UNIX epoch. Must not decrease.
+ * @measurement:    Measurement as read by sps30_read_measurement()
+ * Return:          0 on success, the error of the write callback otherwise
+ */
+int16_t sps30_log_append(struct sps30_log_writer* writer, uint64_t timestamp_ms,
+                         const struct sps30_measurement* measurement);
+
+/**
+ * sps30_log_reader_init() - open a log in memory
+ *
+ * A truncated last block, e.g. of a log which is still being written, is read
+ * up to its last complete record.
+ *
+ * @reader: Decoder state
+ * @data:   The log
+ * @size:   Size of the log in bytes
+ * Return:  0 on success, SPS30_ERR_FORMAT if the header is invalid
+ */
+int16_t sps30_log_reader_init(struct sps30_log_reader* reader,
+                              const uint8_t* data, size_t size);
+
+/**
+ * sps30_log_read_raw() - read the next sample as quantized values
+ *
+ * The values are in the order of the fields of struct sps30_measurement and
+ * in units of the respective resolution of the log header.
+ *
+ * Return:  0 on success, STATUS_FAIL at the end of the log
+ */
+int16_t sps30_log_read_raw(struct sps30_log_reader* reader,
+                           uint64_t* timestamp_ms, int32_t* values);
+
+/**
+ * sps30_log_read_raw_many() - read up to @max_samples samples as quantized
+ * values
+ *
+ * Same as calling sps30_log_read_raw() repeatedly, but decodes a block at a
+ * time and unpacks the value differences without branches (with SSE2 unless
+ * SPS30_LOG_NO_SIMD is defined), for scanning large logs.
+ *
+ * @timestamps_ms:  Memory for @max_samples timestamps
+ * @values:         Memory for @max_samples * SPS30_LOG_NUM_FIELDS values, one
+ *                  sample after the other
+ * @max_samples:    Maximum number of samples to read
+ *
+ * Return:  Number of samples read, less than @max_samples only at the end of
+ *          the log
+ */
+size_t sps30_log_read_raw_many(struct sps30_log_reader* reader,
+                               uint64_t* timestamps_ms, int32_t* values,
+                               size_t max_samples);
+
+/**
+ * sps30_log_read() - read the next sample
+ *
+ * Return:  0 on success, STATUS_FAIL at the end of the log
+ */
+int16_t sps30_log_read(struct sps30_log_reader* reader, uint64_t* timestamp_ms,
+                       struct sps30_measurement* measurement);
+
+/**
+ * sps30_log_seek() - position the reader at the first sample at or after
+ * @timestamp_ms
+ *
+ * Return:  0 on success, STATUS_FAIL if there is no such sample
+ */
+int16_t sps30_log_seek(struct sps30_log_reader* reader, uint64_t timestamp_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPS30_LOG_H */
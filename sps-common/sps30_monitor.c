@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sensirion_arch_config.h"
+#include "sensirion_common.h"
+#include "sps30_monitor.h"
+
+#ifndef SPS30_NO_STATUS_REGISTER
+
+uint8_t sps30_monitor_decode(uint32_t device_status_flags) {
+    uint8_t faults = 0;
+
+    if (device_status_flags & SPS30_DEVICE_STATUS_FAN_SPEED_WARNING)
+        faults |= SPS30_MONITOR_FAULT_FAN_SPEED;
+    if (device_status_flags & SPS30_DEVICE_STATUS_LASER_ERROR_MASK)
+        faults |= SPS30_MONITOR_FAULT_LASER;
+    if (device_status_flags & SPS30_DEVICE_STATUS_FAN_ERROR_MASK)
+        faults |= SPS30_MONITOR_FAULT_FAN;
+    return faults;
+}
+
+void sps30_monitor_init(struct sps30_monitor* monitor, struct sps30_dev* dev,
+                        uint32_t interval_us, sps30_monitor_callback callback,
+                        void* context) {
+    monitor->checks = 0;
+    monitor->errors = 0;
+    monitor->faults = 0;
+    monitor->dev = dev;
+    monitor->callback = callback;
+    monitor->context = context;
+    monitor->interval_us = interval_us;
+    monitor->next_check_us = 0;
+    monitor->scheduled = 0;
+    monitor->pending = 0;
+}
+
+int16_t sps30_monitor_before_read(struct sps30_monitor* monitor,
+                                  uint32_t now_us) {
+    uint32_t device_status_flags;
+    uint8_t changed;
+    int16_t ret;
+
+    if (!monitor->pending)
+        return NO_ERROR;
+
+    monitor->pending = 0;
+    ret = sps30_dev_complete_read_device_status_register(monitor->dev, now_us,
+                                                         &device_status_flags);
+    if (ret != NO_ERROR) {
+        /* the next command overwrites it, check again after the next read */
+        monitor->errors++;
+        monitor->scheduled = 0;
+        return ret;
+    }
+
+    monitor->checks++;
+    changed = monitor->faults ^ sps30_monitor_decode(device_status_flags);
+    monitor->faults ^= changed;
+    if (changed && monitor->callback)
+        monitor->callback(monitor->context, monitor->faults, changed,
+                          device_status_flags);
+    return NO_ERROR;
+}
+
+int16_t sps30_monitor_after_read(struct sps30_monitor* monitor,
+                                 uint32_t now_us) {
+    int16_t ret;
+
+    if (monitor->pending ||
+        (monitor->scheduled &&
+         (int32_t)(now_us - monitor->next_check_us) < 0))
+        return NO_ERROR;
+
+    ret = sps30_dev_issue_read_device_status_register(monitor->dev, now_us);
+    if (ret == SPS30_ERR_NOT_READY)
+        return NO_ERROR; /* busy with a command of the caller, try next time */
+    if (ret != NO_ERROR) {
+        monitor->errors++;
+        return ret;
+    }
+
+    monitor->pending = 1;
+    monitor->scheduled = 1;
+    monitor->next_check_us = now_us + monitor->interval_us;
+    return NO_ERROR;
+}
+
+#endif /* SPS30_NO_STATUS_REGISTER */
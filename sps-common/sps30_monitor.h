@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SPS30_MONITOR_H
+#define SPS30_MONITOR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "sensirion_arch_config.h"
+#include "sps30.h"
+
+#ifndef SPS30_NO_STATUS_REGISTER
+
+/*
+ * Device status monitoring
+ *
+ * Reading the device status register takes a command, 5ms of processing time
+ * and a read. The monitor splits it across two consecutive measurement reads
+ * so that it never sleeps: after a read, when a check is due, the command is
+ * issued; before the next read, the status is fetched. The time in between,
+ * usually a measurement interval, covers the processing time.
+ *
+ * The warning and error bits are decoded into SPS30_MONITOR_FAULT_* flags and
+ * the callback is called only when they change. The sensor is assumed to be
+ * free of faults before the first check.
+ *
+ * Times are in microseconds on any free running 32 bit clock, e.g. the one
+ * passed to the non-blocking sps30_dev_issue_*() functions.
+ */
+
+/** The fan speed is out of range (warning) */
+#define SPS30_MONITOR_FAULT_FAN_SPEED 0x01
+/** The laser current is out of range */
+#define SPS30_MONITOR_FAULT_LASER 0x02
+/** The fan is switched on but not running */
+#define SPS30_MONITOR_FAULT_FAN 0x04
+
+/**
+ * sps30_monitor_callback - called when the faults of the sensor change
+ *
+ * @context:                As passed to sps30_monitor_init()
+ * @faults:                 SPS30_MONITOR_FAULT_* flags now set
+ * @changed:                SPS30_MONITOR_FAULT_* flags which changed
+ * @device_status_flags:    Raw device status register
+ */
+typedef void (*sps30_monitor_callback)(void* context, uint8_t faults,
+                                       uint8_t changed,
+                                       uint32_t device_status_flags);
+
+/**
+ * struct sps30_monitor - monitor state
+ *
+ * Besides the fields below, which may be read, the members are private.
+ *
+ * @checks:     Number of completed checks
+ * @errors:     Number of checks which failed or were abandoned
+ * @faults:     SPS30_MONITOR_FAULT_* flags of the last check
+ */
+struct sps30_monitor {
+    uint32_t checks;
+    uint32_t errors;
+    uint8_t faults;
+
+    struct sps30_dev* dev;
+    sps30_monitor_callback callback;
+    void* context;
+    uint32_t interval_us;
+    uint32_t next_check_us;
+    uint8_t scheduled;
+    uint8_t pending;
+};
+
+/**
+ * sps30_monitor_decode() - decode the device status register
+ *
+ * Return:  SPS30_MONITOR_FAULT_* flags
+ */
+uint8_t sps30_monitor_decode(uint32_t device_status_flags);
+
+/**
+ * sps30_monitor_init() - set up status monitoring of a sensor
+ *
+ * The first check is issued after the first measurement read.
+ *
+ * @monitor:        Monitor to initialize
+ * @dev:            Sensor handle
+ * @interval_us:    Time between checks, rounded up to the next measurement
+ *                  read; at most 2^31 microseconds
+ * @callback:       Called on changes, may be NULL
+ * @context:        Passed to @callback
+ */
+void sps30_monitor_init(struct sps30_monitor* monitor, struct sps30_dev* dev,
+                        uint32_t interval_us, sps30_monitor_callback callback,
+                        void* context);
+
+/**
+ * sps30_monitor_before_read() - fetch the status of a pending check
+ *
+ * Must be called before any command is sent to the sensor after
+ * sps30_monitor_after_read(), i.e. before the next data-ready or measurement
+ * read. Without a pending check, this does not touch the bus. A check which is
+ * not ready yet is abandoned and issued again after the next read.
+ *
+ * @monitor:    Monitor
+ * @now_us:     Current time
+ * Return:      0 if there was nothing to do or the check completed, an error
+ *              code otherwise
+ */
+int16_t sps30_monitor_before_read(struct sps30_monitor* monitor,
+                                  uint32_t now_us);
+
+/**
+ * sps30_monitor_after_read() - issue a check if one is due
+ *
+ * To be called after a measurement was read. The status command is sent
+ * without waiting for its processing time.
+ *
+ * @monitor:    Monitor
+ * @now_us:     Current time
+ * Return:      0 if no check was due or the check was issued, an error code
+ *              otherwise
+ */
+int16_t sps30_monitor_after_read(struct sps30_monitor* monitor,
+                                 uint32_t now_us);
+
+#endif /* SPS30_NO_STATUS_REGISTER */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPS30_MONITOR_H */
@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sensirion_arch_config.h"
+#include "sensirion_common.h"
+#include "sps30_phase.h"
+
+static uint32_t sps30_phase_clamp_guard(uint32_t guard_us) {
+    if (guard_us < SPS30_PHASE_MIN_GUARD_US)
+        return SPS30_PHASE_MIN_GUARD_US;
+    if (guard_us > SPS30_PHASE_MAX_GUARD_US)
+        return SPS30_PHASE_MAX_GUARD_US;
+    return guard_us;
+}
+
+/**
+ * sps30_phase_observe() - account for a transition bracketed by two polls
+ *
+ * @edge_us:    Midpoint of the bracket
+ * @width_us:   Width of the bracket
+ */
+static void sps30_phase_observe(struct sps30_phase* phase, uint32_t edge_us,
+                                uint32_t width_us) {
+    uint32_t cycles;
+    uint32_t expected_us;
+    uint32_t error_us;
+    uint32_t period_us;
+
+    if (!phase->locked) {
+        phase->locked = 1;
+        phase->edge_us = edge_us;
+        phase->anchor_us = edge_us;
+        phase->anchor_cycles = 0;
+        phase->anchor_width_us = width_us;
+        phase->guard_us = sps30_phase_clamp_guard(width_us);
+        return;
+    }
+
+    if ((int32_t)(edge_us - phase->edge_us) < (int32_t)phase->period_us / 2)
+        return; /* not a new transition */
+
+    cycles = (edge_us - phase->edge_us + phase->period_us / 2) /
+             phase->period_us;
+
+    expected_us = phase->edge_us + cycles * phase->period_us;
+    error_us = (int32_t)(edge_us - expected_us) < 0 ? expected_us - edge_us
+                                                     : edge_us - expected_us;
+    phase->edge_us = edge_us;
+    phase->anchor_cycles = (uint16_t)(phase->anchor_cycles + cycles);
+
+    if (width_us < phase->anchor_width_us / 4) {
+        /* the bracket is much narrower than the one the baseline started at */
+        phase->anchor_us = edge_us;
+        phase->anchor_cycles = 0;
+        phase->anchor_width_us = width_us;
+    }
+
+    if (phase->anchor_cycles >= SPS30_PHASE_MIN_BASELINE) {
+        period_us = (edge_us - phase->anchor_us) / phase->anchor_cycles;
+        if (period_us + SPS30_PHASE_MAX_PERIOD_DEVIATION_US >=
+                SPS30_PHASE_NOMINAL_PERIOD_US &&
+            period_us <= SPS30_PHASE_NOMINAL_PERIOD_US +
+                             SPS30_PHASE_MAX_PERIOD_DEVIATION_US)
+            phase->period_us = period_us;
+    }
+    if (phase->anchor_cycles >= SPS30_PHASE_MAX_BASELINE) {
+        /* keep half of the baseline */
+        phase->anchor_us += SPS30_PHASE_MAX_BASELINE / 2 * phase->period_us;
+        phase->anchor_cycles -= SPS30_PHASE_MAX_BASELINE / 2;
+    }
+
+    /*
+     * An error within the bracket is the resolution of the polls, then the
+     * guard time can shrink. Otherwise it follows the error.
+     */
+    if (error_us <= width_us / 2)
+        error_us = phase->guard_us / 4;
+    phase->guard_us =
+        sps30_phase_clamp_guard((phase->guard_us + 2 * error_us) / 2);
+}
+
+/**
+ * sps30_phase_skip() - account for a transition which was not bracketed
+ *
+ * The transition happened somewhere before @now_us, so the phase is kept and
+ * only the guard time is increased.
+ */
+static void sps30_phase_skip(struct sps30_phase* phase, uint32_t now_us) {
+    uint32_t cycles = (now_us - phase->edge_us) / phase->period_us;
+
+    phase->missed++;
+    phase->guard_us = sps30_phase_clamp_guard(2 * phase->guard_us);
+    if (cycles == 0) {
+        /* earlier than predicted */
+        phase->edge_us = now_us;
+        cycles = 1;
+    } else {
+        phase->edge_us += cycles * phase->period_us;
+    }
+    phase->anchor_cycles = (uint16_t)(phase->anchor_cycles + cycles);
+}
+
+void sps30_phase_init(struct sps30_phase* phase, uint32_t now_us) {
+    phase->period_us = SPS30_PHASE_NOMINAL_PERIOD_US;
+    phase->guard_us = SPS30_PHASE_MAX_GUARD_US;
+    phase->polls = 0;
+    phase->not_ready_polls = 0;
+    phase->missed = 0;
+    phase->next_poll_us = now_us;
+    phase->edge_us = now_us;
+    phase->not_ready_us = now_us;
+    phase->anchor_us = now_us;
+    phase->anchor_cycles = 0;
+    phase->anchor_width_us = 0;
+    phase->retry_us = 0;
+    phase->locked = 0;
+    phase->have_not_ready = 0;
+}
+
+void sps30_phase_init_from_start(struct sps30_phase* phase, uint32_t now_us,
+                                 uint32_t start_us) {
+    uint32_t cycles;
+
+    sps30_phase_init(phase, now_us);
+    phase->locked = 1;
+    phase->guard_us = SPS30_PHASE_START_GUARD_US;
+    /* the start is no transition, re-anchor at the first bracket */
+    phase->anchor_us = start_us;
+    phase->anchor_width_us = 4 * SPS30_PHASE_MAX_GUARD_US;
+
+    cycles = (now_us - start_us + phase->guard_us) / phase->period_us;
+    phase->edge_us = start_us + cycles * phase->period_us;
+    phase->next_poll_us = phase->edge_us + phase->period_us - phase->guard_us;
+}
+
+uint32_t sps30_phase_next_poll_us(const struct sps30_phase* phase) {
+    return phase->next_poll_us;
+}
+
+void sps30_phase_update(struct sps30_phase* phase, uint32_t now_us,
+                        uint16_t data_ready) {
+    phase->polls++;
+
+    if (!data_ready) {
+        phase->not_ready_polls++;
+        phase->not_ready_us = now_us;
+        phase->have_not_ready = 1;
+        phase->next_poll_us =
+            now_us +
+            (phase->locked ? phase->guard_us : SPS30_PHASE_SEARCH_STEP_US);
+        return;
+    }
+
+    if (phase->have_not_ready) {
+        sps30_phase_observe(
+            phase,
+            phase->not_ready_us + (now_us - phase->not_ready_us) / 2,
+            now_us - phase->not_ready_us);
+    } else if (phase->locked) {
+        sps30_phase_skip(phase, now_us);
+    }
+    phase->have_not_ready = 0;
+
+    if (!phase->locked) {
+        /* data from before the first poll, no phase information */
+        phase->next_poll_us = now_us + SPS30_PHASE_SEARCH_STEP_US;
+        return;
+    }
+
+    phase->next_poll_us = phase->edge_us + phase->period_us - phase->guard_us;
+    if ((int32_t)(phase->next_poll_us - now_us) < 0)
+        phase->next_poll_us = now_us;
+}
+
+#ifndef SPS30_NO_FLOAT
+
+int16_t sps30_phase_poll(struct sps30_phase* phase, struct sps30_dev* dev,
+                         uint32_t now_us,
+                         struct sps30_measurement* measurement) {
+    uint16_t data_ready;
+    int16_t ret;
+
+    ret = sps30_dev_read_data_ready(dev, &data_ready);
+    if (ret != NO_ERROR) {
+        /* back off while the sensor stays unreachable */
+        if (!phase->retry_us)
+            phase->retry_us = SPS30_PHASE_MIN_GUARD_US;
+        else if (phase->retry_us < phase->period_us / 2)
+            phase->retry_us *= 2;
+        else
+            phase->retry_us = phase->period_us;
+        phase->next_poll_us = now_us + phase->retry_us;
+        return ret;
+    }
+    phase->retry_us = 0;
+
+    sps30_phase_update(phase, now_us, data_ready);
+    if (!data_ready)
+        return SPS30_ERR_NOT_READY;
+
+    return sps30_dev_read_measurement(dev, measurement);
+}
+
+#endif /* SPS30_NO_FLOAT */
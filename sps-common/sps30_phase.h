@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SPS30_PHASE_H
+#define SPS30_PHASE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "sensirion_arch_config.h"
+#include "sps30.h"
+
+/*
+ * Data-ready driven polling
+ *
+ * The sensor produces a new measurement about once per second on its own
+ * clock, which is neither aligned with nor exactly as fast as the host's.
+ * Reading on a fixed host timer therefore either returns stale data or adds up
+ * to a second of latency. The phase tracker learns when the sensor's data-ready
+ * flag goes up and schedules the next poll shortly before the next expected
+ * transition:
+ *
+ *  - Until the first transition is seen, the flag is polled every
+ *    SPS30_PHASE_SEARCH_STEP_US.
+ *  - A not-ready poll followed by a ready poll brackets a transition. Its
+ *    midpoint is taken as the sensor's phase.
+ *  - The period is measured over up to SPS30_PHASE_MAX_BASELINE transitions,
+ *    which compensates the drift between the two clocks.
+ *  - The guard time, by which the first poll precedes the expected transition
+ *    and with which it is repeated until the flag is up, follows the
+ *    prediction error. It bounds the latency to fresh data; in steady state a
+ *    sample costs one not-ready and one ready poll.
+ *
+ * All times are in microseconds on any free running 32 bit clock, e.g. the one
+ * passed to the non-blocking sps30_dev_issue_*() functions.
+ */
+
+#define SPS30_PHASE_NOMINAL_PERIOD_US 1000000
+/* accepted deviation of the measured from the nominal period */
+#define SPS30_PHASE_MAX_PERIOD_DEVIATION_US 20000
+#define SPS30_PHASE_SEARCH_STEP_US 100000
+#define SPS30_PHASE_MIN_GUARD_US 2000
+#define SPS30_PHASE_MAX_GUARD_US 100000
+#define SPS30_PHASE_START_GUARD_US 50000
+#define SPS30_PHASE_MIN_BASELINE 4
+#define SPS30_PHASE_MAX_BASELINE 256
+
+/**
+ * struct sps30_phase - tracker state
+ *
+ * Besides the fields below, which may be read, the members are private.
+ *
+ * @period_us:          Learned period of the sensor's measurements
+ * @guard_us:           Current guard time
+ * @polls:              Number of data-ready polls
+ * @not_ready_polls:    Number of polls which found no new data
+ * @missed:             Number of transitions which were not bracketed, i.e.
+ *                      the data was already ready at the first poll
+ */
+struct sps30_phase {
+    uint32_t period_us;
+    uint32_t guard_us;
+    uint32_t polls;
+    uint32_t not_ready_polls;
+    uint32_t missed;
+    uint32_t next_poll_us;
+    uint32_t edge_us;
+    uint32_t not_ready_us;
+    uint32_t anchor_us;
+    uint32_t anchor_width_us;
+    uint32_t retry_us;
+    uint16_t anchor_cycles;
+    uint8_t locked;
+    uint8_t have_not_ready;
+};
+
+/**
+ * sps30_phase_init() - start learning the phase of a sensor
+ *
+ * Call after starting the measurement.
+ *
+ * @phase:  Tracker to initialize
+ * @now_us: Current time
+ */
+void sps30_phase_init(struct sps30_phase* phase, uint32_t now_us);
+
+/**
+ * sps30_phase_init_from_start() - start tracking with the phase known from the
+ * start measurement command
+ *
+ * The sensor produces its first sample about one period after it was started,
+ * so the phase is known up to the drift accumulated since. Polling begins
+ * SPS30_PHASE_START_GUARD_US before the first expected transition after
+ * @now_us, without the search of sps30_phase_init().
+ *
+ * @phase:      Tracker to initialize
+ * @now_us:     Current time
+ * @start_us:   Time at which the measurement was started
+ */
+void sps30_phase_init_from_start(struct sps30_phase* phase, uint32_t now_us,
+                                 uint32_t start_us);
+
+/**
+ * sps30_phase_next_poll_us() - time at which the data-ready flag should be
+ * polled next
+ *
+ * The returned time may be in the past, in which case the flag should be
+ * polled right away.
+ */
+uint32_t sps30_phase_next_poll_us(const struct sps30_phase* phase);
+
+/**
+ * sps30_phase_update() - feed the result of a data-ready poll
+ *
+ * For callers doing the bus access themselves, e.g. with
+ * sps30_dev_read_data_ready(). The measurement must be read whenever
+ * @data_ready is set, since reading it clears the flag.
+ *
+ * @phase:      Tracker
+ * @now_us:     Time of the poll
+ * @data_ready: Data-ready flag as read from the sensor
+ */
+void sps30_phase_update(struct sps30_phase* phase, uint32_t now_us,
+                        uint16_t data_ready);
+
+#ifndef SPS30_NO_FLOAT
+
+/**
+ * sps30_phase_poll() - poll the data-ready flag and read new data
+ *
+ * Meant to be called at sps30_phase_next_poll_us(). After a failed data-ready
+ * poll the next one is due after SPS30_PHASE_MIN_GUARD_US, doubling with every
+ * further failure up to the measurement period. Not available with
+ * SPS30_NO_FLOAT, use sps30_phase_update() and
+ * sps30_dev_read_measurement_u16() instead.
+ *
+ * @phase:          Tracker
+ * @dev:            Sensor, measuring in the float format
+ * @now_us:         Current time
+ * @measurement:    Memory where the new measurement is stored
+ * Return:          0 if a new measurement was read, SPS30_ERR_NOT_READY if
+ *                  there is no new data yet, an error code otherwise
+ */
+int16_t sps30_phase_poll(struct sps30_phase* phase, struct sps30_dev* dev,
+                         uint32_t now_us,
+                         struct sps30_measurement* measurement);
+
+#endif /* SPS30_NO_FLOAT */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPS30_PHASE_H */
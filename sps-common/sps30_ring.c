@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <string.h>  // memmove
+
+#include "sensirion_arch_config.h"
+#include "sensirion_common.h"
+#include "sps30_ring.h"
+
+int16_t sps30_ring_init(struct sps30_ring* ring, struct sps30_record* records,
+                        uint32_t capacity, uint8_t policy) {
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0)
+        return STATUS_FAIL;
+
+    ring->records = records;
+    ring->mask = capacity - 1;
+    ring->policy = policy;
+    ring->head = 0;
+    ring->producer_dropped = 0;
+    ring->tail = 0;
+    ring->consumer_dropped = 0;
+    return NO_ERROR;
+}
+
+int16_t sps30_ring_push(struct sps30_ring* ring, uint32_t timestamp,
+                        const struct sps30_measurement* measurement) {
+    const uint32_t head = ring->head;
+    struct sps30_record* record;
+
+    if (ring->policy == SPS30_RING_DROP_NEWEST &&
+        head - ring->tail > ring->mask) {
+        ring->producer_dropped++;
+        return STATUS_FAIL;
+    }
+    /* the consumer must be done with the slot before it is rewritten */
+    SPS30_RING_BARRIER();
+
+    record = &ring->records[head & ring->mask];
+    record->timestamp = timestamp;
+    record->sequence = head + ring->producer_dropped;
+    record->measurement = *measurement;
+
+    /* publish the record before the new head */
+    SPS30_RING_BARRIER();
+    ring->head = head + 1;
+    return NO_ERROR;
+}
+
+int16_t sps30_ring_pop(struct sps30_ring* ring, struct sps30_record* record) {
+    return sps30_ring_pop_bulk(ring, record, 1) ? NO_ERROR : STATUS_FAIL;
+}
+
+uint32_t sps30_ring_pop_bulk(struct sps30_ring* ring,
+                             struct sps30_record* records,
+                             uint32_t max_records) {
+    const uint32_t capacity = ring->mask + 1;
+    uint32_t tail = ring->tail;
+    uint32_t head;
+    uint32_t lost;
+    uint32_t n;
+    uint32_t i;
+
+    for (;;) {
+        head = ring->head;
+        SPS30_RING_BARRIER();
+
+        /* With SPS30_RING_DROP_OLDEST the producer may overtake the consumer.
+         * A slot is only safe to read as long as the producer has not reached
+         * the record which reuses it, i.e. head < index + capacity. */
+        if (ring->policy == SPS30_RING_DROP_OLDEST &&
+            head - tail >= capacity) {
+            lost = head - tail - capacity + 1;
+            ring->consumer_dropped += lost;
+            tail += lost;
+        }
+
+        n = head - tail;
+        if (n > max_records)
+            n = max_records;
+
+        for (i = 0; i < n; ++i)
+            records[i] = ring->records[(tail + i) & ring->mask];
+
+        if (ring->policy != SPS30_RING_DROP_OLDEST)
+            break;
+
+        /* discard the records which were overwritten while copying */
+        SPS30_RING_BARRIER();
+        head = ring->head;
+        if (head - tail < capacity)
+            break;
+
+        lost = head - tail - capacity + 1;
+        ring->consumer_dropped += lost;
+        tail += lost;
+        if (lost < n) {
+            n -= lost;
+            memmove(records, &records[lost], n * sizeof(*records));
+            break;
+        }
+    }
+
+    /* the copies must be complete before the slots are released */
+    SPS30_RING_BARRIER();
+    ring->tail = tail + n;
+    return n;
+}
+
+uint32_t sps30_ring_count(const struct sps30_ring* ring) {
+    const uint32_t count = ring->head - ring->tail;
+
+    return count > ring->mask ? ring->mask + 1 : count;
+}
+
+uint32_t sps30_ring_dropped(const struct sps30_ring* ring) {
+    return ring->producer_dropped + ring->consumer_dropped;
+}
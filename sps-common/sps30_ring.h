@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SPS30_RING_H
+#define SPS30_RING_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "sensirion_arch_config.h"
+#include "sps30.h"
+
+/*
+ * Lock-free single-producer/single-consumer ring of timestamped measurements
+ *
+ * One context (e.g. a polling thread or timer ISR) pushes records, another
+ * context drains them, without locks or dynamic allocation. The storage is
+ * provided by the caller and its capacity must be a power of two.
+ *
+ * When the ring is full, either the new record is discarded
+ * (SPS30_RING_DROP_NEWEST) or the oldest records are overwritten
+ * (SPS30_RING_DROP_OLDEST). In both cases the lost records are counted and the
+ * consumer can spot gaps in the sequence numbers.
+ *
+ * The indices are 32 bit wide and must be read and written atomically, which
+ * holds on 32 bit and 64 bit platforms. SPS30_RING_BARRIER() must order memory
+ * accesses between producer and consumer; on a single core MCU a compiler
+ * barrier is sufficient.
+ */
+
+#ifndef SPS30_RING_BARRIER
+#if defined(__GNUC__) || defined(__clang__)
+#define SPS30_RING_BARRIER() __sync_synchronize()
+#else
+#error "Define SPS30_RING_BARRIER() for your compiler"
+#endif
+#endif
+
+/** Discard new records while the ring is full */
+#define SPS30_RING_DROP_NEWEST 0
+/** Overwrite the oldest records while the ring is full */
+#define SPS30_RING_DROP_OLDEST 1
+
+/**
+ * struct sps30_record - a measurement as stored in the ring
+ *
+ * @timestamp:      Time of the measurement, in units chosen by the producer
+ * @sequence:       Sequence number assigned on push, counting up by one for
+ *                  every pushed record including dropped ones
+ * @measurement:    The measurement
+ */
+struct sps30_record {
+    uint32_t timestamp;
+    uint32_t sequence;
+    struct sps30_measurement measurement;
+};
+
+/**
+ * struct sps30_ring - ring state, the members are private
+ */
+struct sps30_ring {
+    struct sps30_record* records;
+    uint32_t mask;
+    uint8_t policy;
+    /* written by the producer only */
+    volatile uint32_t head;
+    volatile uint32_t producer_dropped;
+    /* written by the consumer only */
+    volatile uint32_t tail;
+    volatile uint32_t consumer_dropped;
+};
+
+/**
+ * sps30_ring_init() - initialize an empty ring
+ *
+ * @ring:       Ring to initialize
+ * @records:    Storage for @capacity records
+ * @capacity:   Number of records, must be a power of two
+ * @policy:     SPS30_RING_DROP_NEWEST or SPS30_RING_DROP_OLDEST
+ * Return:      0 on success, STATUS_FAIL if the capacity is not a power of two
+ */
+int16_t sps30_ring_init(struct sps30_ring* ring, struct sps30_record* records,
+                        uint32_t capacity, uint8_t policy);
+
+/**
+ * sps30_ring_push() - add a measurement (producer)
+ *
+ * @ring:           Ring
+ * @timestamp:      Timestamp stored with the measurement
+ * @measurement:    Measurement to store
+ * Return:          0 if the record was stored, STATUS_FAIL if it was dropped
+ *                  because the ring is full (SPS30_RING_DROP_NEWEST only)
+ */
+int16_t sps30_ring_push(struct sps30_ring* ring, uint32_t timestamp,
+                        const struct sps30_measurement* measurement);
+
+/**
+ * sps30_ring_pop() - remove the oldest record (consumer)
+ *
+ * Return:  0 if a record was stored into @record, STATUS_FAIL if the ring is
+ *          empty
+ */
+int16_t sps30_ring_pop(struct sps30_ring* ring, struct sps30_record* record);
+
+/**
+ * sps30_ring_pop_bulk() - remove up to @max_records of the oldest records
+ * (consumer)
+ *
+ * Return:  Number of records stored into @records
+ */
+uint32_t sps30_ring_pop_bulk(struct sps30_ring* ring,
+                             struct sps30_record* records,
+                             uint32_t max_records);
+
+/**
+ * sps30_ring_count() - number of records available to the consumer
+ *
+ * With SPS30_RING_DROP_OLDEST the result may include records which are
+ * overwritten before they are popped.
+ */
+uint32_t sps30_ring_count(const struct sps30_ring* ring);
+
+/**
+ * sps30_ring_dropped() - number of records lost due to overflow
+ */
+uint32_t sps30_ring_dropped(const struct sps30_ring* ring);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPS30_RING_H */
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sensirion_arch_config.h"
+#include "sensirion_common.h"
+#include "sps30_sched.h"
+
+/**
+ * sps30_sched_key() - sort key: bus, multiplexer, channel, address
+ */
+static uint32_t sps30_sched_key(const struct sps30_dev* dev) {
+    uint32_t key = (uint32_t)dev->bus << 24 | dev->address;
+
+#ifndef SPS30_NO_MUX
+    /* multiplexer addresses are never 0, sensors without one come first */
+    if (dev->mux)
+        key |= (uint32_t)dev->mux->address << 16 |
+               (uint32_t)dev->mux_channel << 8;
+#endif
+    return key;
+}
+
+void sps30_sched_init(struct sps30_sched* sched) {
+    sched->num_devs = 0;
+    sched->runs = 0;
+}
+
+int16_t sps30_sched_add(struct sps30_sched* sched, struct sps30_dev* dev) {
+    const uint32_t key = sps30_sched_key(dev);
+    uint8_t i;
+
+    if (sched->num_devs >= SPS30_SCHED_MAX_SENSORS)
+        return STATUS_FAIL;
+
+    /* insertion sort, stable for sensors with the same key */
+    for (i = sched->num_devs; i > 0; --i) {
+        if (sps30_sched_key(sched->devs[i - 1]) <= key)
+            break;
+        sched->devs[i] = sched->devs[i - 1];
+    }
+    sched->devs[i] = dev;
+    sched->num_devs++;
+    return NO_ERROR;
+}
+
+int16_t sps30_sched_run(struct sps30_sched* sched, sps30_sched_op op,
+                        void* context) {
+    const uint8_t reverse = sched->runs & 1;
+    int16_t result = NO_ERROR;
+    int16_t ret;
+    uint8_t i;
+
+    for (i = 0; i < sched->num_devs; ++i) {
+        ret = op(sched->devs[reverse ? sched->num_devs - 1 - i : i], context);
+        if (ret != NO_ERROR)
+            result = ret;
+    }
+    sched->runs++;
+    return result;
+}
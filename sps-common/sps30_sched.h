@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SPS30_SCHED_H
+#define SPS30_SCHED_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "sensirion_arch_config.h"
+#include "sps30.h"
+
+/*
+ * Multiplexer-aware ordering of the sensors
+ *
+ * Visiting the sensors in the order they were set up switches the multiplexer
+ * on almost every access when the sensors are spread over channels and buses.
+ * The scheduler keeps the sensors sorted by bus, multiplexer and channel and
+ * hands them to an operation one by one, so that each channel is selected once
+ * per run and all commands of a sensor go out under one selection. Runs
+ * alternate in direction: the channel selected at the end of a run is the
+ * first one needed by the next, which saves another switch per run.
+ *
+ * With all sensors on the channels of one multiplexer, a run costs one
+ * multiplexer write per channel minus one. Sensors connected directly to a bus
+ * are visited before those behind multiplexers.
+ */
+
+#ifndef SPS30_SCHED_MAX_SENSORS
+#define SPS30_SCHED_MAX_SENSORS 32
+#endif
+
+/**
+ * sps30_sched_op - operation run on every sensor
+ *
+ * @dev:        Sensor handle
+ * @context:    As passed to sps30_sched_run()
+ * Return:      0 on success, an error code otherwise
+ */
+typedef int16_t (*sps30_sched_op)(struct sps30_dev* dev, void* context);
+
+/**
+ * struct sps30_sched - scheduler state
+ *
+ * Besides the fields below, which may be read, the members are private.
+ *
+ * @num_devs:   Number of sensors
+ * @runs:       Number of completed runs
+ */
+struct sps30_sched {
+    uint8_t num_devs;
+    uint32_t runs;
+
+    struct sps30_dev* devs[SPS30_SCHED_MAX_SENSORS];
+};
+
+/**
+ * sps30_sched_init() - initialize a scheduler without sensors
+ */
+void sps30_sched_init(struct sps30_sched* sched);
+
+/**
+ * sps30_sched_add() - add a sensor
+ *
+ * The bus and multiplexer channel of the handle must be set up before, the
+ * sensor is sorted in by them.
+ *
+ * Return:  0 on success, STATUS_FAIL if there are too many sensors
+ */
+int16_t sps30_sched_add(struct sps30_sched* sched, struct sps30_dev* dev);
+
+/**
+ * sps30_sched_run() - run an operation on every sensor
+ *
+ * @op is called for every sensor, also after it failed on one.
+ *
+ * @sched:      Scheduler
+ * @op:         Operation
+ * @context:    Passed to @op
+ * Return:      0 if @op succeeded on all sensors, the last error otherwise
+ */
+int16_t sps30_sched_run(struct sps30_sched* sched, sps30_sched_op op,
+                        void* context);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPS30_SCHED_H */
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sensirion_arch_config.h"
+#include "sensirion_common.h"
+#include "sps30_window.h"
+
+static void sps30_window_to_fields(const struct sps30_measurement* m,
+                                   float* fields) {
+    fields[0] = m->mc_1p0;
+    fields[1] = m->mc_2p5;
+    fields[2] = m->mc_4p0;
+    fields[3] = m->mc_10p0;
+    fields[4] = m->nc_0p5;
+    fields[5] = m->nc_1p0;
+    fields[6] = m->nc_2p5;
+    fields[7] = m->nc_4p0;
+    fields[8] = m->nc_10p0;
+    fields[9] = m->typical_particle_size;
+}
+
+static void sps30_window_from_fields(const float* fields,
+                                     struct sps30_measurement* m) {
+    m->mc_1p0 = fields[0];
+    m->mc_2p5 = fields[1];
+    m->mc_4p0 = fields[2];
+    m->mc_10p0 = fields[3];
+    m->nc_0p5 = fields[4];
+    m->nc_1p0 = fields[5];
+    m->nc_2p5 = fields[6];
+    m->nc_4p0 = fields[7];
+    m->nc_10p0 = fields[8];
+    m->typical_particle_size = fields[9];
+}
+
+static void sps30_window_clear_bucket(struct sps30_window_bucket* bucket) {
+    bucket->count = 0;
+}
+
+int16_t sps30_window_init(struct sps30_window* window,
+                          struct sps30_window_bucket* buckets,
+                          uint16_t num_buckets, uint32_t bucket_duration) {
+    uint16_t i;
+
+    if (num_buckets == 0 || bucket_duration == 0)
+        return STATUS_FAIL;
+
+    window->buckets = buckets;
+    window->num_buckets = num_buckets;
+    window->current = 0;
+    window->bucket_duration = bucket_duration;
+    window->bucket_start = 0;
+    window->started = 0;
+    for (i = 0; i < num_buckets; ++i)
+        sps30_window_clear_bucket(&buckets[i]);
+    return NO_ERROR;
+}
+
+void sps30_window_expire(struct sps30_window* window, uint32_t timestamp) {
+    uint32_t elapsed;
+    uint32_t steps;
+
+    if (!window->started) {
+        window->bucket_start = timestamp;
+        window->started = 1;
+        return;
+    }
+
+    elapsed = timestamp - window->bucket_start;
+    if (elapsed >= 0x80000000u || elapsed < window->bucket_duration)
+        return; /* timestamp went backwards or still in the current bucket */
+
+    steps = elapsed / window->bucket_duration;
+    window->bucket_start += steps * window->bucket_duration;
+    if (steps > window->num_buckets)
+        steps = window->num_buckets;
+    while (steps--) {
+        if (++window->current == window->num_buckets)
+            window->current = 0;
+        sps30_window_clear_bucket(&window->buckets[window->current]);
+    }
+}
+
+void sps30_window_add(struct sps30_window* window, uint32_t timestamp,
+                      const struct sps30_measurement* measurement) {
+    struct sps30_window_bucket* bucket;
+    float fields[SPS30_WINDOW_NUM_FIELDS];
+    uint8_t i;
+
+    sps30_window_expire(window, timestamp);
+    sps30_window_to_fields(measurement, fields);
+
+    bucket = &window->buckets[window->current];
+    if (bucket->count == 0) {
+        for (i = 0; i < SPS30_WINDOW_NUM_FIELDS; ++i) {
+            bucket->sum[i] = fields[i];
+            bucket->min[i] = fields[i];
+            bucket->max[i] = fields[i];
+        }
+    } else {
+        for (i = 0; i < SPS30_WINDOW_NUM_FIELDS; ++i) {
+            bucket->sum[i] += fields[i];
+            if (fields[i] < bucket->min[i])
+                bucket->min[i] = fields[i];
+            if (fields[i] > bucket->max[i])
+                bucket->max[i] = fields[i];
+        }
+    }
+    bucket->count++;
+}
+
+int16_t sps30_window_get(const struct sps30_window* window,
+                         struct sps30_window_result* result) {
+    const struct sps30_window_bucket* bucket;
+    float sum[SPS30_WINDOW_NUM_FIELDS];
+    float min[SPS30_WINDOW_NUM_FIELDS];
+    float max[SPS30_WINDOW_NUM_FIELDS];
+    uint32_t count = 0;
+    uint16_t b;
+    uint8_t i;
+
+    for (b = 0; b < window->num_buckets; ++b) {
+        bucket = &window->buckets[b];
+        if (bucket->count == 0)
+            continue;
+
+        for (i = 0; i < SPS30_WINDOW_NUM_FIELDS; ++i) {
+            if (count == 0) {
+                sum[i] = bucket->sum[i];
+                min[i] = bucket->min[i];
+                max[i] = bucket->max[i];
+                continue;
+            }
+            sum[i] += bucket->sum[i];
+            if (bucket->min[i] < min[i])
+                min[i] = bucket->min[i];
+            if (bucket->max[i] > max[i])
+                max[i] = bucket->max[i];
+        }
+        count += bucket->count;
+    }
+
+    result->count = count;
+    if (count == 0)
+        return STATUS_FAIL;
+
+    for (i = 0; i < SPS30_WINDOW_NUM_FIELDS; ++i)
+        sum[i] /= (float)count;
+    sps30_window_from_fields(sum, &result->mean);
+    sps30_window_from_fields(min, &result->min);
+    sps30_window_from_fields(max, &result->max);
+    return NO_ERROR;
+}
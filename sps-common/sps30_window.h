@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SPS30_WINDOW_H
+#define SPS30_WINDOW_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "sensirion_arch_config.h"
+#include "sps30.h"
+
+/*
+ * Rolling mean/min/max of measurements over a time window
+ *
+ * The window is split into a fixed number of buckets, each keeping the sum,
+ * minimum and maximum of the samples which fall into its time slice. Adding a
+ * sample updates the current bucket only; once a bucket's time slice is over
+ * the oldest bucket is cleared and reused. Neither time nor memory per sample
+ * depend on the window length, and the history is never re-scanned.
+ *
+ * The window covers the current bucket and the num_buckets - 1 buckets before
+ * it, so its length is accurate to one bucket duration. E.g. a 1 minute
+ * window at 1Hz with 60 buckets of 1s is exact, a 24 hour window with 96
+ * buckets of 15 minutes moves in steps of 15 minutes.
+ */
+
+#define SPS30_WINDOW_NUM_FIELDS 10
+
+/**
+ * struct sps30_window_bucket - aggregate of one time slice, the members are
+ * private
+ */
+struct sps30_window_bucket {
+    float sum[SPS30_WINDOW_NUM_FIELDS];
+    float min[SPS30_WINDOW_NUM_FIELDS];
+    float max[SPS30_WINDOW_NUM_FIELDS];
+    uint32_t count;
+};
+
+/**
+ * struct sps30_window - window state, the members are private
+ */
+struct sps30_window {
+    struct sps30_window_bucket* buckets;
+    uint16_t num_buckets;
+    uint16_t current;
+    uint32_t bucket_duration;
+    uint32_t bucket_start;
+    uint8_t started;
+};
+
+/**
+ * struct sps30_window_result - aggregate over the window
+ *
+ * @mean:   Mean of each field
+ * @min:    Minimum of each field
+ * @max:    Maximum of each field
+ * @count:  Number of samples in the window
+ */
+struct sps30_window_result {
+    struct sps30_measurement mean;
+    struct sps30_measurement min;
+    struct sps30_measurement max;
+    uint32_t count;
+};
+
+/**
+ * sps30_window_init() - initialize an empty window
+ *
+ * @window:             Window to initialize
+ * @buckets:            Storage for @num_buckets buckets
+ * @num_buckets:        Number of buckets, at least 1
+ * @bucket_duration:    Duration of a bucket, in the unit of the timestamps
+ *                      passed to sps30_window_add(), at least 1
+ * Return:              0 on success, STATUS_FAIL on invalid arguments
+ */
+int16_t sps30_window_init(struct sps30_window* window,
+                          struct sps30_window_bucket* buckets,
+                          uint16_t num_buckets, uint32_t bucket_duration);
+
+/**
+ * sps30_window_add() - add a measurement to the window
+ *
+ * Timestamps must not decrease; wrap-around of the 32 bit timestamp is
+ * handled as long as samples are not more than 2^31 units apart.
+ *
+ * @window:         Window
+ * @timestamp:      Time of the measurement
+ * @measurement:    Measurement as read by sps30_read_measurement()
+ */
+void sps30_window_add(struct sps30_window* window, uint32_t timestamp,
+                      const struct sps30_measurement* measurement);
+
+/**
+ * sps30_window_expire() - advance the window without adding a measurement
+ *
+ * Drops the samples which are older than the window at @timestamp, e.g.
+ * before reading a window while the sensor was not measuring.
+ */
+void sps30_window_expire(struct sps30_window* window, uint32_t timestamp);
+
+/**
+ * sps30_window_get() - aggregate the samples in the window
+ *
+ * Costs one pass over the buckets, independent of the number of samples.
+ *
+ * @window: Window
+ * @result: Memory where the aggregate is stored
+ * Return:  0 on success, STATUS_FAIL if the window holds no samples
+ */
+int16_t sps30_window_get(const struct sps30_window* window,
+                         struct sps30_window_result* result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPS30_WINDOW_H */
@@ -33,228 +33,1521 @@
 #include "sensirion_arch_config.h"
 #include "sensirion_common.h"
 #include "sensirion_i2c.h"
+#include "sps30_commands.h"
 #include "sps_git_version.h"
 
-#define SPS_CMD_START_MEASUREMENT 0x0010
-#define SPS_CMD_START_MEASUREMENT_ARG 0x0300
-#define SPS_CMD_STOP_MEASUREMENT 0x0104
-#define SPS_CMD_READ_MEASUREMENT 0x0300
-#define SPS_CMD_START_STOP_DELAY_USEC 20000
-#define SPS_CMD_GET_DATA_READY 0x0202
-#define SPS_CMD_AUTOCLEAN_INTERVAL 0x8004
-#define SPS_CMD_GET_FIRMWARE_VERSION 0xd100
-#define SPS_CMD_GET_SERIAL 0xd033
-#define SPS_CMD_RESET 0xd304
-#define SPS_CMD_SLEEP 0x1001
-#define SPS_CMD_READ_DEVICE_STATUS_REG 0xd206
-#define SPS_CMD_START_MANUAL_FAN_CLEANING 0x5607
-#define SPS_CMD_WAKE_UP 0x1103
-#define SPS_CMD_DELAY_USEC 5000
-#define SPS_CMD_DELAY_WRITE_FLASH_USEC 20000
+#if defined(SPS30_CRC_SIMD) && defined(__SSSE3__)
+#include <tmmintrin.h>  // _mm_shuffle_epi8
+#define SPS30_CRC_SSSE3
+#endif
 
 #define SPS30_SERIAL_NUM_WORDS ((SPS30_MAX_SERIAL_LEN) / 2)
 
+/* the longest response is a measurement in float format, then the serial */
+#if !defined(SPS30_NO_FLOAT)
+#define SPS30_MAX_READ_WORDS 20
+#elif !defined(SPS30_NO_IDENTITY)
+#define SPS30_MAX_READ_WORDS SPS30_SERIAL_NUM_WORDS
+#else
+#define SPS30_MAX_READ_WORDS 10
+#endif
+
+#ifdef SPS30_NO_FLOAT
+#define SPS30_FORMAT_DEFAULT SPS30_FORMAT_UINT16
+#else
+#define SPS30_FORMAT_DEFAULT SPS30_FORMAT_FLOAT
+#endif
+
+/* commands whose response is read after a delay */
+#if !defined(SPS30_NO_FAN_CLEANING) || !defined(SPS30_NO_STATUS_REGISTER)
+#define SPS30_DELAYED_READS
+#endif
+
+static struct sps30_dev sps30_default_dev;
+static uint8_t sps30_default_dev_initialized;
+
 const char* sps_get_driver_version(void) {
     return SPS_DRV_VERSION_STR;
 }
 
-int16_t sps30_probe(void) {
+#ifdef SPS30_STATS
+
+/**
+ * sps30_stats_cmd_index() - map a command to its slot in struct sps30_stats
+ */
+static uint8_t sps30_stats_cmd_index(uint16_t cmd) {
+    switch (cmd) {
+        case SPS_CMD_START_MEASUREMENT:
+            return SPS30_STATS_CMD_START_MEASUREMENT;
+        case SPS_CMD_STOP_MEASUREMENT:
+            return SPS30_STATS_CMD_STOP_MEASUREMENT;
+        case SPS_CMD_READ_MEASUREMENT:
+            return SPS30_STATS_CMD_READ_MEASUREMENT;
+        case SPS_CMD_GET_DATA_READY:
+            return SPS30_STATS_CMD_READ_DATA_READY;
+        case SPS_CMD_AUTOCLEAN_INTERVAL:
+            return SPS30_STATS_CMD_AUTOCLEAN_INTERVAL;
+        case SPS_CMD_GET_FIRMWARE_VERSION:
+            return SPS30_STATS_CMD_READ_FIRMWARE_VERSION;
+        case SPS_CMD_GET_SERIAL:
+            return SPS30_STATS_CMD_GET_SERIAL;
+        case SPS_CMD_RESET:
+            return SPS30_STATS_CMD_RESET;
+        case SPS_CMD_SLEEP:
+            return SPS30_STATS_CMD_SLEEP;
+        case SPS_CMD_READ_DEVICE_STATUS_REG:
+            return SPS30_STATS_CMD_READ_DEVICE_STATUS_REGISTER;
+        case SPS_CMD_START_MANUAL_FAN_CLEANING:
+            return SPS30_STATS_CMD_START_MANUAL_FAN_CLEANING;
+        case SPS_CMD_WAKE_UP:
+            return SPS30_STATS_CMD_WAKE_UP;
+        default:
+            return SPS30_STATS_CMD_OTHER;
+    }
+}
+
+/**
+ * sps30_stats_commit() - account the latency of the last command
+ *
+ * The latency of a command spans from sending the command to the last bus
+ * transfer or sleep belonging to it. It is committed when the next command is
+ * sent or when the statistics are retrieved.
+ */
+static void sps30_stats_commit(struct sps30_stats* stats) {
+    struct sps30_cmd_stats* cs;
+    uint32_t latency_us;
+    uint8_t bucket = 0;
+
+    if (!stats->in_progress)
+        return;
+
+    stats->in_progress = 0;
+    cs = &stats->cmd[stats->cur_cmd];
+    latency_us = stats->last_event_us - stats->cmd_start_us;
+
+    if (latency_us < cs->latency_min_us || cs->calls == 1)
+        cs->latency_min_us = latency_us;
+    if (latency_us > cs->latency_max_us)
+        cs->latency_max_us = latency_us;
+
+    while (bucket < SPS30_STATS_NUM_BUCKETS - 1 && (latency_us >> 1) > 0) {
+        latency_us >>= 1;
+        ++bucket;
+    }
+    cs->latency_hist[bucket]++;
+}
+
+static void sps30_stats_begin(struct sps30_dev* dev, uint16_t cmd) {
+    struct sps30_stats* stats = &dev->stats;
+
+    sps30_stats_commit(stats);
+    stats->cur_cmd = sps30_stats_cmd_index(cmd);
+    stats->cmd[stats->cur_cmd].calls++;
+    stats->cmd_start_us = sps30_stats_get_time_usec();
+    stats->last_event_us = stats->cmd_start_us;
+    stats->in_progress = 1;
+}
+
+static void sps30_stats_event(struct sps30_dev* dev, int16_t ret) {
+    struct sps30_stats* stats = &dev->stats;
+
+    if (!stats->in_progress)
+        return;
+
+    if (ret == SPS30_ERR_CRC)
+        stats->cmd[stats->cur_cmd].crc_errors++;
+    else if (ret != NO_ERROR)
+        stats->cmd[stats->cur_cmd].nacks++;
+    stats->last_event_us = sps30_stats_get_time_usec();
+}
+
+#define SPS30_STATS_BEGIN(dev, cmd) sps30_stats_begin(dev, cmd)
+#define SPS30_STATS_EVENT(dev, ret) sps30_stats_event(dev, ret)
+#define SPS30_STATS_SLEEP(dev, useconds) \
+    ((dev)->stats.sleep_time_us += (useconds))
+
+#else /* SPS30_STATS */
+
+#define SPS30_STATS_BEGIN(dev, cmd) ((void)0)
+#define SPS30_STATS_EVENT(dev, ret) ((void)0)
+#define SPS30_STATS_SLEEP(dev, useconds) ((void)0)
+
+#endif /* SPS30_STATS */
+
+#ifndef SPS30_NO_MUX
+
+/* we only write single channels or 0, so no valid selection looks like this */
+#define SPS30_MUX_UNKNOWN 0xff
+
+static int16_t sps30_mux_write(struct sps30_mux* mux, uint8_t channels) {
+    int16_t ret;
+
+    ret = sensirion_i2c_write(mux->address, &channels, 1);
+    mux->selected = ret == NO_ERROR ? channels : SPS30_MUX_UNKNOWN;
+    mux->switches++;
+    return ret;
+}
+
+/**
+ * sps30_mux_select() - connect the given channels of a multiplexer only
+ *
+ * The bus must be selected. The channels of the other multiplexers on the bus
+ * are disconnected first, writes of an unchanged selection are skipped.
+ */
+static int16_t sps30_mux_select(struct sps30_mux* mux, uint8_t channels) {
+    struct sps30_mux* peer;
+    int16_t ret;
+
+    for (peer = mux->next; peer != mux; peer = peer->next) {
+        if (peer->selected != 0) {
+            ret = sps30_mux_write(peer, 0);
+            if (ret != NO_ERROR)
+                return ret;
+        }
+    }
+
+    if (mux->selected == channels)
+        return NO_ERROR;
+
+    return sps30_mux_write(mux, channels);
+}
+
+#endif /* SPS30_NO_MUX */
+
+/**
+ * sps30_select_bus() - select the bus and multiplexer channel of the sensor
+ * before talking to it
+ */
+static int16_t sps30_select_bus(const struct sps30_dev* dev) {
+    int16_t ret = NO_ERROR;
+
+    if (dev->bus != SPS30_BUS_DEFAULT)
+        ret = sensirion_i2c_select_bus(dev->bus);
+
+#ifndef SPS30_NO_MUX
+    if (ret == NO_ERROR && dev->mux)
+        ret = sps30_mux_select(dev->mux, (uint8_t)(1 << dev->mux_channel));
+#endif
+    return ret;
+}
+
+/**
+ * sps30_transfer_done() - account for the outcome of a transfer
+ */
+static void sps30_transfer_done(struct sps30_dev* dev, int16_t ret) {
+#ifndef SPS30_NO_MUX
+    /* a multiplexer which was reset looks like a sensor that does not answer */
+    if (ret != NO_ERROR && dev->mux)
+        dev->mux->selected = SPS30_MUX_UNKNOWN;
+#endif
+    SPS30_STATS_EVENT(dev, ret);
+}
+
+/**
+ * sps30_send_cmd_with_args() - send a command with CRC-protected arguments
+ *
+ * Any command replaces the response of a pending delayed read.
+ */
+static int16_t sps30_send_cmd_with_args(struct sps30_dev* dev, uint16_t cmd,
+                                        const uint16_t* args,
+                                        uint16_t num_args) {
+    int16_t ret;
+
+    dev->pending_cmd = 0;
+    SPS30_STATS_BEGIN(dev, cmd);
+
+    ret = sps30_select_bus(dev);
+    if (ret == NO_ERROR) {
+        ret = sensirion_i2c_write_cmd_with_args(dev->address, cmd, args,
+                                                num_args);
+    }
+
+    sps30_transfer_done(dev, ret);
+    return ret;
+}
+
+static int16_t sps30_send_cmd(struct sps30_dev* dev, uint16_t cmd) {
+    return sps30_send_cmd_with_args(dev, cmd, NULL, 0);
+}
+
+/*
+ * CRC-8 of a data word (polynomial 0x31, initialization 0xff)
+ *
+ * Bit by bit in the common code by default, one of SPS30_CRC_NIBBLE,
+ * SPS30_CRC_TABLE or SPS30_CRC_SIMD trades flash for speed, see sps30.h.
+ */
+#define SPS30_CRC_WORD_SIZE (SENSIRION_WORD_SIZE + CRC8_LEN)
+
+#if defined(SPS30_CRC_NIBBLE)
+
+/* CRC of the high nibble of the register, shifted out four bits at a time */
+static const uint8_t sps30_crc_nibble[16] = {
+    0x00, 0x31, 0x62, 0x53, 0xc4, 0xf5, 0xa6, 0x97,
+    0xb9, 0x88, 0xdb, 0xea, 0x7d, 0x4c, 0x1f, 0x2e,
+};
+
+static uint8_t sps30_crc_word(const uint8_t* word) {
+    uint8_t crc = CRC8_INIT;
+    uint8_t i;
+
+    for (i = 0; i < SENSIRION_WORD_SIZE; ++i) {
+        crc ^= word[i];
+        crc = (uint8_t)(crc << 4) ^ sps30_crc_nibble[crc >> 4];
+        crc = (uint8_t)(crc << 4) ^ sps30_crc_nibble[crc >> 4];
+    }
+    return crc;
+}
+
+#elif defined(SPS30_CRC_TABLE)
+
+/* CRC of a single byte with initialization 0 */
+static const uint8_t sps30_crc_table[256] = {
+    0x00, 0x31, 0x62, 0x53, 0xc4, 0xf5, 0xa6, 0x97,
+    0xb9, 0x88, 0xdb, 0xea, 0x7d, 0x4c, 0x1f, 0x2e,
+    0x43, 0x72, 0x21, 0x10, 0x87, 0xb6, 0xe5, 0xd4,
+    0xfa, 0xcb, 0x98, 0xa9, 0x3e, 0x0f, 0x5c, 0x6d,
+    0x86, 0xb7, 0xe4, 0xd5, 0x42, 0x73, 0x20, 0x11,
+    0x3f, 0x0e, 0x5d, 0x6c, 0xfb, 0xca, 0x99, 0xa8,
+    0xc5, 0xf4, 0xa7, 0x96, 0x01, 0x30, 0x63, 0x52,
+    0x7c, 0x4d, 0x1e, 0x2f, 0xb8, 0x89, 0xda, 0xeb,
+    0x3d, 0x0c, 0x5f, 0x6e, 0xf9, 0xc8, 0x9b, 0xaa,
+    0x84, 0xb5, 0xe6, 0xd7, 0x40, 0x71, 0x22, 0x13,
+    0x7e, 0x4f, 0x1c, 0x2d, 0xba, 0x8b, 0xd8, 0xe9,
+    0xc7, 0xf6, 0xa5, 0x94, 0x03, 0x32, 0x61, 0x50,
+    0xbb, 0x8a, 0xd9, 0xe8, 0x7f, 0x4e, 0x1d, 0x2c,
+    0x02, 0x33, 0x60, 0x51, 0xc6, 0xf7, 0xa4, 0x95,
+    0xf8, 0xc9, 0x9a, 0xab, 0x3c, 0x0d, 0x5e, 0x6f,
+    0x41, 0x70, 0x23, 0x12, 0x85, 0xb4, 0xe7, 0xd6,
+    0x7a, 0x4b, 0x18, 0x29, 0xbe, 0x8f, 0xdc, 0xed,
+    0xc3, 0xf2, 0xa1, 0x90, 0x07, 0x36, 0x65, 0x54,
+    0x39, 0x08, 0x5b, 0x6a, 0xfd, 0xcc, 0x9f, 0xae,
+    0x80, 0xb1, 0xe2, 0xd3, 0x44, 0x75, 0x26, 0x17,
+    0xfc, 0xcd, 0x9e, 0xaf, 0x38, 0x09, 0x5a, 0x6b,
+    0x45, 0x74, 0x27, 0x16, 0x81, 0xb0, 0xe3, 0xd2,
+    0xbf, 0x8e, 0xdd, 0xec, 0x7b, 0x4a, 0x19, 0x28,
+    0x06, 0x37, 0x64, 0x55, 0xc2, 0xf3, 0xa0, 0x91,
+    0x47, 0x76, 0x25, 0x14, 0x83, 0xb2, 0xe1, 0xd0,
+    0xfe, 0xcf, 0x9c, 0xad, 0x3a, 0x0b, 0x58, 0x69,
+    0x04, 0x35, 0x66, 0x57, 0xc0, 0xf1, 0xa2, 0x93,
+    0xbd, 0x8c, 0xdf, 0xee, 0x79, 0x48, 0x1b, 0x2a,
+    0xc1, 0xf0, 0xa3, 0x92, 0x05, 0x34, 0x67, 0x56,
+    0x78, 0x49, 0x1a, 0x2b, 0xbc, 0x8d, 0xde, 0xef,
+    0x82, 0xb3, 0xe0, 0xd1, 0x46, 0x77, 0x24, 0x15,
+    0x3b, 0x0a, 0x59, 0x68, 0xff, 0xce, 0x9d, 0xac,
+};
+
+static uint8_t sps30_crc_word(const uint8_t* word) {
+    return sps30_crc_table[sps30_crc_table[word[0] ^ CRC8_INIT] ^ word[1]];
+}
+
+#elif defined(SPS30_CRC_SIMD)
+
+/*
+ * The CRC is linear: crc(msb, lsb) = 0x81 ^ T(T(msb)) ^ T(lsb) with T(x) the
+ * CRC of the byte x with initialization 0 and 0x81 the CRC of a zero word.
+ * Both terms are looked up per nibble, which the words of a frame can do side
+ * by side.
+ */
+#define SPS30_CRC_ZERO_WORD 0x81
+
+static const uint8_t sps30_crc_nibbles[4][16] = {
+    /* T(T(msb)) of the low and the high nibble */
+    {0x00, 0xf4, 0xd9, 0x2d, 0x83, 0x77, 0x5a, 0xae,
+     0x37, 0xc3, 0xee, 0x1a, 0xb4, 0x40, 0x6d, 0x99},
+    {0x00, 0x6e, 0xdc, 0xb2, 0x89, 0xe7, 0x55, 0x3b,
+     0x23, 0x4d, 0xff, 0x91, 0xaa, 0xc4, 0x76, 0x18},
+    /* T(lsb) of the low and the high nibble */
+    {0x00, 0x31, 0x62, 0x53, 0xc4, 0xf5, 0xa6, 0x97,
+     0xb9, 0x88, 0xdb, 0xea, 0x7d, 0x4c, 0x1f, 0x2e},
+    {0x00, 0x43, 0x86, 0xc5, 0x3d, 0x7e, 0xbb, 0xf8,
+     0x7a, 0x39, 0xfc, 0xbf, 0x47, 0x04, 0xc1, 0x82},
+};
+
+static uint8_t sps30_crc_word(const uint8_t* word) {
+    return SPS30_CRC_ZERO_WORD ^ sps30_crc_nibbles[0][word[0] & 0xf] ^
+           sps30_crc_nibbles[1][word[0] >> 4] ^
+           sps30_crc_nibbles[2][word[1] & 0xf] ^
+           sps30_crc_nibbles[3][word[1] >> 4];
+}
+
+#ifdef SPS30_CRC_SSSE3
+
+static __m128i sps30_crc_lookup(const uint8_t (*nibbles)[16], __m128i bytes) {
+    const __m128i low = _mm_set1_epi8(0x0f);
+    const __m128i lo = _mm_loadu_si128((const __m128i*)nibbles[0]);
+    const __m128i hi = _mm_loadu_si128((const __m128i*)nibbles[1]);
+
+    return _mm_xor_si128(
+        _mm_shuffle_epi8(lo, _mm_and_si128(bytes, low)),
+        _mm_shuffle_epi8(hi, _mm_and_si128(_mm_srli_epi16(bytes, 4), low)));
+}
+
+/**
+ * sps30_crc_check5() - check the five words at the start of a vector
+ *
+ * Return:  1 if all five CRCs match, 0 otherwise
+ */
+static int sps30_crc_check5(__m128i v) {
+    const __m128i msb = _mm_setr_epi8(0, 3, 6, 9, 12, -1, -1, -1, -1, -1, -1,
+                                      -1, -1, -1, -1, -1);
+    const __m128i lsb = _mm_setr_epi8(1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1,
+                                      -1, -1, -1, -1, -1);
+    const __m128i crc = _mm_setr_epi8(2, 5, 8, 11, 14, -1, -1, -1, -1, -1, -1,
+                                      -1, -1, -1, -1, -1);
+    __m128i computed;
+
+    computed = _mm_xor_si128(
+        sps30_crc_lookup(&sps30_crc_nibbles[0], _mm_shuffle_epi8(v, msb)),
+        sps30_crc_lookup(&sps30_crc_nibbles[2], _mm_shuffle_epi8(v, lsb)));
+    computed =
+        _mm_xor_si128(computed, _mm_set1_epi8((char)SPS30_CRC_ZERO_WORD));
+    return (_mm_movemask_epi8(
+                _mm_cmpeq_epi8(computed, _mm_shuffle_epi8(v, crc))) &
+            0x1f) == 0x1f;
+}
+
+#endif /* SPS30_CRC_SSSE3 */
+
+#else
+
+static uint8_t sps30_crc_word(const uint8_t* word) {
+    return sensirion_common_generate_crc(word, SENSIRION_WORD_SIZE);
+}
+
+#endif /* SPS30_CRC_* */
+
+int16_t sps30_check_crcs(const uint8_t* frame, uint16_t num_words) {
+    const uint16_t size = num_words * SPS30_CRC_WORD_SIZE;
+    uint16_t i = 0;
+
+#ifdef SPS30_CRC_SSSE3
+    /* five words per 16 byte load, the last load overlaps the one before */
+    if (size >= 16) {
+        for (; i + 16 <= size; i += 5 * SPS30_CRC_WORD_SIZE) {
+            if (!sps30_crc_check5(_mm_loadu_si128((const __m128i*)&frame[i])))
+                return SPS30_ERR_CRC;
+        }
+        if (i < size &&
+            !sps30_crc_check5(_mm_srli_si128(
+                _mm_loadu_si128((const __m128i*)&frame[size - 16]), 1)))
+            return SPS30_ERR_CRC;
+        return NO_ERROR;
+    }
+#endif
+    for (; i < size; i += SPS30_CRC_WORD_SIZE) {
+        if (sps30_crc_word(&frame[i]) != frame[i + SENSIRION_WORD_SIZE])
+            return SPS30_ERR_CRC;
+    }
+    return NO_ERROR;
+}
+
+/**
+ * sps30_unpack_words() - check the CRCs of a response and strip them
+ *
+ * Return:  0 on success, SPS30_ERR_CRC to tell a CRC mismatch apart from a
+ *          failed transfer
+ */
+static int16_t sps30_unpack_words(const uint8_t* buf, uint8_t* data,
+                                  uint16_t num_words) {
+    const uint16_t size = num_words * SPS30_CRC_WORD_SIZE;
+    uint16_t i;
+
+    if (sps30_check_crcs(buf, num_words))
+        return SPS30_ERR_CRC;
+
+    for (i = 0; i < size; i += SPS30_CRC_WORD_SIZE) {
+        *data++ = buf[i];
+        *data++ = buf[i + 1];
+    }
+    return NO_ERROR;
+}
+
+#if defined(SPS30_DELAYED_READS) || !defined(SPS30_I2C_WRITE_READ)
+
+/**
+ * sps30_read_words_as_bytes() - read the response to the last command
+ *
+ * Like sensirion_i2c_read_words_as_bytes() but a CRC mismatch is reported as
+ * SPS30_ERR_CRC.
+ */
+static int16_t sps30_read_words_as_bytes(struct sps30_dev* dev, uint8_t* data,
+                                         uint16_t num_words) {
+    uint8_t buf[SPS30_MAX_READ_WORDS * (SENSIRION_WORD_SIZE + CRC8_LEN)];
+    const uint16_t size = num_words * (SENSIRION_WORD_SIZE + CRC8_LEN);
+    int16_t ret;
+
+    ret = sps30_select_bus(dev);
+    if (ret == NO_ERROR)
+        ret = sensirion_i2c_read(dev->address, buf, size);
+    if (ret == NO_ERROR)
+        ret = sps30_unpack_words(buf, data, num_words);
+
+    sps30_transfer_done(dev, ret);
+    return ret;
+}
+
+#endif /* SPS30_DELAYED_READS || !SPS30_I2C_WRITE_READ */
+
+#ifdef SPS30_I2C_WRITE_READ
+
+/**
+ * sps30_read_cmd() - send a command and read its immediate response in one
+ * transfer
+ */
+static int16_t sps30_read_cmd(struct sps30_dev* dev, uint16_t cmd,
+                              uint8_t* data, uint16_t num_words) {
+    uint8_t tx[SENSIRION_COMMAND_SIZE];
+    uint8_t buf[SPS30_MAX_READ_WORDS * (SENSIRION_WORD_SIZE + CRC8_LEN)];
+    const uint16_t size = num_words * (SENSIRION_WORD_SIZE + CRC8_LEN);
+    int16_t ret;
+
+    dev->pending_cmd = 0;
+    SPS30_STATS_BEGIN(dev, cmd);
+
+    ret = sps30_select_bus(dev);
+    if (ret == NO_ERROR) {
+        sensirion_fill_cmd_send_buf(tx, cmd, NULL, 0);
+        ret = sps30_i2c_write_read(dev->address, tx, sizeof(tx), buf, size);
+    }
+    if (ret == NO_ERROR)
+        ret = sps30_unpack_words(buf, data, num_words);
+
+    sps30_transfer_done(dev, ret);
+    return ret;
+}
+
+#else /* SPS30_I2C_WRITE_READ */
+
+/**
+ * sps30_read_cmd() - send a command and read its immediate response
+ */
+static int16_t sps30_read_cmd(struct sps30_dev* dev, uint16_t cmd,
+                              uint8_t* data, uint16_t num_words) {
+    int16_t ret;
+
+    ret = sps30_send_cmd(dev, cmd);
+    if (ret != NO_ERROR)
+        return ret;
+
+    return sps30_read_words_as_bytes(dev, data, num_words);
+}
+
+#endif /* SPS30_I2C_WRITE_READ */
+
+static void sps30_sleep_usec(struct sps30_dev* dev, uint32_t useconds) {
+    sensirion_sleep_usec(useconds);
+    SPS30_STATS_SLEEP(dev, useconds);
+    SPS30_STATS_EVENT(dev, NO_ERROR);
+}
+
+void sps30_dev_init(struct sps30_dev* dev, uint8_t bus, uint8_t address) {
+    dev->bus = bus;
+    dev->address = address;
+    dev->state = SPS30_STATE_UNKNOWN;
+    dev->pending_cmd = 0;
+    dev->cmd_issued_us = 0;
+    dev->cmd_delay_us = 0;
+    dev->format = SPS30_FORMAT_DEFAULT;
+    dev->active_format = SPS30_FORMAT_DEFAULT;
+    dev->cached = 0;
+#ifndef SPS30_NO_MUX
+    dev->mux = NULL;
+    dev->mux_channel = SPS30_MUX_NO_CHANNEL;
+#endif
+#ifdef SPS30_STATS
+    sps30_dev_reset_stats(dev);
+#endif
+}
+
+#ifndef SPS30_NO_MUX
+
+int16_t sps30_mux_init(struct sps30_mux* mux, uint8_t bus, uint8_t address,
+                       struct sps30_mux* peer) {
+    mux->bus = bus;
+    mux->address = address;
+    mux->selected = SPS30_MUX_UNKNOWN;
+    mux->switches = 0;
+    mux->next = mux;
+    if (!peer)
+        return NO_ERROR;
+
+    /* multiplexers on different buses must not disconnect each other */
+    if (peer->bus != bus)
+        return STATUS_FAIL;
+
+    mux->next = peer->next;
+    peer->next = mux;
+    return NO_ERROR;
+}
+
+int16_t sps30_dev_set_mux(struct sps30_dev* dev, struct sps30_mux* mux,
+                          uint8_t channel) {
+    if (mux && (channel >= SPS30_MUX_CHANNELS || mux->bus != dev->bus))
+        return STATUS_FAIL;
+
+    dev->mux = mux;
+    dev->mux_channel = mux ? channel : SPS30_MUX_NO_CHANNEL;
+    return NO_ERROR;
+}
+
+int16_t sps30_mux_release(struct sps30_mux* mux) {
+    struct sps30_mux* m = mux;
+    int16_t ret = NO_ERROR;
+
+    if (mux->bus != SPS30_BUS_DEFAULT)
+        ret = sensirion_i2c_select_bus(mux->bus);
+    if (ret != NO_ERROR)
+        return ret;
+
+    do {
+        if (m->selected != 0) {
+            ret = sps30_mux_write(m, 0);
+            if (ret != NO_ERROR)
+                return ret;
+        }
+        m = m->next;
+    } while (m != mux);
+    return NO_ERROR;
+}
+
+void sps30_mux_invalidate(struct sps30_mux* mux) {
+    struct sps30_mux* m = mux;
+
+    do {
+        m->selected = SPS30_MUX_UNKNOWN;
+        m = m->next;
+    } while (m != mux);
+}
+
+#endif /* SPS30_NO_MUX */
+
+int16_t sps30_dev_probe(struct sps30_dev* dev) {
+#ifndef SPS30_NO_IDENTITY
     char serial[SPS30_MAX_SERIAL_LEN];
+    uint8_t major;
+    uint8_t minor;
+#else
+    uint16_t data_ready;
+#endif
+
+#ifndef SPS30_NO_SLEEP
+    // Try to wake up, but ignore failure if it is not in sleep mode
+    (void)sps30_dev_wake_up(dev);
+#endif
+
+#ifndef SPS30_NO_IDENTITY
+    if (!(dev->cached & SPS30_CACHED_SERIAL))
+        return sps30_dev_get_serial(dev, serial);
+
+    /* check the presence with a shorter read than the serial */
+    dev->cached &= (uint8_t)~SPS30_CACHED_FIRMWARE_VERSION;
+    return sps30_dev_read_firmware_version(dev, &major, &minor);
+#else
+    return sps30_dev_read_data_ready(dev, &data_ready);
+#endif
+}
+
+#ifndef SPS30_NO_IDENTITY
+
+int16_t sps30_dev_read_firmware_version(struct sps30_dev* dev, uint8_t* major,
+                                        uint8_t* minor) {
+    uint8_t version[2] = {0};
+    int16_t ret = NO_ERROR;
+
+    if (!(dev->cached & SPS30_CACHED_FIRMWARE_VERSION)) {
+        ret = sps30_read_cmd(dev, SPS_CMD_GET_FIRMWARE_VERSION, version,
+                             SENSIRION_NUM_WORDS(version));
+        if (ret == NO_ERROR) {
+            dev->firmware_major = version[0];
+            dev->firmware_minor = version[1];
+            dev->cached |= SPS30_CACHED_FIRMWARE_VERSION;
+        }
+    } else {
+        version[0] = dev->firmware_major;
+        version[1] = dev->firmware_minor;
+    }
+    *major = version[0];
+    *minor = version[1];
+    return ret;
+}
+
+static void sps30_copy_serial(char* dst, const char* src) {
+    uint16_t i;
+
+    for (i = 0; i < SPS30_MAX_SERIAL_LEN; ++i)
+        dst[i] = src[i];
+}
+
+int16_t sps30_dev_get_serial(struct sps30_dev* dev, char* serial) {
+    int16_t error;
+
+    if (dev->cached & SPS30_CACHED_SERIAL) {
+        sps30_copy_serial(serial, dev->serial);
+        return NO_ERROR;
+    }
+
+    error = sps30_read_cmd(dev, SPS_CMD_GET_SERIAL, (uint8_t*)serial,
+                           SPS30_SERIAL_NUM_WORDS);
+
+    /* ensure a final '\0'. The firmware should always set this so this is just
+     * in case something goes wrong.
+     */
+    serial[SPS30_MAX_SERIAL_LEN - 1] = '\0';
+
+    if (error == NO_ERROR) {
+        sps30_copy_serial(dev->serial, serial);
+        dev->cached |= SPS30_CACHED_SERIAL;
+    }
+    return error;
+}
+
+#endif /* SPS30_NO_IDENTITY */
+
+int16_t sps30_dev_refresh_cache(struct sps30_dev* dev) {
+#ifndef SPS30_NO_IDENTITY
+    char serial[SPS30_MAX_SERIAL_LEN];
+    uint8_t major;
+    uint8_t minor;
+#endif
+#ifndef SPS30_NO_FAN_CLEANING
+    uint32_t interval_seconds;
+#endif
+    int16_t ret = NO_ERROR;
+
+    dev->cached = 0;
+#ifndef SPS30_NO_IDENTITY
+    ret = sps30_dev_get_serial(dev, serial);
+    if (ret == NO_ERROR)
+        ret = sps30_dev_read_firmware_version(dev, &major, &minor);
+#endif
+#ifndef SPS30_NO_FAN_CLEANING
+    if (ret == NO_ERROR)
+        ret = sps30_dev_get_fan_auto_cleaning_interval(dev, &interval_seconds);
+#endif
+    if (ret != NO_ERROR)
+        dev->cached = 0;
+    return ret;
+}
+
+int16_t sps30_dev_set_measurement_format(struct sps30_dev* dev,
+                                         uint16_t format) {
+#ifdef SPS30_NO_FLOAT
+    if (format != SPS30_FORMAT_UINT16)
+        return SPS30_ERR_FORMAT;
+#else
+    if (format != SPS30_FORMAT_FLOAT && format != SPS30_FORMAT_UINT16)
+        return SPS30_ERR_FORMAT;
+#endif
+
+    dev->format = format;
+    return 0;
+}
+
+static int16_t sps30_send_start_measurement(struct sps30_dev* dev) {
+    const uint16_t arg = dev->format;
+    int16_t ret;
+
+    ret = sps30_send_cmd_with_args(dev, SPS_CMD_START_MEASUREMENT, &arg,
+                                   SENSIRION_NUM_WORDS(arg));
+    if (ret == NO_ERROR) {
+        dev->state = SPS30_STATE_MEASURING;
+        dev->active_format = dev->format;
+    }
+    return ret;
+}
+
+int16_t sps30_dev_start_measurement(struct sps30_dev* dev) {
+    int16_t ret = sps30_send_start_measurement(dev);
+
+    sps30_sleep_usec(dev, SPS_CMD_START_STOP_DELAY_USEC);
+    return ret;
+}
+
+static int16_t sps30_send_stop_measurement(struct sps30_dev* dev) {
+    int16_t ret;
+
+    ret = sps30_send_cmd(dev, SPS_CMD_STOP_MEASUREMENT);
+    if (ret == NO_ERROR)
+        dev->state = SPS30_STATE_IDLE;
+    return ret;
+}
+
+int16_t sps30_dev_stop_measurement(struct sps30_dev* dev) {
+    int16_t ret = sps30_send_stop_measurement(dev);
+
+    sps30_sleep_usec(dev, SPS_CMD_START_STOP_DELAY_USEC);
+    return ret;
+}
+
+int16_t sps30_dev_read_data_ready(struct sps30_dev* dev, uint16_t* data_ready) {
+    uint8_t data[2];
+    int16_t ret;
+
+    ret = sps30_read_cmd(dev, SPS_CMD_GET_DATA_READY, data,
+                         SENSIRION_NUM_WORDS(data));
+    if (ret != NO_ERROR)
+        return ret;
+
+    *data_ready = sensirion_bytes_to_uint16_t(data);
+    return 0;
+}
+
+static void sps30_decode_u16(const uint8_t* data,
+                             struct sps30_measurement_u16* measurement) {
+    measurement->mc_1p0 = sensirion_bytes_to_uint16_t(&data[0]);
+    measurement->mc_2p5 = sensirion_bytes_to_uint16_t(&data[2]);
+    measurement->mc_4p0 = sensirion_bytes_to_uint16_t(&data[4]);
+    measurement->mc_10p0 = sensirion_bytes_to_uint16_t(&data[6]);
+    measurement->nc_0p5 = sensirion_bytes_to_uint16_t(&data[8]);
+    measurement->nc_1p0 = sensirion_bytes_to_uint16_t(&data[10]);
+    measurement->nc_2p5 = sensirion_bytes_to_uint16_t(&data[12]);
+    measurement->nc_4p0 = sensirion_bytes_to_uint16_t(&data[14]);
+    measurement->nc_10p0 = sensirion_bytes_to_uint16_t(&data[16]);
+    measurement->typical_particle_size = sensirion_bytes_to_uint16_t(&data[18]);
+}
+
+#ifndef SPS30_NO_FLOAT
+
+static void sps30_decode_float(const uint8_t* data,
+                               struct sps30_measurement* measurement) {
+    measurement->mc_1p0 = sensirion_bytes_to_float(&data[0]);
+    measurement->mc_2p5 = sensirion_bytes_to_float(&data[4]);
+    measurement->mc_4p0 = sensirion_bytes_to_float(&data[8]);
+    measurement->mc_10p0 = sensirion_bytes_to_float(&data[12]);
+    measurement->nc_0p5 = sensirion_bytes_to_float(&data[16]);
+    measurement->nc_1p0 = sensirion_bytes_to_float(&data[20]);
+    measurement->nc_2p5 = sensirion_bytes_to_float(&data[24]);
+    measurement->nc_4p0 = sensirion_bytes_to_float(&data[28]);
+    measurement->nc_10p0 = sensirion_bytes_to_float(&data[32]);
+    measurement->typical_particle_size = sensirion_bytes_to_float(&data[36]);
+}
+
+static void sps30_u16_to_float(const struct sps30_measurement_u16* m,
+                               struct sps30_measurement* measurement) {
+    measurement->mc_1p0 = m->mc_1p0;
+    measurement->mc_2p5 = m->mc_2p5;
+    measurement->mc_4p0 = m->mc_4p0;
+    measurement->mc_10p0 = m->mc_10p0;
+    measurement->nc_0p5 = m->nc_0p5;
+    measurement->nc_1p0 = m->nc_1p0;
+    measurement->nc_2p5 = m->nc_2p5;
+    measurement->nc_4p0 = m->nc_4p0;
+    measurement->nc_10p0 = m->nc_10p0;
+    /* nm to um */
+    measurement->typical_particle_size = m->typical_particle_size / 1000.0f;
+}
+
+#endif /* SPS30_NO_FLOAT */
+
+int16_t sps30_dev_read_measurement_u16(
+    struct sps30_dev* dev, struct sps30_measurement_u16* measurement) {
+    int16_t error;
+    uint8_t data[10][2];
+
+    if (dev->active_format != SPS30_FORMAT_UINT16) {
+        return SPS30_ERR_FORMAT;
+    }
+
+    error = sps30_read_cmd(dev, SPS_CMD_READ_MEASUREMENT, &data[0][0],
+                           SENSIRION_NUM_WORDS(data));
+    if (error != NO_ERROR) {
+        return error;
+    }
+
+    sps30_decode_u16(&data[0][0], measurement);
+    return 0;
+}
+
+#ifndef SPS30_NO_FLOAT
+
+int16_t sps30_dev_read_measurement(struct sps30_dev* dev,
+                                   struct sps30_measurement* measurement) {
+    int16_t error;
+    uint8_t data[10][4];
+
+    if (dev->active_format == SPS30_FORMAT_UINT16) {
+        struct sps30_measurement_u16 m;
+
+        error = sps30_dev_read_measurement_u16(dev, &m);
+        if (error != NO_ERROR) {
+            return error;
+        }
+
+        sps30_u16_to_float(&m, measurement);
+        return 0;
+    }
+
+    error = sps30_read_cmd(dev, SPS_CMD_READ_MEASUREMENT, &data[0][0],
+                           SENSIRION_NUM_WORDS(data));
+    if (error != NO_ERROR) {
+        return error;
+    }
+
+    sps30_decode_float(&data[0][0], measurement);
+    return 0;
+}
+
+#endif /* SPS30_NO_FLOAT */
+
+uint16_t sps30_dev_measurement_frame_size(const struct sps30_dev* dev) {
+    if (dev->active_format == SPS30_FORMAT_UINT16)
+        return SPS30_MEASUREMENT_FRAME_SIZE / 2;
+    return SPS30_MEASUREMENT_FRAME_SIZE;
+}
+
+#ifndef SPS30_NO_FLOAT
+
+int16_t sps30_dev_decode_measurement(const struct sps30_dev* dev,
+                                     const uint8_t* frame,
+                                     struct sps30_measurement* measurement) {
+    struct sps30_measurement_u16 m;
+    uint8_t data[10][4];
+    int16_t error;
+
+    if (dev->active_format == SPS30_FORMAT_UINT16) {
+        error = sps30_unpack_words(frame, &data[0][0], 10);
+        if (error != NO_ERROR)
+            return error;
+
+        sps30_decode_u16(&data[0][0], &m);
+        sps30_u16_to_float(&m, measurement);
+        return 0;
+    }
+
+    error = sps30_unpack_words(frame, &data[0][0], SENSIRION_NUM_WORDS(data));
+    if (error != NO_ERROR)
+        return error;
+
+    sps30_decode_float(&data[0][0], measurement);
+    return 0;
+}
+
+#endif /* SPS30_NO_FLOAT */
+
+void sps30_frame_decoder_init(struct sps30_frame_decoder* decoder,
+                              const struct sps30_dev* dev) {
+    decoder->format = dev->active_format;
+    decoder->received = 0;
+    decoder->status = SPS30_ERR_NOT_READY;
+    decoder->length = 0;
+    decoder->word_byte = 0;
+}
+
+int16_t sps30_frame_decoder_feed(struct sps30_frame_decoder* decoder,
+                                 const uint8_t* data, uint16_t count) {
+    const uint8_t size = decoder->format == SPS30_FORMAT_UINT16
+                             ? SENSIRION_WORD_SIZE * 10
+                             : SPS30_FRAME_DECODER_DATA_SIZE;
+
+    for (; count && decoder->status == SPS30_ERR_NOT_READY; --count, ++data) {
+        decoder->received++;
+        if (decoder->word_byte < SENSIRION_WORD_SIZE) {
+            decoder->data[decoder->length++] = *data;
+            decoder->word_byte++;
+            continue;
+        }
+
+        decoder->word_byte = 0;
+        if (sps30_crc_word(&decoder->data[decoder->length -
+                                          SENSIRION_WORD_SIZE]) != *data)
+            decoder->status = SPS30_ERR_CRC;
+        else if (decoder->length == size)
+            decoder->status = NO_ERROR;
+    }
+    return decoder->status;
+}
+
+int16_t
+sps30_frame_decoder_get_u16(const struct sps30_frame_decoder* decoder,
+                            struct sps30_measurement_u16* measurement) {
+    if (decoder->format != SPS30_FORMAT_UINT16)
+        return SPS30_ERR_FORMAT;
+    if (decoder->status != NO_ERROR)
+        return decoder->status;
+
+    sps30_decode_u16(decoder->data, measurement);
+    return 0;
+}
+
+#ifndef SPS30_NO_FLOAT
+
+int16_t sps30_frame_decoder_get(const struct sps30_frame_decoder* decoder,
+                                struct sps30_measurement* measurement) {
+    struct sps30_measurement_u16 m;
+
+    if (decoder->status != NO_ERROR)
+        return decoder->status;
+
+    if (decoder->format == SPS30_FORMAT_UINT16) {
+        sps30_decode_u16(decoder->data, &m);
+        sps30_u16_to_float(&m, measurement);
+        return 0;
+    }
+
+    sps30_decode_float(decoder->data, measurement);
+    return 0;
+}
+
+#endif /* SPS30_NO_FLOAT */
+
+#ifndef SPS30_NO_FAN_CLEANING
+
+static int16_t sps30_read_fan_auto_cleaning_interval(
+    struct sps30_dev* dev, uint32_t* interval_seconds) {
+    uint8_t data[4];
+    int16_t error;
+
+    error = sps30_read_words_as_bytes(dev, data, SENSIRION_NUM_WORDS(data));
+    if (error != NO_ERROR) {
+        return error;
+    }
+
+    *interval_seconds = sensirion_bytes_to_uint32_t(data);
+    dev->fan_auto_cleaning_interval = *interval_seconds;
+    dev->cached |= SPS30_CACHED_FAN_AUTO_CLEANING_INTERVAL;
+
+    return 0;
+}
+
+int16_t sps30_dev_get_fan_auto_cleaning_interval(struct sps30_dev* dev,
+                                                 uint32_t* interval_seconds) {
+    int16_t error;
+
+    if (dev->cached & SPS30_CACHED_FAN_AUTO_CLEANING_INTERVAL) {
+        *interval_seconds = dev->fan_auto_cleaning_interval;
+        return 0;
+    }
+
+    error = sps30_send_cmd(dev, SPS_CMD_AUTOCLEAN_INTERVAL);
+    if (error != NO_ERROR) {
+        return error;
+    }
+
+    sps30_sleep_usec(dev, SPS_CMD_DELAY_USEC);
+
+    return sps30_read_fan_auto_cleaning_interval(dev, interval_seconds);
+}
 
-    // Try to wake up, but ignore failure if it is not in sleep mode
-    (void)sps30_wake_up();
+static int16_t sps30_send_set_fan_auto_cleaning_interval(
+    struct sps30_dev* dev, uint32_t interval_seconds) {
+    const uint16_t data[] = {(uint16_t)((interval_seconds & 0xFFFF0000) >> 16),
+                             (uint16_t)(interval_seconds & 0x0000FFFF)};
 
-    return sps30_get_serial(serial);
+    /* older firmware reports the new interval only after a reset */
+    dev->cached &= (uint8_t)~SPS30_CACHED_FAN_AUTO_CLEANING_INTERVAL;
+    return sps30_send_cmd_with_args(dev, SPS_CMD_AUTOCLEAN_INTERVAL, data,
+                                    SENSIRION_NUM_WORDS(data));
 }
 
-int16_t sps30_read_firmware_version(uint8_t* major, uint8_t* minor) {
-    uint16_t version;
+int16_t sps30_dev_set_fan_auto_cleaning_interval(struct sps30_dev* dev,
+                                                 uint32_t interval_seconds) {
     int16_t ret;
 
-    ret = sensirion_i2c_read_cmd(SPS30_I2C_ADDRESS,
-                                 SPS_CMD_GET_FIRMWARE_VERSION, &version, 1);
-    *major = (version & 0xff00) >> 8;
-    *minor = (version & 0x00ff);
+    ret = sps30_send_set_fan_auto_cleaning_interval(dev, interval_seconds);
+    sps30_sleep_usec(dev, SPS_CMD_DELAY_WRITE_FLASH_USEC);
     return ret;
 }
 
-int16_t sps30_get_serial(char* serial) {
-    int16_t error;
+int16_t sps30_dev_get_fan_auto_cleaning_interval_days(struct sps30_dev* dev,
+                                                      uint8_t* interval_days) {
+    int16_t ret;
+    uint32_t interval_seconds;
 
-    error = sensirion_i2c_write_cmd(SPS30_I2C_ADDRESS, SPS_CMD_GET_SERIAL);
+    ret = sps30_dev_get_fan_auto_cleaning_interval(dev, &interval_seconds);
+    if (ret < 0)
+        return ret;
 
-    if (error != NO_ERROR) {
-        return error;
-    }
+    *interval_days = interval_seconds / (24 * 60 * 60);
+    return ret;
+}
 
-    error = sensirion_i2c_read_words_as_bytes(
-        SPS30_I2C_ADDRESS, (uint8_t*)serial, SPS30_SERIAL_NUM_WORDS);
+int16_t sps30_dev_set_fan_auto_cleaning_interval_days(struct sps30_dev* dev,
+                                                      uint8_t interval_days) {
+    return sps30_dev_set_fan_auto_cleaning_interval(
+        dev, (uint32_t)interval_days * 24 * 60 * 60);
+}
 
-    /* ensure a final '\0'. The firmware should always set this so this is just
-     * in case something goes wrong.
-     */
-    serial[SPS30_MAX_SERIAL_LEN - 1] = '\0';
+int16_t sps30_dev_start_manual_fan_cleaning(struct sps30_dev* dev) {
+    int16_t ret;
 
-    return error;
+    ret = sps30_send_cmd(dev, SPS_CMD_START_MANUAL_FAN_CLEANING);
+    if (ret)
+        return ret;
+
+    sps30_sleep_usec(dev, SPS_CMD_DELAY_USEC);
+    return 0;
 }
 
-int16_t sps30_start_measurement(void) {
-    const uint16_t arg = SPS_CMD_START_MEASUREMENT_ARG;
+#endif /* SPS30_NO_FAN_CLEANING */
 
-    int16_t ret = sensirion_i2c_write_cmd_with_args(
-        SPS30_I2C_ADDRESS, SPS_CMD_START_MEASUREMENT, &arg,
-        SENSIRION_NUM_WORDS(arg));
+int16_t sps30_dev_reset(struct sps30_dev* dev) {
+    int16_t ret;
 
-    sensirion_sleep_usec(SPS_CMD_START_STOP_DELAY_USEC);
+    ret = sps30_send_cmd(dev, SPS_CMD_RESET);
+    if (ret)
+        return ret;
 
-    return ret;
+    dev->state = SPS30_STATE_UNKNOWN;
+    dev->cached = 0;
+    return 0;
 }
 
-int16_t sps30_stop_measurement(void) {
-    int16_t ret =
-        sensirion_i2c_write_cmd(SPS30_I2C_ADDRESS, SPS_CMD_STOP_MEASUREMENT);
-    sensirion_sleep_usec(SPS_CMD_START_STOP_DELAY_USEC);
-    return ret;
+#ifndef SPS30_NO_SLEEP
+
+static int16_t sps30_send_sleep(struct sps30_dev* dev) {
+    int16_t ret;
+
+    ret = sps30_send_cmd(dev, SPS_CMD_SLEEP);
+    if (ret)
+        return ret;
+
+    dev->state = SPS30_STATE_SLEEPING;
+    return 0;
 }
 
-int16_t sps30_read_data_ready(uint16_t* data_ready) {
-    return sensirion_i2c_read_cmd(SPS30_I2C_ADDRESS, SPS_CMD_GET_DATA_READY,
-                                  data_ready, SENSIRION_NUM_WORDS(*data_ready));
+int16_t sps30_dev_sleep(struct sps30_dev* dev) {
+    int16_t ret;
+
+    ret = sps30_send_sleep(dev);
+    if (ret)
+        return ret;
+
+    sps30_sleep_usec(dev, SPS_CMD_DELAY_USEC);
+    return 0;
 }
 
-int16_t sps30_read_measurement(struct sps30_measurement* measurement) {
-    int16_t error;
-    uint8_t data[10][4];
+static int16_t sps30_send_wake_up(struct sps30_dev* dev) {
+    int16_t ret;
 
-    error =
-        sensirion_i2c_write_cmd(SPS30_I2C_ADDRESS, SPS_CMD_READ_MEASUREMENT);
-    if (error != NO_ERROR) {
-        return error;
-    }
+    /* wake-up must be sent twice within 100ms, ignore first return value */
+    (void)sps30_send_cmd(dev, SPS_CMD_WAKE_UP);
+    ret = sps30_send_cmd(dev, SPS_CMD_WAKE_UP);
+    if (ret)
+        return ret;
 
-    error = sensirion_i2c_read_words_as_bytes(SPS30_I2C_ADDRESS, &data[0][0],
-                                              SENSIRION_NUM_WORDS(data));
+    dev->state = SPS30_STATE_IDLE;
+    return 0;
+}
 
-    if (error != NO_ERROR) {
-        return error;
-    }
+int16_t sps30_dev_wake_up(struct sps30_dev* dev) {
+    int16_t ret;
 
-    measurement->mc_1p0 = sensirion_bytes_to_float(data[0]);
-    measurement->mc_2p5 = sensirion_bytes_to_float(data[1]);
-    measurement->mc_4p0 = sensirion_bytes_to_float(data[2]);
-    measurement->mc_10p0 = sensirion_bytes_to_float(data[3]);
-    measurement->nc_0p5 = sensirion_bytes_to_float(data[4]);
-    measurement->nc_1p0 = sensirion_bytes_to_float(data[5]);
-    measurement->nc_2p5 = sensirion_bytes_to_float(data[6]);
-    measurement->nc_4p0 = sensirion_bytes_to_float(data[7]);
-    measurement->nc_10p0 = sensirion_bytes_to_float(data[8]);
-    measurement->typical_particle_size = sensirion_bytes_to_float(data[9]);
+    ret = sps30_send_wake_up(dev);
+    if (ret)
+        return ret;
 
+    sps30_sleep_usec(dev, SPS_CMD_DELAY_USEC);
     return 0;
 }
 
-int16_t sps30_get_fan_auto_cleaning_interval(uint32_t* interval_seconds) {
+#endif /* SPS30_NO_SLEEP */
+
+#ifndef SPS30_NO_STATUS_REGISTER
+
+static int16_t sps30_read_device_status_flags(struct sps30_dev* dev,
+                                              uint32_t* device_status_flags) {
+    int16_t ret;
     uint8_t data[4];
-    int16_t error;
 
-    error =
-        sensirion_i2c_write_cmd(SPS30_I2C_ADDRESS, SPS_CMD_AUTOCLEAN_INTERVAL);
-    if (error != NO_ERROR) {
-        return error;
-    }
+    ret = sps30_read_words_as_bytes(dev, data, SENSIRION_NUM_WORDS(data));
+    if (ret)
+        return ret;
+
+    *device_status_flags = sensirion_bytes_to_uint32_t(data);
+    return 0;
+}
 
-    sensirion_sleep_usec(SPS_CMD_DELAY_USEC);
+int16_t sps30_dev_read_device_status_register(struct sps30_dev* dev,
+                                              uint32_t* device_status_flags) {
+    int16_t ret;
 
-    error = sensirion_i2c_read_words_as_bytes(SPS30_I2C_ADDRESS, data,
-                                              SENSIRION_NUM_WORDS(data));
-    if (error != NO_ERROR) {
-        return error;
+    ret = sps30_send_cmd(dev, SPS_CMD_READ_DEVICE_STATUS_REG);
+    if (ret)
+        return ret;
+
+    sps30_sleep_usec(dev, SPS_CMD_DELAY_USEC);
+
+    return sps30_read_device_status_flags(dev, device_status_flags);
+}
+
+#endif /* SPS30_NO_STATUS_REGISTER */
+
+uint32_t sps30_dev_poll(struct sps30_dev* dev, uint32_t now_us) {
+    uint32_t elapsed_us = now_us - dev->cmd_issued_us;
+
+    if (elapsed_us >= dev->cmd_delay_us) {
+        dev->cmd_delay_us = 0;
+        return 0;
     }
+    return dev->cmd_delay_us - elapsed_us;
+}
 
-    *interval_seconds = sensirion_bytes_to_uint32_t(data);
+uint32_t sps30_dev_ready_at(const struct sps30_dev* dev) {
+    return dev->cmd_issued_us + dev->cmd_delay_us;
+}
 
-    return 0;
+static void sps30_set_busy(struct sps30_dev* dev, uint32_t now_us,
+                           uint32_t delay_us) {
+    dev->cmd_issued_us = now_us;
+    dev->cmd_delay_us = delay_us;
 }
 
-int16_t sps30_set_fan_auto_cleaning_interval(uint32_t interval_seconds) {
+int16_t sps30_dev_issue_start_measurement(struct sps30_dev* dev,
+                                          uint32_t now_us) {
     int16_t ret;
-    const uint16_t data[] = {(uint16_t)((interval_seconds & 0xFFFF0000) >> 16),
-                             (uint16_t)(interval_seconds & 0x0000FFFF)};
 
-    ret = sensirion_i2c_write_cmd_with_args(SPS30_I2C_ADDRESS,
-                                            SPS_CMD_AUTOCLEAN_INTERVAL, data,
-                                            SENSIRION_NUM_WORDS(data));
-    sensirion_sleep_usec(SPS_CMD_DELAY_WRITE_FLASH_USEC);
-    return ret;
+    if (sps30_dev_poll(dev, now_us))
+        return SPS30_ERR_NOT_READY;
+
+    ret = sps30_send_start_measurement(dev);
+    if (ret)
+        return ret;
+
+    sps30_set_busy(dev, now_us, SPS_CMD_START_STOP_DELAY_USEC);
+    return 0;
 }
 
-int16_t sps30_get_fan_auto_cleaning_interval_days(uint8_t* interval_days) {
+int16_t sps30_dev_issue_stop_measurement(struct sps30_dev* dev,
+                                         uint32_t now_us) {
     int16_t ret;
-    uint32_t interval_seconds;
 
-    ret = sps30_get_fan_auto_cleaning_interval(&interval_seconds);
-    if (ret < 0)
+    if (sps30_dev_poll(dev, now_us))
+        return SPS30_ERR_NOT_READY;
+
+    ret = sps30_send_stop_measurement(dev);
+    if (ret)
         return ret;
 
-    *interval_days = interval_seconds / (24 * 60 * 60);
-    return ret;
+    sps30_set_busy(dev, now_us, SPS_CMD_START_STOP_DELAY_USEC);
+    return 0;
 }
 
-int16_t sps30_set_fan_auto_cleaning_interval_days(uint8_t interval_days) {
-    return sps30_set_fan_auto_cleaning_interval((uint32_t)interval_days * 24 *
-                                                60 * 60);
+#ifndef SPS30_NO_FAN_CLEANING
+
+int16_t sps30_dev_issue_set_fan_auto_cleaning_interval(
+    struct sps30_dev* dev, uint32_t now_us, uint32_t interval_seconds) {
+    int16_t ret;
+
+    if (sps30_dev_poll(dev, now_us))
+        return SPS30_ERR_NOT_READY;
+
+    ret = sps30_send_set_fan_auto_cleaning_interval(dev, interval_seconds);
+    if (ret)
+        return ret;
+
+    sps30_set_busy(dev, now_us, SPS_CMD_DELAY_WRITE_FLASH_USEC);
+    return 0;
 }
 
-int16_t sps30_start_manual_fan_cleaning(void) {
+int16_t sps30_dev_issue_start_manual_fan_cleaning(struct sps30_dev* dev,
+                                                  uint32_t now_us) {
     int16_t ret;
 
-    ret = sensirion_i2c_write_cmd(SPS30_I2C_ADDRESS,
-                                  SPS_CMD_START_MANUAL_FAN_CLEANING);
+    if (sps30_dev_poll(dev, now_us))
+        return SPS30_ERR_NOT_READY;
+
+    ret = sps30_send_cmd(dev, SPS_CMD_START_MANUAL_FAN_CLEANING);
     if (ret)
         return ret;
 
-    sensirion_sleep_usec(SPS_CMD_DELAY_USEC);
+    sps30_set_busy(dev, now_us, SPS_CMD_DELAY_USEC);
     return 0;
 }
 
-int16_t sps30_reset(void) {
-    return sensirion_i2c_write_cmd(SPS30_I2C_ADDRESS, SPS_CMD_RESET);
+#endif /* SPS30_NO_FAN_CLEANING */
+
+#ifndef SPS30_NO_SLEEP
+
+int16_t sps30_dev_issue_sleep(struct sps30_dev* dev, uint32_t now_us) {
+    int16_t ret;
+
+    if (sps30_dev_poll(dev, now_us))
+        return SPS30_ERR_NOT_READY;
+
+    ret = sps30_send_sleep(dev);
+    if (ret)
+        return ret;
+
+    sps30_set_busy(dev, now_us, SPS_CMD_DELAY_USEC);
+    return 0;
 }
 
-int16_t sps30_sleep(void) {
+int16_t sps30_dev_issue_wake_up(struct sps30_dev* dev, uint32_t now_us) {
     int16_t ret;
 
-    ret = sensirion_i2c_write_cmd(SPS30_I2C_ADDRESS, SPS_CMD_SLEEP);
+    if (sps30_dev_poll(dev, now_us))
+        return SPS30_ERR_NOT_READY;
+
+    ret = sps30_send_wake_up(dev);
     if (ret)
         return ret;
 
-    sensirion_sleep_usec(SPS_CMD_DELAY_USEC);
+    sps30_set_busy(dev, now_us, SPS_CMD_DELAY_USEC);
     return 0;
 }
 
-int16_t sps30_wake_up(void) {
+#endif /* SPS30_NO_SLEEP */
+
+int16_t sps30_dev_issue_reset(struct sps30_dev* dev, uint32_t now_us) {
     int16_t ret;
 
-    /* wake-up must be sent twice within 100ms, ignore first return value */
-    (void)sensirion_i2c_write_cmd(SPS30_I2C_ADDRESS, SPS_CMD_WAKE_UP);
-    ret = sensirion_i2c_write_cmd(SPS30_I2C_ADDRESS, SPS_CMD_WAKE_UP);
+    if (sps30_dev_poll(dev, now_us))
+        return SPS30_ERR_NOT_READY;
+
+    ret = sps30_dev_reset(dev);
     if (ret)
         return ret;
 
-    sensirion_sleep_usec(SPS_CMD_DELAY_USEC);
+    dev->pending_cmd = 0;
+    sps30_set_busy(dev, now_us, SPS30_RESET_DELAY_USEC);
     return 0;
 }
 
-int16_t sps30_read_device_status_register(uint32_t* device_status_flags) {
+#ifdef SPS30_DELAYED_READS
+
+/**
+ * sps30_issue_read() - send the command of a delayed read and remember it as
+ * pending until the matching sps30_complete_read() call
+ */
+static int16_t sps30_issue_read(struct sps30_dev* dev, uint32_t now_us,
+                                uint16_t cmd) {
     int16_t ret;
-    uint16_t word_buf[2];
 
-    ret = sensirion_i2c_delayed_read_cmd(
-        SPS30_I2C_ADDRESS, SPS_CMD_READ_DEVICE_STATUS_REG, SPS_CMD_DELAY_USEC,
-        word_buf, SENSIRION_NUM_WORDS(word_buf));
+    if (sps30_dev_poll(dev, now_us))
+        return SPS30_ERR_NOT_READY;
+
+    ret = sps30_send_cmd(dev, cmd);
     if (ret)
         return ret;
 
-    *device_status_flags = (((uint32_t)word_buf[0]) << 16) | word_buf[1];
+    dev->pending_cmd = cmd;
+    sps30_set_busy(dev, now_us, SPS_CMD_DELAY_USEC);
     return 0;
 }
+
+/**
+ * sps30_complete_read() - check that the delayed read of cmd was issued and
+ * that the data is ready to be read
+ */
+static int16_t sps30_complete_read(struct sps30_dev* dev, uint32_t now_us,
+                                   uint16_t cmd) {
+    if (dev->pending_cmd != cmd)
+        return SPS30_ERR_NOT_ISSUED;
+
+    if (sps30_dev_poll(dev, now_us))
+        return SPS30_ERR_NOT_READY;
+
+    dev->pending_cmd = 0;
+    return 0;
+}
+
+#endif /* SPS30_DELAYED_READS */
+
+#ifndef SPS30_NO_FAN_CLEANING
+
+int16_t sps30_dev_issue_get_fan_auto_cleaning_interval(struct sps30_dev* dev,
+                                                       uint32_t now_us) {
+    return sps30_issue_read(dev, now_us, SPS_CMD_AUTOCLEAN_INTERVAL);
+}
+
+int16_t sps30_dev_complete_get_fan_auto_cleaning_interval(
+    struct sps30_dev* dev, uint32_t now_us, uint32_t* interval_seconds) {
+    int16_t ret;
+
+    ret = sps30_complete_read(dev, now_us, SPS_CMD_AUTOCLEAN_INTERVAL);
+    if (ret)
+        return ret;
+
+    return sps30_read_fan_auto_cleaning_interval(dev, interval_seconds);
+}
+
+#endif /* SPS30_NO_FAN_CLEANING */
+
+#ifndef SPS30_NO_STATUS_REGISTER
+
+int16_t sps30_dev_issue_read_device_status_register(struct sps30_dev* dev,
+                                                    uint32_t now_us) {
+    return sps30_issue_read(dev, now_us, SPS_CMD_READ_DEVICE_STATUS_REG);
+}
+
+int16_t sps30_dev_complete_read_device_status_register(
+    struct sps30_dev* dev, uint32_t now_us, uint32_t* device_status_flags) {
+    int16_t ret;
+
+    ret = sps30_complete_read(dev, now_us, SPS_CMD_READ_DEVICE_STATUS_REG);
+    if (ret)
+        return ret;
+
+    return sps30_read_device_status_flags(dev, device_status_flags);
+}
+
+#endif /* SPS30_NO_STATUS_REGISTER */
+
+#ifdef SPS30_STATS
+
+void sps30_dev_get_stats(struct sps30_dev* dev, struct sps30_stats* stats) {
+    sps30_stats_commit(&dev->stats);
+    *stats = dev->stats;
+}
+
+void sps30_dev_reset_stats(struct sps30_dev* dev) {
+    uint8_t i;
+    uint8_t j;
+
+    for (i = 0; i < SPS30_STATS_NUM_CMDS; ++i) {
+        dev->stats.cmd[i].calls = 0;
+        dev->stats.cmd[i].nacks = 0;
+        dev->stats.cmd[i].crc_errors = 0;
+        dev->stats.cmd[i].latency_min_us = 0;
+        dev->stats.cmd[i].latency_max_us = 0;
+        for (j = 0; j < SPS30_STATS_NUM_BUCKETS; ++j)
+            dev->stats.cmd[i].latency_hist[j] = 0;
+    }
+    dev->stats.sleep_time_us = 0;
+    dev->stats.in_progress = 0;
+}
+
+uint32_t sps30_stats_latency_percentile(const struct sps30_cmd_stats* stats,
+                                        uint8_t percentile) {
+    uint32_t count = 0;
+    uint32_t rank;
+    uint8_t bucket;
+
+    if (!stats->calls)
+        return 0;
+
+    /* calls are counted when sent, a command in progress is not yet in the
+     * histogram */
+    for (bucket = 0; bucket < SPS30_STATS_NUM_BUCKETS; ++bucket)
+        count += stats->latency_hist[bucket];
+
+    rank = (uint32_t)(((uint64_t)count * percentile + 99) / 100);
+    count = 0;
+    for (bucket = 0; bucket < SPS30_STATS_NUM_BUCKETS - 1; ++bucket) {
+        count += stats->latency_hist[bucket];
+        if (count >= rank)
+            break;
+    }
+
+    if (bucket == SPS30_STATS_NUM_BUCKETS - 1)
+        return stats->latency_max_us;
+    /* upper bound of the bucket, but never more than the maximum */
+    if ((2UL << bucket) - 1 > stats->latency_max_us)
+        return stats->latency_max_us;
+    return (uint32_t)((2UL << bucket) - 1);
+}
+
+#endif /* SPS30_STATS */
+
+/**
+ * sps30_default() - the handle used by the functions without _dev infix
+ */
+static struct sps30_dev* sps30_default(void) {
+    if (!sps30_default_dev_initialized) {
+        sps30_dev_init(&sps30_default_dev, SPS30_BUS_DEFAULT,
+                       SPS30_I2C_ADDRESS);
+        sps30_default_dev_initialized = 1;
+    }
+    return &sps30_default_dev;
+}
+
+int16_t sps30_probe(void) {
+    return sps30_dev_probe(sps30_default());
+}
+
+#ifndef SPS30_NO_IDENTITY
+
+int16_t sps30_read_firmware_version(uint8_t* major, uint8_t* minor) {
+    return sps30_dev_read_firmware_version(sps30_default(), major, minor);
+}
+
+int16_t sps30_get_serial(char* serial) {
+    return sps30_dev_get_serial(sps30_default(), serial);
+}
+
+#endif /* SPS30_NO_IDENTITY */
+
+int16_t sps30_start_measurement(void) {
+    return sps30_dev_start_measurement(sps30_default());
+}
+
+int16_t sps30_stop_measurement(void) {
+    return sps30_dev_stop_measurement(sps30_default());
+}
+
+int16_t sps30_read_data_ready(uint16_t* data_ready) {
+    return sps30_dev_read_data_ready(sps30_default(), data_ready);
+}
+
+#ifndef SPS30_NO_FLOAT
+
+int16_t sps30_read_measurement(struct sps30_measurement* measurement) {
+    return sps30_dev_read_measurement(sps30_default(), measurement);
+}
+
+#endif /* SPS30_NO_FLOAT */
+
+int16_t sps30_set_measurement_format(uint16_t format) {
+    return sps30_dev_set_measurement_format(sps30_default(), format);
+}
+
+int16_t sps30_read_measurement_u16(struct sps30_measurement_u16* measurement) {
+    return sps30_dev_read_measurement_u16(sps30_default(), measurement);
+}
+
+#ifndef SPS30_NO_FAN_CLEANING
+
+int16_t sps30_get_fan_auto_cleaning_interval(uint32_t* interval_seconds) {
+    return sps30_dev_get_fan_auto_cleaning_interval(sps30_default(),
+                                                    interval_seconds);
+}
+
+int16_t sps30_set_fan_auto_cleaning_interval(uint32_t interval_seconds) {
+    return sps30_dev_set_fan_auto_cleaning_interval(sps30_default(),
+                                                    interval_seconds);
+}
+
+int16_t sps30_get_fan_auto_cleaning_interval_days(uint8_t* interval_days) {
+    return sps30_dev_get_fan_auto_cleaning_interval_days(sps30_default(),
+                                                         interval_days);
+}
+
+int16_t sps30_set_fan_auto_cleaning_interval_days(uint8_t interval_days) {
+    return sps30_dev_set_fan_auto_cleaning_interval_days(sps30_default(),
+                                                         interval_days);
+}
+
+int16_t sps30_start_manual_fan_cleaning(void) {
+    return sps30_dev_start_manual_fan_cleaning(sps30_default());
+}
+
+#endif /* SPS30_NO_FAN_CLEANING */
+
+int16_t sps30_reset(void) {
+    return sps30_dev_reset(sps30_default());
+}
+
+int16_t sps30_refresh_cache(void) {
+    return sps30_dev_refresh_cache(sps30_default());
+}
+
+#ifndef SPS30_NO_SLEEP
+
+int16_t sps30_sleep(void) {
+    return sps30_dev_sleep(sps30_default());
+}
+
+int16_t sps30_wake_up(void) {
+    return sps30_dev_wake_up(sps30_default());
+}
+
+#endif /* SPS30_NO_SLEEP */
+
+#ifndef SPS30_NO_STATUS_REGISTER
+
+int16_t sps30_read_device_status_register(uint32_t* device_status_flags) {
+    return sps30_dev_read_device_status_register(sps30_default(),
+                                                 device_status_flags);
+}
+
+#endif /* SPS30_NO_STATUS_REGISTER */
@@ -53,6 +53,234 @@ extern "C" {
 /** The fan speed is out of range */
 #define SPS30_DEVICE_STATUS_FAN_SPEED_WARNING (1 << 21)
 
+/** Leave the bus selection to the platform, do not call select_bus */
+#define SPS30_BUS_DEFAULT 0xff
+
+/** Last known operating state of a sensor, see struct sps30_dev */
+#define SPS30_STATE_UNKNOWN 0
+#define SPS30_STATE_IDLE 1
+#define SPS30_STATE_MEASURING 2
+#define SPS30_STATE_SLEEPING 3
+
+/** A previously issued command is still being processed by the sensor */
+#define SPS30_ERR_NOT_READY (-2)
+/** A command was completed without being issued first */
+#define SPS30_ERR_NOT_ISSUED (-3)
+/** The measurement is not available in the requested output format */
+#define SPS30_ERR_FORMAT (-4)
+/** The response of the sensor failed the CRC check */
+#define SPS30_ERR_CRC (-5)
+
+/** Measurement output formats, see sps30_dev_set_measurement_format() */
+#define SPS30_FORMAT_FLOAT 0x0300
+#define SPS30_FORMAT_UINT16 0x0500
+
+/*
+ * Feature selection
+ *
+ * Command groups which are not needed can be left out of the build to save
+ * flash on small targets, their functions are then not declared:
+ *
+ * SPS30_NO_FAN_CLEANING:     auto-cleaning interval and manual fan cleaning
+ * SPS30_NO_SLEEP:            sleep and wake-up (firmware >= 2.0)
+ * SPS30_NO_STATUS_REGISTER:  device status register (firmware >= 2.2)
+ * SPS30_NO_IDENTITY:         serial number and firmware version
+ * SPS30_NO_FLOAT:            float measurements; only SPS30_FORMAT_UINT16 is
+ *                            supported and the driver uses no floating point
+ *                            operations
+ * SPS30_NO_MUX:              I2C multiplexer support (struct sps30_mux)
+ *
+ * The sps-common modules which depend on a left out group are left out with
+ * it: sps30_duty with SPS30_NO_SLEEP or SPS30_NO_FLOAT, sps30_phase_poll() with
+ * SPS30_NO_FLOAT and sps30_monitor with SPS30_NO_STATUS_REGISTER.
+ *
+ * See CONFIG_SPS30_* in user_config.inc.
+ */
+
+/*
+ * CRC verification
+ *
+ * The CRCs of the responses are computed bit by bit by default, which needs no
+ * table. One of the following trades flash for a faster check:
+ *
+ * SPS30_CRC_NIBBLE:  16 byte table, two lookups per byte
+ * SPS30_CRC_TABLE:   256 byte table, one lookup per byte
+ * SPS30_CRC_SIMD:    64 bytes of tables, five words per lookup with SSSE3, one
+ *                    word per four lookups otherwise
+ *
+ * See CONFIG_SPS30_CRC in user_config.inc.
+ */
+
+#ifdef SPS30_STATS
+
+/* Command slots of struct sps30_stats */
+#define SPS30_STATS_CMD_START_MEASUREMENT 0
+#define SPS30_STATS_CMD_STOP_MEASUREMENT 1
+#define SPS30_STATS_CMD_READ_MEASUREMENT 2
+#define SPS30_STATS_CMD_READ_DATA_READY 3
+#define SPS30_STATS_CMD_AUTOCLEAN_INTERVAL 4
+#define SPS30_STATS_CMD_READ_FIRMWARE_VERSION 5
+#define SPS30_STATS_CMD_GET_SERIAL 6
+#define SPS30_STATS_CMD_RESET 7
+#define SPS30_STATS_CMD_SLEEP 8
+#define SPS30_STATS_CMD_WAKE_UP 9
+#define SPS30_STATS_CMD_READ_DEVICE_STATUS_REGISTER 10
+#define SPS30_STATS_CMD_START_MANUAL_FAN_CLEANING 11
+/* Any command without a slot of its own */
+#define SPS30_STATS_CMD_OTHER 12
+#define SPS30_STATS_NUM_CMDS 13
+
+/** Latency histogram buckets: bucket n counts latencies of 2^n..2^(n+1)-1us */
+#define SPS30_STATS_NUM_BUCKETS 16
+
+/**
+ * struct sps30_cmd_stats - statistics of a single command
+ *
+ * @calls:          Number of times the command was sent to the sensor
+ * @nacks:          Failed bus transfers (NACKs, bus errors)
+ * @crc_errors:     Responses which failed the CRC check
+ * @latency_min_us: Shortest latency
+ * @latency_max_us: Longest latency
+ * @latency_hist:   Latency histogram, see SPS30_STATS_NUM_BUCKETS
+ */
+struct sps30_cmd_stats {
+    uint32_t calls;
+    uint32_t nacks;
+    uint32_t crc_errors;
+    uint32_t latency_min_us;
+    uint32_t latency_max_us;
+    uint32_t latency_hist[SPS30_STATS_NUM_BUCKETS];
+};
+
+/**
+ * struct sps30_stats - per sensor instrumentation, enabled with SPS30_STATS
+ *
+ * The latency of a command spans from sending the command to the last bus
+ * transfer or driver sleep belonging to it, e.g. the response read of a
+ * non-blocking sps30_dev_complete_*() call.
+ *
+ * @cmd:            Statistics per command, indexed by SPS30_STATS_CMD_*
+ * @sleep_time_us:  Total time spent in sensirion_sleep_usec() by the driver
+ */
+struct sps30_stats {
+    struct sps30_cmd_stats cmd[SPS30_STATS_NUM_CMDS];
+    uint64_t sleep_time_us;
+    /* private */
+    uint8_t in_progress;
+    uint8_t cur_cmd;
+    uint32_t cmd_start_us;
+    uint32_t last_event_us;
+};
+
+#endif /* SPS30_STATS */
+
+/*
+ * Values which do not change while the sensor runs are read once and cached in
+ * the handle: the serial number, the firmware version and the fan
+ * auto-cleaning interval. The cached interval is dropped when a new interval is
+ * set; all cached values are dropped on reset and by sps30_dev_refresh_cache().
+ */
+#define SPS30_CACHED_SERIAL 0x01
+#define SPS30_CACHED_FIRMWARE_VERSION 0x02
+#define SPS30_CACHED_FAN_AUTO_CLEANING_INTERVAL 0x04
+
+#ifndef SPS30_NO_MUX
+
+/** Number of channels of a TCA9548A-style I2C multiplexer */
+#define SPS30_MUX_CHANNELS 8
+/** Channel of a sensor which is not connected through a multiplexer */
+#define SPS30_MUX_NO_CHANNEL 0xff
+
+/**
+ * struct sps30_mux - TCA9548A-style I2C multiplexer
+ *
+ * All SPS30 answer at SPS30_I2C_ADDRESS, so more than one sensor per bus is
+ * connected through the channels of a multiplexer. The control register of the
+ * multiplexer is a bit mask of the connected channels. Before talking to a
+ * sensor, the driver connects the sensor's channel only, and skips the write if
+ * that channel is still selected from the previous transfer.
+ *
+ * Multiplexers on the same bus are linked with the @peer argument of
+ * sps30_mux_init(). Before a channel of one of them is selected, the channels
+ * of the others are disconnected, so that two sensors at the same address are
+ * never connected at the same time. After a failed transfer the selection is
+ * considered unknown and written again on the next transfer.
+ *
+ * Initialize with sps30_mux_init(). Besides the fields below, which may be
+ * read, the members are private.
+ *
+ * @bus:        Bus index of the multiplexer, as for struct sps30_dev
+ * @address:    I2C address of the multiplexer, 0x70 to 0x77 for the TCA9548A
+ * @switches:   Number of writes to the control register
+ */
+struct sps30_mux {
+    uint8_t bus;
+    uint8_t address;
+    uint8_t selected;
+    uint32_t switches;
+    struct sps30_mux* next;
+};
+
+#endif /* SPS30_NO_MUX */
+
+/**
+ * struct sps30_dev - handle of a single SPS30 sensor
+ *
+ * Initialize with sps30_dev_init() and pass it to the sps30_dev_*() functions.
+ * The members are maintained by the driver and must not be modified directly.
+ *
+ * @bus:        Bus index passed to sensirion_i2c_select_bus() before each
+ *              command, or SPS30_BUS_DEFAULT to use the current bus. When
+ *              sensors on several buses are used, every handle needs an
+ *              explicit bus index.
+ * @address:    I2C address of the sensor
+ * @state:      Last known operating state (SPS30_STATE_*), updated on
+ *              successful state-changing commands
+ * @pending_cmd: Command issued with sps30_dev_issue_*() which still awaits its
+ *              sps30_dev_complete_*() call, 0 if none
+ * @cmd_issued_us: Time at which the last non-blocking command was issued
+ * @cmd_delay_us: Processing time of the last non-blocking command, 0 once the
+ *              sensor is ready for the next command
+ * @format:     Output format (SPS30_FORMAT_*) used on the next measurement
+ *              start
+ * @active_format: Output format of the running measurement
+ * @cached:     SPS30_CACHED_* flags of the valid cached values below
+ * @serial:     Cached serial number
+ * @firmware_major: Cached firmware major version
+ * @firmware_minor: Cached firmware minor version
+ * @fan_auto_cleaning_interval: Cached auto-cleaning interval in seconds
+ * @mux:        Multiplexer the sensor is connected through, NULL if none, see
+ *              sps30_dev_set_mux()
+ * @mux_channel: Channel of the sensor on @mux
+ * @stats:      Instrumentation, only with SPS30_STATS defined
+ */
+struct sps30_dev {
+    uint8_t bus;
+    uint8_t address;
+    uint8_t state;
+    uint16_t pending_cmd;
+    uint32_t cmd_issued_us;
+    uint32_t cmd_delay_us;
+    uint16_t format;
+    uint16_t active_format;
+    uint8_t cached;
+#ifndef SPS30_NO_IDENTITY
+    char serial[SPS30_MAX_SERIAL_LEN];
+    uint8_t firmware_major;
+    uint8_t firmware_minor;
+#endif
+#ifndef SPS30_NO_FAN_CLEANING
+    uint32_t fan_auto_cleaning_interval;
+#endif
+#ifndef SPS30_NO_MUX
+    struct sps30_mux* mux;
+    uint8_t mux_channel;
+#endif
+#ifdef SPS30_STATS
+    struct sps30_stats stats;
+#endif
+};
+
 struct sps30_measurement {
     float mc_1p0;
     float mc_2p5;
@@ -66,6 +294,26 @@ struct sps30_measurement {
     float typical_particle_size;
 };
 
+/**
+ * struct sps30_measurement_u16 - measurement in the SPS30_FORMAT_UINT16 format
+ *
+ * Mass concentrations are in ug/m^3, number concentrations in #/cm^3 and the
+ * typical particle size is in nm (instead of um as in struct
+ * sps30_measurement).
+ */
+struct sps30_measurement_u16 {
+    uint16_t mc_1p0;
+    uint16_t mc_2p5;
+    uint16_t mc_4p0;
+    uint16_t mc_10p0;
+    uint16_t nc_0p5;
+    uint16_t nc_1p0;
+    uint16_t nc_2p5;
+    uint16_t nc_4p0;
+    uint16_t nc_10p0;
+    uint16_t typical_particle_size;
+};
+
 /**
  * sps_get_driver_version() - Return the driver version
  * Return:  Driver version string
@@ -79,12 +327,20 @@ const char* sps_get_driver_version(void);
  * mode (this driver). When left floating, the sensor operates in UART mode
  * which is not compatible with this i2c driver.
  *
+ * The first probe reads the serial number into the cache, later probes only
+ * check the sensor's presence with a (shorter) firmware version read.
+ *
  * Return:  0 on success, an error code otherwise
  */
 int16_t sps30_probe(void);
 
+#ifndef SPS30_NO_IDENTITY
 /**
  * sps30_read_firmware_version - read the firmware version
+ *
+ * The version is read from the sensor only once, later calls return the
+ * cached value.
+ *
  * @major:  Memory where the firmware major version is written into
  * @minor:  Memory where the firmware minor version is written into
  *
@@ -95,6 +351,9 @@ int16_t sps30_read_firmware_version(uint8_t* major, uint8_t* minor);
 /**
  * sps30_get_serial() - retrieve the serial number
  *
+ * The serial number is read from the sensor only once, later calls return the
+ * cached value.
+ *
  * Note that serial must be discarded when the return code is non-zero.
  *
  * @serial: Memory where the serial number is written into as hex string (zero
@@ -102,6 +361,7 @@ int16_t sps30_read_firmware_version(uint8_t* major, uint8_t* minor);
  * Return:  0 on success, an error code otherwise
  */
 int16_t sps30_get_serial(char* serial);
+#endif /* SPS30_NO_IDENTITY */
 
 /**
  * sps30_start_measurement() - start measuring
@@ -133,6 +393,7 @@ int16_t sps30_stop_measurement(void);
  */
 int16_t sps30_read_data_ready(uint16_t* data_ready);
 
+#ifndef SPS30_NO_FLOAT
 /**
  * sps30_read_measurement() - read a measurement
  *
@@ -141,11 +402,44 @@ int16_t sps30_read_data_ready(uint16_t* data_ready);
  * Return:  0 on success, an error code otherwise
  */
 int16_t sps30_read_measurement(struct sps30_measurement* measurement);
+#endif /* SPS30_NO_FLOAT */
+
+/**
+ * sps30_set_measurement_format() - select the measurement output format
+ *
+ * The format is applied on the next sps30_start_measurement(). The default is
+ * SPS30_FORMAT_FLOAT. With SPS30_FORMAT_UINT16 the sensor transfers half the
+ * amount of data per measurement which can be read without any floating point
+ * operations with sps30_read_measurement_u16(). sps30_read_measurement() works
+ * with both formats, integer values are converted to float.
+ *
+ * With SPS30_NO_FLOAT, SPS30_FORMAT_UINT16 is the default and the only
+ * supported format.
+ *
+ * @format: SPS30_FORMAT_FLOAT or SPS30_FORMAT_UINT16
+ * Return:  0 on success, SPS30_ERR_FORMAT if the format is not supported
+ */
+int16_t sps30_set_measurement_format(uint16_t format);
+
+/**
+ * sps30_read_measurement_u16() - read a measurement in integer format
+ *
+ * Read the last measurement. The measurement must have been started with the
+ * SPS30_FORMAT_UINT16 output format.
+ *
+ * Return:  0 on success, SPS30_ERR_FORMAT if the measurement runs in float
+ *          format, an error code otherwise
+ */
+int16_t sps30_read_measurement_u16(struct sps30_measurement_u16* measurement);
 
+#ifndef SPS30_NO_FAN_CLEANING
 /**
  * sps30_get_fan_auto_cleaning_interval() - read the current(*) auto-cleaning
  * interval
  *
+ * The interval is read from the sensor only once and cached until it is set
+ * or the sensor is reset.
+ *
  * Note that interval_seconds must be discarded when the return code is
  * non-zero.
  *
@@ -210,6 +504,7 @@ int16_t sps30_set_fan_auto_cleaning_interval_days(uint8_t interval_days);
  * Return:          0 on success, an error code otherwise
  */
 int16_t sps30_start_manual_fan_cleaning(void);
+#endif /* SPS30_NO_FAN_CLEANING */
 
 /**
  * sps30_reset() - reset the SGP30
@@ -225,10 +520,23 @@ int16_t sps30_start_manual_fan_cleaning(void);
  * must be pulled to ground during the reset period for the sensor to remain in
  * i2c mode.
  *
+ * All cached values are dropped.
+ *
  * Return:          0 on success, an error code otherwise
  */
 int16_t sps30_reset(void);
 
+/**
+ * sps30_refresh_cache() - re-read the cached serial number, firmware version
+ * and auto-cleaning interval
+ *
+ * E.g. after the sensor was replaced. The cache is empty if reading fails.
+ *
+ * Return:          0 on success, an error code otherwise
+ */
+int16_t sps30_refresh_cache(void);
+
+#ifndef SPS30_NO_SLEEP
 /**
  * sps30_sleep() - Send the (idle) sensor to sleep
  *
@@ -252,7 +560,9 @@ int16_t sps30_sleep(void);
  *                  does not support the command)
  */
 int16_t sps30_wake_up(void);
+#endif /* SPS30_NO_SLEEP */
 
+#ifndef SPS30_NO_STATUS_REGISTER
 /**
  * sps30_read_device_status_register() - Read the Device Status Register
  *
@@ -268,6 +578,388 @@ int16_t sps30_wake_up(void);
  *                  does not support the command)
  */
 int16_t sps30_read_device_status_register(uint32_t* device_status_flags);
+#endif /* SPS30_NO_STATUS_REGISTER */
+
+/**
+ * sps30_dev_init() - initialize a sensor handle
+ *
+ * No bus communication takes place, call sps30_dev_probe() afterwards.
+ *
+ * @dev:        Handle to initialize
+ * @bus:        Bus index of the sensor or SPS30_BUS_DEFAULT
+ * @address:    I2C address of the sensor, usually SPS30_I2C_ADDRESS
+ */
+void sps30_dev_init(struct sps30_dev* dev, uint8_t bus, uint8_t address);
+
+#ifndef SPS30_NO_MUX
+/**
+ * sps30_mux_init() - initialize a multiplexer
+ *
+ * No bus communication takes place, the channels are disconnected before the
+ * first sensor behind the multiplexer is accessed.
+ *
+ * @mux:        Multiplexer to initialize
+ * @bus:        Bus index of the multiplexer or SPS30_BUS_DEFAULT
+ * @address:    I2C address of the multiplexer
+ * @peer:       An initialized multiplexer on the same bus, NULL for the first
+ *              one
+ * Return:      0 on success, STATUS_FAIL if @peer is on another bus; the
+ *              multiplexer is initialized without a peer then
+ */
+int16_t sps30_mux_init(struct sps30_mux* mux, uint8_t bus, uint8_t address,
+                       struct sps30_mux* peer);
+
+/**
+ * sps30_dev_set_mux() - connect a sensor through a multiplexer channel
+ *
+ * The bus of the sensor must be the bus of the multiplexer.
+ *
+ * @dev:        Sensor handle
+ * @mux:        Multiplexer, NULL if the sensor is connected directly
+ * @channel:    Channel of the sensor, 0 to SPS30_MUX_CHANNELS - 1
+ * Return:      0 on success, STATUS_FAIL if the channel is out of range or the
+ *              bus does not match
+ */
+int16_t sps30_dev_set_mux(struct sps30_dev* dev, struct sps30_mux* mux,
+                          uint8_t channel);
+
+/**
+ * sps30_mux_release() - disconnect all channels of a multiplexer and the
+ * multiplexers on the same bus
+ *
+ * Required only when other code talks to the bus, e.g. to devices behind the
+ * multiplexers which are not managed by this driver.
+ *
+ * Return:  0 on success, an error code otherwise
+ */
+int16_t sps30_mux_release(struct sps30_mux* mux);
+
+/**
+ * sps30_mux_invalidate() - forget the selected channels of a multiplexer and
+ * the multiplexers on the same bus
+ *
+ * Call this when the multiplexers may have been reset or switched by other
+ * code. The selection is written again on the next transfer.
+ */
+void sps30_mux_invalidate(struct sps30_mux* mux);
+#endif /* SPS30_NO_MUX */
+
+/*
+ * Handle based variants of the functions above. They behave exactly like the
+ * function without the _dev infix but address the sensor described by @dev
+ * instead of the sensor at SPS30_I2C_ADDRESS on the default bus.
+ */
+int16_t sps30_dev_probe(struct sps30_dev* dev);
+#ifndef SPS30_NO_IDENTITY
+int16_t sps30_dev_read_firmware_version(struct sps30_dev* dev, uint8_t* major,
+                                        uint8_t* minor);
+int16_t sps30_dev_get_serial(struct sps30_dev* dev, char* serial);
+#endif /* SPS30_NO_IDENTITY */
+int16_t sps30_dev_start_measurement(struct sps30_dev* dev);
+int16_t sps30_dev_stop_measurement(struct sps30_dev* dev);
+int16_t sps30_dev_read_data_ready(struct sps30_dev* dev, uint16_t* data_ready);
+#ifndef SPS30_NO_FLOAT
+int16_t sps30_dev_read_measurement(struct sps30_dev* dev,
+                                   struct sps30_measurement* measurement);
+#endif /* SPS30_NO_FLOAT */
+int16_t sps30_dev_set_measurement_format(struct sps30_dev* dev,
+                                         uint16_t format);
+int16_t sps30_dev_read_measurement_u16(
+    struct sps30_dev* dev, struct sps30_measurement_u16* measurement);
+#ifndef SPS30_NO_FAN_CLEANING
+int16_t sps30_dev_get_fan_auto_cleaning_interval(struct sps30_dev* dev,
+                                                 uint32_t* interval_seconds);
+int16_t sps30_dev_set_fan_auto_cleaning_interval(struct sps30_dev* dev,
+                                                 uint32_t interval_seconds);
+int16_t sps30_dev_get_fan_auto_cleaning_interval_days(struct sps30_dev* dev,
+                                                      uint8_t* interval_days);
+int16_t sps30_dev_set_fan_auto_cleaning_interval_days(struct sps30_dev* dev,
+                                                      uint8_t interval_days);
+int16_t sps30_dev_start_manual_fan_cleaning(struct sps30_dev* dev);
+#endif /* SPS30_NO_FAN_CLEANING */
+int16_t sps30_dev_reset(struct sps30_dev* dev);
+int16_t sps30_dev_refresh_cache(struct sps30_dev* dev);
+#ifndef SPS30_NO_SLEEP
+int16_t sps30_dev_sleep(struct sps30_dev* dev);
+int16_t sps30_dev_wake_up(struct sps30_dev* dev);
+#endif /* SPS30_NO_SLEEP */
+#ifndef SPS30_NO_STATUS_REGISTER
+int16_t sps30_dev_read_device_status_register(struct sps30_dev* dev,
+                                              uint32_t* device_status_flags);
+#endif /* SPS30_NO_STATUS_REGISTER */
+
+/*
+ * Non-blocking API
+ *
+ * The functions above block in sensirion_sleep_usec() while the sensor
+ * processes a command. The sps30_dev_issue_*() functions below only send the
+ * command and record when the sensor will be ready again, so that a single
+ * thread can interleave commands to many sensors. All times are given in
+ * microseconds of an arbitrary free-running clock supplied by the caller
+ * (@now_us). Wrap-around of the clock is handled as long as the sensor is
+ * polled at least once every 2^31 microseconds.
+ *
+ * Issuing a command while the previous one is still being processed fails with
+ * SPS30_ERR_NOT_READY. A command which could not be sent does not mark the
+ * sensor busy, it can be retried right away. Commands returning data are split
+ * into an issue and a complete call; the complete call fails with
+ * SPS30_ERR_NOT_READY if called too early and with SPS30_ERR_NOT_ISSUED if the
+ * command was not issued before or if any other command was sent since.
+ *
+ * Typical usage:
+ *
+ *     sps30_dev_issue_start_measurement(&dev, now());
+ *     ...
+ *     if (sps30_dev_poll(&dev, now()) == 0)
+ *         sps30_dev_issue_read_device_status_register(&dev, now());
+ *     ...
+ *     ret = sps30_dev_complete_read_device_status_register(&dev, now(),
+ *                                                          &flags);
+ */
+
+/**
+ * sps30_dev_poll() - check whether the sensor is ready for the next command
+ *
+ * @dev:    Sensor handle
+ * @now_us: Current time
+ * Return:  0 if the sensor is ready, the remaining microseconds otherwise
+ */
+uint32_t sps30_dev_poll(struct sps30_dev* dev, uint32_t now_us);
+
+/**
+ * sps30_dev_ready_at() - time at which the last issued command has completed
+ *
+ * @dev:    Sensor handle
+ * Return:  Time (on the caller's clock) at which the sensor is ready for the
+ *          next command
+ */
+uint32_t sps30_dev_ready_at(const struct sps30_dev* dev);
+
+int16_t sps30_dev_issue_start_measurement(struct sps30_dev* dev,
+                                          uint32_t now_us);
+int16_t sps30_dev_issue_stop_measurement(struct sps30_dev* dev,
+                                         uint32_t now_us);
+#ifndef SPS30_NO_FAN_CLEANING
+int16_t sps30_dev_issue_set_fan_auto_cleaning_interval(
+    struct sps30_dev* dev, uint32_t now_us, uint32_t interval_seconds);
+int16_t sps30_dev_issue_start_manual_fan_cleaning(struct sps30_dev* dev,
+                                                  uint32_t now_us);
+#endif /* SPS30_NO_FAN_CLEANING */
+#ifndef SPS30_NO_SLEEP
+int16_t sps30_dev_issue_sleep(struct sps30_dev* dev, uint32_t now_us);
+int16_t sps30_dev_issue_wake_up(struct sps30_dev* dev, uint32_t now_us);
+#endif /* SPS30_NO_SLEEP */
+
+/**
+ * sps30_dev_issue_reset() - non-blocking sps30_reset()
+ *
+ * Unlike sps30_reset(), the sensor is only reported ready after
+ * SPS30_RESET_DELAY_USEC.
+ */
+int16_t sps30_dev_issue_reset(struct sps30_dev* dev, uint32_t now_us);
+
+#ifndef SPS30_NO_FAN_CLEANING
+int16_t sps30_dev_issue_get_fan_auto_cleaning_interval(struct sps30_dev* dev,
+                                                       uint32_t now_us);
+int16_t sps30_dev_complete_get_fan_auto_cleaning_interval(
+    struct sps30_dev* dev, uint32_t now_us, uint32_t* interval_seconds);
+#endif /* SPS30_NO_FAN_CLEANING */
+
+#ifndef SPS30_NO_STATUS_REGISTER
+int16_t sps30_dev_issue_read_device_status_register(struct sps30_dev* dev,
+                                                    uint32_t now_us);
+int16_t sps30_dev_complete_read_device_status_register(
+    struct sps30_dev* dev, uint32_t now_us, uint32_t* device_status_flags);
+#endif /* SPS30_NO_STATUS_REGISTER */
+
+/*
+ * Raw measurement frames
+ *
+ * For transfers done outside of the driver, e.g. one bus transaction reading
+ * several sensors, the response to the read measurement command (data words
+ * with their CRCs, as received on the bus) can be decoded separately.
+ */
+
+/** Size of the largest read measurement response (SPS30_FORMAT_FLOAT) */
+#define SPS30_MEASUREMENT_FRAME_SIZE 60
+
+/**
+ * sps30_check_crcs() - check the CRCs of a response as received on the bus
+ *
+ * @frame:      Data words, each followed by its CRC
+ * @num_words:  Number of data words in the frame
+ * Return:      0 if all CRCs match, SPS30_ERR_CRC otherwise
+ */
+int16_t sps30_check_crcs(const uint8_t* frame, uint16_t num_words);
+
+/**
+ * sps30_dev_measurement_frame_size() - size of the read measurement response
+ * in the active output format
+ */
+uint16_t sps30_dev_measurement_frame_size(const struct sps30_dev* dev);
+
+#ifndef SPS30_NO_FLOAT
+/**
+ * sps30_dev_decode_measurement() - decode a read measurement response
+ *
+ * @dev:            Sensor handle, determines the output format
+ * @frame:          sps30_dev_measurement_frame_size() bytes as received
+ * @measurement:    Memory where the measurement is stored
+ * Return:          0 on success, SPS30_ERR_CRC on a CRC mismatch
+ */
+int16_t sps30_dev_decode_measurement(const struct sps30_dev* dev,
+                                     const uint8_t* frame,
+                                     struct sps30_measurement* measurement);
+#endif /* SPS30_NO_FLOAT */
+
+/** Payload of the largest read measurement response the build supports */
+#ifdef SPS30_NO_FLOAT
+#define SPS30_FRAME_DECODER_DATA_SIZE 20
+#else
+#define SPS30_FRAME_DECODER_DATA_SIZE 40
+#endif
+
+/**
+ * struct sps30_frame_decoder - incremental decoder of a read measurement
+ * response
+ *
+ * Takes the response in chunks as they are received, e.g. from an I2C
+ * interrupt or a DMA half-transfer callback, and checks the CRC of every word
+ * as soon as it is complete. It never blocks or touches the bus, so it may be
+ * fed from interrupt context. Reinitialize it for every frame.
+ *
+ * Besides the fields below, which may be read, the members are private.
+ *
+ * @format:     Output format the frame is decoded in
+ * @received:   Bytes of the frame fed so far
+ * @status:     SPS30_ERR_NOT_READY while bytes are missing, 0 once the frame
+ *              is complete, SPS30_ERR_CRC after a CRC mismatch
+ */
+struct sps30_frame_decoder {
+    uint16_t format;
+    uint8_t received;
+    int16_t status;
+    uint8_t length;
+    uint8_t word_byte;
+    uint8_t data[SPS30_FRAME_DECODER_DATA_SIZE];
+};
+
+/**
+ * sps30_frame_decoder_init() - prepare the decoding of a read measurement
+ * response
+ *
+ * @decoder:    Decoder state
+ * @dev:        Sensor handle, determines the output format
+ */
+void sps30_frame_decoder_init(struct sps30_frame_decoder* decoder,
+                              const struct sps30_dev* dev);
+
+/**
+ * sps30_frame_decoder_feed() - feed the next bytes of the response
+ *
+ * Bytes past the end of the frame and after a CRC mismatch are ignored. On a
+ * mismatch the rest of the transfer may be aborted.
+ *
+ * @decoder:    Decoder state
+ * @data:       Bytes as received on the bus
+ * @count:      Number of bytes, may be 0
+ * Return:      The decoder's status: SPS30_ERR_NOT_READY while bytes are
+ *              missing, 0 once the frame is complete, SPS30_ERR_CRC after a
+ *              CRC mismatch
+ */
+int16_t sps30_frame_decoder_feed(struct sps30_frame_decoder* decoder,
+                                 const uint8_t* data, uint16_t count);
+
+/**
+ * sps30_frame_decoder_get_u16() - get the measurement of a complete frame in
+ * SPS30_FORMAT_UINT16
+ *
+ * Return:  0 on success, SPS30_ERR_FORMAT if the frame is in another format,
+ *          the decoder's status if the frame is incomplete or corrupt
+ */
+int16_t
+sps30_frame_decoder_get_u16(const struct sps30_frame_decoder* decoder,
+                            struct sps30_measurement_u16* measurement);
+
+#ifndef SPS30_NO_FLOAT
+/**
+ * sps30_frame_decoder_get() - get the measurement of a complete frame
+ *
+ * Return:  0 on success, the decoder's status if the frame is incomplete or
+ *          corrupt
+ */
+int16_t sps30_frame_decoder_get(const struct sps30_frame_decoder* decoder,
+                                struct sps30_measurement* measurement);
+#endif /* SPS30_NO_FLOAT */
+
+#ifdef SPS30_I2C_WRITE_READ
+
+/**
+ * sps30_i2c_write_read() - send a command and read the response in one
+ * transfer
+ *
+ * Must be implemented by the platform when the driver is compiled with
+ * SPS30_I2C_WRITE_READ defined (CONFIG_SPS30_I2C_WRITE_READ = y in
+ * user_config.inc). The driver then uses it instead of separate
+ * sensirion_i2c_write() and sensirion_i2c_read() calls for the commands the
+ * sensor answers without processing time: read measurement, data-ready flag,
+ * serial number and firmware version.
+ *
+ * @address:    I2C address
+ * @tx:         Command bytes to write
+ * @tx_count:   Number of bytes to write
+ * @rx:         Memory for the response
+ * @rx_count:   Number of bytes to read
+ * Return:      0 on success, an error code otherwise
+ */
+int8_t sps30_i2c_write_read(uint8_t address, const uint8_t* tx,
+                            uint16_t tx_count, uint8_t* rx, uint16_t rx_count);
+
+#endif /* SPS30_I2C_WRITE_READ */
+
+#ifdef SPS30_STATS
+
+/*
+ * Instrumentation
+ *
+ * When the driver is compiled with SPS30_STATS defined (CONFIG_SPS30_STATS = y
+ * in user_config.inc), every sensor handle records call counts, errors and
+ * latencies per command. Without SPS30_STATS neither code nor memory is spent
+ * on it.
+ */
+
+/**
+ * sps30_stats_get_time_usec() - monotonic time used for latency measurements
+ *
+ * Must be implemented by the platform when SPS30_STATS is defined. The clock
+ * may wrap around.
+ *
+ * Return:  Current time in microseconds
+ */
+uint32_t sps30_stats_get_time_usec(void);
+
+/**
+ * sps30_dev_get_stats() - take a snapshot of the statistics of a sensor
+ */
+void sps30_dev_get_stats(struct sps30_dev* dev, struct sps30_stats* stats);
+
+/**
+ * sps30_dev_reset_stats() - clear the statistics of a sensor
+ */
+void sps30_dev_reset_stats(struct sps30_dev* dev);
+
+/**
+ * sps30_stats_latency_percentile() - estimate a latency percentile
+ *
+ * @stats:      Statistics of a command, e.g. from sps30_dev_get_stats()
+ * @percentile: Percentile to estimate (0..100)
+ * Return:      Upper bound in microseconds of the histogram bucket holding the
+ *              percentile, capped to the maximum latency
+ */
+uint32_t sps30_stats_latency_percentile(const struct sps30_cmd_stats* stats,
+                                        uint8_t percentile);
+
+#endif /* SPS30_STATS */
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,550 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SPS30_HPP
+#define SPS30_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include "sensirion_arch_config.h"
+#include "sensirion_common.h"
+#include "sensirion_i2c.h"
+#include "sps30.h"
+#include "sps30_commands.h"
+
+/*
+ * Header-only C++17 interface
+ *
+ * sps30::Sps30<Bus> drives one sensor through a bus policy class which is
+ * known at compile time, so the compiler can inline the whole path from the
+ * call to the bus transfer. It does not need sps30.c and shares only the
+ * constants and measurement structs of sps30.h and the command ids of
+ * sps30_commands.h with the C driver.
+ *
+ * A bus policy provides
+ *
+ *     int16_t write(uint8_t address, const uint8_t* data, uint16_t count);
+ *     int16_t read(uint8_t address, uint8_t* data, uint16_t count);
+ *     void sleep_usec(uint32_t useconds);
+ *
+ * and optionally
+ *
+ *     int16_t write_read(uint8_t address, const uint8_t* tx,
+ *                        uint16_t tx_count, uint8_t* rx, uint16_t rx_count);
+ *
+ * which is then used for commands with an immediate response.
+ * sps30::SensirionI2cBus forwards to the sensirion_i2c.h implementation
+ * (hw_i2c, sw_i2c, sps30-linux/sps30_linux_i2c.c or the test simulator),
+ * sps30-linux/sps30_linux_bus.hpp talks to an i2c-dev file descriptor
+ * directly. A mock for tests only needs the three members above.
+ *
+ * Errors are reported as in the C driver: 0 on success, SPS30_ERR_* or the
+ * error code of the bus otherwise. Functions returning data return a
+ * Result<T> holding the error code and the value, which is only valid if the
+ * error code is 0.
+ */
+
+namespace sps30 {
+
+/**
+ * struct Command - command id and the time the sensor needs to process it
+ *
+ * @code:       Command id sent to the sensor
+ * @delay_us:   For commands with a response the time before the response can
+ *              be read, for all others the time before the next command
+ */
+struct Command {
+    uint16_t code;
+    uint32_t delay_us;
+};
+
+namespace command {
+
+inline constexpr Command start_measurement{SPS_CMD_START_MEASUREMENT,
+                                           SPS_CMD_START_STOP_DELAY_USEC};
+inline constexpr Command stop_measurement{SPS_CMD_STOP_MEASUREMENT,
+                                          SPS_CMD_START_STOP_DELAY_USEC};
+inline constexpr Command read_measurement{SPS_CMD_READ_MEASUREMENT, 0};
+inline constexpr Command read_data_ready{SPS_CMD_GET_DATA_READY, 0};
+inline constexpr Command get_fan_auto_cleaning_interval{
+    SPS_CMD_AUTOCLEAN_INTERVAL, SPS_CMD_DELAY_USEC};
+inline constexpr Command set_fan_auto_cleaning_interval{
+    SPS_CMD_AUTOCLEAN_INTERVAL, SPS_CMD_DELAY_WRITE_FLASH_USEC};
+inline constexpr Command start_manual_fan_cleaning{
+    SPS_CMD_START_MANUAL_FAN_CLEANING, SPS_CMD_DELAY_USEC};
+inline constexpr Command read_firmware_version{SPS_CMD_GET_FIRMWARE_VERSION,
+                                               0};
+inline constexpr Command get_serial{SPS_CMD_GET_SERIAL, 0};
+inline constexpr Command reset{SPS_CMD_RESET, SPS30_RESET_DELAY_USEC};
+inline constexpr Command sleep{SPS_CMD_SLEEP, SPS_CMD_DELAY_USEC};
+inline constexpr Command wake_up{SPS_CMD_WAKE_UP, SPS_CMD_DELAY_USEC};
+inline constexpr Command read_device_status_register{
+    SPS_CMD_READ_DEVICE_STATUS_REG, SPS_CMD_DELAY_USEC};
+
+}  // namespace command
+
+/** CRC-8 of the data words, see sensirion_common_generate_crc() */
+constexpr uint8_t crc8(const uint8_t* data, std::size_t count) {
+    uint8_t crc = CRC8_INIT;
+
+    for (std::size_t i = 0; i < count; ++i) {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; ++bit) {
+            if (crc & 0x80)
+                crc = static_cast<uint8_t>((crc << 1) ^ CRC8_POLYNOMIAL);
+            else
+                crc = static_cast<uint8_t>(crc << 1);
+        }
+    }
+    return crc;
+}
+
+constexpr uint8_t crc8(uint16_t word) {
+    const uint8_t data[] = {static_cast<uint8_t>(word >> 8),
+                            static_cast<uint8_t>(word & 0xff)};
+    return crc8(data, sizeof(data));
+}
+
+static_assert(crc8(0xbeef) == 0x92, "CRC-8 example of the datasheet");
+
+constexpr uint16_t bytes_to_uint16(const uint8_t* bytes) {
+    return static_cast<uint16_t>((bytes[0] << 8) | bytes[1]);
+}
+
+constexpr uint32_t bytes_to_uint32(const uint8_t* bytes) {
+    return (static_cast<uint32_t>(bytes[0]) << 24) |
+           (static_cast<uint32_t>(bytes[1]) << 16) |
+           (static_cast<uint32_t>(bytes[2]) << 8) |
+           static_cast<uint32_t>(bytes[3]);
+}
+
+inline float bytes_to_float(const uint8_t* bytes) {
+    const uint32_t bits = bytes_to_uint32(bytes);
+    float value;
+
+    static_assert(sizeof(value) == sizeof(bits), "32 bit float");
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/** Number of bytes on the bus for num_words data words with their CRCs */
+constexpr std::size_t frame_size(std::size_t num_words) {
+    return num_words * (SENSIRION_WORD_SIZE + CRC8_LEN);
+}
+
+template <typename T> struct Result {
+    int16_t error;
+    T value;
+
+    constexpr bool ok() const noexcept {
+        return error == NO_ERROR;
+    }
+};
+
+struct FirmwareVersion {
+    uint8_t major;
+    uint8_t minor;
+};
+
+using Serial = std::array<char, SPS30_MAX_SERIAL_LEN>;
+
+/** has_write_read<Bus>::value - whether Bus supports combined transfers */
+template <typename Bus, typename = void>
+struct has_write_read : std::false_type {};
+
+template <typename Bus>
+struct has_write_read<
+    Bus, std::void_t<decltype(std::declval<Bus&>().write_read(
+             uint8_t{}, std::declval<const uint8_t*>(), uint16_t{},
+             std::declval<uint8_t*>(), uint16_t{}))>> : std::true_type {};
+
+/**
+ * class SensirionI2cBus - bus policy using the sensirion_i2c.h implementation
+ *
+ * @bus:    Bus index passed to sensirion_i2c_select_bus() before each
+ *          transfer, or SPS30_BUS_DEFAULT to use the current bus
+ */
+class SensirionI2cBus {
+  public:
+    explicit SensirionI2cBus(uint8_t bus = SPS30_BUS_DEFAULT) noexcept
+        : bus_(bus) {
+    }
+
+    int16_t write(uint8_t address, const uint8_t* data, uint16_t count) {
+        const int16_t ret = select();
+
+        if (ret != NO_ERROR)
+            return ret;
+        return sensirion_i2c_write(address, data, count);
+    }
+
+    int16_t read(uint8_t address, uint8_t* data, uint16_t count) {
+        const int16_t ret = select();
+
+        if (ret != NO_ERROR)
+            return ret;
+        return sensirion_i2c_read(address, data, count);
+    }
+
+#ifdef SPS30_I2C_WRITE_READ
+    int16_t write_read(uint8_t address, const uint8_t* tx, uint16_t tx_count,
+                       uint8_t* rx, uint16_t rx_count) {
+        const int16_t ret = select();
+
+        if (ret != NO_ERROR)
+            return ret;
+        return sps30_i2c_write_read(address, tx, tx_count, rx, rx_count);
+    }
+#endif /* SPS30_I2C_WRITE_READ */
+
+    void sleep_usec(uint32_t useconds) {
+        sensirion_sleep_usec(useconds);
+    }
+
+  private:
+    int16_t select() const {
+        if (bus_ == SPS30_BUS_DEFAULT)
+            return NO_ERROR;
+        return sensirion_i2c_select_bus(bus_);
+    }
+
+    uint8_t bus_;
+};
+
+/**
+ * class Sps30 - a single SPS30 sensor on the bus policy Bus
+ *
+ * The member functions behave like the sps30_dev_*() functions of the C
+ * driver of the same name. Unlike the C driver nothing is cached.
+ */
+template <typename Bus> class Sps30 {
+  public:
+    explicit Sps30(Bus bus, uint8_t address = SPS30_I2C_ADDRESS)
+        : bus_(std::move(bus)), address_(address),
+          active_format_(SPS30_FORMAT_FLOAT) {
+    }
+
+    Bus& bus() noexcept {
+        return bus_;
+    }
+
+    uint8_t address() const noexcept {
+        return address_;
+    }
+
+    /** Output format of the measurement started last */
+    uint16_t active_format() const noexcept {
+        return active_format_;
+    }
+
+    /** Wake the sensor up if it sleeps and check that it responds */
+    int16_t probe() {
+        (void)wake_up();
+        return read_firmware_version().error;
+    }
+
+    Result<FirmwareVersion> read_firmware_version() {
+        const auto r = read_cmd<1>(command::read_firmware_version);
+
+        return {r.error, {r.value[0], r.value[1]}};
+    }
+
+    Result<Serial> get_serial() {
+        Result<Serial> result{};
+
+        result.error = read_words(command::get_serial,
+                                reinterpret_cast<uint8_t*>(result.value.data()),
+                                SPS30_MAX_SERIAL_LEN / SENSIRION_WORD_SIZE);
+        result.value.back() = '\0';
+        return result;
+    }
+
+    /**
+     * start_measurement() - start measuring
+     *
+     * @format: SPS30_FORMAT_FLOAT or SPS30_FORMAT_UINT16
+     * Return:  0 on success, SPS30_ERR_FORMAT if the format is not supported,
+     *          an error code otherwise
+     */
+    int16_t start_measurement(uint16_t format = SPS30_FORMAT_FLOAT) {
+        int16_t ret;
+
+        if (format != SPS30_FORMAT_FLOAT && format != SPS30_FORMAT_UINT16)
+            return SPS30_ERR_FORMAT;
+
+        ret = send(command::start_measurement, format);
+        if (ret == NO_ERROR)
+            active_format_ = format;
+        return ret;
+    }
+
+    int16_t stop_measurement() {
+        return send(command::stop_measurement);
+    }
+
+    Result<bool> read_data_ready() {
+        const auto r = read_cmd<1>(command::read_data_ready);
+
+        return {r.error, r.value[1] != 0};
+    }
+
+    /**
+     * read_measurement() - read a measurement in float format
+     *
+     * Measurements started in SPS30_FORMAT_UINT16 are converted.
+     */
+    Result<sps30_measurement> read_measurement() {
+        Result<sps30_measurement> result{};
+
+        if (active_format_ == SPS30_FORMAT_UINT16) {
+            const auto r = read_measurement_u16();
+
+            result.error = r.error;
+            to_float(r.value, result.value);
+            return result;
+        }
+
+        const auto r = read_cmd<20>(command::read_measurement);
+        const uint8_t* data = r.value.data();
+        result.error = r.error;
+        result.value.mc_1p0 = bytes_to_float(&data[0]);
+        result.value.mc_2p5 = bytes_to_float(&data[4]);
+        result.value.mc_4p0 = bytes_to_float(&data[8]);
+        result.value.mc_10p0 = bytes_to_float(&data[12]);
+        result.value.nc_0p5 = bytes_to_float(&data[16]);
+        result.value.nc_1p0 = bytes_to_float(&data[20]);
+        result.value.nc_2p5 = bytes_to_float(&data[24]);
+        result.value.nc_4p0 = bytes_to_float(&data[28]);
+        result.value.nc_10p0 = bytes_to_float(&data[32]);
+        result.value.typical_particle_size = bytes_to_float(&data[36]);
+        return result;
+    }
+
+    /**
+     * read_measurement_u16() - read a measurement in integer format
+     *
+     * Return:  SPS30_ERR_FORMAT in the error code if the measurement was not
+     *          started in SPS30_FORMAT_UINT16
+     */
+    Result<sps30_measurement_u16> read_measurement_u16() {
+        Result<sps30_measurement_u16> result{};
+
+        if (active_format_ != SPS30_FORMAT_UINT16) {
+            result.error = SPS30_ERR_FORMAT;
+            return result;
+        }
+
+        const auto r = read_cmd<10>(command::read_measurement);
+        const uint8_t* data = r.value.data();
+        result.error = r.error;
+        result.value.mc_1p0 = bytes_to_uint16(&data[0]);
+        result.value.mc_2p5 = bytes_to_uint16(&data[2]);
+        result.value.mc_4p0 = bytes_to_uint16(&data[4]);
+        result.value.mc_10p0 = bytes_to_uint16(&data[6]);
+        result.value.nc_0p5 = bytes_to_uint16(&data[8]);
+        result.value.nc_1p0 = bytes_to_uint16(&data[10]);
+        result.value.nc_2p5 = bytes_to_uint16(&data[12]);
+        result.value.nc_4p0 = bytes_to_uint16(&data[14]);
+        result.value.nc_10p0 = bytes_to_uint16(&data[16]);
+        result.value.typical_particle_size = bytes_to_uint16(&data[18]);
+        return result;
+    }
+
+    /** Interval in seconds, see sps30_get_fan_auto_cleaning_interval() */
+    Result<uint32_t> get_fan_auto_cleaning_interval() {
+        const auto r = read_cmd<2>(command::get_fan_auto_cleaning_interval);
+
+        return {r.error, bytes_to_uint32(r.value.data())};
+    }
+
+    int16_t set_fan_auto_cleaning_interval(uint32_t interval_seconds) {
+        return send(command::set_fan_auto_cleaning_interval,
+                    static_cast<uint16_t>(interval_seconds >> 16),
+                    static_cast<uint16_t>(interval_seconds & 0xffff));
+    }
+
+    int16_t start_manual_fan_cleaning() {
+        return send(command::start_manual_fan_cleaning);
+    }
+
+    /**
+     * reset() - reset the sensor
+     *
+     * Like sps30_reset() this does not wait for the restart, the caller must
+     * wait command::reset.delay_us before the next command.
+     */
+    int16_t reset() {
+        return write(encode(command::reset.code));
+    }
+
+    int16_t sleep() {
+        return send(command::sleep);
+    }
+
+    int16_t wake_up() {
+        const auto tx = encode(command::wake_up.code);
+
+        /* wake-up must be sent twice within 100ms, ignore first return */
+        (void)write(tx);
+        return send(command::wake_up);
+    }
+
+    Result<uint32_t> read_device_status_register() {
+        const auto r = read_cmd<2>(command::read_device_status_register);
+
+        return {r.error, bytes_to_uint32(r.value.data())};
+    }
+
+    /**
+     * read_cmd() - send a command and read num_words data words of its
+     * response, CRCs checked and stripped
+     */
+    template <std::size_t NumWords>
+    Result<std::array<uint8_t, NumWords * SENSIRION_WORD_SIZE>>
+    read_cmd(const Command& cmd) {
+        Result<std::array<uint8_t, NumWords * SENSIRION_WORD_SIZE>> result{};
+
+        static_assert(NumWords <= max_read_words, "response too long");
+        result.error = read_words(cmd, result.value.data(), NumWords);
+        return result;
+    }
+
+  private:
+    /* the longest response is a measurement in float format */
+    static constexpr std::size_t max_read_words = 20;
+
+    template <std::size_t NumArgs>
+    using TxBuffer =
+        std::array<uint8_t, SENSIRION_COMMAND_SIZE + frame_size(NumArgs)>;
+
+    /** Command id and the CRC-protected arguments as sent on the bus */
+    template <typename... Args>
+    static constexpr TxBuffer<sizeof...(Args)> encode(uint16_t code,
+                                                      Args... args) {
+        TxBuffer<sizeof...(Args)> buf{};
+        const uint16_t words[] = {code, static_cast<uint16_t>(args)...};
+        std::size_t pos = 0;
+
+        for (std::size_t i = 0; i < sizeof(words) / sizeof(words[0]); ++i) {
+            buf[pos++] = static_cast<uint8_t>(words[i] >> 8);
+            buf[pos++] = static_cast<uint8_t>(words[i] & 0xff);
+            if (i > 0)
+                buf[pos++] = crc8(words[i]);
+        }
+        return buf;
+    }
+
+    template <std::size_t N> int16_t write(const std::array<uint8_t, N>& tx) {
+        return bus_.write(address_, tx.data(), static_cast<uint16_t>(N));
+    }
+
+    /** send a command and wait until it is processed */
+    template <typename... Args>
+    int16_t send(const Command& cmd, Args... args) {
+        const int16_t ret = write(encode(cmd.code, args...));
+
+        if (ret != NO_ERROR)
+            return ret;
+        bus_.sleep_usec(cmd.delay_us);
+        return NO_ERROR;
+    }
+
+    int16_t read_words(const Command& cmd, uint8_t* data,
+                       std::size_t num_words) {
+        std::array<uint8_t, frame_size(max_read_words)> buf;
+        const auto tx = encode(cmd.code);
+        const uint16_t size = static_cast<uint16_t>(frame_size(num_words));
+        int16_t ret;
+
+        if constexpr (has_write_read<Bus>::value) {
+            if (cmd.delay_us == 0)
+                ret = bus_.write_read(address_, tx.data(),
+                                      static_cast<uint16_t>(tx.size()),
+                                      buf.data(), size);
+            else
+                ret = write_delay_read(cmd, tx, buf.data(), size);
+        } else {
+            ret = write_delay_read(cmd, tx, buf.data(), size);
+        }
+        if (ret != NO_ERROR)
+            return ret;
+
+        for (std::size_t i = 0; i < num_words; ++i) {
+            const uint8_t* word = &buf[frame_size(i)];
+
+            if (crc8(word, SENSIRION_WORD_SIZE) != word[SENSIRION_WORD_SIZE])
+                return SPS30_ERR_CRC;
+            *data++ = word[0];
+            *data++ = word[1];
+        }
+        return NO_ERROR;
+    }
+
+    template <std::size_t N>
+    int16_t write_delay_read(const Command& cmd,
+                             const std::array<uint8_t, N>& tx, uint8_t* rx,
+                             uint16_t size) {
+        const int16_t ret = write(tx);
+
+        if (ret != NO_ERROR)
+            return ret;
+        if (cmd.delay_us)
+            bus_.sleep_usec(cmd.delay_us);
+        return bus_.read(address_, rx, size);
+    }
+
+    static void to_float(const sps30_measurement_u16& m,
+                         sps30_measurement& measurement) {
+        measurement.mc_1p0 = m.mc_1p0;
+        measurement.mc_2p5 = m.mc_2p5;
+        measurement.mc_4p0 = m.mc_4p0;
+        measurement.mc_10p0 = m.mc_10p0;
+        measurement.nc_0p5 = m.nc_0p5;
+        measurement.nc_1p0 = m.nc_1p0;
+        measurement.nc_2p5 = m.nc_2p5;
+        measurement.nc_4p0 = m.nc_4p0;
+        measurement.nc_10p0 = m.nc_10p0;
+        /* nm to um */
+        measurement.typical_particle_size = m.typical_particle_size / 1000.0f;
+    }
+
+    Bus bus_;
+    uint8_t address_;
+    uint16_t active_format_;
+};
+
+}  // namespace sps30
+
+#endif /* SPS30_HPP */
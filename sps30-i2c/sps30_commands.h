@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SPS30_COMMANDS_H
+#define SPS30_COMMANDS_H
+
+/*
+ * I2C command ids of the SPS30 and the time the sensor needs to process
+ * them, shared by the C driver, the C++ interface in sps30.hpp and the batch
+ * read of the Linux backend
+ */
+
+#define SPS_CMD_START_MEASUREMENT 0x0010
+#define SPS_CMD_STOP_MEASUREMENT 0x0104
+#define SPS_CMD_READ_MEASUREMENT 0x0300
+#define SPS_CMD_START_STOP_DELAY_USEC 20000
+#define SPS_CMD_GET_DATA_READY 0x0202
+#define SPS_CMD_AUTOCLEAN_INTERVAL 0x8004
+#define SPS_CMD_GET_FIRMWARE_VERSION 0xd100
+#define SPS_CMD_GET_SERIAL 0xd033
+#define SPS_CMD_RESET 0xd304
+#define SPS_CMD_SLEEP 0x1001
+#define SPS_CMD_READ_DEVICE_STATUS_REG 0xd206
+#define SPS_CMD_START_MANUAL_FAN_CLEANING 0x5607
+#define SPS_CMD_WAKE_UP 0x1103
+#define SPS_CMD_DELAY_USEC 5000
+#define SPS_CMD_DELAY_WRITE_FLASH_USEC 20000
+
+#endif /* SPS30_COMMANDS_H */
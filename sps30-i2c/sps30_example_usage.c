@@ -39,7 +39,11 @@
  */
 
 int main(void) {
+#ifndef SPS30_NO_FLOAT
     struct sps30_measurement m;
+#else
+    struct sps30_measurement_u16 m;
+#endif
     int16_t ret;
 
     /* Initialize I2C bus */
@@ -54,6 +58,7 @@ int main(void) {
     }
     printf("SPS sensor probing successful\n");
 
+#ifndef SPS30_NO_IDENTITY
     uint8_t fw_major;
     uint8_t fw_minor;
     ret = sps30_read_firmware_version(&fw_major, &fw_minor);
@@ -70,6 +75,7 @@ int main(void) {
     } else {
         printf("Serial Number: %s\n", serial_number);
     }
+#endif
 
     ret = sps30_start_measurement();
     if (ret < 0)
@@ -78,11 +84,16 @@ int main(void) {
 
     while (1) {
         sensirion_sleep_usec(SPS30_MEASUREMENT_DURATION_USEC); /* wait 1s */
+#ifndef SPS30_NO_FLOAT
         ret = sps30_read_measurement(&m);
+#else
+        ret = sps30_read_measurement_u16(&m);
+#endif
         if (ret < 0) {
             printf("error reading measurement\n");
 
         } else {
+#ifndef SPS30_NO_FLOAT
             printf("measured values:\n"
                    "\t%0.2f pm1.0\n"
                    "\t%0.2f pm2.5\n"
@@ -96,6 +107,21 @@ int main(void) {
                    "\t%0.2f typical particle size\n\n",
                    m.mc_1p0, m.mc_2p5, m.mc_4p0, m.mc_10p0, m.nc_0p5, m.nc_1p0,
                    m.nc_2p5, m.nc_4p0, m.nc_10p0, m.typical_particle_size);
+#else
+            printf("measured values:\n"
+                   "\t%u pm1.0\n"
+                   "\t%u pm2.5\n"
+                   "\t%u pm4.0\n"
+                   "\t%u pm10.0\n"
+                   "\t%u nc0.5\n"
+                   "\t%u nc1.0\n"
+                   "\t%u nc2.5\n"
+                   "\t%u nc4.5\n"
+                   "\t%u nc10.0\n"
+                   "\t%u typical particle size (nm)\n\n",
+                   m.mc_1p0, m.mc_2p5, m.mc_4p0, m.mc_10p0, m.nc_0p5, m.nc_1p0,
+                   m.nc_2p5, m.nc_4p0, m.nc_10p0, m.typical_particle_size);
+#endif
         }
     }
 
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SPS30_LINUX_BUS_HPP
+#define SPS30_LINUX_BUS_HPP
+
+#include <errno.h>          // errno
+#include <linux/i2c-dev.h>  // I2C_RDWR, I2C_FUNCS
+#include <linux/i2c.h>      // struct i2c_msg
+#include <sys/ioctl.h>      // ioctl
+#include <time.h>           // nanosleep
+
+#include "sps30.hpp"
+
+namespace sps30 {
+
+/**
+ * class LinuxI2cDevBus - bus policy for an open i2c-dev file descriptor
+ *
+ * Every transfer is a single I2C_RDWR ioctl addressing the sensor directly,
+ * so several sensors on one bus need no I2C_SLAVE switching. The file
+ * descriptor is owned by the caller and must stay open while the bus is used.
+ *
+ * @fd:     File descriptor of e.g. /dev/i2c-1, opened O_RDWR
+ */
+class LinuxI2cDevBus {
+  public:
+    explicit LinuxI2cDevBus(int fd) noexcept : fd_(fd) {
+    }
+
+    int16_t write(uint8_t address, const uint8_t* data, uint16_t count) {
+        struct i2c_msg msg = {address, 0, count, const_cast<uint8_t*>(data)};
+
+        return transfer(&msg, 1);
+    }
+
+    int16_t read(uint8_t address, uint8_t* data, uint16_t count) {
+        struct i2c_msg msg = {address, I2C_M_RD, count, data};
+
+        return transfer(&msg, 1);
+    }
+
+    void sleep_usec(uint32_t useconds) {
+        struct timespec ts;
+
+        ts.tv_sec = static_cast<time_t>(useconds / 1000000);
+        ts.tv_nsec = static_cast<long>(useconds % 1000000) * 1000;
+        while (nanosleep(&ts, &ts) != 0 && errno == EINTR)
+            ;
+    }
+
+  protected:
+    int16_t transfer(struct i2c_msg* msgs, uint32_t num_msgs) {
+        struct i2c_rdwr_ioctl_data xfer = {msgs, num_msgs};
+
+        if (ioctl(fd_, I2C_RDWR, &xfer) != static_cast<int>(num_msgs))
+            return STATUS_FAIL;
+        return NO_ERROR;
+    }
+
+    int fd_;
+};
+
+/**
+ * class LinuxI2cDevCombinedBus - LinuxI2cDevBus sending commands with an
+ * immediate response and reading the response in one ioctl
+ *
+ * The SPS30 expects a stop condition after the command, which the adapter can
+ * only produce within a combined transfer if it supports protocol mangling
+ * (I2C_M_STOP). Use it only where supported() is true, LinuxI2cDevBus
+ * otherwise.
+ *
+ * @fd:     File descriptor of e.g. /dev/i2c-1, opened O_RDWR
+ */
+class LinuxI2cDevCombinedBus : public LinuxI2cDevBus {
+  public:
+    explicit LinuxI2cDevCombinedBus(int fd) noexcept : LinuxI2cDevBus(fd) {
+    }
+
+    /** supported() - whether the adapter behind @fd honors I2C_M_STOP */
+    static bool supported(int fd) noexcept {
+        unsigned long funcs = 0;
+
+        return ioctl(fd, I2C_FUNCS, &funcs) == 0 &&
+               (funcs & I2C_FUNC_PROTOCOL_MANGLING);
+    }
+
+    int16_t write_read(uint8_t address, const uint8_t* tx, uint16_t tx_count,
+                       uint8_t* rx, uint16_t rx_count) {
+        struct i2c_msg msgs[2] = {
+            {address, I2C_M_STOP, tx_count, const_cast<uint8_t*>(tx)},
+            {address, I2C_M_RD, rx_count, rx}};
+
+        return transfer(msgs, 2);
+    }
+};
+
+}  // namespace sps30
+
+#endif /* SPS30_LINUX_BUS_HPP */
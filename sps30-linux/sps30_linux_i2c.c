@@ -0,0 +1,403 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <errno.h>          // errno
+#include <fcntl.h>          // open
+#include <linux/i2c-dev.h>  // I2C_SLAVE, I2C_RDWR
+#include <linux/i2c.h>      // struct i2c_msg
+#include <pthread.h>        // pthread_mutex_*
+#include <stdio.h>          // snprintf
+#include <sys/ioctl.h>      // ioctl
+#include <time.h>           // clock_gettime, nanosleep
+#include <unistd.h>         // read, write, close
+
+#include "sensirion_arch_config.h"
+#include "sensirion_common.h"
+#include "sensirion_i2c.h"
+#include "sps30.h"
+#include "sps30_commands.h"
+#include "sps30_linux_i2c.h"
+
+#define I2C_WRITE_FAILED -1
+#define I2C_READ_FAILED -1
+#define SPS30_LINUX_I2C_NO_ADDRESS 0xff
+/* I2C_RDWR_IOCTL_MAX_MSGS */
+#define SPS30_LINUX_I2C_MAX_MSGS 42
+
+struct sps30_linux_i2c_bus {
+    const char* path;
+    int fd;
+    uint8_t open_failed;
+    uint8_t address;
+    uint8_t combined;
+};
+
+static struct sps30_linux_i2c_bus buses[SPS30_LINUX_I2C_MAX_BUSES];
+static pthread_once_t buses_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t buses_lock = PTHREAD_MUTEX_INITIALIZER;
+static __thread uint8_t selected_bus = SPS30_LINUX_I2C_DEFAULT_BUS;
+
+static void sps30_linux_i2c_init_buses(void) {
+    uint8_t i;
+
+    for (i = 0; i < SPS30_LINUX_I2C_MAX_BUSES; ++i)
+        buses[i].fd = -1;
+}
+
+int16_t sps30_linux_i2c_set_bus_path(uint8_t bus_idx, const char* path) {
+    if (bus_idx >= SPS30_LINUX_I2C_MAX_BUSES)
+        return STATUS_FAIL;
+
+    pthread_once(&buses_once, sps30_linux_i2c_init_buses);
+    pthread_mutex_lock(&buses_lock);
+    buses[bus_idx].path = path;
+    buses[bus_idx].open_failed = 0;
+    pthread_mutex_unlock(&buses_lock);
+    return NO_ERROR;
+}
+
+/*
+ * The SPS30 expects a stop condition after a command. Only adapters which
+ * allow protocol mangling honor I2C_M_STOP within a combined transfer, on all
+ * others command and response are separate transfers.
+ */
+static uint8_t sps30_linux_i2c_supports_combined(int fd) {
+    unsigned long funcs = 0;
+
+    return ioctl(fd, I2C_FUNCS, &funcs) == 0 &&
+           (funcs & I2C_FUNC_PROTOCOL_MANGLING);
+}
+
+/*
+ * returns the bus of the calling thread, opened, or NULL. A bus which failed to
+ * open is not retried until its path is set again or the buses are released.
+ */
+static struct sps30_linux_i2c_bus* sps30_linux_i2c_bus(void) {
+    struct sps30_linux_i2c_bus* bus = &buses[selected_bus];
+    char path[32];
+    int fd;
+
+    pthread_once(&buses_once, sps30_linux_i2c_init_buses);
+    pthread_mutex_lock(&buses_lock);
+    if (bus->fd < 0 && !bus->open_failed) {
+        if (!bus->path) {
+            snprintf(path, sizeof(path), "/dev/i2c-%u", selected_bus);
+            bus->fd = open(path, O_RDWR);
+        } else {
+            bus->fd = open(bus->path, O_RDWR);
+        }
+        if (bus->fd < 0) {
+            bus->open_failed = 1;
+        } else {
+            bus->address = SPS30_LINUX_I2C_NO_ADDRESS;
+            bus->combined = sps30_linux_i2c_supports_combined(bus->fd);
+        }
+    }
+    fd = bus->fd;
+    pthread_mutex_unlock(&buses_lock);
+    return fd < 0 ? NULL : bus;
+}
+
+static int8_t sps30_linux_i2c_set_address(struct sps30_linux_i2c_bus* bus,
+                                          uint8_t address) {
+    if (bus->address != address) {
+        if (ioctl(bus->fd, I2C_SLAVE, address) < 0)
+            return STATUS_FAIL;
+        bus->address = address;
+    }
+    return NO_ERROR;
+}
+
+int16_t sensirion_i2c_select_bus(uint8_t bus_idx) {
+    if (bus_idx >= SPS30_LINUX_I2C_MAX_BUSES)
+        return STATUS_FAIL;
+
+    selected_bus = bus_idx;
+    return NO_ERROR;
+}
+
+void sensirion_i2c_init(void) {
+}
+
+void sensirion_i2c_release(void) {
+    uint8_t i;
+
+    pthread_once(&buses_once, sps30_linux_i2c_init_buses);
+    pthread_mutex_lock(&buses_lock);
+    for (i = 0; i < SPS30_LINUX_I2C_MAX_BUSES; ++i) {
+        if (buses[i].fd >= 0)
+            close(buses[i].fd);
+        buses[i].fd = -1;
+        buses[i].open_failed = 0;
+    }
+    pthread_mutex_unlock(&buses_lock);
+}
+
+int8_t sensirion_i2c_read(uint8_t address, uint8_t* data, uint16_t count) {
+    struct sps30_linux_i2c_bus* bus = sps30_linux_i2c_bus();
+
+    if (!bus || sps30_linux_i2c_set_address(bus, address))
+        return I2C_READ_FAILED;
+    if (read(bus->fd, data, count) != count)
+        return I2C_READ_FAILED;
+    return NO_ERROR;
+}
+
+int8_t sensirion_i2c_write(uint8_t address, const uint8_t* data,
+                           uint16_t count) {
+    struct sps30_linux_i2c_bus* bus = sps30_linux_i2c_bus();
+
+    if (!bus || sps30_linux_i2c_set_address(bus, address))
+        return I2C_WRITE_FAILED;
+    if (write(bus->fd, data, count) != count)
+        return I2C_WRITE_FAILED;
+    return NO_ERROR;
+}
+
+/* command with a stop condition and response, for combined transfers */
+static void sps30_linux_i2c_fill_msgs(struct i2c_msg* msgs, uint8_t address,
+                                      const uint8_t* tx, uint16_t tx_count,
+                                      uint8_t* rx, uint16_t rx_count) {
+    msgs[0].addr = address;
+    msgs[0].flags = I2C_M_STOP;
+    msgs[0].len = tx_count;
+    msgs[0].buf = (uint8_t*)tx;
+    msgs[1].addr = address;
+    msgs[1].flags = I2C_M_RD;
+    msgs[1].len = rx_count;
+    msgs[1].buf = rx;
+}
+
+int8_t sps30_i2c_write_read(uint8_t address, const uint8_t* tx,
+                            uint16_t tx_count, uint8_t* rx, uint16_t rx_count) {
+    struct sps30_linux_i2c_bus* bus = sps30_linux_i2c_bus();
+    struct i2c_rdwr_ioctl_data xfer;
+    struct i2c_msg msgs[2];
+
+    if (!bus)
+        return I2C_READ_FAILED;
+
+    if (!bus->combined) {
+        if (sensirion_i2c_write(address, tx, tx_count) != NO_ERROR)
+            return I2C_WRITE_FAILED;
+        return sensirion_i2c_read(address, rx, rx_count);
+    }
+
+    sps30_linux_i2c_fill_msgs(msgs, address, tx, tx_count, rx, rx_count);
+    xfer.msgs = msgs;
+    xfer.nmsgs = 2;
+    if (ioctl(bus->fd, I2C_RDWR, &xfer) != 2)
+        return I2C_READ_FAILED;
+    return NO_ERROR;
+}
+
+#ifndef SPS30_NO_MUX
+
+/* control register values, no channel and each single channel */
+static const uint8_t sps30_linux_i2c_mux_channels[SPS30_MUX_CHANNELS + 1] = {
+    0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80};
+
+static void sps30_linux_i2c_fill_mux_msg(struct i2c_msg* msg,
+                                         struct sps30_mux* mux,
+                                         const uint8_t* channels) {
+    msg->addr = mux->address;
+    msg->flags = I2C_M_STOP;
+    msg->len = 1;
+    msg->buf = (uint8_t*)channels;
+    mux->selected = *channels;
+    mux->switches++;
+}
+
+/**
+ * sps30_linux_i2c_select_mux() - append the messages which connect the channel
+ * of a sensor, as sps30.c does before talking to it
+ *
+ * Only the messages are counted if @msgs is NULL, otherwise the selections of
+ * the multiplexers are updated as if the messages were sent.
+ */
+static uint16_t sps30_linux_i2c_select_mux(const struct sps30_dev* dev,
+                                           struct i2c_msg* msgs) {
+    const uint8_t* channels;
+    struct sps30_mux* peer;
+    uint16_t num_msgs = 0;
+
+    if (!dev->mux)
+        return 0;
+
+    for (peer = dev->mux->next; peer != dev->mux; peer = peer->next) {
+        if (peer->selected != 0) {
+            if (msgs)
+                sps30_linux_i2c_fill_mux_msg(&msgs[num_msgs], peer,
+                                             &sps30_linux_i2c_mux_channels[0]);
+            num_msgs++;
+        }
+    }
+
+    channels = &sps30_linux_i2c_mux_channels[dev->mux_channel + 1];
+    if (dev->mux->selected != *channels) {
+        if (msgs)
+            sps30_linux_i2c_fill_mux_msg(&msgs[num_msgs], dev->mux, channels);
+        num_msgs++;
+    }
+    return num_msgs;
+}
+
+#endif /* SPS30_NO_MUX */
+
+/* whether two handles talk to the same sensor, or both answer at once */
+static int sps30_linux_i2c_same_sensor(const struct sps30_dev* a,
+                                       const struct sps30_dev* b) {
+#ifndef SPS30_NO_MUX
+    if (a->mux != b->mux || a->mux_channel != b->mux_channel)
+        return 0;
+#endif
+    return a->address == b->address;
+}
+
+/*
+ * reads sensors with the driver when the transfers cannot be combined or to
+ * tell which sensor of a batch failed
+ */
+static void sps30_linux_i2c_read_one_by_one(
+    struct sps30_dev* const* devs, uint16_t num_devs,
+    struct sps30_measurement* measurements, int16_t* errors) {
+    uint16_t i;
+
+    for (i = 0; i < num_devs; ++i)
+        errors[i] = sps30_dev_read_measurement(devs[i], &measurements[i]);
+}
+
+int16_t sps30_linux_i2c_read_measurements(
+    struct sps30_dev* const* devs, uint16_t num_devs,
+    struct sps30_measurement* measurements, int16_t* errors) {
+    static const uint8_t tx[SENSIRION_COMMAND_SIZE] = {
+        SPS_CMD_READ_MEASUREMENT >> 8,
+        SPS_CMD_READ_MEASUREMENT & 0xff};
+    uint8_t rx[SPS30_LINUX_I2C_BATCH_SIZE][SPS30_MEASUREMENT_FRAME_SIZE];
+    struct i2c_msg msgs[SPS30_LINUX_I2C_MAX_MSGS];
+    struct sps30_linux_i2c_bus* bus;
+    struct i2c_rdwr_ioctl_data xfer;
+    uint16_t num_failed = 0;
+    uint16_t num_msgs;
+    uint16_t i;
+    uint16_t n;
+    uint16_t j;
+
+    if (num_devs == 0)
+        return NO_ERROR;
+
+    for (i = 0; i < num_devs; ++i) {
+        if (devs[i]->bus != devs[0]->bus)
+            return STATUS_FAIL;
+        for (j = 0; j < i; ++j) {
+            if (sps30_linux_i2c_same_sensor(devs[i], devs[j]))
+                return STATUS_FAIL;
+        }
+    }
+    if (devs[0]->bus != SPS30_BUS_DEFAULT &&
+        sensirion_i2c_select_bus(devs[0]->bus) != NO_ERROR)
+        return STATUS_FAIL;
+
+    bus = sps30_linux_i2c_bus();
+    if (!bus)
+        return STATUS_FAIL;
+
+    for (i = 0; i < num_devs; i += n) {
+        /* as many sensors as fit into one ioctl, none without I2C_M_STOP */
+        num_msgs = 0;
+        for (n = 0; bus->combined && i + n < num_devs &&
+                    n < SPS30_LINUX_I2C_BATCH_SIZE;
+             ++n) {
+#ifndef SPS30_NO_MUX
+            if (num_msgs + sps30_linux_i2c_select_mux(devs[i + n], NULL) + 2 >
+                SPS30_LINUX_I2C_MAX_MSGS)
+                break;
+            num_msgs += sps30_linux_i2c_select_mux(devs[i + n],
+                                                   &msgs[num_msgs]);
+#endif
+            sps30_linux_i2c_fill_msgs(
+                &msgs[num_msgs], devs[i + n]->address, tx, sizeof(tx), rx[n],
+                sps30_dev_measurement_frame_size(devs[i + n]));
+            num_msgs += 2;
+            /* as for any command, a pending delayed read is replaced */
+            devs[i + n]->pending_cmd = 0;
+        }
+        xfer.msgs = msgs;
+        xfer.nmsgs = num_msgs;
+
+        if (n == 0) {
+            n = num_devs - i;
+            sps30_linux_i2c_read_one_by_one(&devs[i], n, &measurements[i],
+                                            &errors[i]);
+        } else if (ioctl(bus->fd, I2C_RDWR, &xfer) == (int)num_msgs) {
+            for (j = 0; j < n; ++j) {
+                errors[i + j] = sps30_dev_decode_measurement(
+                    devs[i + j], rx[j], &measurements[i + j]);
+            }
+        } else {
+            /* the adapter aborts on the first NACK, find out who failed */
+#ifndef SPS30_NO_MUX
+            for (j = 0; j < n; ++j) {
+                if (devs[i + j]->mux)
+                    sps30_mux_invalidate(devs[i + j]->mux);
+            }
+#endif
+            sps30_linux_i2c_read_one_by_one(&devs[i], n, &measurements[i],
+                                            &errors[i]);
+        }
+
+        for (j = 0; j < n; ++j) {
+            if (errors[i + j] != NO_ERROR)
+                num_failed++;
+        }
+    }
+
+    return num_failed ? STATUS_FAIL : NO_ERROR;
+}
+
+void sensirion_sleep_usec(uint32_t useconds) {
+    struct timespec ts;
+
+    ts.tv_sec = (time_t)(useconds / 1000000);
+    ts.tv_nsec = (long)(useconds % 1000000) * 1000;
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR)
+        ;
+}
+
+#ifdef SPS30_STATS
+uint32_t sps30_stats_get_time_usec(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000 +
+                      (uint64_t)ts.tv_nsec / 1000);
+}
+#endif
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SPS30_LINUX_I2C_H
+#define SPS30_LINUX_I2C_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "sensirion_arch_config.h"
+#include "sps30.h"
+
+/*
+ * Linux i2c-dev implementation of sensirion_i2c.h for several buses
+ *
+ * Bus index N maps to /dev/i2c-N unless configured otherwise with
+ * sps30_linux_i2c_set_bus_path(). The bus is opened on first use. If that
+ * fails, transfers on the bus fail without another attempt until its path is
+ * set again or sensirion_i2c_release() is called. The bus selected with
+ * sensirion_i2c_select_bus() is per thread, so threads driving different
+ * buses do not interfere; a bus must not be used by more than one thread at a
+ * time. Threads which never select a bus use SPS30_LINUX_I2C_DEFAULT_BUS.
+ *
+ * sps30_i2c_write_read() is a single combined transfer only if the adapter
+ * supports I2C_FUNC_PROTOCOL_MANGLING, which is needed to end the command with
+ * a stop condition. On all other adapters it writes and reads separately.
+ */
+
+#define SPS30_LINUX_I2C_MAX_BUSES 16
+#define SPS30_LINUX_I2C_DEFAULT_BUS 1
+/* I2C_RDWR_IOCTL_MAX_MSGS, two messages per sensor */
+#define SPS30_LINUX_I2C_BATCH_SIZE 21
+
+/**
+ * sps30_linux_i2c_set_bus_path() - set the device of a bus index
+ *
+ * Must be called before the bus is first used.
+ *
+ * @bus_idx:    Bus index as passed to sensirion_i2c_select_bus()
+ * @path:       Device path, e.g. "/dev/i2c-1". The string is not copied.
+ * Return:      0 on success, STATUS_FAIL if @bus_idx is out of range
+ */
+int16_t sps30_linux_i2c_set_bus_path(uint8_t bus_idx, const char* path);
+
+/**
+ * sps30_linux_i2c_read_measurements() - read the measurements of several
+ * sensors on one bus
+ *
+ * Command and response of up to SPS30_LINUX_I2C_BATCH_SIZE sensors are
+ * transferred with a single I2C_RDWR ioctl. Sensors connected through a
+ * multiplexer (sps30_dev_set_mux()) are included: the ioctl connects the
+ * channel of each sensor before its command, like the driver does, and so
+ * holds fewer sensors when channels are switched. If the adapter reports a
+ * failure, the sensors of that batch are read one by one with
+ * sps30_dev_read_measurement() to tell which one failed. Adapters which cannot
+ * end a message with a stop condition within a combined transfer (no
+ * I2C_FUNC_PROTOCOL_MANGLING) always read the sensors one by one. Statistics
+ * are recorded only for the sensors read one by one.
+ *
+ * @devs:           Sensor handles, all on the same bus and measuring. No two
+ *                  of them may answer at the same time, i.e. share the
+ *                  address and the multiplexer channel.
+ * @num_devs:       Number of sensors
+ * @measurements:   Memory for num_devs measurements
+ * @errors:         Memory for num_devs error codes, 0 where the measurement
+ *                  is valid
+ * Return:          0 if all measurements were read, STATUS_FAIL if any failed,
+ *                  the sensors are not on the same bus or two of them answer
+ *                  at the same time
+ */
+int16_t sps30_linux_i2c_read_measurements(
+    struct sps30_dev* const* devs, uint16_t num_devs,
+    struct sps30_measurement* measurements, int16_t* errors);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPS30_LINUX_I2C_H */
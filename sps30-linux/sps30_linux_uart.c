@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <errno.h>    // errno
+#include <fcntl.h>    // open
+#include <poll.h>     // poll
+#include <stdio.h>    // snprintf
+#include <termios.h>  // tcgetattr, tcsetattr, cfmakeraw
+#include <time.h>     // nanosleep
+#include <unistd.h>   // read, write, close
+
+#include "sensirion_arch_config.h"
+#include "sensirion_common.h"
+#include "sensirion_uart.h"
+#include "sps30_linux_uart.h"
+
+struct sps30_linux_uart_port {
+    const char* path;
+    int fd;
+};
+
+#define SPS30_LINUX_UART_PORT_CLOSED {NULL, -1}
+
+/* one initializer per port, see SPS30_LINUX_UART_MAX_PORTS */
+static struct sps30_linux_uart_port ports[] = {
+    SPS30_LINUX_UART_PORT_CLOSED, SPS30_LINUX_UART_PORT_CLOSED,
+    SPS30_LINUX_UART_PORT_CLOSED, SPS30_LINUX_UART_PORT_CLOSED,
+    SPS30_LINUX_UART_PORT_CLOSED, SPS30_LINUX_UART_PORT_CLOSED,
+    SPS30_LINUX_UART_PORT_CLOSED, SPS30_LINUX_UART_PORT_CLOSED};
+typedef char sps30_linux_uart_ports_check
+    [sizeof(ports) / sizeof(ports[0]) == SPS30_LINUX_UART_MAX_PORTS ? 1 : -1];
+static __thread uint8_t selected_port = SPS30_LINUX_UART_DEFAULT_PORT;
+
+int16_t sps30_linux_uart_set_port_path(uint8_t port, const char* path) {
+    if (port >= SPS30_LINUX_UART_MAX_PORTS)
+        return STATUS_FAIL;
+
+    ports[port].path = path;
+    return NO_ERROR;
+}
+
+int16_t sensirion_uart_select_port(uint8_t port) {
+    if (port >= SPS30_LINUX_UART_MAX_PORTS)
+        return STATUS_FAIL;
+
+    selected_port = port;
+    return NO_ERROR;
+}
+
+/* 115200 8N1, raw, reads return immediately */
+static int16_t sps30_linux_uart_configure(int fd) {
+    struct termios tio;
+
+    if (tcgetattr(fd, &tio) != 0)
+        return STATUS_FAIL;
+
+    cfmakeraw(&tio);
+    tio.c_cflag &= ~(tcflag_t)(CSTOPB | CRTSCTS);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tio.c_cc[VMIN] = 0;
+    tio.c_cc[VTIME] = 0;
+    if (cfsetispeed(&tio, B115200) != 0 || cfsetospeed(&tio, B115200) != 0)
+        return STATUS_FAIL;
+    if (tcsetattr(fd, TCSANOW, &tio) != 0)
+        return STATUS_FAIL;
+
+    tcflush(fd, TCIOFLUSH);
+    return NO_ERROR;
+}
+
+int16_t sensirion_uart_open(void) {
+    struct sps30_linux_uart_port* port = &ports[selected_port];
+    char path[32];
+
+    if (port->fd >= 0)
+        return NO_ERROR;
+
+    if (!port->path) {
+        snprintf(path, sizeof(path), "/dev/ttyUSB%u", selected_port);
+        port->fd = open(path, O_RDWR | O_NOCTTY);
+    } else {
+        port->fd = open(port->path, O_RDWR | O_NOCTTY);
+    }
+    if (port->fd < 0)
+        return STATUS_FAIL;
+
+    if (sps30_linux_uart_configure(port->fd) != NO_ERROR) {
+        close(port->fd);
+        port->fd = -1;
+        return STATUS_FAIL;
+    }
+    return NO_ERROR;
+}
+
+int16_t sensirion_uart_close(void) {
+    struct sps30_linux_uart_port* port = &ports[selected_port];
+
+    if (port->fd < 0)
+        return NO_ERROR;
+    if (close(port->fd) != 0)
+        return STATUS_FAIL;
+    port->fd = -1;
+    return NO_ERROR;
+}
+
+int16_t sensirion_uart_tx(uint16_t data_len, const uint8_t* data) {
+    int fd = ports[selected_port].fd;
+    uint16_t sent = 0;
+    ssize_t ret;
+
+    while (sent < data_len) {
+        ret = write(fd, &data[sent], data_len - sent);
+        if (ret < 0) {
+            if (errno == EINTR)
+                continue;
+            return STATUS_FAIL;
+        }
+        sent += (uint16_t)ret;
+    }
+    if (tcdrain(fd) != 0 && errno != ENOTTY)
+        return STATUS_FAIL;
+    return (int16_t)sent;
+}
+
+int16_t sensirion_uart_rx(uint16_t max_data_len, uint8_t* data) {
+    struct pollfd pfd;
+    ssize_t ret;
+
+    pfd.fd = ports[selected_port].fd;
+    pfd.events = POLLIN;
+    ret = poll(&pfd, 1, SPS30_LINUX_UART_RX_WAIT_MS);
+    if (ret < 0)
+        return errno == EINTR ? 0 : STATUS_FAIL;
+    if (ret == 0)
+        return 0;
+
+    if (max_data_len > INT16_MAX)
+        max_data_len = INT16_MAX;
+    ret = read(pfd.fd, data, max_data_len);
+    if (ret < 0)
+        return errno == EAGAIN || errno == EINTR ? 0 : STATUS_FAIL;
+    return (int16_t)ret;
+}
+
+#ifndef SPS30_LINUX_UART_NO_SLEEP
+void sensirion_sleep_usec(uint32_t useconds) {
+    struct timespec ts;
+
+    ts.tv_sec = (time_t)(useconds / 1000000);
+    ts.tv_nsec = (long)(useconds % 1000000) * 1000;
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR)
+        ;
+}
+#endif /* SPS30_LINUX_UART_NO_SLEEP */
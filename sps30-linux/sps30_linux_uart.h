@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SPS30_LINUX_UART_H
+#define SPS30_LINUX_UART_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "sensirion_arch_config.h"
+
+/*
+ * Linux termios implementation of sensirion_uart.h for several ports
+ *
+ * Port index N maps to /dev/ttyUSBN unless configured otherwise with
+ * sps30_linux_uart_set_port_path(). The port selected with
+ * sensirion_uart_select_port() is per thread. sensirion_uart_rx() waits up to
+ * SPS30_LINUX_UART_RX_WAIT_MS for data if none is available.
+ *
+ * Build with SPS30_LINUX_UART_NO_SLEEP when an I2C implementation, which
+ * defines sensirion_sleep_usec() as well, is linked into the same program.
+ */
+
+#define SPS30_LINUX_UART_MAX_PORTS 8
+#define SPS30_LINUX_UART_DEFAULT_PORT 0
+#define SPS30_LINUX_UART_RX_WAIT_MS 1
+
+/**
+ * sps30_linux_uart_set_port_path() - set the device of a port index
+ *
+ * Must be called before the port is opened.
+ *
+ * @port:   Port index as passed to sensirion_uart_select_port()
+ * @path:   Device path, e.g. "/dev/ttyAMA0". The string is not copied.
+ * Return:  0 on success, STATUS_FAIL if @port is out of range
+ */
+int16_t sps30_linux_uart_set_port_path(uint8_t port, const char* path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPS30_LINUX_UART_H */
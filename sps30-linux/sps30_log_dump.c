@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Dump a measurement log written with sps30_log_append()
+ *
+ * usage: sps30-log-dump [-s start_ms] [-q] <log file>
+ *
+ * Prints the samples as CSV, starting at start_ms if given. With -q only the
+ * number of samples and the scan rate are printed.
+ */
+
+#include <fcntl.h>     // open
+#include <stdio.h>     // printf, fprintf
+#include <stdlib.h>    // strtoull
+#include <sys/mman.h>  // mmap, munmap
+#include <sys/stat.h>  // fstat
+#include <time.h>      // clock_gettime
+#include <unistd.h>    // close, getopt
+
+#include "sps30_log.h"
+
+/* samples decoded at once with -q */
+#define SCAN_SAMPLES 1024
+
+static double now_sec(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static uint64_t scan(struct sps30_log_reader* reader, int quiet) {
+    struct sps30_measurement m;
+    uint64_t timestamp;
+    uint64_t samples = 0;
+
+    if (quiet) {
+        static uint64_t timestamps[SCAN_SAMPLES];
+        static int32_t values[SCAN_SAMPLES * SPS30_LOG_NUM_FIELDS];
+        size_t n;
+
+        do {
+            n = sps30_log_read_raw_many(reader, timestamps, values,
+                                        SCAN_SAMPLES);
+            samples += n;
+        } while (n == SCAN_SAMPLES);
+        return samples;
+    }
+
+    printf("timestamp_ms,mc_1p0,mc_2p5,mc_4p0,mc_10p0,nc_0p5,nc_1p0,nc_2p5,"
+           "nc_4p0,nc_10p0,typical_particle_size\n");
+    while (sps30_log_read(reader, &timestamp, &m) == 0) {
+        printf("%llu,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.3f\n",
+               (unsigned long long)timestamp, m.mc_1p0, m.mc_2p5, m.mc_4p0,
+               m.mc_10p0, m.nc_0p5, m.nc_1p0, m.nc_2p5, m.nc_4p0, m.nc_10p0,
+               m.typical_particle_size);
+        ++samples;
+    }
+    return samples;
+}
+
+int main(int argc, char** argv) {
+    struct sps30_log_reader reader;
+    struct stat st;
+    const uint8_t* data;
+    uint64_t start_ms = 0;
+    uint64_t samples;
+    double elapsed;
+    int quiet = 0;
+    int opt;
+    int fd;
+
+    while ((opt = getopt(argc, argv, "s:q")) != -1) {
+        switch (opt) {
+            case 's':
+                start_ms = strtoull(optarg, NULL, 0);
+                break;
+            case 'q':
+                quiet = 1;
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-s start_ms] [-q] <log file>\n",
+                        argv[0]);
+                return 2;
+        }
+    }
+    if (optind != argc - 1) {
+        fprintf(stderr, "usage: %s [-s start_ms] [-q] <log file>\n", argv[0]);
+        return 2;
+    }
+
+    fd = open(argv[optind], O_RDONLY);
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        perror(argv[optind]);
+        return 1;
+    }
+    if (st.st_size == 0) {
+        fprintf(stderr, "%s: empty file\n", argv[optind]);
+        return 1;
+    }
+    data = (const uint8_t*)mmap(NULL, (size_t)st.st_size, PROT_READ,
+                                MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        perror("mmap");
+        return 1;
+    }
+    madvise((void*)data, (size_t)st.st_size, MADV_SEQUENTIAL);
+
+    if (sps30_log_reader_init(&reader, data, (size_t)st.st_size) != 0) {
+        fprintf(stderr, "%s: not a measurement log\n", argv[optind]);
+        return 1;
+    }
+    fprintf(stderr, "serial %s, firmware %u.%u, period %ums\n",
+            reader.info.serial, reader.info.firmware_major,
+            reader.info.firmware_minor, reader.info.period_ms);
+
+    if (start_ms && sps30_log_seek(&reader, start_ms) != 0)
+        return 0;
+
+    elapsed = now_sec();
+    samples = scan(&reader, quiet);
+    elapsed = now_sec() - elapsed;
+    if (quiet)
+        printf("%llu samples, %.1f MB/s\n", (unsigned long long)samples,
+               (double)st.st_size / 1e6 / elapsed);
+
+    munmap((void*)data, (size_t)st.st_size);
+    return 0;
+}
@@ -0,0 +1,330 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <errno.h>         // errno
+#include <string.h>        // memset
+#include <sys/epoll.h>     // epoll_*
+#include <sys/eventfd.h>   // eventfd
+#include <sys/timerfd.h>   // timerfd_*
+#include <time.h>          // clock_gettime
+#include <unistd.h>        // read, write, close
+
+#include "sensirion_arch_config.h"
+#include "sensirion_common.h"
+#include "sps30_poller.h"
+
+#define SPS30_POLLER_EVENT_TIMER 0
+#define SPS30_POLLER_EVENT_STOP 1
+
+static uint64_t sps30_poller_now_us(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+static struct timespec sps30_poller_timespec(uint64_t us) {
+    struct timespec ts;
+
+    ts.tv_sec = (time_t)(us / 1000000);
+    ts.tv_nsec = (long)(us % 1000000) * 1000;
+    return ts;
+}
+
+#ifndef SPS30_NO_STATUS_REGISTER
+static void sps30_poller_status_changed(void* context, uint8_t faults,
+                                        uint8_t changed,
+                                        uint32_t device_status_flags) {
+    struct sps30_poller_sensor* sensor = (struct sps30_poller_sensor*)context;
+    struct sps30_poller* poller = sensor->poller;
+
+    poller->status_callback(poller->context, sensor->index, faults, changed,
+                            device_status_flags);
+}
+#endif /* SPS30_NO_STATUS_REGISTER */
+
+static void sps30_poller_read(struct sps30_poller_bus* bus, uint8_t index,
+                              uint64_t scheduled_us) {
+    struct sps30_poller* poller = bus->poller;
+    struct sps30_poller_sensor* sensor = &poller->sensors[index];
+    struct sps30_poller_jitter* jitter = &sensor->jitter;
+    struct sps30_measurement m;
+    uint16_t data_ready;
+    uint64_t now_us;
+    uint32_t jitter_us;
+    int16_t ret;
+
+#ifndef SPS30_NO_STATUS_REGISTER
+    if (poller->status_callback)
+        (void)sps30_monitor_before_read(&sensor->monitor,
+                                        (uint32_t)sps30_poller_now_us());
+#endif
+    ret = sps30_dev_read_data_ready(&sensor->dev, &data_ready);
+    if (!ret && !data_ready) {
+        pthread_mutex_lock(&poller->lock);
+        jitter->not_ready++;
+        pthread_mutex_unlock(&poller->lock);
+        return;
+    }
+    if (!ret)
+        ret = sps30_dev_read_measurement(&sensor->dev, &m);
+    now_us = sps30_poller_now_us();
+#ifndef SPS30_NO_STATUS_REGISTER
+    if (!ret && poller->status_callback)
+        (void)sps30_monitor_after_read(&sensor->monitor, (uint32_t)now_us);
+#endif
+
+    pthread_mutex_lock(&poller->lock);
+    if (ret) {
+        jitter->errors++;
+    } else {
+        jitter_us = now_us > scheduled_us ? (uint32_t)(now_us - scheduled_us)
+                                          : 0;
+        if (!jitter->reads || jitter_us < jitter->jitter_min_us)
+            jitter->jitter_min_us = jitter_us;
+        if (jitter_us > jitter->jitter_max_us)
+            jitter->jitter_max_us = jitter_us;
+        jitter->jitter_last_us = jitter_us;
+        jitter->jitter_sum_us += jitter_us;
+        jitter->reads++;
+    }
+    pthread_mutex_unlock(&poller->lock);
+
+    poller->callback(poller->context, index, ret, now_us, ret ? NULL : &m);
+}
+
+static int sps30_poller_watch(int epoll_fd, int fd, uint32_t event) {
+    struct epoll_event ev;
+
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.u32 = event;
+    return epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev);
+}
+
+static void sps30_poller_loop(struct sps30_poller_bus* bus, int epoll_fd,
+                              int timer_fd, uint64_t base_us,
+                              uint32_t slot_us) {
+    struct sps30_poller* poller = bus->poller;
+    struct sps30_poller_sensor* sensor;
+    struct epoll_event ev;
+    uint64_t expirations;
+    uint64_t slot = 0;
+    uint8_t stopping;
+
+    for (;;) {
+        if (epoll_wait(epoll_fd, &ev, 1, -1) != 1)
+            continue;
+        /* the flag also stops the worker if the stop event was not sent */
+        pthread_mutex_lock(&poller->lock);
+        stopping = poller->stopping;
+        pthread_mutex_unlock(&poller->lock);
+        if (stopping || ev.data.u32 == SPS30_POLLER_EVENT_STOP)
+            return;
+        if (read(timer_fd, &expirations, sizeof(expirations)) !=
+            sizeof(expirations))
+            continue;
+
+        /* slots which passed while the previous read was in progress */
+        pthread_mutex_lock(&poller->lock);
+        for (; expirations > 1; --expirations, ++slot) {
+            sensor = &poller->sensors[bus->sensors[slot % bus->num_sensors]];
+            sensor->jitter.missed++;
+        }
+        pthread_mutex_unlock(&poller->lock);
+
+        sps30_poller_read(bus, bus->sensors[slot % bus->num_sensors],
+                          base_us + slot * slot_us);
+        slot++;
+    }
+}
+
+static void* sps30_poller_worker(void* arg) {
+    struct sps30_poller_bus* bus = (struct sps30_poller_bus*)arg;
+    struct sps30_poller* poller = bus->poller;
+    struct sps30_poller_sensor* sensor;
+    const uint32_t slot_us = poller->period_us / bus->num_sensors;
+    struct itimerspec spec;
+    uint64_t base_us;
+    int epoll_fd;
+    int timer_fd;
+    int16_t ret;
+    uint8_t i;
+
+    for (i = 0; i < bus->num_sensors; ++i) {
+        sensor = &poller->sensors[bus->sensors[i]];
+#ifndef SPS30_NO_STATUS_REGISTER
+        sps30_monitor_init(&sensor->monitor, &sensor->dev,
+                           poller->status_interval_us,
+                           sps30_poller_status_changed, sensor);
+#endif
+        ret = sps30_dev_start_measurement(&sensor->dev);
+        if (ret) {
+            pthread_mutex_lock(&poller->lock);
+            sensor->jitter.errors++;
+            pthread_mutex_unlock(&poller->lock);
+            poller->callback(poller->context, bus->sensors[i], ret,
+                             sps30_poller_now_us(), NULL);
+        }
+    }
+
+    /* the first measurement is available one period after the start */
+    base_us = sps30_poller_now_us() + poller->period_us;
+    spec.it_value = sps30_poller_timespec(base_us);
+    spec.it_interval = sps30_poller_timespec(slot_us);
+
+    timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (timer_fd >= 0 && epoll_fd >= 0 &&
+        timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &spec, NULL) == 0 &&
+        sps30_poller_watch(epoll_fd, timer_fd, SPS30_POLLER_EVENT_TIMER) == 0 &&
+        sps30_poller_watch(epoll_fd, poller->stop_fd,
+                           SPS30_POLLER_EVENT_STOP) == 0)
+        sps30_poller_loop(bus, epoll_fd, timer_fd, base_us, slot_us);
+
+    if (epoll_fd >= 0)
+        close(epoll_fd);
+    if (timer_fd >= 0)
+        close(timer_fd);
+    for (i = 0; i < bus->num_sensors; ++i)
+        sps30_dev_stop_measurement(&poller->sensors[bus->sensors[i]].dev);
+    return NULL;
+}
+
+void sps30_poller_init(struct sps30_poller* poller, uint32_t period_us,
+                       sps30_poller_callback callback, void* context) {
+    memset(poller, 0, sizeof(*poller));
+    pthread_mutex_init(&poller->lock, NULL);
+    poller->period_us = period_us;
+    poller->callback = callback;
+    poller->context = context;
+    poller->stop_fd = -1;
+}
+
+int16_t sps30_poller_add_sensor(struct sps30_poller* poller, uint8_t bus,
+                                uint8_t address) {
+    struct sps30_poller_bus* b = NULL;
+    uint8_t index;
+    uint8_t i;
+
+    if (poller->running || poller->num_sensors >= SPS30_POLLER_MAX_SENSORS)
+        return STATUS_FAIL;
+
+    for (i = 0; i < poller->num_buses; ++i) {
+        if (poller->buses[i].bus == bus)
+            b = &poller->buses[i];
+    }
+    if (!b) {
+        if (poller->num_buses >= SPS30_POLLER_MAX_BUSES)
+            return STATUS_FAIL;
+        b = &poller->buses[poller->num_buses++];
+        b->poller = poller;
+        b->bus = bus;
+    }
+
+    index = poller->num_sensors++;
+    sps30_dev_init(&poller->sensors[index].dev, bus, address);
+#ifndef SPS30_NO_STATUS_REGISTER
+    poller->sensors[index].poller = poller;
+    poller->sensors[index].index = index;
+#endif
+    b->sensors[b->num_sensors++] = index;
+    return index;
+}
+
+#ifndef SPS30_NO_STATUS_REGISTER
+int16_t sps30_poller_set_status_monitor(struct sps30_poller* poller,
+                                        uint32_t interval_us,
+                                        sps30_poller_status_callback callback) {
+    if (poller->running)
+        return STATUS_FAIL;
+
+    poller->status_interval_us = interval_us;
+    poller->status_callback = callback;
+    return NO_ERROR;
+}
+#endif /* SPS30_NO_STATUS_REGISTER */
+
+static void sps30_poller_join(struct sps30_poller* poller,
+                              uint8_t num_workers) {
+    const uint64_t stop = 1;
+    uint8_t i;
+
+    pthread_mutex_lock(&poller->lock);
+    poller->stopping = 1;
+    pthread_mutex_unlock(&poller->lock);
+
+    /* the event stays readable and wakes up all workers */
+    if (write(poller->stop_fd, &stop, sizeof(stop)) != sizeof(stop)) {
+        /* they see the flag on their next timer expiration instead */
+    }
+    for (i = 0; i < num_workers; ++i)
+        pthread_join(poller->buses[i].thread, NULL);
+    close(poller->stop_fd);
+    poller->stop_fd = -1;
+}
+
+int16_t sps30_poller_start(struct sps30_poller* poller) {
+    uint8_t i;
+
+    if (poller->running || !poller->num_buses)
+        return STATUS_FAIL;
+
+    poller->stop_fd = eventfd(0, EFD_CLOEXEC);
+    if (poller->stop_fd < 0)
+        return STATUS_FAIL;
+    poller->stopping = 0;
+
+    for (i = 0; i < poller->num_buses; ++i) {
+        if (pthread_create(&poller->buses[i].thread, NULL,
+                           sps30_poller_worker, &poller->buses[i]) != 0) {
+            sps30_poller_join(poller, i);
+            return STATUS_FAIL;
+        }
+    }
+    poller->running = 1;
+    return NO_ERROR;
+}
+
+void sps30_poller_stop(struct sps30_poller* poller) {
+    if (!poller->running)
+        return;
+
+    sps30_poller_join(poller, poller->num_buses);
+    poller->running = 0;
+}
+
+void sps30_poller_get_jitter(struct sps30_poller* poller, uint8_t sensor,
+                             struct sps30_poller_jitter* jitter) {
+    pthread_mutex_lock(&poller->lock);
+    *jitter = poller->sensors[sensor].jitter;
+    pthread_mutex_unlock(&poller->lock);
+}
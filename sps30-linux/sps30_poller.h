@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SPS30_POLLER_H
+#define SPS30_POLLER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <pthread.h>
+
+#include "sensirion_arch_config.h"
+#include "sps30.h"
+#include "sps30_monitor.h"
+
+/*
+ * Periodic measurement of several sensors on several buses (Linux)
+ *
+ * Every bus is served by its own worker thread with a timerfd, so a slow or
+ * hung bus does not delay the sensors on other buses. On a bus, the sensors
+ * are read in turn in evenly spaced slots of period / sensors on the bus,
+ * i.e. the transfers to the sensors of one bus never overlap.
+ *
+ * The I2C implementation must support sensirion_i2c_select_bus() with a per
+ * thread selection, e.g. sps30_linux_i2c.c.
+ */
+
+#define SPS30_POLLER_MAX_SENSORS 32
+#define SPS30_POLLER_MAX_BUSES 8
+
+/**
+ * sps30_poller_callback - called from the bus worker for every read
+ *
+ * @context:        As passed to sps30_poller_init()
+ * @sensor:         Index returned by sps30_poller_add_sensor()
+ * @status:         0 if @measurement is valid, the error of the driver
+ *                  otherwise
+ * @timestamp_us:   CLOCK_MONOTONIC time of the read in microseconds
+ * @measurement:    The measurement, NULL on error
+ */
+typedef void (*sps30_poller_callback)(
+    void* context, uint8_t sensor, int16_t status, uint64_t timestamp_us,
+    const struct sps30_measurement* measurement);
+
+#ifndef SPS30_NO_STATUS_REGISTER
+/**
+ * sps30_poller_status_callback - called from the bus worker when the faults of
+ * a sensor change, see sps30_poller_set_status_monitor()
+ *
+ * @context:                As passed to sps30_poller_init()
+ * @sensor:                 Index returned by sps30_poller_add_sensor()
+ * @faults:                 SPS30_MONITOR_FAULT_* flags now set
+ * @changed:                SPS30_MONITOR_FAULT_* flags which changed
+ * @device_status_flags:    Raw device status register
+ */
+typedef void (*sps30_poller_status_callback)(void* context, uint8_t sensor,
+                                             uint8_t faults, uint8_t changed,
+                                             uint32_t device_status_flags);
+#endif /* SPS30_NO_STATUS_REGISTER */
+
+/**
+ * struct sps30_poller_jitter - read timing of a sensor
+ *
+ * The jitter is the time from the scheduled slot until the measurement was
+ * read, including the wake-up latency of the worker and the bus transfers.
+ *
+ * @reads:          Number of measurements read
+ * @errors:         Number of failed reads
+ * @not_ready:      Slots without new data from the sensor
+ * @missed:         Slots which passed while the worker was busy
+ * @jitter_last_us: Jitter of the last read
+ * @jitter_min_us:  Minimum jitter
+ * @jitter_max_us:  Maximum jitter
+ * @jitter_sum_us:  Sum of the jitter of all reads, divide by @reads for the
+ *                  mean
+ */
+struct sps30_poller_jitter {
+    uint32_t reads;
+    uint32_t errors;
+    uint32_t not_ready;
+    uint32_t missed;
+    uint32_t jitter_last_us;
+    uint32_t jitter_min_us;
+    uint32_t jitter_max_us;
+    uint64_t jitter_sum_us;
+};
+
+struct sps30_poller;
+
+/**
+ * struct sps30_poller_sensor - sensor state, the members are private
+ */
+struct sps30_poller_sensor {
+    struct sps30_dev dev;
+    struct sps30_poller_jitter jitter;
+#ifndef SPS30_NO_STATUS_REGISTER
+    struct sps30_monitor monitor;
+    struct sps30_poller* poller;
+    uint8_t index;
+#endif
+};
+
+/**
+ * struct sps30_poller_bus - bus worker state, the members are private
+ */
+struct sps30_poller_bus {
+    struct sps30_poller* poller;
+    pthread_t thread;
+    uint8_t bus;
+    uint8_t num_sensors;
+    uint8_t sensors[SPS30_POLLER_MAX_SENSORS];
+};
+
+/**
+ * struct sps30_poller - poller state, the members are private
+ */
+struct sps30_poller {
+    struct sps30_poller_sensor sensors[SPS30_POLLER_MAX_SENSORS];
+    struct sps30_poller_bus buses[SPS30_POLLER_MAX_BUSES];
+    pthread_mutex_t lock;
+    sps30_poller_callback callback;
+    void* context;
+#ifndef SPS30_NO_STATUS_REGISTER
+    sps30_poller_status_callback status_callback;
+    uint32_t status_interval_us;
+#endif
+    uint32_t period_us;
+    int stop_fd;
+    uint8_t num_sensors;
+    uint8_t num_buses;
+    uint8_t running;
+    uint8_t stopping;
+};
+
+/**
+ * sps30_poller_init() - initialize a poller without sensors
+ *
+ * @poller:     Poller
+ * @period_us:  Read period of every sensor, usually
+ *              SPS30_MEASUREMENT_DURATION_USEC
+ * @callback:   Called with every measurement
+ * @context:    Passed to @callback
+ */
+void sps30_poller_init(struct sps30_poller* poller, uint32_t period_us,
+                       sps30_poller_callback callback, void* context);
+
+/**
+ * sps30_poller_add_sensor() - add a sensor before starting the poller
+ *
+ * Return:  Index of the sensor, STATUS_FAIL if there are too many sensors or
+ *          buses
+ */
+int16_t sps30_poller_add_sensor(struct sps30_poller* poller, uint8_t bus,
+                                uint8_t address);
+
+#ifndef SPS30_NO_STATUS_REGISTER
+/**
+ * sps30_poller_set_status_monitor() - check the device status registers
+ * before starting the poller
+ *
+ * The status of every sensor is checked every @interval_us with
+ * sps30_monitor, in the read slots of the sensor and without delaying them.
+ *
+ * @poller:         Poller
+ * @interval_us:    Time between checks of a sensor
+ * @callback:       Called when the faults of a sensor change
+ * Return:          0 on success, STATUS_FAIL if the poller is running
+ */
+int16_t sps30_poller_set_status_monitor(struct sps30_poller* poller,
+                                        uint32_t interval_us,
+                                        sps30_poller_status_callback callback);
+#endif /* SPS30_NO_STATUS_REGISTER */
+
+/**
+ * sps30_poller_start() - start the measurements and the bus workers
+ *
+ * Return:  0 on success, STATUS_FAIL if the workers could not be started
+ */
+int16_t sps30_poller_start(struct sps30_poller* poller);
+
+/**
+ * sps30_poller_stop() - stop the bus workers and the measurements
+ */
+void sps30_poller_stop(struct sps30_poller* poller);
+
+/**
+ * sps30_poller_get_jitter() - read timing of a sensor
+ */
+void sps30_poller_get_jitter(struct sps30_poller* poller, uint8_t sensor,
+                             struct sps30_poller_jitter* jitter);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPS30_POLLER_H */
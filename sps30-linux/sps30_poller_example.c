@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Poll SPS30 sensors on several Linux i2c buses
+ *
+ * usage: sps30-poller [-p period_ms] [-j report_s] [-s status_s]
+ *                     <bus>[:<address>] ...
+ *
+ * Bus N is /dev/i2c-N, the address defaults to 0x69. Measurements are
+ * printed as they arrive, the read jitter of every sensor every report_s
+ * seconds (default 60). With -s, the device status of every sensor is checked
+ * every status_s seconds and printed when it changes.
+ */
+
+#include <signal.h>  // signal
+#include <stdio.h>   // printf, fprintf
+#include <stdlib.h>  // strtoul
+#include <unistd.h>  // getopt, pause
+
+#include "sensirion_i2c.h"
+#include "sps30.h"
+#include "sps30_poller.h"
+
+static volatile sig_atomic_t stop;
+
+static void on_signal(int signal) {
+    stop = 1;
+}
+
+static void on_measurement(void* context, uint8_t sensor, int16_t status,
+                           uint64_t timestamp_us,
+                           const struct sps30_measurement* m) {
+    if (status) {
+        printf("%llu sensor %u: error %d\n", (unsigned long long)timestamp_us,
+               sensor, status);
+        return;
+    }
+    printf("%llu sensor %u: pm1.0 %0.2f pm2.5 %0.2f pm4.0 %0.2f pm10.0 %0.2f "
+           "typical size %0.2f\n",
+           (unsigned long long)timestamp_us, sensor, m->mc_1p0, m->mc_2p5,
+           m->mc_4p0, m->mc_10p0, m->typical_particle_size);
+    fflush(stdout);
+}
+
+#ifndef SPS30_NO_STATUS_REGISTER
+static void on_status(void* context, uint8_t sensor, uint8_t faults,
+                      uint8_t changed, uint32_t device_status_flags) {
+    printf("sensor %u: device status 0x%08x%s%s%s%s\n", sensor,
+           device_status_flags, faults ? "" : " ok",
+           (faults & SPS30_MONITOR_FAULT_FAN_SPEED) ? " fan speed warning" : "",
+           (faults & SPS30_MONITOR_FAULT_LASER) ? " laser error" : "",
+           (faults & SPS30_MONITOR_FAULT_FAN) ? " fan error" : "");
+    fflush(stdout);
+}
+#endif /* SPS30_NO_STATUS_REGISTER */
+
+static void report(struct sps30_poller* poller, uint8_t num_sensors) {
+    struct sps30_poller_jitter j;
+    uint8_t i;
+
+    for (i = 0; i < num_sensors; ++i) {
+        sps30_poller_get_jitter(poller, i, &j);
+        printf("sensor %u: %u reads, %u errors, %u not ready, %u missed, "
+               "jitter min %uus mean %lluus max %uus\n",
+               i, j.reads, j.errors, j.not_ready, j.missed, j.jitter_min_us,
+               (unsigned long long)(j.reads ? j.jitter_sum_us / j.reads : 0),
+               j.jitter_max_us);
+    }
+    fflush(stdout);
+}
+
+int main(int argc, char** argv) {
+    static struct sps30_poller poller;
+    unsigned long period_ms = SPS30_MEASUREMENT_DURATION_USEC / 1000;
+    unsigned long report_s = 60;
+    unsigned long status_s = 0;
+    unsigned long bus;
+    unsigned long address;
+    unsigned long elapsed_s = 0;
+    char* end;
+    uint8_t num_sensors = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "p:j:s:")) != -1) {
+        switch (opt) {
+            case 'p':
+                period_ms = strtoul(optarg, NULL, 0);
+                break;
+            case 'j':
+                report_s = strtoul(optarg, NULL, 0);
+                break;
+            case 's':
+                status_s = strtoul(optarg, NULL, 0);
+                break;
+            default:
+                optind = argc;
+                break;
+        }
+    }
+    if (optind >= argc || !period_ms || !report_s) {
+        fprintf(stderr,
+                "usage: %s [-p period_ms] [-j report_s] [-s status_s] "
+                "<bus>[:<address>] ...\n",
+                argv[0]);
+        return 2;
+    }
+
+    sensirion_i2c_init();
+    sps30_poller_init(&poller, (uint32_t)(period_ms * 1000), on_measurement,
+                      NULL);
+#ifndef SPS30_NO_STATUS_REGISTER
+    if (status_s)
+        sps30_poller_set_status_monitor(
+            &poller, (uint32_t)(status_s * 1000000), on_status);
+#else
+    if (status_s)
+        fprintf(stderr, "built without device status register, ignoring -s\n");
+#endif
+    for (; optind < argc; ++optind) {
+        bus = strtoul(argv[optind], &end, 0);
+        address = *end == ':' ? strtoul(end + 1, NULL, 0) : SPS30_I2C_ADDRESS;
+        if (sps30_poller_add_sensor(&poller, (uint8_t)bus, (uint8_t)address) <
+            0) {
+            fprintf(stderr, "too many sensors or buses\n");
+            return 1;
+        }
+        printf("sensor %u: bus %lu address 0x%02lx\n", num_sensors, bus,
+               address);
+        num_sensors++;
+    }
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    if (sps30_poller_start(&poller) != 0) {
+        fprintf(stderr, "starting the poller failed\n");
+        return 1;
+    }
+    while (!stop) {
+        sensirion_sleep_usec(1000000);
+        if (++elapsed_s % report_s == 0)
+            report(&poller, num_sensors);
+    }
+    sps30_poller_stop(&poller);
+    report(&poller, num_sensors);
+    sensirion_i2c_release();
+    return 0;
+}
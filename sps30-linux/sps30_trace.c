@@ -0,0 +1,505 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <errno.h>    // errno
+#include <pthread.h>  // pthread_mutex_*
+#include <stdio.h>    // FILE, fopen, fwrite, fread
+#include <stdlib.h>   // malloc, free
+#include <string.h>   // memcmp, memcpy
+#include <time.h>     // clock_gettime, nanosleep
+
+#include "sensirion_arch_config.h"
+#include "sensirion_common.h"
+#include "sps30_trace.h"
+
+static const uint8_t trace_magic[] = {'S', 'P', 'S', '3', '0', 'T', 'R', 'C'};
+
+#define SPS30_TRACE_MAX_VARINT 5
+#define SPS30_TRACE_MAX_VARINT64 10
+/* op, delta and return value */
+#define SPS30_TRACE_MAX_RECORD_HEADER (2 + SPS30_TRACE_MAX_VARINT64)
+
+struct sps30_trace_record {
+    uint8_t op;
+    int8_t ret;
+    uint64_t delta_us;
+    uint8_t address;
+    uint32_t tx_count;
+    const uint8_t* tx;
+    uint32_t rx_count;
+    const uint8_t* rx;
+    uint32_t useconds;
+    size_t next;
+};
+
+static struct {
+    pthread_mutex_t lock;
+    FILE* file;
+    uint64_t last_us;
+    int16_t error;
+} recorder = {PTHREAD_MUTEX_INITIALIZER, NULL, 0, NO_ERROR};
+
+static struct {
+    uint8_t active;
+    uint8_t flags;
+    const uint8_t* trace;
+    size_t size;
+    size_t pos;
+    uint8_t* loaded;
+    uint64_t start_us;
+    uint64_t trace_us;
+    uint32_t loop_records;
+    struct sps30_trace_stats stats;
+} replay;
+
+static uint64_t sps30_trace_now_us(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+static uint8_t sps30_trace_put_varint(uint8_t* buf, uint64_t value) {
+    uint8_t len = 0;
+
+    while (value >= 0x80) {
+        buf[len++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    buf[len++] = (uint8_t)value;
+    return len;
+}
+
+/* returns 0 and advances *pos, or STATUS_FAIL if the varint is truncated */
+static int16_t sps30_trace_get_varint64(const uint8_t* buf, size_t size,
+                                        size_t* pos, uint64_t* value) {
+    uint8_t shift = 0;
+
+    *value = 0;
+    while (*pos < size && shift < 70) {
+        const uint8_t byte = buf[(*pos)++];
+
+        *value |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return NO_ERROR;
+        shift += 7;
+    }
+    return STATUS_FAIL;
+}
+
+/* as above, STATUS_FAIL also if the value does not fit 32 bit */
+static int16_t sps30_trace_get_varint(const uint8_t* buf, size_t size,
+                                      size_t* pos, uint32_t* value) {
+    uint64_t value64;
+
+    if (sps30_trace_get_varint64(buf, size, pos, &value64) ||
+        value64 > UINT32_MAX)
+        return STATUS_FAIL;
+    *value = (uint32_t)value64;
+    return NO_ERROR;
+}
+
+/* writes to the recording, a short write is latched in recorder.error */
+static void sps30_trace_write(const void* data, size_t size) {
+    if (size && fwrite(data, 1, size, recorder.file) != size)
+        recorder.error = STATUS_FAIL;
+}
+
+/**
+ * sps30_trace_record_begin() - lock the recorder and write the common part of
+ * a record
+ *
+ * Return:  0 with the recorder locked, STATUS_FAIL if no recording runs or
+ *          writing it failed before
+ */
+static int16_t sps30_trace_record_begin(uint8_t op, int16_t ret,
+                                        const uint8_t* fields,
+                                        uint8_t fields_len) {
+    uint8_t buf[SPS30_TRACE_MAX_RECORD_HEADER];
+    uint64_t now_us;
+    uint8_t len = 0;
+
+    pthread_mutex_lock(&recorder.lock);
+    if (!recorder.file || recorder.error) {
+        pthread_mutex_unlock(&recorder.lock);
+        return STATUS_FAIL;
+    }
+
+    now_us = sps30_trace_now_us();
+    buf[len++] = ret ? (uint8_t)(op | SPS30_TRACE_FAILED) : op;
+    len += sps30_trace_put_varint(&buf[len], now_us - recorder.last_us);
+    if (ret)
+        buf[len++] = (uint8_t)ret;
+    recorder.last_us = now_us;
+
+    sps30_trace_write(buf, len);
+    sps30_trace_write(fields, fields_len);
+    return NO_ERROR;
+}
+
+static void sps30_trace_record_data(const uint8_t* data, uint16_t count) {
+    uint8_t buf[SPS30_TRACE_MAX_VARINT];
+
+    sps30_trace_write(buf, sps30_trace_put_varint(buf, count));
+    sps30_trace_write(data, count);
+}
+
+static void sps30_trace_record_end(void) {
+    pthread_mutex_unlock(&recorder.lock);
+}
+
+int16_t sps30_trace_record_start(const char* path) {
+    const uint8_t version = SPS30_TRACE_VERSION;
+    FILE* file;
+
+    sps30_trace_replay_stop();
+    sps30_trace_record_stop();
+
+    file = fopen(path, "wb");
+    if (!file)
+        return STATUS_FAIL;
+    if (fwrite(trace_magic, 1, sizeof(trace_magic), file) !=
+            sizeof(trace_magic) ||
+        fwrite(&version, 1, 1, file) != 1) {
+        fclose(file);
+        return STATUS_FAIL;
+    }
+
+    pthread_mutex_lock(&recorder.lock);
+    recorder.file = file;
+    recorder.last_us = sps30_trace_now_us();
+    recorder.error = NO_ERROR;
+    pthread_mutex_unlock(&recorder.lock);
+    return NO_ERROR;
+}
+
+int16_t sps30_trace_record_stop(void) {
+    int16_t ret;
+
+    pthread_mutex_lock(&recorder.lock);
+    /* fclose() flushes the buffered records */
+    if (recorder.file && fclose(recorder.file) != 0)
+        recorder.error = STATUS_FAIL;
+    recorder.file = NULL;
+    ret = recorder.error;
+    recorder.error = NO_ERROR;
+    pthread_mutex_unlock(&recorder.lock);
+    return ret;
+}
+
+void sps30_trace_record_select_bus(uint8_t bus_idx, int16_t ret) {
+    if (sps30_trace_record_begin(SPS30_TRACE_OP_SELECT_BUS, ret, &bus_idx, 1))
+        return;
+    sps30_trace_record_end();
+}
+
+void sps30_trace_record_write(uint8_t address, const uint8_t* data,
+                              uint16_t count, int16_t ret) {
+    if (sps30_trace_record_begin(SPS30_TRACE_OP_WRITE, ret, &address, 1))
+        return;
+    sps30_trace_record_data(data, count);
+    sps30_trace_record_end();
+}
+
+void sps30_trace_record_read(uint8_t address, const uint8_t* data,
+                             uint16_t count, int16_t ret) {
+    if (sps30_trace_record_begin(SPS30_TRACE_OP_READ, ret, &address, 1))
+        return;
+    sps30_trace_record_data(data, count);
+    sps30_trace_record_end();
+}
+
+void sps30_trace_record_write_read(uint8_t address, const uint8_t* tx,
+                                   uint16_t tx_count, const uint8_t* rx,
+                                   uint16_t rx_count, int16_t ret) {
+    if (sps30_trace_record_begin(SPS30_TRACE_OP_WRITE_READ, ret, &address, 1))
+        return;
+    sps30_trace_record_data(tx, tx_count);
+    sps30_trace_record_data(rx, rx_count);
+    sps30_trace_record_end();
+}
+
+void sps30_trace_record_sleep(uint32_t useconds) {
+    uint8_t buf[SPS30_TRACE_MAX_VARINT];
+
+    if (sps30_trace_record_begin(SPS30_TRACE_OP_SLEEP, NO_ERROR, buf,
+                                 sps30_trace_put_varint(buf, useconds)))
+        return;
+    sps30_trace_record_end();
+}
+
+int16_t sps30_trace_replay_start(const uint8_t* trace, size_t size,
+                                 uint8_t flags) {
+    sps30_trace_replay_stop();
+    sps30_trace_record_stop();
+
+    if (size < SPS30_TRACE_HEADER_SIZE ||
+        memcmp(trace, trace_magic, sizeof(trace_magic)) != 0 ||
+        trace[sizeof(trace_magic)] != SPS30_TRACE_VERSION)
+        return STATUS_FAIL;
+
+    memset(&replay.stats, 0, sizeof(replay.stats));
+    replay.trace = trace;
+    replay.size = size;
+    replay.pos = SPS30_TRACE_HEADER_SIZE;
+    replay.flags = flags;
+    replay.start_us = sps30_trace_now_us();
+    replay.trace_us = 0;
+    replay.loop_records = 0;
+    replay.active = 1;
+    return NO_ERROR;
+}
+
+int16_t sps30_trace_replay_load(const char* path, uint8_t flags) {
+    FILE* file = fopen(path, "rb");
+    uint8_t* trace = NULL;
+    long size;
+    int16_t ret;
+
+    if (!file)
+        return STATUS_FAIL;
+    if (fseek(file, 0, SEEK_END) == 0 && (size = ftell(file)) > 0 &&
+        fseek(file, 0, SEEK_SET) == 0) {
+        trace = (uint8_t*)malloc((size_t)size);
+        if (trace && fread(trace, 1, (size_t)size, file) != (size_t)size) {
+            free(trace);
+            trace = NULL;
+        }
+    }
+    fclose(file);
+    if (!trace)
+        return STATUS_FAIL;
+
+    ret = sps30_trace_replay_start(trace, (size_t)size, flags);
+    if (ret != NO_ERROR) {
+        free(trace);
+        return ret;
+    }
+    replay.loaded = trace;
+    return NO_ERROR;
+}
+
+void sps30_trace_replay_stop(void) {
+    replay.active = 0;
+    free(replay.loaded);
+    replay.loaded = NULL;
+}
+
+uint8_t sps30_trace_replaying(void) {
+    return replay.active;
+}
+
+void sps30_trace_get_stats(struct sps30_trace_stats* stats) {
+    *stats = replay.stats;
+}
+
+static int16_t sps30_trace_parse_data(size_t* pos, uint32_t* count,
+                                      const uint8_t** data) {
+    if (sps30_trace_get_varint(replay.trace, replay.size, pos, count) ||
+        replay.size - *pos < *count)
+        return STATUS_FAIL;
+
+    *data = &replay.trace[*pos];
+    *pos += *count;
+    return NO_ERROR;
+}
+
+/* parses the record at replay.pos, STATUS_FAIL at the end of the trace */
+static int16_t sps30_trace_parse(struct sps30_trace_record* rec) {
+    const uint8_t* trace = replay.trace;
+    size_t pos = replay.pos;
+    uint8_t op;
+
+    if (pos >= replay.size)
+        return STATUS_FAIL;
+
+    op = trace[pos++];
+    rec->op = op & SPS30_TRACE_OP_MASK;
+    rec->ret = NO_ERROR;
+    if (sps30_trace_get_varint64(trace, replay.size, &pos, &rec->delta_us))
+        return STATUS_FAIL;
+    if (op & SPS30_TRACE_FAILED) {
+        if (pos >= replay.size)
+            return STATUS_FAIL;
+        rec->ret = (int8_t)trace[pos++];
+    }
+
+    switch (rec->op) {
+        case SPS30_TRACE_OP_SLEEP:
+            if (sps30_trace_get_varint(trace, replay.size, &pos,
+                                       &rec->useconds))
+                return STATUS_FAIL;
+            break;
+        case SPS30_TRACE_OP_SELECT_BUS:
+        case SPS30_TRACE_OP_WRITE:
+        case SPS30_TRACE_OP_READ:
+        case SPS30_TRACE_OP_WRITE_READ:
+            if (pos >= replay.size)
+                return STATUS_FAIL;
+            rec->address = trace[pos++];
+            if (rec->op == SPS30_TRACE_OP_WRITE ||
+                rec->op == SPS30_TRACE_OP_WRITE_READ) {
+                if (sps30_trace_parse_data(&pos, &rec->tx_count, &rec->tx))
+                    return STATUS_FAIL;
+            }
+            if (rec->op == SPS30_TRACE_OP_READ ||
+                rec->op == SPS30_TRACE_OP_WRITE_READ) {
+                if (sps30_trace_parse_data(&pos, &rec->rx_count, &rec->rx))
+                    return STATUS_FAIL;
+            }
+            break;
+        default:
+            return STATUS_FAIL;
+    }
+    rec->next = pos;
+    return NO_ERROR;
+}
+
+static void sps30_trace_rewind(void) {
+    replay.pos = SPS30_TRACE_HEADER_SIZE;
+    replay.start_us = sps30_trace_now_us();
+    replay.trace_us = 0;
+    replay.loop_records = 0;
+    replay.stats.loops++;
+}
+
+/* consumes the record and, in real time, waits for its timestamp */
+static void sps30_trace_consume(const struct sps30_trace_record* rec) {
+    replay.pos = rec->next;
+    replay.trace_us += rec->delta_us;
+    replay.loop_records++;
+    replay.stats.records++;
+
+    if (replay.flags & SPS30_TRACE_REAL_TIME) {
+        const uint64_t at_us = replay.start_us + replay.trace_us;
+        uint64_t now_us = sps30_trace_now_us();
+
+        while (now_us < at_us) {
+            struct timespec ts;
+            const uint64_t wait_us = at_us - now_us;
+
+            ts.tv_sec = (time_t)(wait_us / 1000000);
+            ts.tv_nsec = (long)(wait_us % 1000000) * 1000;
+            if (nanosleep(&ts, NULL) != 0 && errno != EINTR)
+                break;
+            now_us = sps30_trace_now_us();
+        }
+    }
+}
+
+/**
+ * sps30_trace_next() - consume the next record which is not a sleep
+ *
+ * Return:  0 with the record in rec, STATUS_FAIL at the end of the trace
+ */
+static int16_t sps30_trace_next(struct sps30_trace_record* rec) {
+    if (!replay.active)
+        return STATUS_FAIL;
+
+    for (;;) {
+        if (sps30_trace_parse(rec)) {
+            /* a trace of sleeps only would loop forever */
+            if ((replay.flags & SPS30_TRACE_LOOP) && replay.loop_records) {
+                sps30_trace_rewind();
+                continue;
+            }
+            replay.stats.exhausted++;
+            return STATUS_FAIL;
+        }
+        sps30_trace_consume(rec);
+        if (rec->op != SPS30_TRACE_OP_SLEEP)
+            return NO_ERROR;
+    }
+}
+
+static int8_t sps30_trace_mismatch(void) {
+    replay.stats.mismatches++;
+    return STATUS_FAIL;
+}
+
+int16_t sps30_trace_replay_select_bus(uint8_t bus_idx) {
+    struct sps30_trace_record rec;
+
+    if (sps30_trace_next(&rec))
+        return STATUS_FAIL;
+    if (rec.op != SPS30_TRACE_OP_SELECT_BUS || rec.address != bus_idx)
+        return sps30_trace_mismatch();
+    return rec.ret;
+}
+
+int8_t sps30_trace_replay_write(uint8_t address, const uint8_t* data,
+                                uint16_t count) {
+    struct sps30_trace_record rec;
+
+    if (sps30_trace_next(&rec))
+        return STATUS_FAIL;
+    if (rec.op != SPS30_TRACE_OP_WRITE || rec.address != address ||
+        rec.tx_count != count || memcmp(rec.tx, data, count) != 0)
+        return sps30_trace_mismatch();
+    return rec.ret;
+}
+
+int8_t sps30_trace_replay_read(uint8_t address, uint8_t* data,
+                               uint16_t count) {
+    struct sps30_trace_record rec;
+
+    if (sps30_trace_next(&rec))
+        return STATUS_FAIL;
+    if (rec.op != SPS30_TRACE_OP_READ || rec.address != address ||
+        rec.rx_count != count)
+        return sps30_trace_mismatch();
+    memcpy(data, rec.rx, count);
+    return rec.ret;
+}
+
+int8_t sps30_trace_replay_write_read(uint8_t address, const uint8_t* tx,
+                                     uint16_t tx_count, uint8_t* rx,
+                                     uint16_t rx_count) {
+    struct sps30_trace_record rec;
+
+    if (sps30_trace_next(&rec))
+        return STATUS_FAIL;
+    if (rec.op != SPS30_TRACE_OP_WRITE_READ || rec.address != address ||
+        rec.tx_count != tx_count || memcmp(rec.tx, tx, tx_count) != 0 ||
+        rec.rx_count != rx_count)
+        return sps30_trace_mismatch();
+    memcpy(rx, rec.rx, rx_count);
+    return rec.ret;
+}
+
+void sps30_trace_replay_sleep(uint32_t useconds) {
+    struct sps30_trace_record rec;
+
+    /* sleeps are only consumed in order, never at the cost of a mismatch */
+    if (replay.active && sps30_trace_parse(&rec) == NO_ERROR &&
+        rec.op == SPS30_TRACE_OP_SLEEP)
+        sps30_trace_consume(&rec);
+}
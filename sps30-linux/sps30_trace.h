@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SPS30_TRACE_H
+#define SPS30_TRACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>  // size_t
+
+#include "sensirion_arch_config.h"
+
+/*
+ * Record and replay of I2C transactions
+ *
+ * The recorder writes every sensirion_i2c.h call of the driver (bus
+ * selection, write, read, combined write-read if SPS30_I2C_WRITE_READ is
+ * used, and sleep) with its timestamp, data and return value to a trace
+ * file. Replaying the trace feeds the same bytes back to the driver, either
+ * as fast as possible or with the recorded timing, to reproduce field issues
+ * (CRC errors, odd readings) offline and to run the decode path on
+ * deterministic input.
+ *
+ * Two ways to use it:
+ *
+ * - sps30_trace_wrap.c sits in front of the platform's sensirion_i2c.h
+ *   implementation when linked with the GNU ld option
+ *   -Wl,--wrap=<function> for each function (see sps30_trace_wrap_ldflags in
+ *   default_config.inc). Calls are passed through and recorded while a
+ *   recording runs and served from the trace while a replay runs.
+ * - sps30_trace_i2c.c implements sensirion_i2c.h on replay only, for hosts
+ *   without any sensor.
+ *
+ * Trace file layout:
+ *
+ *   header     "SPS30TRC" followed by SPS30_TRACE_VERSION (1 byte)
+ *   records    one per call
+ *
+ * A record starts with the operation (SPS30_TRACE_OP_*, ORed with
+ * SPS30_TRACE_FAILED if the call returned an error) and the microseconds
+ * since the previous record as unsigned LEB128 varint of up to 64 bit (the
+ * other varints hold up to 32 bit). A failed call stores its return value as
+ * next byte. The operation specific fields follow:
+ *
+ *   SELECT_BUS     bus index (1 byte)
+ *   WRITE, READ    address (1 byte), length (varint), data
+ *   WRITE_READ     address (1 byte), tx length (varint), tx data,
+ *                  rx length (varint), rx data
+ *   SLEEP          microseconds (varint)
+ *
+ * Read data is stored as returned, also for failed calls. A read of the
+ * measurement in float format takes 64 bytes plus the varint timestamp.
+ *
+ * Recording may be done from several threads, replay must be driven by a
+ * single thread.
+ */
+
+#define SPS30_TRACE_VERSION 1
+#define SPS30_TRACE_HEADER_SIZE 9
+
+#define SPS30_TRACE_OP_SELECT_BUS 0
+#define SPS30_TRACE_OP_WRITE 1
+#define SPS30_TRACE_OP_READ 2
+#define SPS30_TRACE_OP_WRITE_READ 3
+#define SPS30_TRACE_OP_SLEEP 4
+#define SPS30_TRACE_OP_MASK 0x07
+#define SPS30_TRACE_FAILED 0x80
+
+/** Replay flags */
+/** Wait until the recorded time of each call instead of replaying at once */
+#define SPS30_TRACE_REAL_TIME 0x01
+/** Restart from the beginning at the end of the trace */
+#define SPS30_TRACE_LOOP 0x02
+
+/**
+ * struct sps30_trace_stats - replay statistics
+ *
+ * @records:    Records served
+ * @mismatches: Calls which did not match the next record (different
+ *              operation, address, length or written data); they fail with
+ *              STATUS_FAIL and consume the record
+ * @loops:      Number of restarts with SPS30_TRACE_LOOP
+ * @exhausted:  Calls made after the end of the trace without
+ *              SPS30_TRACE_LOOP; they fail with STATUS_FAIL
+ */
+struct sps30_trace_stats {
+    uint32_t records;
+    uint32_t mismatches;
+    uint32_t loops;
+    uint32_t exhausted;
+};
+
+/**
+ * sps30_trace_record_start() - start recording to a file
+ *
+ * A running recording or replay is stopped first.
+ *
+ * @path:   Trace file, truncated if it exists
+ * Return:  0 on success, STATUS_FAIL if the file cannot be written
+ */
+int16_t sps30_trace_record_start(const char* path);
+
+/**
+ * sps30_trace_record_stop() - stop recording and close the file
+ *
+ * Once writing the file fails, no further calls are recorded and the trace is
+ * incomplete.
+ *
+ * Return:  0 on success, STATUS_FAIL if writing the file failed at any point
+ *          of the recording
+ */
+int16_t sps30_trace_record_stop(void);
+
+/**
+ * sps30_trace_replay_start() - start replaying a trace in memory
+ *
+ * The trace is not copied and must stay valid until the replay is stopped. A
+ * running recording or replay is stopped first.
+ *
+ * @trace:  Trace including the header
+ * @size:   Size of the trace in bytes
+ * @flags:  SPS30_TRACE_REAL_TIME and/or SPS30_TRACE_LOOP
+ * Return:  0 on success, STATUS_FAIL if the header is invalid
+ */
+int16_t sps30_trace_replay_start(const uint8_t* trace, size_t size,
+                                 uint8_t flags);
+
+/**
+ * sps30_trace_replay_load() - read a trace file and start replaying it
+ *
+ * The file is read into memory which is freed by sps30_trace_replay_stop().
+ *
+ * Return:  0 on success, STATUS_FAIL if the file cannot be read or is invalid
+ */
+int16_t sps30_trace_replay_load(const char* path, uint8_t flags);
+
+/**
+ * sps30_trace_replay_stop() - stop replaying
+ */
+void sps30_trace_replay_stop(void);
+
+/**
+ * sps30_trace_replaying() - check whether a replay is running
+ *
+ * Return:  1 while a replay is running, 0 otherwise
+ */
+uint8_t sps30_trace_replaying(void);
+
+/**
+ * sps30_trace_get_stats() - statistics of the running or last replay
+ */
+void sps30_trace_get_stats(struct sps30_trace_stats* stats);
+
+/*
+ * Recording of a call, used by sps30_trace_wrap.c. Calls while no recording
+ * runs are ignored.
+ */
+void sps30_trace_record_select_bus(uint8_t bus_idx, int16_t ret);
+void sps30_trace_record_write(uint8_t address, const uint8_t* data,
+                              uint16_t count, int16_t ret);
+void sps30_trace_record_read(uint8_t address, const uint8_t* data,
+                             uint16_t count, int16_t ret);
+void sps30_trace_record_write_read(uint8_t address, const uint8_t* tx,
+                                   uint16_t tx_count, const uint8_t* rx,
+                                   uint16_t rx_count, int16_t ret);
+void sps30_trace_record_sleep(uint32_t useconds);
+
+/*
+ * Replay of a call, with the signature and return value of the
+ * sensirion_i2c.h function. Sleeps are not replayed, with
+ * SPS30_TRACE_REAL_TIME the timing follows the recorded timestamps.
+ */
+int16_t sps30_trace_replay_select_bus(uint8_t bus_idx);
+int8_t sps30_trace_replay_write(uint8_t address, const uint8_t* data,
+                                uint16_t count);
+int8_t sps30_trace_replay_read(uint8_t address, uint8_t* data, uint16_t count);
+int8_t sps30_trace_replay_write_read(uint8_t address, const uint8_t* tx,
+                                     uint16_t tx_count, uint8_t* rx,
+                                     uint16_t rx_count);
+void sps30_trace_replay_sleep(uint32_t useconds);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPS30_TRACE_H */
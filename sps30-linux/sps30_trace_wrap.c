@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sensirion_arch_config.h"
+#include "sensirion_i2c.h"
+#include "sps30.h"
+#include "sps30_trace.h"
+
+/*
+ * Shim in front of the sensirion_i2c.h implementation, active when linked
+ * with -Wl,--wrap=<function> for the functions below: ld then resolves the
+ * driver's calls to __wrap_<function> and __real_<function> to the platform
+ * implementation.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int16_t __real_sensirion_i2c_select_bus(uint8_t bus_idx);
+int8_t __real_sensirion_i2c_read(uint8_t address, uint8_t* data,
+                                 uint16_t count);
+int8_t __real_sensirion_i2c_write(uint8_t address, const uint8_t* data,
+                                  uint16_t count);
+void __real_sensirion_sleep_usec(uint32_t useconds);
+
+int16_t __wrap_sensirion_i2c_select_bus(uint8_t bus_idx);
+int8_t __wrap_sensirion_i2c_read(uint8_t address, uint8_t* data,
+                                 uint16_t count);
+int8_t __wrap_sensirion_i2c_write(uint8_t address, const uint8_t* data,
+                                  uint16_t count);
+void __wrap_sensirion_sleep_usec(uint32_t useconds);
+
+#ifdef SPS30_I2C_WRITE_READ
+int8_t __real_sps30_i2c_write_read(uint8_t address, const uint8_t* tx,
+                                   uint16_t tx_count, uint8_t* rx,
+                                   uint16_t rx_count);
+int8_t __wrap_sps30_i2c_write_read(uint8_t address, const uint8_t* tx,
+                                   uint16_t tx_count, uint8_t* rx,
+                                   uint16_t rx_count);
+#endif /* SPS30_I2C_WRITE_READ */
+
+#ifdef __cplusplus
+}
+#endif
+
+int16_t __wrap_sensirion_i2c_select_bus(uint8_t bus_idx) {
+    int16_t ret;
+
+    if (sps30_trace_replaying())
+        return sps30_trace_replay_select_bus(bus_idx);
+
+    ret = __real_sensirion_i2c_select_bus(bus_idx);
+    sps30_trace_record_select_bus(bus_idx, ret);
+    return ret;
+}
+
+int8_t __wrap_sensirion_i2c_read(uint8_t address, uint8_t* data,
+                                 uint16_t count) {
+    int8_t ret;
+
+    if (sps30_trace_replaying())
+        return sps30_trace_replay_read(address, data, count);
+
+    ret = __real_sensirion_i2c_read(address, data, count);
+    sps30_trace_record_read(address, data, count, ret);
+    return ret;
+}
+
+int8_t __wrap_sensirion_i2c_write(uint8_t address, const uint8_t* data,
+                                  uint16_t count) {
+    int8_t ret;
+
+    if (sps30_trace_replaying())
+        return sps30_trace_replay_write(address, data, count);
+
+    ret = __real_sensirion_i2c_write(address, data, count);
+    sps30_trace_record_write(address, data, count, ret);
+    return ret;
+}
+
+void __wrap_sensirion_sleep_usec(uint32_t useconds) {
+    if (sps30_trace_replaying()) {
+        sps30_trace_replay_sleep(useconds);
+        return;
+    }
+
+    __real_sensirion_sleep_usec(useconds);
+    sps30_trace_record_sleep(useconds);
+}
+
+#ifdef SPS30_I2C_WRITE_READ
+int8_t __wrap_sps30_i2c_write_read(uint8_t address, const uint8_t* tx,
+                                   uint16_t tx_count, uint8_t* rx,
+                                   uint16_t rx_count) {
+    int8_t ret;
+
+    if (sps30_trace_replaying())
+        return sps30_trace_replay_write_read(address, tx, tx_count, rx,
+                                             rx_count);
+
+    ret = __real_sps30_i2c_write_read(address, tx, tx_count, rx, rx_count);
+    sps30_trace_record_write_read(address, tx, tx_count, rx, rx_count, ret);
+    return ret;
+}
+#endif /* SPS30_I2C_WRITE_READ */
@@ -0,0 +1,284 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sensirion_shdlc.h"
+#include "sensirion_arch_config.h"
+#include "sensirion_common.h"
+#include "sensirion_uart.h"
+
+#define SHDLC_START 0x7e
+#define SHDLC_STOP 0x7e
+#define SHDLC_ESCAPE 0x7d
+#define SHDLC_ESCAPE_XOR 0x20
+#define SHDLC_XON 0x11
+#define SHDLC_XOFF 0x13
+
+/* address, command, state and length */
+#define SHDLC_MISO_HEADER_LEN 4
+#define SHDLC_MISO_FRAME_LEN(n) (SHDLC_MISO_HEADER_LEN + (n) + 1)
+#define SHDLC_RX_CHUNK_SIZE 32
+
+#define SHDLC_RX_PHASE_IDLE 0
+#define SHDLC_RX_PHASE_FRAME 1
+
+static uint8_t sensirion_shdlc_needs_escape(uint8_t b) {
+    return b == SHDLC_START || b == SHDLC_ESCAPE || b == SHDLC_XON ||
+           b == SHDLC_XOFF;
+}
+
+uint8_t sensirion_shdlc_checksum(uint8_t header_sum, uint8_t data_len,
+                                 const uint8_t* data) {
+    uint8_t sum = header_sum;
+    uint8_t i;
+
+    for (i = 0; i < data_len; ++i)
+        sum = (uint8_t)(sum + data[i]);
+    return (uint8_t)~sum;
+}
+
+uint16_t sensirion_shdlc_stuff(uint8_t data_len, const uint8_t* data,
+                               uint8_t* frame) {
+    uint16_t len = 0;
+    uint8_t i;
+
+    for (i = 0; i < data_len; ++i) {
+        if (sensirion_shdlc_needs_escape(data[i])) {
+            frame[len++] = SHDLC_ESCAPE;
+            frame[len++] = data[i] ^ SHDLC_ESCAPE_XOR;
+        } else {
+            frame[len++] = data[i];
+        }
+    }
+    return len;
+}
+
+uint16_t sensirion_shdlc_build_frame(uint8_t addr, uint8_t cmd,
+                                     uint8_t data_len, const uint8_t* data,
+                                     uint8_t* frame) {
+    const uint8_t header[] = {addr, cmd, data_len};
+    uint8_t checksum;
+    uint16_t len = 0;
+
+    checksum = sensirion_shdlc_checksum(
+        (uint8_t)(addr + cmd + data_len), data_len, data);
+
+    frame[len++] = SHDLC_START;
+    len += sensirion_shdlc_stuff(sizeof(header), header, &frame[len]);
+    len += sensirion_shdlc_stuff(data_len, data, &frame[len]);
+    len += sensirion_shdlc_stuff(1, &checksum, &frame[len]);
+    frame[len++] = SHDLC_STOP;
+    return len;
+}
+
+int16_t sensirion_shdlc_tx(uint8_t addr, uint8_t cmd, uint8_t data_len,
+                           const uint8_t* data) {
+    uint8_t
+        frame[SENSIRION_SHDLC_TX_FRAME_SIZE(SENSIRION_SHDLC_MAX_TX_DATA_LEN)];
+    uint16_t len;
+    int16_t ret;
+
+    if (data_len > SENSIRION_SHDLC_MAX_TX_DATA_LEN)
+        return SENSIRION_SHDLC_ERR_FRAME;
+
+    len = sensirion_shdlc_build_frame(addr, cmd, data_len, data, frame);
+    ret = sensirion_uart_tx(len, frame);
+    if (ret < 0)
+        return ret;
+    if ((uint16_t)ret != len)
+        return SENSIRION_SHDLC_ERR_TX_INCOMPLETE;
+    return NO_ERROR;
+}
+
+void sensirion_shdlc_rx_init(struct sensirion_shdlc_rx* rx) {
+    rx->phase = SHDLC_RX_PHASE_IDLE;
+    rx->escaped = 0;
+    rx->checksum = 0;
+    rx->len = 0;
+}
+
+static void sensirion_shdlc_rx_start(struct sensirion_shdlc_rx* rx) {
+    sensirion_shdlc_rx_init(rx);
+    rx->phase = SHDLC_RX_PHASE_FRAME;
+}
+
+/* stores an unstuffed byte, returns 0 if the frame is too long */
+static uint8_t sensirion_shdlc_rx_put(struct sensirion_shdlc_rx* rx,
+                                      uint8_t b) {
+    switch (rx->len) {
+        case 0:
+            rx->addr = b;
+            break;
+        case 1:
+            rx->cmd = b;
+            break;
+        case 2:
+            rx->state = b;
+            break;
+        case 3:
+            if (b > SENSIRION_SHDLC_MAX_RX_DATA_LEN)
+                return 0;
+            rx->data_len = b;
+            break;
+        default:
+            if (rx->len >= SHDLC_MISO_FRAME_LEN(rx->data_len))
+                return 0;
+            /* the checksum byte is only summed up */
+            if (rx->len < SHDLC_MISO_FRAME_LEN(rx->data_len) - 1)
+                rx->data[rx->len - SHDLC_MISO_HEADER_LEN] = b;
+            break;
+    }
+    rx->checksum = (uint8_t)(rx->checksum + b);
+    rx->len++;
+    return 1;
+}
+
+/* the checksum byte complements the sum of the other bytes to 0xff */
+static int16_t sensirion_shdlc_rx_finish(const struct sensirion_shdlc_rx* rx) {
+    if (rx->len < SHDLC_MISO_HEADER_LEN ||
+        rx->len != SHDLC_MISO_FRAME_LEN(rx->data_len))
+        return SENSIRION_SHDLC_ERR_FRAME;
+    if (rx->checksum != 0xff)
+        return SENSIRION_SHDLC_ERR_CHECKSUM;
+    return 1;
+}
+
+int16_t sensirion_shdlc_rx_feed(struct sensirion_shdlc_rx* rx,
+                                uint16_t data_len, const uint8_t* data,
+                                uint16_t* consumed) {
+    int16_t ret;
+    uint16_t i;
+    uint8_t b;
+
+    for (i = 0; i < data_len; ++i) {
+        b = data[i];
+        if (b == SHDLC_START) {
+            if (rx->phase == SHDLC_RX_PHASE_FRAME && rx->len > 0) {
+                *consumed = i + 1;
+                ret = sensirion_shdlc_rx_finish(rx);
+                /* a broken frame's stop byte may well be the next start */
+                if (ret < 0)
+                    sensirion_shdlc_rx_start(rx);
+                else
+                    rx->phase = SHDLC_RX_PHASE_IDLE;
+                return ret;
+            }
+            sensirion_shdlc_rx_start(rx);
+            continue;
+        }
+        if (rx->phase != SHDLC_RX_PHASE_FRAME)
+            continue;
+        if (b == SHDLC_ESCAPE) {
+            rx->escaped = 1;
+            continue;
+        }
+        if (rx->escaped) {
+            b ^= SHDLC_ESCAPE_XOR;
+            rx->escaped = 0;
+        }
+        if (!sensirion_shdlc_rx_put(rx, b)) {
+            *consumed = i + 1;
+            rx->phase = SHDLC_RX_PHASE_IDLE;
+            return SENSIRION_SHDLC_ERR_FRAME;
+        }
+    }
+    *consumed = data_len;
+    return 0;
+}
+
+int16_t sensirion_shdlc_rx_poll(struct sensirion_shdlc_rx* rx) {
+    uint8_t buf[SHDLC_RX_CHUNK_SIZE];
+    uint16_t offset = 0;
+    uint16_t consumed;
+    int16_t error = 0;
+    int16_t len;
+    int16_t ret;
+
+    len = sensirion_uart_rx(sizeof(buf), buf);
+    if (len < 0)
+        return len;
+
+    /* stale bytes ahead of a good frame do not fail it */
+    while (offset < (uint16_t)len) {
+        ret = sensirion_shdlc_rx_feed(rx, (uint16_t)len - offset,
+                                      &buf[offset], &consumed);
+        offset += consumed;
+        if (ret == 1)
+            return ret;
+        if (ret < 0)
+            error = ret;
+    }
+    return error;
+}
+
+uint8_t sensirion_shdlc_rx_in_frame(const struct sensirion_shdlc_rx* rx) {
+    return rx->phase == SHDLC_RX_PHASE_FRAME;
+}
+
+int16_t sensirion_shdlc_rx(struct sensirion_shdlc_rx* rx) {
+    uint32_t waited_us = 0;
+    int16_t error = SENSIRION_SHDLC_ERR_NO_DATA;
+    int16_t ret;
+
+    for (;;) {
+        ret = sensirion_shdlc_rx_poll(rx);
+        if (ret == 1)
+            return NO_ERROR;
+        if (ret < 0) {
+            /* the start of the response may have ended a stale frame */
+            if (!sensirion_shdlc_rx_in_frame(rx))
+                return ret;
+            error = ret;
+        }
+        if (waited_us >= SENSIRION_SHDLC_RX_TIMEOUT_USEC)
+            return error;
+        sensirion_sleep_usec(SENSIRION_SHDLC_RX_POLL_USEC);
+        waited_us += SENSIRION_SHDLC_RX_POLL_USEC;
+    }
+}
+
+int16_t sensirion_shdlc_xcv(uint8_t addr, uint8_t cmd, uint8_t data_len,
+                            const uint8_t* data,
+                            struct sensirion_shdlc_rx* rx) {
+    int16_t ret;
+
+    sensirion_shdlc_rx_init(rx);
+    ret = sensirion_shdlc_tx(addr, cmd, data_len, data);
+    if (ret != NO_ERROR)
+        return ret;
+
+    ret = sensirion_shdlc_rx(rx);
+    if (ret != NO_ERROR)
+        return ret;
+
+    if (rx->addr != addr || rx->cmd != cmd)
+        return SENSIRION_SHDLC_ERR_MISMATCH;
+    return NO_ERROR;
+}
@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SENSIRION_SHDLC_H
+#define SENSIRION_SHDLC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "sensirion_arch_config.h"
+
+/*
+ * SHDLC framing over sensirion_uart.h
+ *
+ * A command frame (MOSI) consists of address, command, data length and data,
+ * a response frame (MISO) additionally carries a state byte after the
+ * command:
+ *
+ *     0x7e ADR CMD [STATE] LEN DATA... CHK 0x7e
+ *
+ * The checksum is the inverted low byte of the sum of all bytes between the
+ * start and the checksum. Between the start and stop bytes, 0x7e, 0x7d, 0x11
+ * and 0x13 are sent as 0x7d followed by the byte XOR 0x20.
+ */
+
+/** Largest response payload kept by the receiver */
+#ifndef SENSIRION_SHDLC_MAX_RX_DATA_LEN
+#define SENSIRION_SHDLC_MAX_RX_DATA_LEN 64
+#endif
+/** Time to wait for the rest of a response in sensirion_shdlc_rx() */
+#ifndef SENSIRION_SHDLC_RX_TIMEOUT_USEC
+#define SENSIRION_SHDLC_RX_TIMEOUT_USEC 100000
+#endif
+/** Sleep between polls of sensirion_uart_rx() while waiting */
+#define SENSIRION_SHDLC_RX_POLL_USEC 1000
+
+/** Largest command payload sent by sensirion_shdlc_tx() */
+#ifndef SENSIRION_SHDLC_MAX_TX_DATA_LEN
+#define SENSIRION_SHDLC_MAX_TX_DATA_LEN 16
+#endif
+/** Size of a stuffed command frame with @n payload bytes */
+#define SENSIRION_SHDLC_TX_FRAME_SIZE(n) (2 + (4 + (n)) * 2)
+
+/** No response within SENSIRION_SHDLC_RX_TIMEOUT_USEC */
+#define SENSIRION_SHDLC_ERR_NO_DATA (-16)
+/** A frame is truncated, too long or its length byte is wrong */
+#define SENSIRION_SHDLC_ERR_FRAME (-17)
+/** The response failed the checksum */
+#define SENSIRION_SHDLC_ERR_CHECKSUM (-18)
+/** The response does not belong to the command sent */
+#define SENSIRION_SHDLC_ERR_MISMATCH (-19)
+/** The command frame could not be sent completely */
+#define SENSIRION_SHDLC_ERR_TX_INCOMPLETE (-20)
+
+/**
+ * struct sensirion_shdlc_rx - incremental response decoder
+ *
+ * Bytes are fed in chunks of any size as they arrive, e.g. from an interrupt
+ * handler or a DMA buffer. Bytes outside of a frame are skipped.
+ *
+ * Besides the fields below, which may be read once
+ * sensirion_shdlc_rx_feed() reported a complete frame, the members are
+ * private.
+ *
+ * @addr:       Address of the responding device
+ * @cmd:        Command the response belongs to
+ * @state:      Execution state, 0 on success. Bit 7 flags a device error
+ *              readable from the device's status register
+ * @data_len:   Number of bytes in @data
+ * @data:       Payload
+ */
+struct sensirion_shdlc_rx {
+    uint8_t addr;
+    uint8_t cmd;
+    uint8_t state;
+    uint8_t data_len;
+    uint8_t data[SENSIRION_SHDLC_MAX_RX_DATA_LEN];
+
+    uint8_t phase;
+    uint8_t escaped;
+    uint8_t checksum;
+    uint16_t len;
+};
+
+/**
+ * sensirion_shdlc_checksum() - checksum over the unstuffed frame content
+ *
+ * @header_sum: Sum of the header bytes
+ * @data_len:   Number of payload bytes
+ * @data:       Payload
+ * Return:      Checksum byte
+ */
+uint8_t sensirion_shdlc_checksum(uint8_t header_sum, uint8_t data_len,
+                                 const uint8_t* data);
+
+/**
+ * sensirion_shdlc_stuff() - append bytes with byte stuffing
+ *
+ * @data_len:   Number of bytes to append
+ * @data:       Bytes to append
+ * @frame:      Memory where the stuffed bytes are written into, up to
+ *              2 * @data_len bytes
+ * Return:      Number of bytes written
+ */
+uint16_t sensirion_shdlc_stuff(uint8_t data_len, const uint8_t* data,
+                               uint8_t* frame);
+
+/**
+ * sensirion_shdlc_build_frame() - build a command frame
+ *
+ * @addr:       Device address
+ * @cmd:        Command
+ * @data_len:   Number of payload bytes
+ * @data:       Payload
+ * @frame:      Memory of at least SENSIRION_SHDLC_TX_FRAME_SIZE(@data_len)
+ *              bytes where the frame is written into
+ * Return:      Frame size
+ */
+uint16_t sensirion_shdlc_build_frame(uint8_t addr, uint8_t cmd,
+                                     uint8_t data_len, const uint8_t* data,
+                                     uint8_t* frame);
+
+/**
+ * sensirion_shdlc_tx() - send a command frame
+ *
+ * @addr:       Device address
+ * @cmd:        Command
+ * @data_len:   Number of payload bytes
+ * @data:       Payload
+ * Return:      0 on success, SENSIRION_SHDLC_ERR_FRAME if @data_len exceeds
+ *              SENSIRION_SHDLC_MAX_TX_DATA_LEN, an error code otherwise
+ */
+int16_t sensirion_shdlc_tx(uint8_t addr, uint8_t cmd, uint8_t data_len,
+                           const uint8_t* data);
+
+/**
+ * sensirion_shdlc_rx_init() - reset the decoder to wait for a new frame
+ */
+void sensirion_shdlc_rx_init(struct sensirion_shdlc_rx* rx);
+
+/**
+ * sensirion_shdlc_rx_feed() - decode received bytes
+ *
+ * Decoding stops after the first complete frame, the remaining bytes are not
+ * consumed. After an error, the decoder resynchronizes on the next frame
+ * boundary by itself.
+ *
+ * @rx:         Decoder
+ * @data_len:   Number of received bytes
+ * @data:       Received bytes
+ * @consumed:   Memory where the number of bytes consumed is written into
+ * Return:      1 if a complete frame was decoded, 0 if more bytes are needed,
+ *              SENSIRION_SHDLC_ERR_FRAME or SENSIRION_SHDLC_ERR_CHECKSUM if a
+ *              broken frame was dropped
+ */
+int16_t sensirion_shdlc_rx_feed(struct sensirion_shdlc_rx* rx,
+                                uint16_t data_len, const uint8_t* data,
+                                uint16_t* consumed);
+
+/**
+ * sensirion_shdlc_rx_poll() - feed the bytes available from the UART
+ *
+ * Reads once from sensirion_uart_rx(). Bytes following a complete frame are
+ * dropped, responses only follow commands.
+ *
+ * @rx:     Decoder
+ * Return:  1 if a complete frame was decoded, 0 if more bytes are needed, an
+ *          error code otherwise
+ */
+int16_t sensirion_shdlc_rx_poll(struct sensirion_shdlc_rx* rx);
+
+/**
+ * sensirion_shdlc_rx_in_frame() - check whether a frame is being decoded
+ *
+ * After sensirion_shdlc_rx_poll() dropped a broken frame, e.g. the rest of an
+ * earlier response cut off by the start of the next one, the decoder may
+ * already be in the following frame, which is worth waiting for.
+ *
+ * @rx:     Decoder
+ * Return:  1 if the decoder is inside a frame, 0 otherwise
+ */
+uint8_t sensirion_shdlc_rx_in_frame(const struct sensirion_shdlc_rx* rx);
+
+/**
+ * sensirion_shdlc_rx() - wait for a complete response frame
+ *
+ * Broken frames are skipped as long as the decoder is inside the next frame.
+ *
+ * @rx:     Decoder, the frame is decoded into it
+ * Return:  0 on success, SENSIRION_SHDLC_ERR_NO_DATA if no complete frame
+ *          arrived within SENSIRION_SHDLC_RX_TIMEOUT_USEC, the last frame
+ *          error if broken frames arrived in that time, an error code
+ *          otherwise
+ */
+int16_t sensirion_shdlc_rx(struct sensirion_shdlc_rx* rx);
+
+/**
+ * sensirion_shdlc_xcv() - send a command and wait for its response
+ *
+ * The execution state of the response is not checked.
+ *
+ * @addr:       Device address
+ * @cmd:        Command
+ * @data_len:   Number of payload bytes
+ * @data:       Payload
+ * @rx:         Decoder, the response is decoded into it
+ * Return:      0 on success, SENSIRION_SHDLC_ERR_MISMATCH if the response does
+ *              not match @addr and @cmd, an error code otherwise
+ */
+int16_t sensirion_shdlc_xcv(uint8_t addr, uint8_t cmd, uint8_t data_len,
+                            const uint8_t* data,
+                            struct sensirion_shdlc_rx* rx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SENSIRION_SHDLC_H */
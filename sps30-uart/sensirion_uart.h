@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SENSIRION_UART_H
+#define SENSIRION_UART_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "sensirion_arch_config.h"
+
+/*
+ * Platform interface of the UART drivers, the counterpart of sensirion_i2c.h
+ *
+ * The port is configured for 115200 baud, 8 data bits, no parity, one stop
+ * bit and no flow control. sensirion_sleep_usec() is the same function as in
+ * sensirion_i2c.h, platforms which implement both interfaces define it once.
+ */
+
+/**
+ * sensirion_uart_select_port() - select the UART port of the following calls
+ *
+ * @port:   Platform specific port index
+ * Return:  0 on success, an error code otherwise
+ */
+int16_t sensirion_uart_select_port(uint8_t port);
+
+/**
+ * sensirion_uart_open() - open and configure the selected port
+ *
+ * Return:  0 on success, an error code otherwise
+ */
+int16_t sensirion_uart_open(void);
+
+/**
+ * sensirion_uart_close() - close the selected port
+ *
+ * Return:  0 on success, an error code otherwise
+ */
+int16_t sensirion_uart_close(void);
+
+/**
+ * sensirion_uart_tx() - send data
+ *
+ * @data_len:   Number of bytes to send
+ * @data:       Data to send
+ * Return:      Number of bytes sent or a negative error code
+ */
+int16_t sensirion_uart_tx(uint16_t data_len, const uint8_t* data);
+
+/**
+ * sensirion_uart_rx() - receive data
+ *
+ * Returns the bytes received so far. If none are available, the
+ * implementation may wait for a platform specific time for data to arrive,
+ * but must not wait for @max_data_len bytes.
+ *
+ * @max_data_len:   Size of @data
+ * @data:           Memory where the received bytes are written into
+ * Return:          Number of bytes received (0 if none) or a negative error
+ *                  code
+ */
+int16_t sensirion_uart_rx(uint16_t max_data_len, uint8_t* data);
+
+/**
+ * sensirion_sleep_usec() - sleep for a given number of microseconds
+ *
+ * @useconds:   The number of microseconds to sleep
+ */
+void sensirion_sleep_usec(uint32_t useconds);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SENSIRION_UART_H */
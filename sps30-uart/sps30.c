@@ -0,0 +1,498 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sps30.h"
+#include "sensirion_arch_config.h"
+#include "sensirion_common.h"
+#include "sensirion_shdlc.h"
+#include "sensirion_uart.h"
+#include "sps_git_version.h"
+
+#define SPS_CMD_START_MEASUREMENT 0x00
+#define SPS_SUBCMD_MEASUREMENT_START 0x01
+#define SPS_CMD_STOP_MEASUREMENT 0x01
+#define SPS_CMD_READ_MEASUREMENT 0x03
+#define SPS_CMD_SLEEP 0x10
+#define SPS_CMD_WAKE_UP 0x11
+#define SPS_CMD_START_MANUAL_FAN_CLEANING 0x56
+#define SPS_CMD_AUTOCLEAN_INTERVAL 0x80
+#define SPS_SUBCMD_AUTOCLEAN_INTERVAL 0x00
+#define SPS_CMD_DEVICE_INFORMATION 0xd0
+#define SPS_SUBCMD_SERIAL 0x03
+#define SPS_CMD_READ_VERSION 0xd1
+#define SPS_CMD_READ_DEVICE_STATUS_REG 0xd2
+#define SPS_SUBCMD_READ_DEVICE_STATUS_KEEP 0x00
+#define SPS_CMD_RESET 0xd3
+/* switches the UART of a sleeping sensor back on */
+#define SPS_WAKE_UP_PULSE 0xff
+
+#define SPS30_MEASUREMENT_LEN_UINT16 20
+#define SPS30_MEASUREMENT_LEN_FLOAT 40
+#ifdef SPS30_NO_FLOAT
+#define SPS30_MAX_MEASUREMENT_LEN SPS30_MEASUREMENT_LEN_UINT16
+#define SPS30_FORMAT_DEFAULT SPS30_FORMAT_UINT16
+#else
+#define SPS30_MAX_MEASUREMENT_LEN SPS30_MEASUREMENT_LEN_FLOAT
+#define SPS30_FORMAT_DEFAULT SPS30_FORMAT_FLOAT
+#endif
+
+static struct sensirion_shdlc_rx sps30_rx;
+/* format of the next and of the running measurement */
+static uint16_t sps30_format = SPS30_FORMAT_DEFAULT;
+static uint16_t sps30_active_format = SPS30_FORMAT_DEFAULT;
+/* measurement read by sps30_read_data_ready(), 0 bytes if none */
+static uint8_t sps30_kept[SPS30_MAX_MEASUREMENT_LEN];
+static uint8_t sps30_kept_len;
+static uint8_t sps30_read_issued;
+
+const char* sps_get_driver_version(void) {
+    return SPS_DRV_VERSION_STR;
+}
+
+static uint16_t sps30_bytes_to_uint16(const uint8_t* bytes) {
+    return (uint16_t)((uint16_t)bytes[0] << 8 | bytes[1]);
+}
+
+#if !defined(SPS30_NO_FLOAT) || !defined(SPS30_NO_FAN_CLEANING) || \
+    !defined(SPS30_NO_STATUS_REGISTER)
+static uint32_t sps30_bytes_to_uint32(const uint8_t* bytes) {
+    return (uint32_t)bytes[0] << 24 | (uint32_t)bytes[1] << 16 |
+           (uint32_t)bytes[2] << 8 | (uint32_t)bytes[3];
+}
+#endif
+
+static int16_t sps30_check_response(const struct sensirion_shdlc_rx* rx,
+                                    uint8_t cmd) {
+    if (rx->addr != SPS30_SHDLC_ADDRESS || rx->cmd != cmd)
+        return SENSIRION_SHDLC_ERR_MISMATCH;
+    /* the device error flag alone does not fail the command */
+    if (rx->state & (uint8_t)~SPS30_STATE_DEVICE_ERROR)
+        return SPS30_ERR_STATE_MASK | rx->state;
+    return NO_ERROR;
+}
+
+static int16_t sps30_xcv(uint8_t cmd, uint8_t data_len, const uint8_t* data) {
+    int16_t ret;
+
+    sps30_read_issued = 0;
+    ret = sensirion_shdlc_xcv(SPS30_SHDLC_ADDRESS, cmd, data_len, data,
+                              &sps30_rx);
+    if (ret != NO_ERROR)
+        return ret;
+    return sps30_check_response(&sps30_rx, cmd);
+}
+
+static int16_t sps30_read_version(uint8_t* major, uint8_t* minor) {
+    int16_t ret;
+
+    ret = sps30_xcv(SPS_CMD_READ_VERSION, 0, NULL);
+    if (ret != NO_ERROR)
+        return ret;
+    if (sps30_rx.data_len < 2)
+        return SENSIRION_SHDLC_ERR_FRAME;
+
+    *major = sps30_rx.data[0];
+    *minor = sps30_rx.data[1];
+    return NO_ERROR;
+}
+
+int16_t sps30_probe(void) {
+    uint8_t major;
+    uint8_t minor;
+
+#ifndef SPS30_NO_SLEEP
+    /* rejected by a sensor which is awake */
+    (void)sps30_wake_up();
+#endif
+    return sps30_read_version(&major, &minor);
+}
+
+#ifndef SPS30_NO_IDENTITY
+
+int16_t sps30_read_firmware_version(uint8_t* major, uint8_t* minor) {
+    return sps30_read_version(major, minor);
+}
+
+int16_t sps30_get_serial(char* serial) {
+    const uint8_t subcmd = SPS_SUBCMD_SERIAL;
+    uint8_t i;
+    int16_t ret;
+
+    ret = sps30_xcv(SPS_CMD_DEVICE_INFORMATION, sizeof(subcmd), &subcmd);
+    if (ret != NO_ERROR)
+        return ret;
+
+    for (i = 0; i < sps30_rx.data_len && i < SPS30_MAX_SERIAL_LEN - 1; ++i)
+        serial[i] = (char)sps30_rx.data[i];
+    serial[i] = '\0';
+    return NO_ERROR;
+}
+
+#endif /* SPS30_NO_IDENTITY */
+
+int16_t sps30_start_measurement(void) {
+    const uint8_t data[] = {SPS_SUBCMD_MEASUREMENT_START,
+                            (uint8_t)(sps30_format >> 8)};
+    int16_t ret;
+
+    ret = sps30_xcv(SPS_CMD_START_MEASUREMENT, sizeof(data), data);
+    if (ret == NO_ERROR) {
+        sps30_active_format = sps30_format;
+        sps30_kept_len = 0;
+    }
+    return ret;
+}
+
+int16_t sps30_stop_measurement(void) {
+    sps30_kept_len = 0;
+    return sps30_xcv(SPS_CMD_STOP_MEASUREMENT, 0, NULL);
+}
+
+int16_t sps30_set_measurement_format(uint16_t format) {
+#ifdef SPS30_NO_FLOAT
+    if (format != SPS30_FORMAT_UINT16)
+        return SPS30_ERR_FORMAT;
+#else
+    if (format != SPS30_FORMAT_FLOAT && format != SPS30_FORMAT_UINT16)
+        return SPS30_ERR_FORMAT;
+#endif
+
+    sps30_format = format;
+    return 0;
+}
+
+/* an empty response means there is no new measurement */
+static int16_t sps30_check_measurement(uint8_t data_len) {
+    if (data_len == 0)
+        return SPS30_ERR_NO_DATA;
+    if (data_len != (sps30_active_format == SPS30_FORMAT_UINT16
+                         ? SPS30_MEASUREMENT_LEN_UINT16
+                         : SPS30_MEASUREMENT_LEN_FLOAT))
+        return SENSIRION_SHDLC_ERR_FRAME;
+    return NO_ERROR;
+}
+
+/* points @data to the kept measurement or reads a new one */
+static int16_t sps30_read_measurement_data(const uint8_t** data) {
+    int16_t ret;
+
+    if (sps30_kept_len) {
+        sps30_kept_len = 0;
+        *data = sps30_kept;
+        return NO_ERROR;
+    }
+
+    ret = sps30_xcv(SPS_CMD_READ_MEASUREMENT, 0, NULL);
+    if (ret != NO_ERROR)
+        return ret;
+    *data = sps30_rx.data;
+    return sps30_check_measurement(sps30_rx.data_len);
+}
+
+int16_t sps30_read_data_ready(uint16_t* data_ready) {
+    uint8_t i;
+    int16_t ret;
+
+    if (!sps30_kept_len) {
+        ret = sps30_xcv(SPS_CMD_READ_MEASUREMENT, 0, NULL);
+        if (ret == NO_ERROR)
+            ret = sps30_check_measurement(sps30_rx.data_len);
+        if (ret == SPS30_ERR_NO_DATA) {
+            *data_ready = 0;
+            return NO_ERROR;
+        }
+        if (ret != NO_ERROR)
+            return ret;
+
+        for (i = 0; i < sps30_rx.data_len; ++i)
+            sps30_kept[i] = sps30_rx.data[i];
+        sps30_kept_len = sps30_rx.data_len;
+    }
+
+    *data_ready = 1;
+    return NO_ERROR;
+}
+
+static void sps30_decode_u16(const uint8_t* data,
+                             struct sps30_measurement_u16* measurement) {
+    measurement->mc_1p0 = sps30_bytes_to_uint16(&data[0]);
+    measurement->mc_2p5 = sps30_bytes_to_uint16(&data[2]);
+    measurement->mc_4p0 = sps30_bytes_to_uint16(&data[4]);
+    measurement->mc_10p0 = sps30_bytes_to_uint16(&data[6]);
+    measurement->nc_0p5 = sps30_bytes_to_uint16(&data[8]);
+    measurement->nc_1p0 = sps30_bytes_to_uint16(&data[10]);
+    measurement->nc_2p5 = sps30_bytes_to_uint16(&data[12]);
+    measurement->nc_4p0 = sps30_bytes_to_uint16(&data[14]);
+    measurement->nc_10p0 = sps30_bytes_to_uint16(&data[16]);
+    measurement->typical_particle_size = sps30_bytes_to_uint16(&data[18]);
+}
+
+#ifndef SPS30_NO_FLOAT
+
+static float sps30_bytes_to_float(const uint8_t* bytes) {
+    union {
+        uint32_t u32_value;
+        float float32;
+    } tmp;
+
+    tmp.u32_value = sps30_bytes_to_uint32(bytes);
+    return tmp.float32;
+}
+
+static void sps30_decode_float(const uint8_t* data,
+                               struct sps30_measurement* measurement) {
+    measurement->mc_1p0 = sps30_bytes_to_float(&data[0]);
+    measurement->mc_2p5 = sps30_bytes_to_float(&data[4]);
+    measurement->mc_4p0 = sps30_bytes_to_float(&data[8]);
+    measurement->mc_10p0 = sps30_bytes_to_float(&data[12]);
+    measurement->nc_0p5 = sps30_bytes_to_float(&data[16]);
+    measurement->nc_1p0 = sps30_bytes_to_float(&data[20]);
+    measurement->nc_2p5 = sps30_bytes_to_float(&data[24]);
+    measurement->nc_4p0 = sps30_bytes_to_float(&data[28]);
+    measurement->nc_10p0 = sps30_bytes_to_float(&data[32]);
+    measurement->typical_particle_size = sps30_bytes_to_float(&data[36]);
+}
+
+static void sps30_u16_to_float(const struct sps30_measurement_u16* m,
+                               struct sps30_measurement* measurement) {
+    measurement->mc_1p0 = m->mc_1p0;
+    measurement->mc_2p5 = m->mc_2p5;
+    measurement->mc_4p0 = m->mc_4p0;
+    measurement->mc_10p0 = m->mc_10p0;
+    measurement->nc_0p5 = m->nc_0p5;
+    measurement->nc_1p0 = m->nc_1p0;
+    measurement->nc_2p5 = m->nc_2p5;
+    measurement->nc_4p0 = m->nc_4p0;
+    measurement->nc_10p0 = m->nc_10p0;
+    /* nm to um */
+    measurement->typical_particle_size = m->typical_particle_size / 1000.0f;
+}
+
+static void sps30_decode(const uint8_t* data,
+                         struct sps30_measurement* measurement) {
+    struct sps30_measurement_u16 m16;
+
+    if (sps30_active_format == SPS30_FORMAT_UINT16) {
+        sps30_decode_u16(data, &m16);
+        sps30_u16_to_float(&m16, measurement);
+    } else {
+        sps30_decode_float(data, measurement);
+    }
+}
+
+int16_t sps30_read_measurement(struct sps30_measurement* measurement) {
+    const uint8_t* data;
+    int16_t ret;
+
+    ret = sps30_read_measurement_data(&data);
+    if (ret != NO_ERROR)
+        return ret;
+
+    sps30_decode(data, measurement);
+    return NO_ERROR;
+}
+
+#endif /* SPS30_NO_FLOAT */
+
+int16_t sps30_read_measurement_u16(struct sps30_measurement_u16* measurement) {
+    const uint8_t* data;
+    int16_t ret;
+
+    if (sps30_active_format != SPS30_FORMAT_UINT16)
+        return SPS30_ERR_FORMAT;
+
+    ret = sps30_read_measurement_data(&data);
+    if (ret != NO_ERROR)
+        return ret;
+
+    sps30_decode_u16(data, measurement);
+    return NO_ERROR;
+}
+
+int16_t sps30_issue_read_measurement(void) {
+    int16_t ret;
+
+    sps30_kept_len = 0;
+    sensirion_shdlc_rx_init(&sps30_rx);
+    ret = sensirion_shdlc_tx(SPS30_SHDLC_ADDRESS, SPS_CMD_READ_MEASUREMENT, 0,
+                             NULL);
+    sps30_read_issued = (ret == NO_ERROR);
+    return ret;
+}
+
+/* feeds the bytes received so far, then as sps30_read_measurement_data() */
+static int16_t sps30_complete_read_measurement_data(const uint8_t** data) {
+    int16_t ret;
+
+    if (!sps30_read_issued)
+        return SPS30_ERR_NOT_ISSUED;
+
+    ret = sensirion_shdlc_rx_poll(&sps30_rx);
+    /* the start of the response may have ended a stale frame */
+    if (ret == 0 || (ret < 0 && sensirion_shdlc_rx_in_frame(&sps30_rx)))
+        return SPS30_ERR_NOT_READY;
+    sps30_read_issued = 0;
+    if (ret < 0)
+        return ret;
+
+    ret = sps30_check_response(&sps30_rx, SPS_CMD_READ_MEASUREMENT);
+    if (ret != NO_ERROR)
+        return ret;
+    *data = sps30_rx.data;
+    return sps30_check_measurement(sps30_rx.data_len);
+}
+
+#ifndef SPS30_NO_FLOAT
+
+int16_t sps30_complete_read_measurement(struct sps30_measurement* measurement) {
+    const uint8_t* data;
+    int16_t ret;
+
+    ret = sps30_complete_read_measurement_data(&data);
+    if (ret != NO_ERROR)
+        return ret;
+
+    sps30_decode(data, measurement);
+    return NO_ERROR;
+}
+
+#endif /* SPS30_NO_FLOAT */
+
+int16_t sps30_complete_read_measurement_u16(
+    struct sps30_measurement_u16* measurement) {
+    const uint8_t* data;
+    int16_t ret;
+
+    if (sps30_active_format != SPS30_FORMAT_UINT16)
+        return SPS30_ERR_FORMAT;
+
+    ret = sps30_complete_read_measurement_data(&data);
+    if (ret != NO_ERROR)
+        return ret;
+
+    sps30_decode_u16(data, measurement);
+    return NO_ERROR;
+}
+
+#ifndef SPS30_NO_FAN_CLEANING
+
+int16_t sps30_get_fan_auto_cleaning_interval(uint32_t* interval_seconds) {
+    const uint8_t subcmd = SPS_SUBCMD_AUTOCLEAN_INTERVAL;
+    int16_t ret;
+
+    ret = sps30_xcv(SPS_CMD_AUTOCLEAN_INTERVAL, sizeof(subcmd), &subcmd);
+    if (ret != NO_ERROR)
+        return ret;
+    if (sps30_rx.data_len < 4)
+        return SENSIRION_SHDLC_ERR_FRAME;
+
+    *interval_seconds = sps30_bytes_to_uint32(sps30_rx.data);
+    return NO_ERROR;
+}
+
+int16_t sps30_set_fan_auto_cleaning_interval(uint32_t interval_seconds) {
+    const uint8_t data[] = {SPS_SUBCMD_AUTOCLEAN_INTERVAL,
+                            (uint8_t)(interval_seconds >> 24),
+                            (uint8_t)(interval_seconds >> 16),
+                            (uint8_t)(interval_seconds >> 8),
+                            (uint8_t)interval_seconds};
+
+    return sps30_xcv(SPS_CMD_AUTOCLEAN_INTERVAL, sizeof(data), data);
+}
+
+int16_t sps30_get_fan_auto_cleaning_interval_days(uint8_t* interval_days) {
+    uint32_t interval_seconds;
+    int16_t ret;
+
+    ret = sps30_get_fan_auto_cleaning_interval(&interval_seconds);
+    if (ret != NO_ERROR)
+        return ret;
+
+    *interval_days = (uint8_t)(interval_seconds / (24 * 60 * 60));
+    return NO_ERROR;
+}
+
+int16_t sps30_set_fan_auto_cleaning_interval_days(uint8_t interval_days) {
+    return sps30_set_fan_auto_cleaning_interval((uint32_t)interval_days * 24 *
+                                                60 * 60);
+}
+
+int16_t sps30_start_manual_fan_cleaning(void) {
+    return sps30_xcv(SPS_CMD_START_MANUAL_FAN_CLEANING, 0, NULL);
+}
+
+#endif /* SPS30_NO_FAN_CLEANING */
+
+int16_t sps30_reset(void) {
+    sps30_kept_len = 0;
+    return sps30_xcv(SPS_CMD_RESET, 0, NULL);
+}
+
+int16_t sps30_refresh_cache(void) {
+    sps30_kept_len = 0;
+    return NO_ERROR;
+}
+
+#ifndef SPS30_NO_SLEEP
+
+int16_t sps30_sleep(void) {
+    return sps30_xcv(SPS_CMD_SLEEP, 0, NULL);
+}
+
+int16_t sps30_wake_up(void) {
+    const uint8_t pulse = SPS_WAKE_UP_PULSE;
+    int16_t ret;
+
+    ret = sensirion_uart_tx(sizeof(pulse), &pulse);
+    if (ret < 0)
+        return ret;
+    return sps30_xcv(SPS_CMD_WAKE_UP, 0, NULL);
+}
+
+#endif /* SPS30_NO_SLEEP */
+
+#ifndef SPS30_NO_STATUS_REGISTER
+
+int16_t sps30_read_device_status_register(uint32_t* device_status_flags) {
+    const uint8_t subcmd = SPS_SUBCMD_READ_DEVICE_STATUS_KEEP;
+    int16_t ret;
+
+    ret = sps30_xcv(SPS_CMD_READ_DEVICE_STATUS_REG, sizeof(subcmd), &subcmd);
+    if (ret != NO_ERROR)
+        return ret;
+    if (sps30_rx.data_len < 4)
+        return SENSIRION_SHDLC_ERR_FRAME;
+
+    *device_status_flags = sps30_bytes_to_uint32(sps30_rx.data);
+    return NO_ERROR;
+}
+
+#endif /* SPS30_NO_STATUS_REGISTER */
@@ -0,0 +1,411 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SPS30_H
+#define SPS30_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "sensirion_arch_config.h"
+#include "sensirion_common.h"
+#include "sensirion_shdlc.h"
+#include "sensirion_uart.h"
+
+/*
+ * SPS30 driver for the UART (SHDLC) interface
+ *
+ * The API is the one of the I2C driver's sps30.h for a single sensor on the
+ * port selected with sensirion_uart_select_port(), so that applications
+ * switch interfaces by building against this directory instead of
+ * sps30-i2c. The SPS30_NO_* feature selection applies as well. The UART
+ * runs at 115200 baud and works over cable lengths where I2C fails.
+ *
+ * Errors of the SHDLC layer are returned as SENSIRION_SHDLC_ERR_*. If the
+ * sensor rejects a command, the error code has SPS30_ERR_STATE_MASK set and
+ * carries the sensor's state byte, see SPS30_GET_ERR_STATE().
+ */
+
+#define SPS30_SHDLC_ADDRESS 0x00
+#define SPS30_MAX_SERIAL_LEN 32
+/* 1s measurement intervals */
+#define SPS30_MEASUREMENT_DURATION_USEC 1000000
+/* 100ms delay after resetting the sensor */
+#define SPS30_RESET_DELAY_USEC 100000
+/** The fan is switched on but not running */
+#define SPS30_DEVICE_STATUS_FAN_ERROR_MASK (1 << 4)
+/** The laser current is out of range */
+#define SPS30_DEVICE_STATUS_LASER_ERROR_MASK (1 << 5)
+/** The fan speed is out of range */
+#define SPS30_DEVICE_STATUS_FAN_SPEED_WARNING (1 << 21)
+
+/** The response to an issued read is still being received */
+#define SPS30_ERR_NOT_READY (-2)
+/** A command was completed without being issued first */
+#define SPS30_ERR_NOT_ISSUED (-3)
+/** The measurement is not available in the requested output format */
+#define SPS30_ERR_FORMAT (-4)
+/** The response of the sensor failed the checksum */
+#define SPS30_ERR_CRC SENSIRION_SHDLC_ERR_CHECKSUM
+/** The sensor has no new measurement since the last read */
+#define SPS30_ERR_NO_DATA (-6)
+/** The sensor rejected the command, the state byte is in the low bits */
+#define SPS30_ERR_STATE_MASK 0x100
+#define SPS30_IS_ERR_STATE(err_code) (((err_code) | 0xff) == 0x1ff)
+#define SPS30_GET_ERR_STATE(err_code) ((err_code)&0xff)
+
+/** State bytes of rejected commands, see SPS30_GET_ERR_STATE() */
+#define SPS30_STATE_WRONG_DATA_LENGTH 0x01
+#define SPS30_STATE_UNKNOWN_COMMAND 0x02
+#define SPS30_STATE_NO_ACCESS 0x03
+#define SPS30_STATE_ILLEGAL_PARAMETER 0x04
+#define SPS30_STATE_OUT_OF_RANGE 0x28
+#define SPS30_STATE_NOT_ALLOWED 0x43
+/** Flag of the state byte: the device status register reports an error */
+#define SPS30_STATE_DEVICE_ERROR 0x80
+
+/** Measurement output formats, see sps30_set_measurement_format() */
+#define SPS30_FORMAT_FLOAT 0x0300
+#define SPS30_FORMAT_UINT16 0x0500
+
+struct sps30_measurement {
+    float mc_1p0;
+    float mc_2p5;
+    float mc_4p0;
+    float mc_10p0;
+    float nc_0p5;
+    float nc_1p0;
+    float nc_2p5;
+    float nc_4p0;
+    float nc_10p0;
+    float typical_particle_size;
+};
+
+/**
+ * struct sps30_measurement_u16 - measurement in the SPS30_FORMAT_UINT16 format
+ *
+ * Mass concentrations are in ug/m^3, number concentrations in #/cm^3 and the
+ * typical particle size is in nm (instead of um as in struct
+ * sps30_measurement).
+ */
+struct sps30_measurement_u16 {
+    uint16_t mc_1p0;
+    uint16_t mc_2p5;
+    uint16_t mc_4p0;
+    uint16_t mc_10p0;
+    uint16_t nc_0p5;
+    uint16_t nc_1p0;
+    uint16_t nc_2p5;
+    uint16_t nc_4p0;
+    uint16_t nc_10p0;
+    uint16_t typical_particle_size;
+};
+
+/**
+ * sps_get_driver_version() - Return the driver version
+ * Return:  Driver version string
+ */
+const char* sps_get_driver_version(void);
+
+/**
+ * sps30_probe() - check if SPS sensor is available and initialize it
+ *
+ * Note that Pin 4 must be left floating for the sensor to operate in UART
+ * mode (this driver). The port must have been opened with
+ * sensirion_uart_open(). A sleeping sensor is woken up.
+ *
+ * Return:  0 on success, an error code otherwise
+ */
+int16_t sps30_probe(void);
+
+#ifndef SPS30_NO_IDENTITY
+/**
+ * sps30_read_firmware_version - read the firmware version
+ *
+ * @major:  Memory where the firmware major version is written into
+ * @minor:  Memory where the firmware minor version is written into
+ *
+ * Return:  0 on success, an error code otherwise
+ */
+int16_t sps30_read_firmware_version(uint8_t* major, uint8_t* minor);
+
+/**
+ * sps30_get_serial() - retrieve the serial number
+ *
+ * Note that serial must be discarded when the return code is non-zero.
+ *
+ * @serial: Memory where the serial number is written into as string (zero
+ *          terminated). Must be at least SPS30_MAX_SERIAL_LEN long.
+ * Return:  0 on success, an error code otherwise
+ */
+int16_t sps30_get_serial(char* serial);
+#endif /* SPS30_NO_IDENTITY */
+
+/**
+ * sps30_start_measurement() - start measuring
+ *
+ * Once the measurement is started, measurements are retrievable once per second
+ * with sps30_read_measurement.
+ *
+ * Return:  0 on success, an error code otherwise
+ */
+int16_t sps30_start_measurement(void);
+
+/**
+ * sps30_stop_measurement() - stop measuring
+ *
+ * Stops measuring and puts the sensor back into idle mode.
+ *
+ * Return:  0 on success, an error code otherwise
+ */
+int16_t sps30_stop_measurement(void);
+
+/**
+ * sps30_read_data_ready() - check for a new measurement
+ *
+ * The UART interface has no data-ready command. The measurement is read
+ * instead and kept for the next sps30_read_measurement() or
+ * sps30_read_measurement_u16() call.
+ *
+ * @data_ready: Memory where the data-ready flag (0|1) is stored.
+ * Return:      0 on success, an error code otherwise
+ */
+int16_t sps30_read_data_ready(uint16_t* data_ready);
+
+#ifndef SPS30_NO_FLOAT
+/**
+ * sps30_read_measurement() - read a measurement
+ *
+ * Read the measurement taken since the last read.
+ *
+ * Return:  0 on success, SPS30_ERR_NO_DATA if there is no new measurement, an
+ *          error code otherwise
+ */
+int16_t sps30_read_measurement(struct sps30_measurement* measurement);
+#endif /* SPS30_NO_FLOAT */
+
+/**
+ * sps30_set_measurement_format() - select the measurement output format
+ *
+ * The format is applied on the next sps30_start_measurement(). The default is
+ * SPS30_FORMAT_FLOAT. With SPS30_FORMAT_UINT16 the sensor transfers half the
+ * amount of data per measurement which can be read without any floating point
+ * operations with sps30_read_measurement_u16(). sps30_read_measurement() works
+ * with both formats, integer values are converted to float.
+ *
+ * With SPS30_NO_FLOAT, SPS30_FORMAT_UINT16 is the default and the only
+ * supported format.
+ *
+ * @format: SPS30_FORMAT_FLOAT or SPS30_FORMAT_UINT16
+ * Return:  0 on success, SPS30_ERR_FORMAT if the format is not supported
+ */
+int16_t sps30_set_measurement_format(uint16_t format);
+
+/**
+ * sps30_read_measurement_u16() - read a measurement in integer format
+ *
+ * Read the measurement taken since the last read. The measurement must have
+ * been started with the SPS30_FORMAT_UINT16 output format.
+ *
+ * Return:  0 on success, SPS30_ERR_FORMAT if the measurement runs in float
+ *          format, SPS30_ERR_NO_DATA if there is no new measurement, an error
+ *          code otherwise
+ */
+int16_t sps30_read_measurement_u16(struct sps30_measurement_u16* measurement);
+
+/**
+ * sps30_issue_read_measurement() - send a measurement read without waiting
+ * for the response
+ *
+ * The response is collected with sps30_complete_read_measurement() or
+ * sps30_complete_read_measurement_u16(). No other command may be sent in
+ * between.
+ *
+ * Return:  0 on success, an error code otherwise
+ */
+int16_t sps30_issue_read_measurement(void);
+
+#ifndef SPS30_NO_FLOAT
+/**
+ * sps30_complete_read_measurement() - collect the response of an issued read
+ *
+ * Takes the bytes received so far, the response may arrive over any number of
+ * calls. Broken frames ahead of the response are skipped, so the caller
+ * bounds the wait with its own timeout. See sps30_read_measurement().
+ *
+ * Return:  0 on success, SPS30_ERR_NOT_READY while the response is incomplete,
+ *          SPS30_ERR_NOT_ISSUED if no read was issued, SPS30_ERR_NO_DATA if
+ *          there is no new measurement, an error code otherwise
+ */
+int16_t sps30_complete_read_measurement(struct sps30_measurement* measurement);
+#endif /* SPS30_NO_FLOAT */
+
+/**
+ * sps30_complete_read_measurement_u16() - collect the response of an issued
+ * read in integer format
+ *
+ * See sps30_complete_read_measurement() and sps30_read_measurement_u16().
+ */
+int16_t sps30_complete_read_measurement_u16(
+    struct sps30_measurement_u16* measurement);
+
+#ifndef SPS30_NO_FAN_CLEANING
+/**
+ * sps30_get_fan_auto_cleaning_interval() - read the current(*) auto-cleaning
+ * interval
+ *
+ * Note that interval_seconds must be discarded when the return code is
+ * non-zero.
+ *
+ * (*) Note that due to a firmware bug on FW<2.2, the reported interval is only
+ * updated on sensor restart/reset. If the interval was thus updated after the
+ * last reset, the old value is still reported. Power-cycle the sensor or call
+ * sps30_reset() first if you need the latest value.
+ *
+ * @interval_seconds:   Memory where the interval in seconds is stored
+ * Return:              0 on success, an error code otherwise
+ */
+int16_t sps30_get_fan_auto_cleaning_interval(uint32_t* interval_seconds);
+
+/**
+ * sps30_set_fan_auto_cleaning_interval() - set the current auto-cleaning
+ * interval
+ *
+ * @interval_seconds:   Value in seconds used to sets the auto-cleaning
+ *                      interval, 0 to disable auto cleaning
+ * Return:              0 on success, an error code otherwise
+ */
+int16_t sps30_set_fan_auto_cleaning_interval(uint32_t interval_seconds);
+
+/**
+ * sps30_get_fan_auto_cleaning_interval_days() - convenience function to read
+ * the current(*) auto-cleaning interval in days
+ *
+ * See sps30_get_fan_auto_cleaning_interval(), the value is cut, not rounded.
+ *
+ * @interval_days:  Memory where the interval in days is stored
+ * Return:          0 on success, an error code otherwise
+ */
+int16_t sps30_get_fan_auto_cleaning_interval_days(uint8_t* interval_days);
+
+/**
+ * sps30_set_fan_auto_cleaning_interval_days() - convenience function to set the
+ * current auto-cleaning interval in days
+ *
+ * @interval_days:  Value in days used to sets the auto-cleaning interval, 0 to
+ *                  disable auto cleaning
+ * Return:          0 on success, an error code otherwise
+ */
+int16_t sps30_set_fan_auto_cleaning_interval_days(uint8_t interval_days);
+
+/**
+ * sps30_start_manual_fan_cleaning() - Immediately trigger the fan cleaning
+ *
+ * Note that this command can only be run when the sensor is in measurement
+ * mode, i.e. after sps30_start_measurement() without subsequent
+ * sps30_stop_measurement().
+ *
+ * Return:          0 on success, an error code otherwise
+ */
+int16_t sps30_start_manual_fan_cleaning(void);
+#endif /* SPS30_NO_FAN_CLEANING */
+
+/**
+ * sps30_reset() - reset the SPS30
+ *
+ * The caller should wait at least SPS30_RESET_DELAY_USEC microseconds before
+ * interacting with the sensor again in order for the sensor to restart.
+ *
+ * Return:          0 on success, an error code otherwise
+ */
+int16_t sps30_reset(void);
+
+/**
+ * sps30_refresh_cache() - drop cached values
+ *
+ * Drops a measurement kept by sps30_read_data_ready(). Identity and
+ * auto-cleaning interval are not cached by the UART driver.
+ *
+ * Return:          0
+ */
+int16_t sps30_refresh_cache(void);
+
+#ifndef SPS30_NO_SLEEP
+/**
+ * sps30_sleep() - Send the (idle) sensor to sleep
+ *
+ * The sensor will reduce its power consumption to a minimum and switches off
+ * its UART, it must be woken up again with sps30_wake_up() prior to resuming
+ * operations. It will only suceed if the sensor is idle, i.e. not currently
+ * measuring.
+ * Note that this command only works on firmware 2.0 or more recent.
+ *
+ * Return:          0 on success, an error code otherwise (e.g. if the firmware
+ *                  does not support the command)
+ */
+int16_t sps30_sleep(void);
+
+/**
+ * sps30_wake_up() - Wake up the sensor from sleep
+ *
+ * Sends a single 0xff byte to switch the sensor's UART back on, followed by
+ * the wake-up command.
+ * Note that this command only works on firmware 2.0 or more recent.
+ *
+ * Return:          0 on success, an error code otherwise (e.g. if the firmware
+ *                  does not support the command)
+ */
+int16_t sps30_wake_up(void);
+#endif /* SPS30_NO_SLEEP */
+
+#ifndef SPS30_NO_STATUS_REGISTER
+/**
+ * sps30_read_device_status_register() - Read the Device Status Register
+ *
+ * Reads the Device Status Register which reveals info, warnings and errors
+ * about the sensor's current operational state. The register is not cleared.
+ * Note that this command only works on firmware 2.2 or more recent.
+ *
+ * @device_status_flags:    Memory where the device status flags are written
+ *                          into
+ *
+ * Return:          0 on success, an error code otherwise (e.g. if the firmware
+ *                  does not support the command)
+ */
+int16_t sps30_read_device_status_register(uint32_t* device_status_flags);
+#endif /* SPS30_NO_STATUS_REGISTER */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPS30_H */
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>  // printf
+
+#include "sps30.h"
+
+/**
+ * TO USE CONSOLE OUTPUT (printf) PLEASE ADAPT TO YOUR PLATFORM:
+ * #define printf(...)
+ */
+
+int main(void) {
+#ifndef SPS30_NO_FLOAT
+    struct sps30_measurement m;
+#else
+    struct sps30_measurement_u16 m;
+#endif
+    int16_t ret;
+
+    /* Open the first UART port */
+    sensirion_uart_select_port(0);
+    while (sensirion_uart_open() != 0) {
+        printf("UART init failed\n");
+        sensirion_sleep_usec(1000000); /* wait 1s */
+    }
+
+    /* Busy loop for initialization, because the main loop does not work without
+     * a sensor.
+     */
+    while (sps30_probe() != 0) {
+        printf("SPS sensor probing failed\n");
+        sensirion_sleep_usec(1000000); /* wait 1s */
+    }
+    printf("SPS sensor probing successful\n");
+
+#ifndef SPS30_NO_IDENTITY
+    uint8_t fw_major;
+    uint8_t fw_minor;
+    ret = sps30_read_firmware_version(&fw_major, &fw_minor);
+    if (ret) {
+        printf("error reading firmware version\n");
+    } else {
+        printf("FW: %u.%u\n", fw_major, fw_minor);
+    }
+
+    char serial_number[SPS30_MAX_SERIAL_LEN];
+    ret = sps30_get_serial(serial_number);
+    if (ret) {
+        printf("error reading serial number\n");
+    } else {
+        printf("Serial Number: %s\n", serial_number);
+    }
+#endif
+
+    ret = sps30_start_measurement();
+    if (ret < 0)
+        printf("error starting measurement\n");
+    printf("measurements started\n");
+
+    while (1) {
+        sensirion_sleep_usec(SPS30_MEASUREMENT_DURATION_USEC); /* wait 1s */
+#ifndef SPS30_NO_FLOAT
+        ret = sps30_read_measurement(&m);
+#else
+        ret = sps30_read_measurement_u16(&m);
+#endif
+        if (ret == SPS30_ERR_NO_DATA) {
+            printf("no new measurement\n");
+
+        } else if (ret < 0) {
+            printf("error reading measurement\n");
+
+        } else {
+#ifndef SPS30_NO_FLOAT
+            printf("measured values:\n"
+                   "\t%0.2f pm1.0\n"
+                   "\t%0.2f pm2.5\n"
+                   "\t%0.2f pm4.0\n"
+                   "\t%0.2f pm10.0\n"
+                   "\t%0.2f nc0.5\n"
+                   "\t%0.2f nc1.0\n"
+                   "\t%0.2f nc2.5\n"
+                   "\t%0.2f nc4.5\n"
+                   "\t%0.2f nc10.0\n"
+                   "\t%0.2f typical particle size\n\n",
+                   m.mc_1p0, m.mc_2p5, m.mc_4p0, m.mc_10p0, m.nc_0p5, m.nc_1p0,
+                   m.nc_2p5, m.nc_4p0, m.nc_10p0, m.typical_particle_size);
+#else
+            printf("measured values:\n"
+                   "\t%u pm1.0\n"
+                   "\t%u pm2.5\n"
+                   "\t%u pm4.0\n"
+                   "\t%u pm10.0\n"
+                   "\t%u nc0.5\n"
+                   "\t%u nc1.0\n"
+                   "\t%u nc2.5\n"
+                   "\t%u nc4.5\n"
+                   "\t%u nc10.0\n"
+                   "\t%u typical particle size (nm)\n\n",
+                   m.mc_1p0, m.mc_2p5, m.mc_4p0, m.mc_10p0, m.nc_0p5, m.nc_1p0,
+                   m.nc_2p5, m.nc_4p0, m.nc_10p0, m.typical_particle_size);
+#endif
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,102 @@
+#include "sensirion_test_setup.h"
+#include "sps30_aqi.h"
+
+#define HOUR 3600
+
+/* hourly PM2.5 averages, newest first */
+static const float hourly_pm2p5[SPS30_AQI_HOURS] = {
+    30.0f, 20.0f, 10.0f, 12.0f, 15.0f, 18.0f,
+    25.0f, 40.0f, 33.0f, 22.0f, 11.0f, 9.0f};
+
+static void aqi_add(struct sps30_aqi* aqi, uint32_t t, float pm2p5,
+                    float pm10) {
+    struct sps30_measurement m;
+
+    memset(&m, 0, sizeof(m));
+    m.mc_2p5 = pm2p5;
+    m.mc_10p0 = pm10;
+    sps30_aqi_add(aqi, t, &m);
+}
+
+TEST_GROUP (SPSAqiTestGroup) {
+    struct sps30_aqi aqi;
+    struct sps30_aqi_result result;
+
+    void setup() {
+    }
+
+    void teardown() {
+    }
+};
+
+TEST (SPSAqiTestGroup, SPS30AqiTest_breakpoints) {
+    CHECK_EQUAL(0, sps30_aqi_from_concentration(SPS30_AQI_PM2P5, 0.0f));
+    CHECK_EQUAL(50, sps30_aqi_from_concentration(SPS30_AQI_PM2P5, 9.0f));
+    CHECK_EQUAL(50, sps30_aqi_from_concentration(SPS30_AQI_PM2P5, 9.09f));
+    CHECK_EQUAL(51, sps30_aqi_from_concentration(SPS30_AQI_PM2P5, 9.1f));
+    CHECK_EQUAL(100, sps30_aqi_from_concentration(SPS30_AQI_PM2P5, 35.4f));
+    CHECK_EQUAL(151, sps30_aqi_from_concentration(SPS30_AQI_PM2P5, 55.5f));
+    CHECK_EQUAL(500, sps30_aqi_from_concentration(SPS30_AQI_PM2P5, 325.4f));
+    CHECK_EQUAL(500, sps30_aqi_from_concentration(SPS30_AQI_PM2P5, 1000.0f));
+    CHECK_EQUAL(50, sps30_aqi_from_concentration(SPS30_AQI_PM10, 54.9f));
+    CHECK_EQUAL(51, sps30_aqi_from_concentration(SPS30_AQI_PM10, 55.0f));
+    CHECK_EQUAL(200, sps30_aqi_from_concentration(SPS30_AQI_PM10, 354.0f));
+    CHECK_EQUAL(500, sps30_aqi_from_concentration(SPS30_AQI_PM10, 604.0f));
+}
+
+TEST (SPSAqiTestGroup, SPS30AqiTest_requires_recent_hours) {
+    sps30_aqi_init(&aqi, 1);
+    CHECK_EQUAL(STATUS_FAIL, sps30_aqi_get(&aqi, &result));
+
+    /* the current hour does not count until it is complete */
+    aqi_add(&aqi, 0, 10.0f, 20.0f);
+    aqi_add(&aqi, HOUR - 1, 10.0f, 20.0f);
+    CHECK_EQUAL(STATUS_FAIL, sps30_aqi_get(&aqi, &result));
+    aqi_add(&aqi, HOUR, 10.0f, 20.0f);
+    CHECK_EQUAL(STATUS_FAIL, sps30_aqi_get(&aqi, &result));
+    aqi_add(&aqi, 2 * HOUR, 10.0f, 20.0f);
+    CHECK_ZERO(sps30_aqi_get(&aqi, &result));
+    DOUBLES_EQUAL(10.0, result.nowcast_pm2p5, 1e-4);
+    DOUBLES_EQUAL(20.0, result.nowcast_pm10, 1e-4);
+
+    /* a gap of two hours leaves only one of the three recent hours */
+    aqi_add(&aqi, 5 * HOUR, 10.0f, 20.0f);
+    CHECK_EQUAL(STATUS_FAIL, sps30_aqi_get(&aqi, &result));
+}
+
+TEST (SPSAqiTestGroup, SPS30AqiTest_min_samples) {
+    uint32_t t;
+
+    sps30_aqi_init(&aqi, 3 * HOUR / 4);
+    for (t = 0; t < HOUR; ++t)
+        aqi_add(&aqi, t, 10.0f, 20.0f);
+    for (t = HOUR; t < HOUR + HOUR / 2; ++t)
+        aqi_add(&aqi, t, 10.0f, 20.0f);
+    for (t = 2 * HOUR; t <= 3 * HOUR; ++t)
+        aqi_add(&aqi, t, 10.0f, 20.0f);
+    /* the half covered hour is not valid */
+    CHECK_ZERO(sps30_aqi_get(&aqi, &result));
+    aqi_add(&aqi, 4 * HOUR, 10.0f, 20.0f);
+    CHECK_EQUAL(STATUS_FAIL, sps30_aqi_get(&aqi, &result));
+}
+
+TEST (SPSAqiTestGroup, SPS30AqiTest_nowcast) {
+    uint32_t h;
+
+    sps30_aqi_init(&aqi, 1);
+    for (h = 0; h < SPS30_AQI_HOURS; ++h) {
+        const float pm2p5 = hourly_pm2p5[SPS30_AQI_HOURS - 1 - h];
+
+        aqi_add(&aqi, h * HOUR, pm2p5 - 1.0f, 100.0f);
+        aqi_add(&aqi, h * HOUR + 1800, pm2p5 + 1.0f, 100.0f);
+    }
+    aqi_add(&aqi, SPS30_AQI_HOURS * HOUR, 0.0f, 0.0f);
+
+    /* weight 0.5, NowCast 23.2007 truncated to 23.2 */
+    CHECK_ZERO(sps30_aqi_get(&aqi, &result));
+    DOUBLES_EQUAL(23.2, result.nowcast_pm2p5, 1e-4);
+    DOUBLES_EQUAL(100.0, result.nowcast_pm10, 1e-4);
+    CHECK_EQUAL(77, result.aqi_pm2p5);
+    CHECK_EQUAL(73, result.aqi_pm10);
+    CHECK_EQUAL(77, result.aqi);
+}
@@ -0,0 +1,97 @@
+#include "sensirion_common.h"
+#include "sensirion_test_setup.h"
+#include "sps30_batch.h"
+
+#include <math.h>  // NAN
+
+/* covers the 8, 4 and single sample steps of every implementation */
+#define NUM_SAMPLES 23
+
+static void encode(uint8_t* payload, uint8_t column, float value) {
+    uint32_t raw;
+
+    memcpy(&raw, &value, sizeof(raw));
+    payload[column * 4] = (uint8_t)(raw >> 24);
+    payload[column * 4 + 1] = (uint8_t)(raw >> 16);
+    payload[column * 4 + 2] = (uint8_t)(raw >> 8);
+    payload[column * 4 + 3] = (uint8_t)raw;
+}
+
+static uint32_t bits(float value) {
+    uint32_t raw;
+
+    memcpy(&raw, &value, sizeof(raw));
+    return raw;
+}
+
+TEST_GROUP (SPSBatchTestGroup) {
+    uint8_t payloads[NUM_SAMPLES][SPS30_BATCH_PAYLOAD_SIZE];
+    float columns[SPS30_BATCH_NUM_COLUMNS][NUM_SAMPLES + 3];
+
+    void setup() {
+        uint8_t i;
+        uint8_t c;
+
+        for (i = 0; i < NUM_SAMPLES; ++i) {
+            for (c = 0; c < SPS30_BATCH_NUM_COLUMNS; ++c)
+                encode(payloads[i], c, (float)(i * 100 + c) + 0.25f);
+        }
+        memset(columns, 0xa5, sizeof(columns));
+    }
+};
+
+TEST (SPSBatchTestGroup, SPS30BatchTest_implementation) {
+#ifdef SPS30_BATCH_NO_SIMD
+    STRCMP_EQUAL("scalar", sps30_batch_implementation());
+#else
+    CHECK_TRUE(sps30_batch_implementation() != NULL);
+#endif
+}
+
+TEST (SPSBatchTestGroup, SPS30BatchTest_columns) {
+    const uint32_t stride = NUM_SAMPLES + 3;
+    uint32_t i;
+    uint8_t c;
+
+    for (i = 1; i <= NUM_SAMPLES; ++i) {
+        memset(columns, 0xa5, sizeof(columns));
+        sps30_batch_decode(&payloads[0][0], i, &columns[0][0], stride);
+        for (c = 0; c < SPS30_BATCH_NUM_COLUMNS; ++c) {
+            DOUBLES_EQUAL(c + 0.25, columns[c][0], 0);
+            DOUBLES_EQUAL((i - 1) * 100 + c + 0.25, columns[c][i - 1], 0);
+            /* the gap up to the next column is left alone */
+            CHECK_EQUAL(0xa5a5a5a5, bits(columns[c][i]));
+        }
+    }
+}
+
+TEST (SPSBatchTestGroup, SPS30BatchTest_matches_driver) {
+    uint8_t i;
+    uint8_t c;
+
+    sps30_batch_decode(&payloads[0][0], NUM_SAMPLES, &columns[0][0],
+                       NUM_SAMPLES + 3);
+    for (i = 0; i < NUM_SAMPLES; ++i) {
+        for (c = 0; c < SPS30_BATCH_NUM_COLUMNS; ++c) {
+            CHECK_EQUAL(bits(sensirion_bytes_to_float(&payloads[i][c * 4])),
+                        bits(columns[c][i]));
+        }
+    }
+}
+
+TEST (SPSBatchTestGroup, SPS30BatchTest_special_values) {
+    const float values[] = {0.0f, -0.0f, NAN, -INFINITY, 1e-45f, 3.4e38f};
+    const uint8_t n = sizeof(values) / sizeof(values[0]);
+    uint8_t i;
+
+    for (i = 0; i < NUM_SAMPLES; ++i)
+        encode(payloads[i], SPS30_BATCH_TYPICAL_PARTICLE_SIZE, values[i % n]);
+    sps30_batch_decode(&payloads[0][0], NUM_SAMPLES, &columns[0][0],
+                       NUM_SAMPLES + 3);
+    for (i = 0; i < NUM_SAMPLES; ++i) {
+        CHECK_EQUAL(bits(values[i % n]),
+                    bits(columns[SPS30_BATCH_TYPICAL_PARTICLE_SIZE][i]));
+        DOUBLES_EQUAL(i * 100 + SPS30_BATCH_NC_10P0 + 0.25,
+                      columns[SPS30_BATCH_NC_10P0][i], 0);
+    }
+}
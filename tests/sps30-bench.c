@@ -0,0 +1,490 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Micro-benchmark of the SPS30 driver against the simulated sensor
+ *
+ * Every driver entry point is called repeatedly and the following costs per
+ * call are reported:
+ *  - CPU time of the host (including the simulation)
+ *  - number of bus transactions and payload bytes on the bus
+ *  - time spent on the bus at the simulated bus clock
+ *  - time the driver spent in sensirion_sleep_usec()
+ *
+ * Getters of values cached in the handle are reported twice: with the cached
+ * value dropped before each call and as cache hits.
+ *
+ * Decoding many float measurements is compared per sample, as done by
+ * sps30_read_measurement(), and in batches with sps30_batch.h, against a copy
+ * of the same amount of data as reference for the memory bandwidth.
+ *
+ * The CRC check of a measurement frame is compared between the common code
+ * and sps30_check_crcs() in the configured variant (CONFIG_SPS30_CRC).
+ * Decoding a measurement frame at once is compared with the work left to the
+ * incremental decoder when the last word arrives.
+ *
+ * Usage: sps30-bench [iterations] [bus clock in Hz]
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>   // printf
+#include <stdlib.h>  // malloc, strtoul
+#include <string.h>  // memcpy, memset
+#include <time.h>    // clock_gettime
+
+#include "sps30.h"
+#include "sps30_batch.h"
+#include "sps30_sim.h"
+
+#define BENCH_DEFAULT_ITERATIONS 10000
+#define BENCH_BUS 0
+/* more than fits into the caches, passes are iterations / 100 */
+#define BENCH_BATCH_SAMPLES 65536
+#define BENCH_BATCH_PASSES_DIV 100
+
+/* CRC checks of a frame per iteration */
+#define BENCH_CRC_CHECKS 100
+
+#if defined(SPS30_CRC_NIBBLE)
+#define BENCH_CRC_VARIANT "nibble"
+#elif defined(SPS30_CRC_TABLE)
+#define BENCH_CRC_VARIANT "table"
+#elif defined(SPS30_CRC_SIMD) && defined(__SSSE3__)
+#define BENCH_CRC_VARIANT "simd, ssse3"
+#elif defined(SPS30_CRC_SIMD)
+#define BENCH_CRC_VARIANT "simd"
+#else
+#define BENCH_CRC_VARIANT "bitwise"
+#endif
+
+/* operating mode of the sensor during a benchmark */
+#define BENCH_IDLE 0
+#define BENCH_MEASURING_FLOAT SPS30_FORMAT_FLOAT
+#define BENCH_MEASURING_UINT16 SPS30_FORMAT_UINT16
+
+struct bench_case {
+    const char* name;
+    uint16_t mode;
+    int16_t (*run)(void);
+};
+
+static struct sps30_dev bench_dev;
+
+static int16_t bench_read_measurement(void) {
+    struct sps30_measurement m;
+    return sps30_dev_read_measurement(&bench_dev, &m);
+}
+
+static int16_t bench_read_measurement_u16(void) {
+    struct sps30_measurement_u16 m;
+    return sps30_dev_read_measurement_u16(&bench_dev, &m);
+}
+
+static int16_t bench_read_measurement_u16_as_float(void) {
+    struct sps30_measurement m;
+    return sps30_dev_read_measurement(&bench_dev, &m);
+}
+
+static int16_t bench_read_data_ready(void) {
+    uint16_t data_ready;
+    return sps30_dev_read_data_ready(&bench_dev, &data_ready);
+}
+
+/* the uncached variants drop the cached value before each call */
+static int16_t bench_get_serial_cached(void) {
+    char serial[SPS30_MAX_SERIAL_LEN];
+    return sps30_dev_get_serial(&bench_dev, serial);
+}
+
+static int16_t bench_get_serial(void) {
+    bench_dev.cached &= (uint8_t)~SPS30_CACHED_SERIAL;
+    return bench_get_serial_cached();
+}
+
+static int16_t bench_read_firmware_version_cached(void) {
+    uint8_t major;
+    uint8_t minor;
+    return sps30_dev_read_firmware_version(&bench_dev, &major, &minor);
+}
+
+static int16_t bench_read_firmware_version(void) {
+    bench_dev.cached &= (uint8_t)~SPS30_CACHED_FIRMWARE_VERSION;
+    return bench_read_firmware_version_cached();
+}
+
+static int16_t bench_read_device_status_register(void) {
+    uint32_t flags;
+    return sps30_dev_read_device_status_register(&bench_dev, &flags);
+}
+
+static int16_t bench_get_fan_auto_cleaning_interval_cached(void) {
+    uint32_t interval;
+    return sps30_dev_get_fan_auto_cleaning_interval(&bench_dev, &interval);
+}
+
+static int16_t bench_get_fan_auto_cleaning_interval(void) {
+    bench_dev.cached &= (uint8_t)~SPS30_CACHED_FAN_AUTO_CLEANING_INTERVAL;
+    return bench_get_fan_auto_cleaning_interval_cached();
+}
+
+static int16_t bench_set_fan_auto_cleaning_interval(void) {
+    return sps30_dev_set_fan_auto_cleaning_interval(&bench_dev, 604800);
+}
+
+static int16_t bench_probe(void) {
+    return sps30_dev_probe(&bench_dev);
+}
+
+static int16_t bench_start_stop_measurement(void) {
+    int16_t ret = sps30_dev_start_measurement(&bench_dev);
+    if (ret)
+        return ret;
+    return sps30_dev_stop_measurement(&bench_dev);
+}
+
+static int16_t bench_sleep_wake_up(void) {
+    int16_t ret = sps30_dev_sleep(&bench_dev);
+    if (ret)
+        return ret;
+    return sps30_dev_wake_up(&bench_dev);
+}
+
+static int16_t bench_start_manual_fan_cleaning(void) {
+    return sps30_dev_start_manual_fan_cleaning(&bench_dev);
+}
+
+static const struct bench_case bench_cases[] = {
+    {"read_measurement", BENCH_MEASURING_FLOAT, bench_read_measurement},
+    {"read_measurement_u16", BENCH_MEASURING_UINT16,
+     bench_read_measurement_u16},
+    {"read_measurement (u16 format)", BENCH_MEASURING_UINT16,
+     bench_read_measurement_u16_as_float},
+    {"read_data_ready", BENCH_MEASURING_FLOAT, bench_read_data_ready},
+    {"get_serial", BENCH_IDLE, bench_get_serial},
+    {"get_serial (cached)", BENCH_IDLE, bench_get_serial_cached},
+    {"read_firmware_version", BENCH_IDLE, bench_read_firmware_version},
+    {"read_firmware_version (cached)", BENCH_IDLE,
+     bench_read_firmware_version_cached},
+    {"read_device_status_register", BENCH_MEASURING_FLOAT,
+     bench_read_device_status_register},
+    {"get_fan_auto_cleaning_interval", BENCH_IDLE,
+     bench_get_fan_auto_cleaning_interval},
+    {"get_fan_auto_cleaning_interval (cached)", BENCH_IDLE,
+     bench_get_fan_auto_cleaning_interval_cached},
+    {"set_fan_auto_cleaning_interval", BENCH_IDLE,
+     bench_set_fan_auto_cleaning_interval},
+    {"probe", BENCH_IDLE, bench_probe},
+    {"start+stop_measurement", BENCH_IDLE, bench_start_stop_measurement},
+    {"sleep+wake_up", BENCH_IDLE, bench_sleep_wake_up},
+    {"start_manual_fan_cleaning", BENCH_MEASURING_FLOAT,
+     bench_start_manual_fan_cleaning},
+};
+
+static uint64_t bench_cpu_time_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int16_t bench_setup(uint32_t bus_hz, uint16_t mode) {
+    int16_t ret;
+
+    sps30_sim_reset();
+    sps30_sim_set_bus_speed(bus_hz);
+    ret = sps30_sim_add_sensor(BENCH_BUS, SPS30_I2C_ADDRESS);
+    if (ret)
+        return ret;
+
+    sps30_dev_init(&bench_dev, BENCH_BUS, SPS30_I2C_ADDRESS);
+    ret = sps30_dev_probe(&bench_dev);
+    if (ret || mode == BENCH_IDLE)
+        return ret;
+
+    ret = sps30_dev_set_measurement_format(&bench_dev, mode);
+    if (ret)
+        return ret;
+
+    ret = sps30_dev_start_measurement(&bench_dev);
+    if (ret)
+        return ret;
+
+    /* wait for the first measurement */
+    sensirion_sleep_usec(SPS30_MEASUREMENT_DURATION_USEC);
+    return 0;
+}
+
+static int bench_run(const struct bench_case* bc, uint32_t iterations,
+                     uint32_t bus_hz) {
+    struct sps30_sim_stats stats;
+    uint64_t start_ns;
+    uint64_t cpu_ns;
+    uint32_t errors = 0;
+    uint32_t i;
+
+    if (bench_setup(bus_hz, bc->mode)) {
+        printf("%-40s setup failed\n", bc->name);
+        return 1;
+    }
+
+    sps30_sim_reset_stats();
+    start_ns = bench_cpu_time_ns();
+    for (i = 0; i < iterations; ++i) {
+        if (bc->run())
+            errors++;
+    }
+    cpu_ns = bench_cpu_time_ns() - start_ns;
+    sps30_sim_get_stats(&stats);
+
+    printf("%-40s %10.1f %6.2f %8.1f %8.1f %10.1f %10.1f %6u\n", bc->name,
+           (double)cpu_ns / iterations,
+           (double)stats.transactions / iterations,
+           (double)stats.bytes_written / iterations,
+           (double)stats.bytes_read / iterations,
+           (double)stats.bus_time_ns / 1000.0 / iterations,
+           (double)stats.sleep_time_us / iterations, errors);
+    return errors != 0;
+}
+
+static void bench_decode_structs(const uint8_t* payloads, void* out,
+                                 uint32_t count) {
+    struct sps30_measurement* m = (struct sps30_measurement*)out;
+    uint32_t i;
+
+    for (i = 0; i < count; ++i, ++m, payloads += SPS30_BATCH_PAYLOAD_SIZE) {
+        m->mc_1p0 = sensirion_bytes_to_float(&payloads[0]);
+        m->mc_2p5 = sensirion_bytes_to_float(&payloads[4]);
+        m->mc_4p0 = sensirion_bytes_to_float(&payloads[8]);
+        m->mc_10p0 = sensirion_bytes_to_float(&payloads[12]);
+        m->nc_0p5 = sensirion_bytes_to_float(&payloads[16]);
+        m->nc_1p0 = sensirion_bytes_to_float(&payloads[20]);
+        m->nc_2p5 = sensirion_bytes_to_float(&payloads[24]);
+        m->nc_4p0 = sensirion_bytes_to_float(&payloads[28]);
+        m->nc_10p0 = sensirion_bytes_to_float(&payloads[32]);
+        m->typical_particle_size = sensirion_bytes_to_float(&payloads[36]);
+    }
+}
+
+static void bench_decode_columns(const uint8_t* payloads, void* out,
+                                 uint32_t count) {
+    sps30_batch_decode(payloads, count, (float*)out, count);
+}
+
+static void bench_copy(const uint8_t* payloads, void* out, uint32_t count) {
+    memcpy(out, payloads, (size_t)count * SPS30_BATCH_PAYLOAD_SIZE);
+}
+
+static void bench_decode(const char* name,
+                         void (*decode)(const uint8_t*, void*, uint32_t),
+                         const uint8_t* payloads, void* out,
+                         uint32_t passes) {
+    const double bytes =
+        (double)passes * BENCH_BATCH_SAMPLES * SPS30_BATCH_PAYLOAD_SIZE;
+    uint64_t start_ns;
+    uint64_t cpu_ns;
+    uint32_t i;
+
+    start_ns = bench_cpu_time_ns();
+    for (i = 0; i < passes; ++i)
+        decode(payloads, out, BENCH_BATCH_SAMPLES);
+    cpu_ns = bench_cpu_time_ns() - start_ns;
+
+    printf("%-40s %10.2f %10.1f\n", name,
+           (double)cpu_ns / passes / BENCH_BATCH_SAMPLES,
+           cpu_ns ? bytes * 1000.0 / (double)cpu_ns : 0.0);
+}
+
+static int bench_batch(uint32_t iterations) {
+    const size_t size = (size_t)BENCH_BATCH_SAMPLES * SPS30_BATCH_PAYLOAD_SIZE;
+    uint32_t passes = iterations / BENCH_BATCH_PASSES_DIV;
+    uint8_t* payloads = (uint8_t*)malloc(size);
+    void* out = malloc(size);
+    size_t i;
+
+    if (!payloads || !out) {
+        free(payloads);
+        free(out);
+        printf("batch decode: out of memory\n");
+        return 1;
+    }
+    if (!passes)
+        passes = 1;
+    for (i = 0; i < size; ++i)
+        payloads[i] = (uint8_t)(i * 31 + 7);
+    memset(out, 0, size);
+
+    printf("\nbatch decode (%s), %u samples, %u passes\n",
+           sps30_batch_implementation(), BENCH_BATCH_SAMPLES, passes);
+    printf("%-40s %10s %10s\n", "per sample", "cpu ns", "MB/s");
+    bench_decode("structs (sps30_read_measurement)", bench_decode_structs,
+                 payloads, out, passes);
+    bench_decode("columns (sps30_batch_decode)", bench_decode_columns,
+                 payloads, out, passes);
+    bench_decode("memcpy", bench_copy, payloads, out, passes);
+
+    free(payloads);
+    free(out);
+    return 0;
+}
+
+static int16_t bench_check_crcs_common(const uint8_t* frame,
+                                       uint16_t num_words) {
+    uint16_t i;
+
+    for (i = 0; i < num_words; ++i, frame += SENSIRION_WORD_SIZE + CRC8_LEN) {
+        if (sensirion_common_check_crc(frame, SENSIRION_WORD_SIZE,
+                                       frame[SENSIRION_WORD_SIZE]))
+            return SPS30_ERR_CRC;
+    }
+    return NO_ERROR;
+}
+
+static int bench_check(const char* name,
+                       int16_t (*check)(const uint8_t*, uint16_t),
+                       const uint8_t* frame, uint32_t checks) {
+    uint64_t start_ns;
+    uint64_t cpu_ns;
+    uint32_t errors = 0;
+    uint32_t i;
+
+    start_ns = bench_cpu_time_ns();
+    for (i = 0; i < checks; ++i) {
+        if (check(frame, SPS30_MEASUREMENT_FRAME_SIZE /
+                             (SENSIRION_WORD_SIZE + CRC8_LEN)))
+            errors++;
+    }
+    cpu_ns = bench_cpu_time_ns() - start_ns;
+
+    printf("%-40s %10.1f %6u\n", name, (double)cpu_ns / checks, errors);
+    return errors != 0;
+}
+
+static int bench_crc(uint32_t iterations) {
+    uint8_t frame[SPS30_MEASUREMENT_FRAME_SIZE];
+    int failed;
+    uint8_t i;
+
+    for (i = 0; i < sizeof(frame); i += SENSIRION_WORD_SIZE + CRC8_LEN) {
+        frame[i] = (uint8_t)(i * 31 + 7);
+        frame[i + 1] = (uint8_t)(i * 17 + 3);
+        frame[i + 2] =
+            sensirion_common_generate_crc(&frame[i], SENSIRION_WORD_SIZE);
+    }
+
+    printf("\ncrc check of a measurement frame, %u checks\n",
+           iterations * BENCH_CRC_CHECKS);
+    printf("%-40s %10s %6s\n", "per frame", "cpu ns", "errors");
+    failed = bench_check("sensirion_common_check_crc", bench_check_crcs_common,
+                         frame, iterations * BENCH_CRC_CHECKS);
+    failed |= bench_check("sps30_check_crcs (" BENCH_CRC_VARIANT ")",
+                          sps30_check_crcs, frame,
+                          iterations * BENCH_CRC_CHECKS);
+    return failed;
+}
+
+static int bench_frame(uint32_t iterations) {
+    const uint32_t runs = iterations * BENCH_CRC_CHECKS;
+    const uint8_t last = SPS30_MEASUREMENT_FRAME_SIZE - CRC8_LEN -
+                         SENSIRION_WORD_SIZE;
+    uint8_t frame[SPS30_MEASUREMENT_FRAME_SIZE];
+    struct sps30_frame_decoder pending;
+    struct sps30_frame_decoder decoder;
+    struct sps30_measurement m;
+    uint64_t start_ns;
+    uint64_t at_once_ns;
+    uint64_t last_word_ns;
+    uint32_t errors = 0;
+    uint32_t i;
+
+    for (i = 0; i < sizeof(frame); i += SENSIRION_WORD_SIZE + CRC8_LEN) {
+        frame[i] = (uint8_t)(i * 31 + 7);
+        frame[i + 1] = (uint8_t)(i * 17 + 3);
+        frame[i + 2] =
+            sensirion_common_generate_crc(&frame[i], SENSIRION_WORD_SIZE);
+    }
+    sps30_dev_init(&bench_dev, BENCH_BUS, SPS30_I2C_ADDRESS);
+    sps30_frame_decoder_init(&pending, &bench_dev);
+    (void)sps30_frame_decoder_feed(&pending, frame, last);
+
+    start_ns = bench_cpu_time_ns();
+    for (i = 0; i < runs; ++i) {
+        if (sps30_dev_decode_measurement(&bench_dev, frame, &m))
+            errors++;
+    }
+    at_once_ns = bench_cpu_time_ns() - start_ns;
+
+    start_ns = bench_cpu_time_ns();
+    for (i = 0; i < runs; ++i) {
+        decoder = pending;
+        if (sps30_frame_decoder_feed(&decoder, &frame[last],
+                                     sizeof(frame) - last) ||
+            sps30_frame_decoder_get(&decoder, &m))
+            errors++;
+    }
+    last_word_ns = bench_cpu_time_ns() - start_ns;
+
+    printf("\nmeasurement frame decode, %u decodes\n", runs);
+    printf("%-40s %10s %6s\n", "after the last byte", "cpu ns", "errors");
+    printf("%-40s %10.1f\n", "sps30_dev_decode_measurement",
+           (double)at_once_ns / runs);
+    printf("%-40s %10.1f %6u\n", "sps30_frame_decoder (last word)",
+           (double)last_word_ns / runs, errors);
+    return errors != 0;
+}
+
+int main(int argc, char** argv) {
+    uint32_t iterations = BENCH_DEFAULT_ITERATIONS;
+    uint32_t bus_hz = SPS30_SIM_DEFAULT_BUS_HZ;
+    int failed = 0;
+    size_t i;
+
+    if (argc > 1)
+        iterations = (uint32_t)strtoul(argv[1], NULL, 0);
+    if (argc > 2)
+        bus_hz = (uint32_t)strtoul(argv[2], NULL, 0);
+    if (!iterations) {
+        printf("usage: %s [iterations] [bus clock in Hz]\n", argv[0]);
+        return 1;
+    }
+
+    printf("sps30 driver %s, %u iterations, %u Hz bus\n",
+           sps_get_driver_version(), iterations, bus_hz);
+    printf("%-40s %10s %6s %8s %8s %10s %10s %6s\n", "per call", "cpu ns",
+           "xfers", "wr bytes", "rd bytes", "bus us", "sleep us", "errors");
+    for (i = 0; i < sizeof(bench_cases) / sizeof(bench_cases[0]); ++i)
+        failed |= bench_run(&bench_cases[i], iterations, bus_hz);
+    failed |= bench_batch(iterations);
+    failed |= bench_crc(iterations);
+    failed |= bench_frame(iterations);
+
+    return failed;
+}
@@ -0,0 +1,66 @@
+#include "sensirion_test_setup.h"
+#include "sps30_cleaning.h"
+
+#define S 1000000
+
+TEST_GROUP (SPSCleaningTestGroup) {
+    struct sps30_cleaning cleaning;
+};
+
+TEST (SPSCleaningTestGroup, SPS30CleaningTest_manual) {
+    sps30_cleaning_init(&cleaning, 0);
+    sps30_cleaning_start(&cleaning, 0);
+    CHECK_EQUAL(SPS30_CLEANING_NONE, sps30_cleaning_check(&cleaning, 1 * S));
+
+    sps30_cleaning_manual(&cleaning, 2 * S);
+    CHECK_EQUAL(1, cleaning.cleanings);
+    CHECK_EQUAL(SPS30_CLEANING_MANUAL, sps30_cleaning_check(&cleaning, 3 * S));
+    CHECK_EQUAL(SPS30_CLEANING_MANUAL,
+                sps30_cleaning_check(&cleaning,
+                                     2 * S + SPS30_CLEANING_WINDOW_US - 1));
+    CHECK_EQUAL(SPS30_CLEANING_NONE,
+                sps30_cleaning_check(&cleaning,
+                                     2 * S + SPS30_CLEANING_WINDOW_US));
+    CHECK_EQUAL(2, cleaning.flagged);
+    CHECK_EQUAL(0, sps30_cleaning_next_auto_s(&cleaning));
+
+    /* stopping the measurement ends the cleaning */
+    sps30_cleaning_manual(&cleaning, 20 * S);
+    sps30_cleaning_stop(&cleaning, 21 * S);
+    sps30_cleaning_start(&cleaning, 22 * S);
+    CHECK_EQUAL(SPS30_CLEANING_NONE, sps30_cleaning_check(&cleaning, 23 * S));
+}
+
+TEST (SPSCleaningTestGroup, SPS30CleaningTest_auto) {
+    const uint32_t base = 0xfffff000; /* across the wrap-around */
+
+    sps30_cleaning_init(&cleaning, 100);
+
+    /* 60s of measuring, idle, then the interval is reached after 40s more */
+    sps30_cleaning_start(&cleaning, base);
+    CHECK_EQUAL(SPS30_CLEANING_NONE,
+                sps30_cleaning_check(&cleaning, base + 30 * S));
+    sps30_cleaning_stop(&cleaning, base + 60 * S);
+    CHECK_EQUAL(40, sps30_cleaning_next_auto_s(&cleaning));
+    sps30_cleaning_start(&cleaning, base + 1000 * S);
+    CHECK_EQUAL(SPS30_CLEANING_NONE,
+                sps30_cleaning_check(&cleaning, base + 1039 * S));
+    CHECK_EQUAL(SPS30_CLEANING_AUTO,
+                sps30_cleaning_check(&cleaning, base + 1041 * S));
+    CHECK_EQUAL(1, cleaning.cleanings);
+    CHECK_EQUAL(99, sps30_cleaning_next_auto_s(&cleaning));
+
+    /* the window started at the interval, not at the check */
+    CHECK_EQUAL(SPS30_CLEANING_AUTO,
+                sps30_cleaning_check(&cleaning, base + 1050 * S));
+    CHECK_EQUAL(SPS30_CLEANING_NONE,
+                sps30_cleaning_check(&cleaning,
+                                     base + 1040 * S +
+                                         SPS30_CLEANING_WINDOW_US));
+
+    /* a cleaning which was not observed is counted but not flagged */
+    CHECK_EQUAL(SPS30_CLEANING_NONE,
+                sps30_cleaning_check(&cleaning, base + 1200 * S));
+    CHECK_EQUAL(2, cleaning.cleanings);
+    CHECK_EQUAL(2, cleaning.flagged);
+}
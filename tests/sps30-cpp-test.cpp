@@ -0,0 +1,221 @@
+#include "sensirion_test_setup.h"
+#include "sps30.hpp"
+#include "sps30_sim.h"
+
+#include <vector>
+
+#define SIM_BUS 0
+
+static_assert(sps30::crc8(0x0000) == 0x81, "CRC-8 of a zero word");
+static_assert(sps30::command::read_measurement.code == 0x0300,
+              "read measurement command");
+static_assert(!sps30::has_write_read<sps30::SensirionI2cBus>::value,
+              "combined transfers without SPS30_I2C_WRITE_READ");
+
+static const struct sps30_measurement fixed = {
+    1.5f, 2.5f, 4.5f, 10.5f, 5.0f, 10.0f, 25.0f, 40.0f, 100.0f, 0.75f};
+
+/* records the transfers and answers every read with a canned response */
+struct MockBus {
+    std::vector<std::vector<uint8_t>> writes;
+    std::vector<uint8_t> response;
+    uint16_t reads = 0;
+    uint32_t slept_us = 0;
+
+    int16_t write(uint8_t address, const uint8_t* data, uint16_t count) {
+        writes.emplace_back(data, data + count);
+        return NO_ERROR;
+    }
+
+    int16_t read(uint8_t address, uint8_t* data, uint16_t count) {
+        ++reads;
+        for (uint16_t i = 0; i < count; ++i)
+            data[i] = i < response.size() ? response[i] : 0;
+        return NO_ERROR;
+    }
+
+    void sleep_usec(uint32_t useconds) {
+        slept_us += useconds;
+    }
+};
+
+struct MockWriteReadBus : MockBus {
+    uint16_t write_reads = 0;
+
+    int16_t write_read(uint8_t address, const uint8_t* tx, uint16_t tx_count,
+                       uint8_t* rx, uint16_t rx_count) {
+        ++write_reads;
+        write(address, tx, tx_count);
+        return read(address, rx, rx_count);
+    }
+};
+
+static_assert(sps30::has_write_read<MockWriteReadBus>::value,
+              "write_read detected");
+
+TEST_GROUP (SPSCppTestGroup) {
+    void setup() {
+        int16_t ret;
+
+        sps30_sim_reset();
+        ret = sps30_sim_add_sensor(SIM_BUS, SPS30_I2C_ADDRESS);
+        CHECK_ZERO_TEXT(ret, "sps30_sim_add_sensor");
+        sensirion_i2c_init();
+    }
+
+    void teardown() {
+        sensirion_i2c_release();
+    }
+};
+
+TEST (SPSCppTestGroup, SPS30CppTest_identity) {
+    sps30::Sps30<sps30::SensirionI2cBus> sensor(
+        sps30::SensirionI2cBus{SIM_BUS});
+
+    CHECK_ZERO_TEXT(sensor.probe(), "probe");
+
+    const auto serial = sensor.get_serial();
+    CHECK_ZERO_TEXT(serial.error, "get_serial");
+    STRCMP_EQUAL("SIM0000000000001", serial.value.data());
+
+    const auto version = sensor.read_firmware_version();
+    CHECK_ZERO_TEXT(version.error, "read_firmware_version");
+    CHECK_EQUAL(2, version.value.major);
+    CHECK_EQUAL(2, version.value.minor);
+
+    sps30::Sps30<sps30::SensirionI2cBus> absent(
+        sps30::SensirionI2cBus{SIM_BUS}, SPS30_I2C_ADDRESS + 1);
+    CHECK_TRUE_TEXT(absent.probe() != 0, "probe without sensor");
+}
+
+TEST (SPSCppTestGroup, SPS30CppTest_measurement) {
+    sps30::Sps30<sps30::SensirionI2cBus> sensor(
+        sps30::SensirionI2cBus{SIM_BUS});
+    uint16_t polls;
+
+    sps30_sim_set_measurement(SIM_BUS, SPS30_I2C_ADDRESS, &fixed);
+    CHECK_ZERO_TEXT(sensor.start_measurement(), "start_measurement");
+    CHECK_EQUAL(SPS30_STATE_MEASURING,
+                sps30_sim_get_state(SIM_BUS, SPS30_I2C_ADDRESS));
+
+    for (polls = 0; polls < 20; ++polls) {
+        const auto ready = sensor.read_data_ready();
+
+        CHECK_ZERO_TEXT(ready.error, "read_data_ready");
+        if (ready.value)
+            break;
+        sensirion_sleep_usec(100000);
+    }
+    CHECK_TRUE_TEXT(polls < 20, "no data ready after 2s");
+
+    const auto m = sensor.read_measurement();
+    CHECK_ZERO_TEXT(m.error, "read_measurement");
+    DOUBLES_EQUAL(fixed.mc_1p0, m.value.mc_1p0, 1e-6);
+    DOUBLES_EQUAL(fixed.nc_4p0, m.value.nc_4p0, 1e-6);
+    DOUBLES_EQUAL(fixed.typical_particle_size, m.value.typical_particle_size,
+                  1e-6);
+    CHECK_EQUAL(SPS30_ERR_FORMAT, sensor.read_measurement_u16().error);
+
+    CHECK_ZERO_TEXT(sensor.stop_measurement(), "stop_measurement");
+    CHECK_EQUAL(SPS30_STATE_IDLE,
+                sps30_sim_get_state(SIM_BUS, SPS30_I2C_ADDRESS));
+}
+
+TEST (SPSCppTestGroup, SPS30CppTest_uint16_measurement) {
+    sps30::Sps30<sps30::SensirionI2cBus> sensor(
+        sps30::SensirionI2cBus{SIM_BUS});
+
+    sps30_sim_set_measurement(SIM_BUS, SPS30_I2C_ADDRESS, &fixed);
+    CHECK_EQUAL(SPS30_ERR_FORMAT, sensor.start_measurement(0x1234));
+    CHECK_ZERO_TEXT(sensor.start_measurement(SPS30_FORMAT_UINT16),
+                    "start_measurement");
+    sensirion_sleep_usec(SPS30_MEASUREMENT_DURATION_USEC + 100000);
+
+    const auto m16 = sensor.read_measurement_u16();
+    CHECK_ZERO_TEXT(m16.error, "read_measurement_u16");
+    CHECK_EQUAL(3, m16.value.mc_2p5);
+    CHECK_EQUAL(100, m16.value.nc_10p0);
+    CHECK_EQUAL(750, m16.value.typical_particle_size);
+
+    const auto m = sensor.read_measurement();
+    CHECK_ZERO_TEXT(m.error, "read_measurement in uint16 format");
+    DOUBLES_EQUAL(0.75, m.value.typical_particle_size, 1e-6);
+}
+
+TEST (SPSCppTestGroup, SPS30CppTest_fan_and_status) {
+    sps30::Sps30<sps30::SensirionI2cBus> sensor(
+        sps30::SensirionI2cBus{SIM_BUS});
+
+    auto interval = sensor.get_fan_auto_cleaning_interval();
+    CHECK_ZERO_TEXT(interval.error, "get_fan_auto_cleaning_interval");
+    CHECK_EQUAL(604800, interval.value);
+    CHECK_ZERO_TEXT(sensor.set_fan_auto_cleaning_interval(3600),
+                    "set_fan_auto_cleaning_interval");
+    interval = sensor.get_fan_auto_cleaning_interval();
+    CHECK_ZERO_TEXT(interval.error, "get_fan_auto_cleaning_interval");
+    CHECK_EQUAL(3600, interval.value);
+
+    sps30_sim_set_device_status(SIM_BUS, SPS30_I2C_ADDRESS,
+                                SPS30_DEVICE_STATUS_FAN_ERROR_MASK);
+    const auto status = sensor.read_device_status_register();
+    CHECK_ZERO_TEXT(status.error, "read_device_status_register");
+    CHECK_EQUAL(SPS30_DEVICE_STATUS_FAN_ERROR_MASK, status.value);
+
+    CHECK_ZERO_TEXT(sensor.sleep(), "sleep");
+    CHECK_EQUAL(SPS30_STATE_SLEEPING,
+                sps30_sim_get_state(SIM_BUS, SPS30_I2C_ADDRESS));
+    CHECK_ZERO_TEXT(sensor.wake_up(), "wake_up");
+    CHECK_EQUAL(SPS30_STATE_IDLE,
+                sps30_sim_get_state(SIM_BUS, SPS30_I2C_ADDRESS));
+}
+
+TEST (SPSCppTestGroup, SPS30CppTest_crc_error) {
+    sps30::Sps30<sps30::SensirionI2cBus> sensor(
+        sps30::SensirionI2cBus{SIM_BUS});
+
+    sps30_sim_inject_crc_errors(SIM_BUS, SPS30_I2C_ADDRESS, 1);
+    CHECK_EQUAL(SPS30_ERR_CRC, sensor.read_firmware_version().error);
+    CHECK_ZERO_TEXT(sensor.read_firmware_version().error,
+                    "read_firmware_version after CRC error");
+}
+
+TEST (SPSCppTestGroup, SPS30CppTest_mock_encoding) {
+    sps30::Sps30<MockBus> sensor(MockBus{});
+    const std::vector<uint8_t> expected = {
+        0x80, 0x04, 0x00, 0x09, sps30::crc8(0x0009),
+        0x3a, 0x80, sps30::crc8(0x3a80)};
+
+    CHECK_ZERO_TEXT(sensor.set_fan_auto_cleaning_interval(0x93a80),
+                    "set_fan_auto_cleaning_interval");
+    CHECK_EQUAL(1, sensor.bus().writes.size());
+    CHECK_TRUE(expected == sensor.bus().writes[0]);
+    CHECK_EQUAL(sps30::command::set_fan_auto_cleaning_interval.delay_us,
+                sensor.bus().slept_us);
+
+    sensor.bus().response = {0x00, 0x01, sps30::crc8(0x0001)};
+    const auto ready = sensor.read_data_ready();
+    CHECK_ZERO_TEXT(ready.error, "read_data_ready");
+    CHECK_TRUE(ready.value);
+
+    sensor.bus().response = {0x00, 0x01, 0x00};
+    CHECK_EQUAL(SPS30_ERR_CRC, sensor.read_data_ready().error);
+}
+
+TEST (SPSCppTestGroup, SPS30CppTest_mock_write_read) {
+    sps30::Sps30<MockWriteReadBus> sensor(MockWriteReadBus{});
+
+    sensor.bus().response = {0x00, 0x01, sps30::crc8(0x0001)};
+    CHECK_ZERO_TEXT(sensor.read_data_ready().error, "read_data_ready");
+    CHECK_EQUAL(1, sensor.bus().write_reads);
+    CHECK_EQUAL(0, sensor.bus().slept_us);
+
+    /* delayed responses are never read in a combined transfer */
+    sensor.bus().response = {0x00, 0x00, sps30::crc8(0x0000),
+                             0x00, 0x10, sps30::crc8(0x0010)};
+    const auto status = sensor.read_device_status_register();
+    CHECK_ZERO_TEXT(status.error, "read_device_status_register");
+    CHECK_EQUAL(0x10, status.value);
+    CHECK_EQUAL(1, sensor.bus().write_reads);
+    CHECK_EQUAL(sps30::command::read_device_status_register.delay_us,
+                sensor.bus().slept_us);
+}
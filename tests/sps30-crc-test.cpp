@@ -0,0 +1,92 @@
+#include "sensirion_test_setup.h"
+#include "sps30.h"
+#include "sps30_sim.h"
+
+#include <vector>
+
+#define SIM_BUS 0
+/* covers the vector steps and the overlapping last step of SPS30_CRC_SIMD */
+#define MAX_WORDS 25
+#define WORD_SIZE (SENSIRION_WORD_SIZE + CRC8_LEN)
+
+static void fill(uint8_t* frame, uint16_t num_words, uint16_t seed) {
+    uint16_t i;
+
+    for (i = 0; i < num_words; ++i, frame += WORD_SIZE) {
+        frame[0] = (uint8_t)((seed + i) * 151 >> 3);
+        frame[1] = (uint8_t)((seed + i) * 73 + 11);
+        frame[2] = sensirion_common_generate_crc(frame, SENSIRION_WORD_SIZE);
+    }
+}
+
+TEST_GROUP (SPSCrcTestGroup) {
+    void setup() {
+        int16_t ret;
+
+        sps30_sim_reset();
+        ret = sps30_sim_add_sensor(SIM_BUS, SPS30_I2C_ADDRESS);
+        CHECK_ZERO_TEXT(ret, "sps30_sim_add_sensor");
+        sensirion_i2c_init();
+    }
+
+    void teardown() {
+        sensirion_i2c_release();
+    }
+};
+
+TEST (SPSCrcTestGroup, SPS30CrcTest_all_words) {
+    uint8_t frame[WORD_SIZE];
+    uint8_t bit;
+    uint32_t w;
+
+    for (w = 0; w <= 0xffff; ++w) {
+        frame[0] = (uint8_t)(w >> 8);
+        frame[1] = (uint8_t)w;
+        frame[2] = sensirion_common_generate_crc(frame, SENSIRION_WORD_SIZE);
+        CHECK_ZERO_TEXT(sps30_check_crcs(frame, 1), "matching CRC");
+        for (bit = 0; bit < 8; ++bit) {
+            frame[2] ^= (uint8_t)(1 << bit);
+            CHECK_EQUAL(SPS30_ERR_CRC, sps30_check_crcs(frame, 1));
+            frame[2] ^= (uint8_t)(1 << bit);
+        }
+    }
+}
+
+TEST (SPSCrcTestGroup, SPS30CrcTest_error_positions) {
+    uint16_t num_words;
+    uint16_t bad;
+
+    CHECK_ZERO_TEXT(sps30_check_crcs(NULL, 0), "empty frame");
+    for (num_words = 1; num_words <= MAX_WORDS; ++num_words) {
+        /* sized exactly, reads past the end are caught by the sanitizer */
+        std::vector<uint8_t> buf(num_words * WORD_SIZE);
+        uint8_t* frame = buf.data();
+
+        fill(frame, num_words, num_words);
+        CHECK_ZERO_TEXT(sps30_check_crcs(frame, num_words), "matching CRCs");
+        for (bad = 0; bad < num_words; ++bad) {
+            frame[bad * WORD_SIZE] ^= 0x40;
+            CHECK_EQUAL(SPS30_ERR_CRC, sps30_check_crcs(frame, num_words));
+            frame[bad * WORD_SIZE] ^= 0x40;
+            frame[bad * WORD_SIZE + 2] ^= 0x01;
+            CHECK_EQUAL(SPS30_ERR_CRC, sps30_check_crcs(frame, num_words));
+            frame[bad * WORD_SIZE + 2] ^= 0x01;
+        }
+    }
+}
+
+TEST (SPSCrcTestGroup, SPS30CrcTest_read_measurement) {
+    struct sps30_measurement m;
+    struct sps30_dev dev;
+    int16_t ret;
+
+    sps30_dev_init(&dev, SIM_BUS, SPS30_I2C_ADDRESS);
+    ret = sps30_dev_start_measurement(&dev);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_start_measurement");
+    sensirion_sleep_usec(SPS30_MEASUREMENT_DURATION_USEC);
+
+    sps30_sim_inject_crc_errors(SIM_BUS, SPS30_I2C_ADDRESS, 1);
+    CHECK_EQUAL(SPS30_ERR_CRC, sps30_dev_read_measurement(&dev, &m));
+    ret = sps30_dev_read_measurement(&dev, &m);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_read_measurement after CRC error");
+}
@@ -0,0 +1,175 @@
+#include "sensirion_test_setup.h"
+#include "sps30.h"
+#include "sps30_duty.h"
+#include "sps30_sim.h"
+
+#define SIM_BUS 0
+
+static const struct sps30_measurement fixed = {
+    1.5f, 2.5f, 4.5f, 10.5f, 5.0f, 10.0f, 25.0f, 40.0f, 100.0f, 0.75f};
+
+/**
+ * duty_run_cycle() - run the scheduler on the simulated clock until a cycle
+ * finishes
+ */
+static void duty_run_cycle(struct sps30_duty* duty,
+                           struct sps30_duty_report* report) {
+    int32_t wait_us;
+    int16_t ret;
+
+    do {
+        wait_us = (int32_t)(sps30_duty_next_us(duty) - sps30_sim_time_us());
+        if (wait_us > 0)
+            sps30_sim_advance_us((uint32_t)wait_us);
+        ret = sps30_duty_run(duty, sps30_sim_time_us(), report);
+    } while (ret == SPS30_ERR_NOT_READY);
+    CHECK_ZERO_TEXT(ret, "sps30_duty_run");
+}
+
+TEST_GROUP (SPSDutyTestGroup) {
+    struct sps30_dev dev;
+    struct sps30_duty duty;
+    struct sps30_duty_config config;
+    struct sps30_duty_report report;
+
+    void setup() {
+        int16_t ret;
+
+        sps30_sim_reset();
+        ret = sps30_sim_add_sensor(SIM_BUS, SPS30_I2C_ADDRESS);
+        CHECK_ZERO_TEXT(ret, "sps30_sim_add_sensor");
+        sps30_sim_set_measurement(SIM_BUS, SPS30_I2C_ADDRESS, &fixed);
+        sps30_dev_init(&dev, SIM_BUS, SPS30_I2C_ADDRESS);
+        ret = sps30_dev_probe(&dev);
+        CHECK_ZERO_TEXT(ret, "sps30_dev_probe");
+
+        config.period_us = 300000000;
+        config.warm_up_us = 15000000;
+        config.num_samples = 3;
+        config.clean_every = 0;
+        config.fan_auto_cleaning_interval = 0;
+    }
+
+    void teardown() {
+    }
+};
+
+TEST (SPSDutyTestGroup, SPS30DutyTest_init) {
+    config.num_samples = 0;
+    CHECK_EQUAL(STATUS_FAIL, sps30_duty_init(&duty, &dev, &config));
+    config.num_samples = 1;
+    config.period_us = 0;
+    CHECK_EQUAL(STATUS_FAIL, sps30_duty_init(&duty, &dev, &config));
+}
+
+TEST (SPSDutyTestGroup, SPS30DutyTest_cycles) {
+    struct sps30_sim_stats stats;
+    uint32_t cycle_start_us;
+    int32_t wait_us;
+    uint16_t i;
+    int16_t ret;
+
+    ret = sps30_duty_init(&duty, &dev, &config);
+    CHECK_ZERO_TEXT(ret, "sps30_duty_init");
+
+    for (i = 0; i < 3; ++i) {
+        wait_us = (int32_t)(sps30_duty_next_us(&duty) - sps30_sim_time_us());
+        if (wait_us > 0)
+            sps30_sim_advance_us((uint32_t)wait_us);
+        cycle_start_us = sps30_sim_time_us();
+        sps30_sim_reset_stats();
+        duty_run_cycle(&duty, &report);
+        sps30_sim_get_stats(&stats);
+
+        CHECK_EQUAL(SPS30_STATE_SLEEPING,
+                    sps30_sim_get_state(SIM_BUS, SPS30_I2C_ADDRESS));
+        CHECK_EQUAL(3, report.num_samples);
+        CHECK_EQUAL(1, report.discarded);
+        DOUBLES_EQUAL(fixed.mc_2p5, report.mean.mc_2p5, 1e-5);
+        DOUBLES_EQUAL(fixed.typical_particle_size,
+                      report.mean.typical_particle_size, 1e-5);
+
+        /* warm-up plus three samples at 1Hz */
+        CHECK_TRUE_TEXT(report.measuring_ms >= 17000 &&
+                            report.measuring_ms < 19100,
+                        "measuring time");
+        CHECK_TRUE_TEXT(report.awake_ms >= report.measuring_ms &&
+                            report.awake_ms < report.measuring_ms + 100,
+                        "awake time");
+        CHECK_TRUE_TEXT(stats.transactions < 32, "too many transactions");
+        CHECK_EQUAL(cycle_start_us + config.period_us,
+                    sps30_duty_next_us(&duty));
+    }
+}
+
+TEST (SPSDutyTestGroup, SPS30DutyTest_retry) {
+    uint32_t now_us;
+    int16_t ret;
+
+    ret = sps30_duty_init(&duty, &dev, &config);
+    CHECK_ZERO_TEXT(ret, "sps30_duty_init");
+
+    /* the first command of the cycle fails */
+    sps30_sim_inject_nacks(SIM_BUS, SPS30_I2C_ADDRESS, 1);
+    do {
+        now_us = sps30_sim_time_us();
+        ret = sps30_duty_run(&duty, now_us, &report);
+    } while (ret == SPS30_ERR_NOT_READY);
+    CHECK_TRUE_TEXT(ret != 0, "NACK not reported");
+    CHECK_EQUAL(now_us + SPS30_DUTY_RETRY_US, sps30_duty_next_us(&duty));
+
+    duty_run_cycle(&duty, &report);
+    CHECK_EQUAL(3, report.num_samples);
+}
+
+TEST (SPSDutyTestGroup, SPS30DutyTest_manual_cleaning) {
+    uint16_t i;
+    int16_t ret;
+
+    config.clean_every = 2;
+    ret = sps30_duty_init(&duty, &dev, &config);
+    CHECK_ZERO_TEXT(ret, "sps30_duty_init");
+
+    for (i = 0; i < 3; ++i) {
+        duty_run_cycle(&duty, &report);
+        CHECK_EQUAL(i % 2 == 0, report.cleaned);
+        CHECK_EQUAL(0, report.cleaning_discarded);
+        CHECK_EQUAL(3, report.num_samples);
+        DOUBLES_EQUAL(fixed.mc_2p5, report.mean.mc_2p5, 1e-5);
+    }
+    CHECK_EQUAL(2, sps30_sim_get_cleanings(SIM_BUS, SPS30_I2C_ADDRESS));
+
+    /* a shorter warm-up is extended to cover the cleaning */
+    config.warm_up_us = 2000000;
+    config.clean_every = 1;
+    sps30_sim_advance_us(SPS30_MEASUREMENT_DURATION_USEC);
+    ret = sps30_duty_init(&duty, &dev, &config);
+    CHECK_ZERO_TEXT(ret, "sps30_duty_init");
+    duty_run_cycle(&duty, &report);
+    CHECK_EQUAL(1, report.cleaned);
+    CHECK_TRUE_TEXT(report.measuring_ms >= SPS30_CLEANING_WINDOW_US / 1000,
+                    "measuring time");
+    DOUBLES_EQUAL(fixed.mc_2p5, report.mean.mc_2p5, 1e-5);
+}
+
+TEST (SPSDutyTestGroup, SPS30DutyTest_auto_cleaning) {
+    int16_t ret;
+
+    /* the second cycle's measurement reaches the interval during warm-up */
+    ret = sps30_dev_set_fan_auto_cleaning_interval(&dev, 25);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_set_fan_auto_cleaning_interval");
+    config.fan_auto_cleaning_interval = 25;
+    ret = sps30_duty_init(&duty, &dev, &config);
+    CHECK_ZERO_TEXT(ret, "sps30_duty_init");
+
+    duty_run_cycle(&duty, &report);
+    CHECK_EQUAL(0, report.cleaning_discarded);
+    duty_run_cycle(&duty, &report);
+    CHECK_EQUAL(1, sps30_sim_get_cleanings(SIM_BUS, SPS30_I2C_ADDRESS));
+    CHECK_EQUAL(1, duty.cleaning.cleanings);
+    CHECK_TRUE_TEXT(report.cleaning_discarded >= 1, "no sample discarded");
+    CHECK_EQUAL(0, report.cleaned);
+    CHECK_EQUAL(3, report.num_samples);
+    DOUBLES_EQUAL(fixed.mc_2p5, report.mean.mc_2p5, 1e-5);
+    DOUBLES_EQUAL(fixed.nc_10p0, report.mean.nc_10p0, 1e-4);
+}
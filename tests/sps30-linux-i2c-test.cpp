@@ -0,0 +1,384 @@
+#include "sensirion_test_setup.h"
+#include "sps30.h"
+#include "sps30_linux_i2c.h"
+#include "sps30_sim.h"
+
+#include <errno.h>
+#include <linux/i2c-dev.h>
+#include <linux/i2c.h>
+#include <stdarg.h>
+#include <string.h>
+#include <time.h>
+
+#define SIM_BUS 3
+#define MUX_A 0x70
+#define MUX_B 0x71
+#define FAKE_PATH "fake-i2c"
+#define FAKE_FD 1000
+/* one more than fits into a single I2C_RDWR ioctl */
+#define NUM_DIRECT (SPS30_LINUX_I2C_BATCH_SIZE + 1)
+#define MUX_SENSORS 4
+
+/*
+ * i2c-dev device backed by the simulation, the test binary is linked with
+ * --wrap for the system calls of sps30_linux_i2c.c
+ */
+static struct {
+    int mangling;
+    uint8_t address;
+    uint32_t rdwr_calls;
+    uint32_t rdwr_msgs;
+    uint32_t max_rdwr_msgs;
+    uint32_t repeated_starts;
+} fake;
+
+extern "C" {
+
+int __real_open(const char* path, int flags, ...);
+int __real_close(int fd);
+ssize_t __real_read(int fd, void* data, size_t count);
+ssize_t __real_write(int fd, const void* data, size_t count);
+int __real_ioctl(int fd, unsigned long request, ...);
+int __real_nanosleep(const struct timespec* req, struct timespec* rem);
+
+int __wrap_open(const char* path, int flags, ...) {
+    va_list args;
+    int mode;
+
+    if (strcmp(path, FAKE_PATH) == 0)
+        return FAKE_FD;
+    va_start(args, flags);
+    mode = va_arg(args, int);
+    va_end(args);
+    return __real_open(path, flags, mode);
+}
+
+int __wrap_close(int fd) {
+    return fd == FAKE_FD ? 0 : __real_close(fd);
+}
+
+ssize_t __wrap_read(int fd, void* data, size_t count) {
+    if (fd != FAKE_FD)
+        return __real_read(fd, data, count);
+    if (sps30_sim_read(SIM_BUS, fake.address, (uint8_t*)data,
+                       (uint16_t)count) != NO_ERROR) {
+        errno = EREMOTEIO;
+        return -1;
+    }
+    return (ssize_t)count;
+}
+
+ssize_t __wrap_write(int fd, const void* data, size_t count) {
+    if (fd != FAKE_FD)
+        return __real_write(fd, data, count);
+    if (sps30_sim_write(SIM_BUS, fake.address, (const uint8_t*)data,
+                        (uint16_t)count) != NO_ERROR) {
+        errno = EREMOTEIO;
+        return -1;
+    }
+    return (ssize_t)count;
+}
+
+static int fake_rdwr(struct i2c_rdwr_ioctl_data* xfer) {
+    struct i2c_msg* msg;
+    int8_t ret;
+    uint32_t i;
+
+    fake.rdwr_calls++;
+    fake.rdwr_msgs += xfer->nmsgs;
+    if (xfer->nmsgs > fake.max_rdwr_msgs)
+        fake.max_rdwr_msgs = xfer->nmsgs;
+    if (xfer->nmsgs > I2C_RDWR_IOCTL_MAX_MSGS) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    for (i = 0; i < xfer->nmsgs; ++i) {
+        msg = &xfer->msgs[i];
+        if (msg->flags & I2C_M_RD) {
+            ret = sps30_sim_read(SIM_BUS, (uint8_t)msg->addr, msg->buf,
+                                 msg->len);
+        } else {
+            if (i + 1 < xfer->nmsgs &&
+                !(fake.mangling && (msg->flags & I2C_M_STOP)))
+                fake.repeated_starts++;
+            ret = sps30_sim_write(SIM_BUS, (uint8_t)msg->addr, msg->buf,
+                                  msg->len);
+        }
+        if (ret != NO_ERROR) {
+            errno = EREMOTEIO;
+            return -1;
+        }
+    }
+    return (int)xfer->nmsgs;
+}
+
+int __wrap_ioctl(int fd, unsigned long request, ...) {
+    va_list args;
+    void* arg;
+
+    va_start(args, request);
+    arg = va_arg(args, void*);
+    va_end(args);
+    if (fd != FAKE_FD)
+        return __real_ioctl(fd, request, arg);
+
+    switch (request) {
+        case I2C_SLAVE:
+            fake.address = (uint8_t)(uintptr_t)arg;
+            return 0;
+        case I2C_FUNCS:
+            *(unsigned long*)arg =
+                I2C_FUNC_I2C |
+                (fake.mangling ? I2C_FUNC_PROTOCOL_MANGLING : 0);
+            return 0;
+        case I2C_RDWR:
+            return fake_rdwr((struct i2c_rdwr_ioctl_data*)arg);
+        default:
+            errno = ENOTTY;
+            return -1;
+    }
+}
+
+int __wrap_nanosleep(const struct timespec* req, struct timespec* rem) {
+    sps30_sim_advance_us((uint32_t)(req->tv_sec * 1000000 +
+                                    req->tv_nsec / 1000));
+    return 0;
+}
+}
+
+/* identifies the sensor in its measurements */
+static void set_values(uint8_t bus, uint8_t address, uint16_t id) {
+    struct sps30_measurement m;
+
+    memset(&m, 0, sizeof(m));
+    m.mc_1p0 = (float)id;
+    m.nc_10p0 = (float)id + 0.5f;
+    CHECK_ZERO_TEXT(sps30_sim_set_measurement(bus, address, &m),
+                    "sps30_sim_set_measurement");
+}
+
+TEST_GROUP (SPSLinuxI2cTestGroup) {
+    struct sps30_dev devs[NUM_DIRECT + 2 * MUX_SENSORS];
+    struct sps30_dev* handles[NUM_DIRECT + 2 * MUX_SENSORS];
+    struct sps30_measurement measurements[NUM_DIRECT + 2 * MUX_SENSORS];
+    int16_t errors[NUM_DIRECT + 2 * MUX_SENSORS];
+    struct sps30_mux mux_a;
+    struct sps30_mux mux_b;
+    uint16_t num_devs;
+
+    void setup() {
+        sps30_sim_reset();
+        memset(&fake, 0, sizeof(fake));
+        num_devs = 0;
+        CHECK_ZERO_TEXT(sps30_linux_i2c_set_bus_path(SIM_BUS, FAKE_PATH),
+                        "sps30_linux_i2c_set_bus_path");
+    }
+
+    void teardown() {
+        sensirion_i2c_release();
+    }
+
+    void add_sensor(uint8_t address) {
+        CHECK_ZERO_TEXT(sps30_sim_add_sensor(SIM_BUS, address),
+                        "sps30_sim_add_sensor");
+        set_values(SIM_BUS, address, num_devs);
+        sps30_dev_init(&devs[num_devs], SIM_BUS, address);
+        handles[num_devs] = &devs[num_devs];
+        num_devs++;
+    }
+
+    void add_mux_sensor(struct sps30_mux * mux, uint8_t channel) {
+        int16_t ret;
+
+        ret = sps30_sim_add_mux_sensor(SIM_BUS, mux->address, channel,
+                                       SPS30_I2C_ADDRESS);
+        CHECK_ZERO_TEXT(ret, "sps30_sim_add_mux_sensor");
+        set_values(SPS30_SIM_MUX_BUS(mux->address, channel), SPS30_I2C_ADDRESS,
+                   num_devs);
+        sps30_dev_init(&devs[num_devs], SIM_BUS, SPS30_I2C_ADDRESS);
+        CHECK_ZERO_TEXT(sps30_dev_set_mux(&devs[num_devs], mux, channel),
+                        "sps30_dev_set_mux");
+        handles[num_devs] = &devs[num_devs];
+        num_devs++;
+    }
+
+    void start_all() {
+        uint16_t i;
+
+        for (i = 0; i < num_devs; ++i) {
+            CHECK_ZERO_TEXT(sps30_dev_start_measurement(&devs[i]),
+                            "sps30_dev_start_measurement");
+        }
+        sps30_sim_advance_us(SPS30_MEASUREMENT_DURATION_USEC);
+    }
+
+    void check_values() {
+        uint16_t i;
+
+        for (i = 0; i < num_devs; ++i) {
+            CHECK_ZERO_TEXT(errors[i], "measurement error");
+            CHECK_EQUAL((float)i, measurements[i].mc_1p0);
+            CHECK_EQUAL((float)i + 0.5f, measurements[i].nc_10p0);
+        }
+    }
+};
+
+TEST (SPSLinuxI2cTestGroup, SPS30LinuxI2cTest_write_read_separate) {
+    uint16_t data_ready;
+
+    add_sensor(SPS30_I2C_ADDRESS);
+    CHECK_ZERO_TEXT(sps30_dev_read_data_ready(&devs[0], &data_ready),
+                    "sps30_dev_read_data_ready");
+    CHECK_EQUAL(0, fake.rdwr_calls);
+}
+
+TEST (SPSLinuxI2cTestGroup, SPS30LinuxI2cTest_write_read_combined) {
+    uint16_t data_ready;
+
+    fake.mangling = 1;
+    add_sensor(SPS30_I2C_ADDRESS);
+    CHECK_ZERO_TEXT(sps30_dev_read_data_ready(&devs[0], &data_ready),
+                    "sps30_dev_read_data_ready");
+    CHECK_EQUAL(1, fake.rdwr_calls);
+    CHECK_EQUAL(2, fake.rdwr_msgs);
+    CHECK_EQUAL(0, fake.repeated_starts);
+}
+
+TEST (SPSLinuxI2cTestGroup, SPS30LinuxI2cTest_batch_split) {
+    struct sps30_sim_stats stats;
+    int16_t ret;
+    uint16_t i;
+
+    fake.mangling = 1;
+    for (i = 0; i < NUM_DIRECT; ++i)
+        add_sensor((uint8_t)(0x10 + i));
+    start_all();
+
+    fake.rdwr_calls = 0;
+    fake.rdwr_msgs = 0;
+    sps30_sim_reset_stats();
+    ret = sps30_linux_i2c_read_measurements(handles, num_devs, measurements,
+                                            errors);
+    CHECK_ZERO_TEXT(ret, "sps30_linux_i2c_read_measurements");
+    check_values();
+    CHECK_EQUAL(2, fake.rdwr_calls);
+    CHECK_EQUAL(2 * NUM_DIRECT, fake.rdwr_msgs);
+    CHECK_EQUAL(I2C_RDWR_IOCTL_MAX_MSGS, fake.max_rdwr_msgs);
+    CHECK_EQUAL(0, fake.repeated_starts);
+    sps30_sim_get_stats(&stats);
+    CHECK_EQUAL(0, stats.nacks);
+}
+
+TEST (SPSLinuxI2cTestGroup, SPS30LinuxI2cTest_batch_nack_fallback) {
+    int16_t ret;
+    uint16_t i;
+
+    fake.mangling = 1;
+    for (i = 0; i < 3; ++i)
+        add_sensor((uint8_t)(0x10 + i));
+    start_all();
+
+    /* one NACK fails the batch, the sensors are read one by one */
+    fake.rdwr_calls = 0;
+    sps30_sim_inject_nacks(SIM_BUS, 0x11, 1);
+    ret = sps30_linux_i2c_read_measurements(handles, num_devs, measurements,
+                                            errors);
+    CHECK_ZERO_TEXT(ret, "sps30_linux_i2c_read_measurements after NACK");
+    check_values();
+    CHECK_EQUAL(1u + num_devs, fake.rdwr_calls);
+
+    /* the sensor which keeps failing is reported */
+    sps30_sim_inject_nacks(SIM_BUS, 0x11, 2);
+    ret = sps30_linux_i2c_read_measurements(handles, num_devs, measurements,
+                                            errors);
+    CHECK_EQUAL(STATUS_FAIL, ret);
+    CHECK_ZERO_TEXT(errors[0], "first sensor");
+    CHECK_TRUE_TEXT(errors[1] != NO_ERROR, "failing sensor");
+    CHECK_ZERO_TEXT(errors[2], "last sensor");
+}
+
+TEST (SPSLinuxI2cTestGroup, SPS30LinuxI2cTest_batch_mux) {
+    struct sps30_measurement m;
+    struct sps30_sim_stats stats;
+    int16_t ret;
+    uint8_t i;
+
+    fake.mangling = 1;
+    CHECK_ZERO_TEXT(sps30_sim_add_mux(SIM_BUS, MUX_A), "sps30_sim_add_mux");
+    CHECK_ZERO_TEXT(sps30_sim_add_mux(SIM_BUS, MUX_B), "sps30_sim_add_mux");
+    sps30_mux_init(&mux_a, SIM_BUS, MUX_A, NULL);
+    sps30_mux_init(&mux_b, SIM_BUS, MUX_B, &mux_a);
+    for (i = 0; i < MUX_SENSORS; ++i) {
+        add_mux_sensor(&mux_a, i);
+        add_mux_sensor(&mux_b, i);
+    }
+    add_sensor(0x10);
+    start_all();
+
+    fake.rdwr_calls = 0;
+    sps30_sim_reset_stats();
+    ret = sps30_linux_i2c_read_measurements(handles, num_devs, measurements,
+                                            errors);
+    CHECK_ZERO_TEXT(ret, "sps30_linux_i2c_read_measurements");
+    check_values();
+    CHECK_EQUAL(1, fake.rdwr_calls);
+    CHECK_EQUAL(0, fake.repeated_starts);
+    sps30_sim_get_stats(&stats);
+    CHECK_EQUAL(0, stats.collisions);
+    /* the sensors alternate the multiplexers: deselect, select */
+    CHECK_EQUAL(2 * 2 * MUX_SENSORS, stats.mux_switches);
+
+    /* the driver continues from the selection left by the batch */
+    sps30_sim_reset_stats();
+    ret = sps30_dev_read_measurement(&devs[num_devs - 2], &m);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_read_measurement after batch");
+    sps30_sim_get_stats(&stats);
+    CHECK_EQUAL(0, stats.mux_switches);
+    ret = sps30_dev_read_measurement(&devs[0], &m);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_read_measurement after batch");
+    CHECK_EQUAL(0.0f, m.mc_1p0);
+    sps30_sim_get_stats(&stats);
+    CHECK_EQUAL(2, stats.mux_switches);
+    CHECK_EQUAL(0, stats.collisions);
+}
+
+TEST (SPSLinuxI2cTestGroup, SPS30LinuxI2cTest_batch_no_mangling) {
+    struct sps30_sim_stats stats;
+    int16_t ret;
+    uint8_t i;
+
+    CHECK_ZERO_TEXT(sps30_sim_add_mux(SIM_BUS, MUX_A), "sps30_sim_add_mux");
+    sps30_mux_init(&mux_a, SIM_BUS, MUX_A, NULL);
+    for (i = 0; i < MUX_SENSORS; ++i)
+        add_mux_sensor(&mux_a, i);
+    add_sensor(0x10);
+    start_all();
+
+    ret = sps30_linux_i2c_read_measurements(handles, num_devs, measurements,
+                                            errors);
+    CHECK_ZERO_TEXT(ret, "sps30_linux_i2c_read_measurements");
+    check_values();
+    CHECK_EQUAL(0, fake.rdwr_calls);
+    sps30_sim_get_stats(&stats);
+    CHECK_EQUAL(0, stats.collisions);
+}
+
+TEST (SPSLinuxI2cTestGroup, SPS30LinuxI2cTest_batch_rejects) {
+    fake.mangling = 1;
+    CHECK_ZERO_TEXT(sps30_sim_add_mux(SIM_BUS, MUX_A), "sps30_sim_add_mux");
+    sps30_mux_init(&mux_a, SIM_BUS, MUX_A, NULL);
+    add_sensor(SPS30_I2C_ADDRESS);
+    sps30_dev_init(&devs[1], SIM_BUS, SPS30_I2C_ADDRESS);
+    handles[1] = &devs[1];
+
+    CHECK_EQUAL(STATUS_FAIL, sps30_linux_i2c_read_measurements(
+                                 handles, 2, measurements, errors));
+    CHECK_ZERO_TEXT(sps30_dev_set_mux(&devs[0], &mux_a, 1),
+                    "sps30_dev_set_mux");
+    CHECK_ZERO_TEXT(sps30_dev_set_mux(&devs[1], &mux_a, 1),
+                    "sps30_dev_set_mux");
+    CHECK_EQUAL(STATUS_FAIL, sps30_linux_i2c_read_measurements(
+                                 handles, 2, measurements, errors));
+    CHECK_EQUAL(0, fake.rdwr_calls);
+}
@@ -0,0 +1,276 @@
+#include "sensirion_test_setup.h"
+#include "sps30_log.h"
+
+#define LOG_CAPACITY (1024 * 1024)
+#define PERIOD_MS 1000
+#define START_MS 1700000000000ull
+
+static uint8_t log_data[LOG_CAPACITY];
+static size_t log_size;
+static uint32_t log_seed;
+
+static int16_t log_write(void* context, const uint8_t* data, uint16_t length) {
+    if (log_size + length > LOG_CAPACITY)
+        return STATUS_FAIL;
+    memcpy(&log_data[log_size], data, length);
+    log_size += length;
+    return NO_ERROR;
+}
+
+static float log_random_step(float max_step) {
+    log_seed = log_seed * 1103515245u + 12345u;
+    return ((float)((log_seed >> 16) & 0xff) / 255.0f - 0.5f) * 2 * max_step;
+}
+
+/* slowly drifting signal, as seen in a room at 1Hz */
+static void log_next_measurement(struct sps30_measurement* m) {
+    m->mc_1p0 += log_random_step(0.2f);
+    m->mc_2p5 = m->mc_1p0 + 0.5f + log_random_step(0.2f);
+    m->mc_4p0 = m->mc_2p5 + 0.3f;
+    m->mc_10p0 = m->mc_4p0 + 0.1f;
+    m->nc_0p5 += log_random_step(0.3f);
+    m->nc_1p0 = m->nc_0p5 + 2.0f + log_random_step(0.3f);
+    m->nc_2p5 = m->nc_1p0 + 0.2f;
+    m->nc_4p0 = m->nc_2p5 + 0.05f;
+    m->nc_10p0 = m->nc_4p0 + 0.01f;
+    m->typical_particle_size = 0.5f + log_random_step(0.005f);
+}
+
+static void check_measurement(const struct sps30_measurement* expected,
+                              const struct sps30_measurement* actual) {
+    DOUBLES_EQUAL(expected->mc_1p0, actual->mc_1p0, 0.051);
+    DOUBLES_EQUAL(expected->mc_2p5, actual->mc_2p5, 0.051);
+    DOUBLES_EQUAL(expected->mc_4p0, actual->mc_4p0, 0.051);
+    DOUBLES_EQUAL(expected->mc_10p0, actual->mc_10p0, 0.051);
+    DOUBLES_EQUAL(expected->nc_0p5, actual->nc_0p5, 0.051);
+    DOUBLES_EQUAL(expected->nc_1p0, actual->nc_1p0, 0.051);
+    DOUBLES_EQUAL(expected->nc_2p5, actual->nc_2p5, 0.051);
+    DOUBLES_EQUAL(expected->nc_4p0, actual->nc_4p0, 0.051);
+    DOUBLES_EQUAL(expected->nc_10p0, actual->nc_10p0, 0.051);
+    DOUBLES_EQUAL(expected->typical_particle_size,
+                  actual->typical_particle_size, 0.00051);
+}
+
+TEST_GROUP (SPSLogTestGroup) {
+    struct sps30_log_info info;
+    struct sps30_log_writer writer;
+    struct sps30_log_reader reader;
+    struct sps30_measurement m;
+
+    void setup() {
+        log_size = 0;
+        log_seed = 1;
+        memset(&m, 0, sizeof(m));
+        m.mc_1p0 = 10.0f;
+        m.nc_0p5 = 50.0f;
+        sps30_log_info_init(&info, PERIOD_MS);
+        strcpy(info.serial, "SIM0000000000001");
+        info.firmware_major = 2;
+        info.firmware_minor = 2;
+        CHECK_ZERO(sps30_log_writer_init(&writer, &info, log_write, NULL));
+        CHECK_EQUAL(SPS30_LOG_HEADER_SIZE, log_size);
+    }
+
+    void teardown() {
+    }
+};
+
+TEST (SPSLogTestGroup, SPS30LogTest_header) {
+    CHECK_ZERO(sps30_log_reader_init(&reader, log_data, log_size));
+    STRCMP_EQUAL("SIM0000000000001", reader.info.serial);
+    CHECK_EQUAL(2, reader.info.firmware_major);
+    CHECK_EQUAL(2, reader.info.firmware_minor);
+    CHECK_EQUAL(PERIOD_MS, reader.info.period_ms);
+    CHECK_EQUAL(SPS30_LOG_DEFAULT_RESOLUTION_MC, reader.info.resolution_mc);
+    CHECK_EQUAL(SPS30_LOG_DEFAULT_RESOLUTION_NC, reader.info.resolution_nc);
+    CHECK_EQUAL(SPS30_LOG_DEFAULT_RESOLUTION_SIZE,
+                reader.info.resolution_size);
+
+    log_data[0] = 'X';
+    CHECK_EQUAL(SPS30_ERR_FORMAT,
+                sps30_log_reader_init(&reader, log_data, log_size));
+    CHECK_EQUAL(SPS30_ERR_FORMAT,
+                sps30_log_reader_init(&reader, log_data, 10));
+}
+
+TEST (SPSLogTestGroup, SPS30LogTest_roundtrip) {
+    const uint32_t samples = 20000;
+    struct sps30_measurement written[64];
+    struct sps30_measurement read;
+    uint64_t timestamp;
+    uint32_t i;
+
+    log_seed = 42;
+    for (i = 0; i < samples; ++i) {
+        log_next_measurement(&m);
+        written[i % 64] = m;
+        CHECK_ZERO(sps30_log_append(&writer, START_MS + i * PERIOD_MS, &m));
+        if (i % 64 != 63)
+            continue;
+
+        /* compare each batch against the log written so far */
+        CHECK_ZERO(sps30_log_reader_init(&reader, log_data, log_size));
+        CHECK_ZERO(sps30_log_seek(&reader, START_MS + (i - 63) * PERIOD_MS));
+        for (uint32_t j = i - 63; j <= i; ++j) {
+            CHECK_ZERO(sps30_log_read(&reader, &timestamp, &read));
+            CHECK_EQUAL(START_MS + j * PERIOD_MS, timestamp);
+            check_measurement(&written[j % 64], &read);
+        }
+    }
+
+    /* compact enough for weeks of 1Hz data */
+    printf("%.2f bytes per sample\n",
+           (double)(log_size - SPS30_LOG_HEADER_SIZE) / samples);
+    CHECK_TRUE(log_size - SPS30_LOG_HEADER_SIZE < 8 * samples);
+}
+
+TEST (SPSLogTestGroup, SPS30LogTest_irregular) {
+    const uint64_t timestamps[] = {START_MS,        START_MS + 1000,
+                                   START_MS + 2013, START_MS + 2990,
+                                   START_MS + 3990, START_MS + 86400000};
+    struct sps30_measurement read;
+    uint64_t timestamp;
+    uint32_t i;
+
+    for (i = 0; i < sizeof(timestamps) / sizeof(timestamps[0]); ++i) {
+        /* alternate between small and large jumps */
+        m.mc_1p0 = (i & 1) ? 1000.0f : 0.0f;
+        m.nc_10p0 = (float)i * 3.0f;
+        m.typical_particle_size = 0.1f * (float)i;
+        CHECK_ZERO(sps30_log_append(&writer, timestamps[i], &m));
+    }
+
+    CHECK_ZERO(sps30_log_reader_init(&reader, log_data, log_size));
+    for (i = 0; i < sizeof(timestamps) / sizeof(timestamps[0]); ++i) {
+        CHECK_ZERO(sps30_log_read(&reader, &timestamp, &read));
+        CHECK_EQUAL(timestamps[i], timestamp);
+        DOUBLES_EQUAL((i & 1) ? 1000.0 : 0.0, read.mc_1p0, 0.051);
+        DOUBLES_EQUAL(i * 3.0, read.nc_10p0, 0.051);
+        DOUBLES_EQUAL(0.1 * i, read.typical_particle_size, 0.00051);
+    }
+    CHECK_EQUAL(STATUS_FAIL, sps30_log_read(&reader, &timestamp, &read));
+}
+
+TEST (SPSLogTestGroup, SPS30LogTest_seek) {
+    const uint32_t samples = 5000;
+    struct sps30_measurement read;
+    uint64_t timestamp;
+    uint32_t i;
+
+    for (i = 0; i < samples; ++i) {
+        m.mc_1p0 = (float)(i % 100);
+        CHECK_ZERO(sps30_log_append(&writer, START_MS + i * PERIOD_MS, &m));
+    }
+    CHECK_TRUE(log_size > SPS30_LOG_HEADER_SIZE + 2 * SPS30_LOG_BLOCK_SIZE);
+    CHECK_ZERO(sps30_log_reader_init(&reader, log_data, log_size));
+
+    CHECK_ZERO(sps30_log_seek(&reader, START_MS + 4321 * PERIOD_MS));
+    CHECK_ZERO(sps30_log_read(&reader, &timestamp, &read));
+    CHECK_EQUAL(START_MS + 4321 * PERIOD_MS, timestamp);
+    DOUBLES_EQUAL(21.0, read.mc_1p0, 0.051);
+
+    /* between samples */
+    CHECK_ZERO(sps30_log_seek(&reader, START_MS + 1234 * PERIOD_MS + 1));
+    CHECK_ZERO(sps30_log_read(&reader, &timestamp, &read));
+    CHECK_EQUAL(START_MS + 1235 * PERIOD_MS, timestamp);
+
+    CHECK_ZERO(sps30_log_seek(&reader, 0));
+    CHECK_ZERO(sps30_log_read(&reader, &timestamp, &read));
+    CHECK_EQUAL(START_MS, timestamp);
+
+    CHECK_EQUAL(STATUS_FAIL,
+                sps30_log_seek(&reader, START_MS + samples * PERIOD_MS));
+}
+
+TEST (SPSLogTestGroup, SPS30LogTest_resume_and_truncate) {
+    struct sps30_measurement read;
+    uint64_t timestamp;
+    size_t size;
+    uint32_t i;
+
+    for (i = 0; i < 100; ++i) {
+        m.mc_1p0 = (float)i;
+        CHECK_ZERO(sps30_log_append(&writer, START_MS + i * PERIOD_MS, &m));
+    }
+
+    /* continue after a restart */
+    CHECK_ZERO(sps30_log_writer_resume(&writer, &info, log_write, NULL,
+                                       log_size));
+    CHECK_EQUAL(SPS30_LOG_HEADER_SIZE + SPS30_LOG_BLOCK_SIZE, log_size);
+    for (i = 100; i < 200; ++i) {
+        m.mc_1p0 = (float)i;
+        CHECK_ZERO(sps30_log_append(&writer, START_MS + i * PERIOD_MS, &m));
+    }
+
+    CHECK_ZERO(sps30_log_reader_init(&reader, log_data, log_size));
+    for (i = 0; i < 200; ++i) {
+        CHECK_ZERO(sps30_log_read(&reader, &timestamp, &read));
+        CHECK_EQUAL(START_MS + i * PERIOD_MS, timestamp);
+        DOUBLES_EQUAL(i, read.mc_1p0, 0.051);
+    }
+    CHECK_EQUAL(STATUS_FAIL, sps30_log_read(&reader, &timestamp, &read));
+
+    /* a partially written last record is ignored */
+    size = log_size - 3;
+    CHECK_ZERO(sps30_log_reader_init(&reader, log_data, size));
+    for (i = 0; i < 199; ++i)
+        CHECK_ZERO(sps30_log_read(&reader, &timestamp, &read));
+    CHECK_EQUAL(STATUS_FAIL, sps30_log_read(&reader, &timestamp, &read));
+}
+
+TEST (SPSLogTestGroup, SPS30LogTest_read_raw_many) {
+    const size_t chunks[] = {1, 7, 1024};
+    static uint64_t expected_ts[4000];
+    static int32_t expected[4000 * SPS30_LOG_NUM_FIELDS];
+    static uint64_t timestamps[4000];
+    static int32_t values[4000 * SPS30_LOG_NUM_FIELDS];
+    size_t num_expected;
+    size_t count;
+    size_t size;
+    size_t n;
+    uint32_t i;
+
+    /* every mode, timestamp deviations, a resumed block and varint jumps */
+    for (i = 0; i < 3000; ++i) {
+        if (i < 2000 || i > 2100)
+            log_next_measurement(&m);
+        if (i % 500 == 250)
+            m.mc_1p0 += 800.0f;
+        if (i % 3 == 0)
+            m.nc_0p5 = 50.0f;
+        CHECK_ZERO(sps30_log_append(&writer,
+                                    START_MS + i * PERIOD_MS + (i % 37 == 0),
+                                    &m));
+        if (i == 1000)
+            CHECK_ZERO(sps30_log_writer_resume(&writer, &info, log_write, NULL,
+                                               log_size));
+    }
+
+    /* down to records cut off at the end of the last block */
+    for (size = log_size; size > log_size - 40; --size) {
+        CHECK_ZERO(sps30_log_reader_init(&reader, log_data, size));
+        num_expected = 0;
+        while (sps30_log_read_raw(&reader, &expected_ts[num_expected],
+                                  &expected[num_expected *
+                                            SPS30_LOG_NUM_FIELDS]) == 0)
+            ++num_expected;
+        CHECK_TRUE(num_expected > 2990);
+
+        for (i = 0; i < sizeof(chunks) / sizeof(chunks[0]); ++i) {
+            CHECK_ZERO(sps30_log_reader_init(&reader, log_data, size));
+            count = 0;
+            do {
+                n = sps30_log_read_raw_many(
+                    &reader, &timestamps[count],
+                    &values[count * SPS30_LOG_NUM_FIELDS], chunks[i]);
+                count += n;
+            } while (n == chunks[i]);
+            CHECK_EQUAL(num_expected, count);
+            CHECK_TRUE(memcmp(expected_ts, timestamps,
+                              count * sizeof(timestamps[0])) == 0);
+            CHECK_TRUE(memcmp(expected, values,
+                              count * sizeof(values[0]) *
+                                  SPS30_LOG_NUM_FIELDS) == 0);
+        }
+    }
+}
@@ -0,0 +1,110 @@
+#include "sensirion_test_setup.h"
+#include "sps30.h"
+#include "sps30_sim.h"
+
+/* built with all SPS30_NO_* feature selections */
+
+#define SIM_BUS 0
+
+static const struct sps30_measurement fixed = {
+    1.5f, 2.5f, 4.5f, 10.5f, 5.0f, 10.0f, 25.0f, 40.0f, 100.0f, 0.75f};
+
+TEST_GROUP (SPSMinimalTestGroup) {
+    struct sps30_dev dev;
+
+    void setup() {
+        int16_t ret;
+
+        sps30_sim_reset();
+        ret = sps30_sim_add_sensor(SIM_BUS, SPS30_I2C_ADDRESS);
+        CHECK_ZERO_TEXT(ret, "sps30_sim_add_sensor");
+        sensirion_i2c_init();
+        sps30_dev_init(&dev, SIM_BUS, SPS30_I2C_ADDRESS);
+    }
+
+    void teardown() {
+        sensirion_i2c_release();
+    }
+};
+
+TEST (SPSMinimalTestGroup, SPS30MinimalTest_probe) {
+    struct sps30_dev absent;
+    int16_t ret;
+
+    ret = sps30_dev_probe(&dev);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_probe");
+
+    sps30_dev_init(&absent, SIM_BUS, SPS30_I2C_ADDRESS + 1);
+    ret = sps30_dev_probe(&absent);
+    CHECK_TRUE_TEXT(ret != 0, "sps30_dev_probe without sensor");
+}
+
+TEST (SPSMinimalTestGroup, SPS30MinimalTest_format) {
+    int16_t ret;
+
+    CHECK_EQUAL(SPS30_FORMAT_UINT16, dev.format);
+    CHECK_EQUAL(SPS30_MEASUREMENT_FRAME_SIZE / 2,
+                sps30_dev_measurement_frame_size(&dev));
+
+    ret = sps30_dev_set_measurement_format(&dev, SPS30_FORMAT_FLOAT);
+    CHECK_EQUAL(SPS30_ERR_FORMAT, ret);
+    ret = sps30_dev_set_measurement_format(&dev, SPS30_FORMAT_UINT16);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_set_measurement_format");
+}
+
+TEST (SPSMinimalTestGroup, SPS30MinimalTest_measurement) {
+    struct sps30_measurement_u16 m16;
+    uint16_t data_ready = 0;
+    uint16_t polls;
+    int16_t ret;
+
+    sps30_sim_set_measurement(SIM_BUS, SPS30_I2C_ADDRESS, &fixed);
+    ret = sps30_dev_start_measurement(&dev);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_start_measurement");
+
+    for (polls = 0; polls < 20 && !data_ready; ++polls) {
+        sensirion_sleep_usec(100000);  // Sleep 100ms
+        ret = sps30_dev_read_data_ready(&dev, &data_ready);
+        CHECK_ZERO_TEXT(ret, "sps30_dev_read_data_ready while polling");
+    }
+    CHECK_TRUE_TEXT(data_ready, "no data ready after 2s");
+
+    ret = sps30_dev_read_measurement_u16(&dev, &m16);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_read_measurement_u16");
+    CHECK_EQUAL(3, m16.mc_2p5);
+    CHECK_EQUAL(100, m16.nc_10p0);
+    CHECK_EQUAL(750, m16.typical_particle_size);
+
+    ret = sps30_dev_stop_measurement(&dev);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_stop_measurement");
+}
+
+TEST (SPSMinimalTestGroup, SPS30MinimalTest_frame_decoder) {
+    uint8_t frame[SPS30_MEASUREMENT_FRAME_SIZE / 2];
+    uint8_t cmd[SENSIRION_COMMAND_SIZE];
+    struct sps30_frame_decoder decoder;
+    struct sps30_measurement_u16 m16;
+    int16_t ret;
+
+    /* only room for the uint16 payload */
+    CHECK_EQUAL(20, sizeof(decoder.data));
+
+    sps30_sim_set_measurement(SIM_BUS, SPS30_I2C_ADDRESS, &fixed);
+    ret = sps30_dev_start_measurement(&dev);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_start_measurement");
+    sensirion_sleep_usec(SPS30_MEASUREMENT_DURATION_USEC);
+
+    sensirion_fill_cmd_send_buf(cmd, 0x0300, NULL, 0);
+    ret = sensirion_i2c_write(SPS30_I2C_ADDRESS, cmd, sizeof(cmd));
+    CHECK_ZERO_TEXT(ret, "sensirion_i2c_write read measurement command");
+    ret = sensirion_i2c_read(SPS30_I2C_ADDRESS, frame, sizeof(frame));
+    CHECK_ZERO_TEXT(ret, "sensirion_i2c_read measurement frame");
+
+    sps30_frame_decoder_init(&decoder, &dev);
+    ret = sps30_frame_decoder_feed(&decoder, frame, sizeof(frame));
+    CHECK_ZERO_TEXT(ret, "sps30_frame_decoder_feed");
+    ret = sps30_frame_decoder_get_u16(&decoder, &m16);
+    CHECK_ZERO_TEXT(ret, "sps30_frame_decoder_get_u16");
+    CHECK_EQUAL(100, m16.nc_10p0);
+    CHECK_EQUAL(750, m16.typical_particle_size);
+}
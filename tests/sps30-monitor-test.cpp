@@ -0,0 +1,157 @@
+#include "sensirion_test_setup.h"
+#include "sps30.h"
+#include "sps30_monitor.h"
+#include "sps30_sim.h"
+
+#define SIM_BUS 0
+#define CHECK_INTERVAL_US 5000000
+
+struct status_log {
+    uint32_t calls;
+    uint8_t faults;
+    uint8_t changed;
+    uint32_t device_status_flags;
+};
+
+static void on_status(void* context, uint8_t faults, uint8_t changed,
+                      uint32_t device_status_flags) {
+    struct status_log* log = (struct status_log*)context;
+
+    log->calls++;
+    log->faults = faults;
+    log->changed = changed;
+    log->device_status_flags = device_status_flags;
+}
+
+TEST_GROUP (SPSMonitorTestGroup) {
+    struct sps30_dev dev;
+    struct sps30_monitor monitor;
+    struct status_log log;
+
+    void setup() {
+        int16_t ret;
+
+        sps30_sim_reset();
+        ret = sps30_sim_add_sensor(SIM_BUS, SPS30_I2C_ADDRESS);
+        CHECK_ZERO_TEXT(ret, "sps30_sim_add_sensor");
+        sensirion_i2c_init();
+        sps30_dev_init(&dev, SIM_BUS, SPS30_I2C_ADDRESS);
+        memset(&log, 0, sizeof(log));
+        sps30_monitor_init(&monitor, &dev, CHECK_INTERVAL_US, on_status, &log);
+        ret = sps30_dev_start_measurement(&dev);
+        CHECK_ZERO_TEXT(ret, "sps30_dev_start_measurement");
+    }
+
+    void teardown() {
+        sensirion_i2c_release();
+    }
+
+    /* one read slot per second with the monitor around the read */
+    void read_slots(uint32_t count) {
+        struct sps30_measurement m;
+        int16_t ret;
+
+        while (count--) {
+            sps30_sim_advance_us(SPS30_MEASUREMENT_DURATION_USEC);
+            ret = sps30_monitor_before_read(&monitor, sps30_sim_time_us());
+            CHECK_ZERO_TEXT(ret, "sps30_monitor_before_read");
+            ret = sps30_dev_read_measurement(&dev, &m);
+            CHECK_ZERO_TEXT(ret, "sps30_dev_read_measurement");
+            ret = sps30_monitor_after_read(&monitor, sps30_sim_time_us());
+            CHECK_ZERO_TEXT(ret, "sps30_monitor_after_read");
+        }
+    }
+};
+
+TEST (SPSMonitorTestGroup, SPS30MonitorTest_decode) {
+    const uint32_t faults = SPS30_DEVICE_STATUS_FAN_ERROR_MASK |
+                            SPS30_DEVICE_STATUS_LASER_ERROR_MASK |
+                            SPS30_DEVICE_STATUS_FAN_SPEED_WARNING;
+
+    CHECK_EQUAL(0, sps30_monitor_decode(0));
+    CHECK_EQUAL(0, sps30_monitor_decode(~faults));
+    CHECK_EQUAL(SPS30_MONITOR_FAULT_FAN,
+                sps30_monitor_decode(SPS30_DEVICE_STATUS_FAN_ERROR_MASK));
+    CHECK_EQUAL(SPS30_MONITOR_FAULT_LASER,
+                sps30_monitor_decode(SPS30_DEVICE_STATUS_LASER_ERROR_MASK));
+    CHECK_EQUAL(SPS30_MONITOR_FAULT_FAN_SPEED,
+                sps30_monitor_decode(SPS30_DEVICE_STATUS_FAN_SPEED_WARNING));
+}
+
+TEST (SPSMonitorTestGroup, SPS30MonitorTest_no_sleep) {
+    struct sps30_sim_stats stats;
+
+    sps30_sim_reset_stats();
+    read_slots(20);
+    sps30_sim_get_stats(&stats);
+
+    /* a check every five reads, each a write and a read without sleeping */
+    CHECK_EQUAL(4, monitor.checks);
+    CHECK_EQUAL(0, monitor.errors);
+    CHECK_EQUAL(0, stats.nacks);
+    CHECK_EQUAL(0, stats.sleeps);
+    CHECK_EQUAL(20 * 2 + 4 * 2, stats.transactions);
+    CHECK_EQUAL(0, log.calls);
+}
+
+TEST (SPSMonitorTestGroup, SPS30MonitorTest_changes) {
+    const uint32_t fan_error = SPS30_DEVICE_STATUS_FAN_ERROR_MASK;
+
+    read_slots(1);
+    sps30_sim_set_device_status(SIM_BUS, SPS30_I2C_ADDRESS, fan_error);
+    /* the check issued after the first read still reports no faults */
+    read_slots(5);
+    CHECK_EQUAL(0, log.calls);
+    read_slots(1);
+    CHECK_EQUAL(1, log.calls);
+    CHECK_EQUAL(SPS30_MONITOR_FAULT_FAN, log.faults);
+    CHECK_EQUAL(SPS30_MONITOR_FAULT_FAN, log.changed);
+    CHECK_EQUAL(fan_error, log.device_status_flags);
+    CHECK_EQUAL(SPS30_MONITOR_FAULT_FAN, monitor.faults);
+
+    /* unchanged status, no callback */
+    read_slots(10);
+    CHECK_EQUAL(1, log.calls);
+
+    sps30_sim_set_device_status(SIM_BUS, SPS30_I2C_ADDRESS,
+                                SPS30_DEVICE_STATUS_FAN_SPEED_WARNING);
+    read_slots(5);
+    CHECK_EQUAL(2, log.calls);
+    CHECK_EQUAL(SPS30_MONITOR_FAULT_FAN_SPEED, log.faults);
+    CHECK_EQUAL(SPS30_MONITOR_FAULT_FAN | SPS30_MONITOR_FAULT_FAN_SPEED,
+                log.changed);
+}
+
+TEST (SPSMonitorTestGroup, SPS30MonitorTest_abandoned) {
+    struct sps30_measurement m;
+    int16_t ret;
+
+    read_slots(1);
+    /* the next read follows right away, before the processing time */
+    ret = sps30_monitor_before_read(&monitor, sps30_sim_time_us());
+    CHECK_EQUAL(SPS30_ERR_NOT_READY, ret);
+    CHECK_EQUAL(1, monitor.errors);
+    sps30_sim_advance_us(SPS30_MEASUREMENT_DURATION_USEC);
+    ret = sps30_dev_read_measurement(&dev, &m);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_read_measurement after abandoned check");
+
+    /* the check is issued again after the next read */
+    ret = sps30_monitor_after_read(&monitor, sps30_sim_time_us());
+    CHECK_ZERO_TEXT(ret, "sps30_monitor_after_read");
+    read_slots(1);
+    CHECK_EQUAL(1, monitor.checks);
+}
+
+TEST (SPSMonitorTestGroup, SPS30MonitorTest_crc_error) {
+    read_slots(1);
+    sps30_sim_inject_crc_errors(SIM_BUS, SPS30_I2C_ADDRESS, 1);
+    sps30_sim_advance_us(SPS30_MEASUREMENT_DURATION_USEC);
+    CHECK_EQUAL(SPS30_ERR_CRC,
+                sps30_monitor_before_read(&monitor, sps30_sim_time_us()));
+    CHECK_EQUAL(1, monitor.errors);
+    CHECK_EQUAL(0, log.calls);
+
+    /* the monitor does not wait for the interval to retry */
+    read_slots(2);
+    CHECK_EQUAL(1, monitor.checks);
+}
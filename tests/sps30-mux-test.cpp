@@ -0,0 +1,276 @@
+#include "sensirion_test_setup.h"
+#include "sps30.h"
+#include "sps30_sched.h"
+#include "sps30_sim.h"
+
+#define SIM_BUS 0
+#define MUX_A 0x70
+#define MUX_B 0x71
+
+struct visit_log {
+    uint8_t channels[2 * SPS30_MUX_CHANNELS];
+    uint8_t count;
+};
+
+/* everything a read slot needs from one sensor */
+static int16_t read_sensor(struct sps30_dev* dev, void* context) {
+    struct visit_log* log = (struct visit_log*)context;
+    struct sps30_measurement m;
+    uint16_t data_ready;
+    int16_t ret;
+
+    log->channels[log->count++] = dev->mux_channel;
+    ret = sps30_dev_read_data_ready(dev, &data_ready);
+    if (ret == NO_ERROR && data_ready)
+        ret = sps30_dev_read_measurement(dev, &m);
+    return ret;
+}
+
+TEST_GROUP (SPSMuxTestGroup) {
+    struct sps30_mux mux_a;
+    struct sps30_mux mux_b;
+    struct sps30_dev devs[SPS30_MUX_CHANNELS];
+
+    void setup() {
+        sps30_sim_reset();
+        CHECK_ZERO_TEXT(sps30_sim_add_mux(SIM_BUS, MUX_A), "sps30_sim_add_mux");
+        CHECK_ZERO_TEXT(sps30_sim_add_mux(SIM_BUS, MUX_B), "sps30_sim_add_mux");
+        sensirion_i2c_init();
+        CHECK_ZERO_TEXT(sps30_mux_init(&mux_a, SIM_BUS, MUX_A, NULL),
+                        "sps30_mux_init");
+        CHECK_ZERO_TEXT(sps30_mux_init(&mux_b, SIM_BUS, MUX_B, &mux_a),
+                        "sps30_mux_init peer");
+    }
+
+    void teardown() {
+        sensirion_i2c_release();
+    }
+
+    /* sensors on channels 0..count-1 of a multiplexer */
+    void add_sensors(struct sps30_mux * mux, uint8_t count) {
+        int16_t ret;
+        uint8_t i;
+
+        for (i = 0; i < count; ++i) {
+            ret = sps30_sim_add_mux_sensor(SIM_BUS, mux->address, i,
+                                           SPS30_I2C_ADDRESS);
+            CHECK_ZERO_TEXT(ret, "sps30_sim_add_mux_sensor");
+            sps30_dev_init(&devs[i], SIM_BUS, SPS30_I2C_ADDRESS);
+            ret = sps30_dev_set_mux(&devs[i], mux, i);
+            CHECK_ZERO_TEXT(ret, "sps30_dev_set_mux");
+        }
+    }
+};
+
+TEST (SPSMuxTestGroup, SPS30MuxTest_set_mux) {
+    struct sps30_dev dev;
+
+    sps30_dev_init(&dev, SIM_BUS, SPS30_I2C_ADDRESS);
+    CHECK_TRUE(dev.mux == NULL);
+    CHECK_EQUAL(SPS30_MUX_NO_CHANNEL, dev.mux_channel);
+
+    CHECK_EQUAL(STATUS_FAIL,
+                sps30_dev_set_mux(&dev, &mux_a, SPS30_MUX_CHANNELS));
+    dev.bus = SIM_BUS + 1;
+    CHECK_EQUAL(STATUS_FAIL, sps30_dev_set_mux(&dev, &mux_a, 0));
+    dev.bus = SIM_BUS;
+    CHECK_ZERO_TEXT(sps30_dev_set_mux(&dev, &mux_a, 7), "sps30_dev_set_mux");
+    CHECK_EQUAL(7, dev.mux_channel);
+    CHECK_ZERO_TEXT(sps30_dev_set_mux(&dev, NULL, 0), "sps30_dev_set_mux");
+    CHECK_TRUE(dev.mux == NULL);
+    CHECK_EQUAL(SPS30_MUX_NO_CHANNEL, dev.mux_channel);
+}
+
+TEST (SPSMuxTestGroup, SPS30MuxTest_skip_unchanged) {
+    struct sps30_sim_stats stats;
+    char serial[SPS30_MAX_SERIAL_LEN];
+    uint8_t major;
+    uint8_t minor;
+    uint8_t i;
+    int16_t ret;
+
+    add_sensors(&mux_a, 4);
+    for (i = 0; i < 4; ++i) {
+        ret = sps30_dev_get_serial(&devs[i], serial);
+        CHECK_ZERO_TEXT(ret, "sps30_dev_get_serial");
+        CHECK_EQUAL('1' + i, serial[15]);
+        ret = sps30_dev_read_firmware_version(&devs[i], &major, &minor);
+        CHECK_ZERO_TEXT(ret, "sps30_dev_read_firmware_version");
+        CHECK_EQUAL(1 << i, sps30_sim_get_mux_channels(SIM_BUS, MUX_A));
+    }
+
+    /* once per channel, and the other multiplexer is closed once */
+    sps30_sim_get_stats(&stats);
+    CHECK_EQUAL(4, mux_a.switches);
+    CHECK_EQUAL(1, mux_b.switches);
+    CHECK_EQUAL(5, stats.mux_switches);
+    CHECK_EQUAL(0, stats.collisions);
+    CHECK_EQUAL(0, stats.nacks);
+}
+
+TEST (SPSMuxTestGroup, SPS30MuxTest_peers) {
+    struct sps30_sim_stats stats;
+    struct sps30_dev dev_b;
+    uint16_t data_ready;
+    int16_t ret;
+
+    add_sensors(&mux_a, 1);
+    ret = sps30_sim_add_mux_sensor(SIM_BUS, MUX_B, 0, SPS30_I2C_ADDRESS);
+    CHECK_ZERO_TEXT(ret, "sps30_sim_add_mux_sensor");
+    sps30_dev_init(&dev_b, SIM_BUS, SPS30_I2C_ADDRESS);
+    CHECK_ZERO_TEXT(sps30_dev_set_mux(&dev_b, &mux_b, 0), "sps30_dev_set_mux");
+
+    ret = sps30_dev_read_data_ready(&devs[0], &data_ready);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_read_data_ready on mux A");
+    ret = sps30_dev_read_data_ready(&dev_b, &data_ready);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_read_data_ready on mux B");
+    CHECK_EQUAL(0, sps30_sim_get_mux_channels(SIM_BUS, MUX_A));
+    CHECK_EQUAL(1, sps30_sim_get_mux_channels(SIM_BUS, MUX_B));
+    sps30_sim_get_stats(&stats);
+    CHECK_EQUAL(0, stats.collisions);
+
+    /* without linking, the channel of mux B stays connected */
+    sps30_mux_init(&mux_a, SIM_BUS, MUX_A, NULL);
+    sps30_mux_init(&mux_b, SIM_BUS, MUX_B, NULL);
+    ret = sps30_dev_read_data_ready(&devs[0], &data_ready);
+    CHECK_TRUE(ret != NO_ERROR);
+    sps30_sim_get_stats(&stats);
+    CHECK_TRUE(stats.collisions > 0);
+}
+
+TEST (SPSMuxTestGroup, SPS30MuxTest_peer_on_other_bus) {
+    struct sps30_mux mux_c;
+    uint16_t data_ready;
+    int16_t ret;
+
+    ret = sps30_mux_init(&mux_c, SIM_BUS + 1, MUX_A, &mux_a);
+    CHECK_EQUAL(STATUS_FAIL, ret);
+
+    /* mux C is not linked in, selecting on mux A leaves it alone */
+    add_sensors(&mux_a, 1);
+    ret = sps30_dev_read_data_ready(&devs[0], &data_ready);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_read_data_ready");
+    CHECK_EQUAL(0, mux_c.switches);
+}
+
+TEST (SPSMuxTestGroup, SPS30MuxTest_error_reselects) {
+    uint16_t data_ready;
+    uint32_t switches;
+    int16_t ret;
+
+    add_sensors(&mux_a, 2);
+    ret = sps30_dev_read_data_ready(&devs[1], &data_ready);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_read_data_ready");
+    switches = mux_a.switches;
+
+    sps30_sim_inject_nacks(SPS30_SIM_MUX_BUS(MUX_A, 1), SPS30_I2C_ADDRESS, 1);
+    ret = sps30_dev_read_data_ready(&devs[1], &data_ready);
+    CHECK_TRUE(ret != NO_ERROR);
+    CHECK_EQUAL(switches, mux_a.switches);
+
+    /* the selection is unknown after the error and written again */
+    ret = sps30_dev_read_data_ready(&devs[1], &data_ready);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_read_data_ready after NACK");
+    CHECK_EQUAL(switches + 1, mux_a.switches);
+}
+
+TEST (SPSMuxTestGroup, SPS30MuxTest_release) {
+    uint16_t data_ready;
+    uint32_t switches;
+    int16_t ret;
+
+    add_sensors(&mux_a, 2);
+    ret = sps30_dev_read_data_ready(&devs[1], &data_ready);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_read_data_ready");
+    CHECK_EQUAL(2, sps30_sim_get_mux_channels(SIM_BUS, MUX_A));
+
+    CHECK_ZERO_TEXT(sps30_mux_release(&mux_b), "sps30_mux_release");
+    CHECK_EQUAL(0, sps30_sim_get_mux_channels(SIM_BUS, MUX_A));
+    switches = mux_a.switches + mux_b.switches;
+    CHECK_ZERO_TEXT(sps30_mux_release(&mux_a), "sps30_mux_release");
+    CHECK_EQUAL(switches, mux_a.switches + mux_b.switches);
+
+    /* e.g. after a power cycle of the multiplexers */
+    sps30_mux_invalidate(&mux_a);
+    ret = sps30_dev_read_data_ready(&devs[1], &data_ready);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_read_data_ready");
+    CHECK_EQUAL(switches + 2, mux_a.switches + mux_b.switches);
+}
+
+TEST (SPSMuxTestGroup, SPS30MuxTest_sched_order) {
+    static const uint8_t order[SPS30_MUX_CHANNELS] = {5, 2, 7, 0, 3, 6, 1, 4};
+    struct sps30_sched sched;
+    struct sps30_sim_stats stats;
+    struct visit_log log;
+    uint8_t i;
+    int16_t ret;
+
+    add_sensors(&mux_a, SPS30_MUX_CHANNELS);
+    sps30_sched_init(&sched);
+    for (i = 0; i < SPS30_MUX_CHANNELS; ++i) {
+        ret = sps30_sched_add(&sched, &devs[order[i]]);
+        CHECK_ZERO_TEXT(ret, "sps30_sched_add");
+    }
+    for (i = 0; i < SPS30_MUX_CHANNELS; ++i) {
+        ret = sps30_dev_start_measurement(&devs[i]);
+        CHECK_ZERO_TEXT(ret, "sps30_dev_start_measurement");
+    }
+    sps30_sim_advance_us(SPS30_MEASUREMENT_DURATION_USEC);
+    sps30_sim_reset_stats();
+
+    memset(&log, 0, sizeof(log));
+    ret = sps30_sched_run(&sched, read_sensor, &log);
+    CHECK_ZERO_TEXT(ret, "sps30_sched_run");
+    sps30_sim_advance_us(SPS30_MEASUREMENT_DURATION_USEC);
+    ret = sps30_sched_run(&sched, read_sensor, &log);
+    CHECK_ZERO_TEXT(ret, "sps30_sched_run");
+    CHECK_EQUAL(2, sched.runs);
+
+    /* ascending, then descending from the last selected channel */
+    for (i = 0; i < SPS30_MUX_CHANNELS; ++i) {
+        CHECK_EQUAL(i, log.channels[i]);
+        CHECK_EQUAL(SPS30_MUX_CHANNELS - 1 - i,
+                    log.channels[SPS30_MUX_CHANNELS + i]);
+    }
+    sps30_sim_get_stats(&stats);
+    CHECK_EQUAL(2 * SPS30_MUX_CHANNELS - 1, stats.mux_switches);
+    CHECK_EQUAL(2 * SPS30_MUX_CHANNELS * 2 * 2, stats.transactions -
+                                                    stats.mux_switches);
+    CHECK_EQUAL(0, stats.collisions);
+}
+
+TEST (SPSMuxTestGroup, SPS30MuxTest_sched_errors) {
+    struct sps30_sched sched;
+    struct sps30_sched full;
+    struct sps30_dev direct;
+    struct visit_log log;
+    uint8_t i;
+    int16_t ret;
+
+    CHECK_ZERO_TEXT(sps30_sim_add_sensor(SIM_BUS, SPS30_I2C_ADDRESS + 1),
+                    "sps30_sim_add_sensor");
+    add_sensors(&mux_a, 3);
+    sps30_dev_init(&direct, SIM_BUS, SPS30_I2C_ADDRESS + 1);
+    sps30_sched_init(&sched);
+    for (i = 0; i < 3; ++i) {
+        ret = sps30_sched_add(&sched, &devs[2 - i]);
+        CHECK_ZERO_TEXT(ret, "sps30_sched_add");
+    }
+    CHECK_ZERO_TEXT(sps30_sched_add(&sched, &direct), "sps30_sched_add");
+
+    sps30_sched_init(&full);
+    for (i = 0; i < SPS30_SCHED_MAX_SENSORS; ++i)
+        CHECK_ZERO_TEXT(sps30_sched_add(&full, &direct), "sps30_sched_add");
+    CHECK_EQUAL(STATUS_FAIL, sps30_sched_add(&full, &direct));
+
+    /* the operation runs on all sensors, the error is reported */
+    sps30_sim_inject_nacks(SPS30_SIM_MUX_BUS(MUX_A, 1), SPS30_I2C_ADDRESS, 1);
+    memset(&log, 0, sizeof(log));
+    ret = sps30_sched_run(&sched, read_sensor, &log);
+    CHECK_TRUE(ret != NO_ERROR);
+    CHECK_EQUAL(4, log.count);
+    CHECK_EQUAL(SPS30_MUX_NO_CHANNEL, log.channels[0]);
+    CHECK_EQUAL(0, log.channels[1]);
+    CHECK_EQUAL(1, log.channels[2]);
+    CHECK_EQUAL(2, log.channels[3]);
+}
@@ -0,0 +1,181 @@
+#include "sensirion_test_setup.h"
+#include "sps30.h"
+#include "sps30_phase.h"
+#include "sps30_sim.h"
+
+#define SIM_BUS 0
+#define PHASE_NUM_SAMPLES 300
+#define PHASE_WARM_UP_SAMPLES 20
+
+struct phase_result {
+    uint32_t reads;
+    uint32_t samples;
+    uint32_t polls_after_warm_up;
+    uint64_t max_latency_ns;
+};
+
+/**
+ * phase_run() - read PHASE_NUM_SAMPLES samples at the tracker's schedule from
+ * a sensor whose clock deviates by @ppm
+ */
+static void phase_run(struct sps30_phase* phase, int32_t ppm,
+                      struct phase_result* result) {
+    const uint64_t interval_ns =
+        1000000000ULL + (uint64_t)((int64_t)ppm * 1000);
+    struct sps30_measurement m;
+    struct sps30_dev dev;
+    uint64_t start_ns;
+    uint64_t poll_ns;
+    uint64_t sample_ns;
+    uint32_t polls_at_warm_up = 0;
+    int32_t wait_us;
+    int16_t ret;
+
+    sps30_sim_reset();
+    ret = sps30_sim_add_sensor(SIM_BUS, SPS30_I2C_ADDRESS);
+    CHECK_ZERO_TEXT(ret, "sps30_sim_add_sensor");
+    ret = sps30_sim_set_clock_drift(SIM_BUS, SPS30_I2C_ADDRESS, ppm);
+    CHECK_ZERO_TEXT(ret, "sps30_sim_set_clock_drift");
+    sps30_dev_init(&dev, SIM_BUS, SPS30_I2C_ADDRESS);
+
+    ret = sps30_dev_issue_start_measurement(&dev, sps30_sim_time_us());
+    CHECK_ZERO_TEXT(ret, "sps30_dev_issue_start_measurement");
+    start_ns = sps30_sim_time_ns();
+    /* the driver's busy time starts before, the sensor's after the command */
+    sps30_sim_advance_us(sps30_dev_poll(&dev, sps30_sim_time_us()) + 1000);
+    sps30_phase_init(phase, sps30_sim_time_us());
+
+    memset(result, 0, sizeof(*result));
+    while (result->reads < PHASE_NUM_SAMPLES) {
+        wait_us = (int32_t)(sps30_phase_next_poll_us(phase) -
+                            sps30_sim_time_us());
+        if (wait_us > 0)
+            sps30_sim_advance_us((uint32_t)wait_us);
+
+        poll_ns = sps30_sim_time_ns();
+        ret = sps30_phase_poll(phase, &dev, sps30_sim_time_us(), &m);
+        if (ret == SPS30_ERR_NOT_READY)
+            continue;
+        CHECK_ZERO_TEXT(ret, "sps30_phase_poll");
+
+        result->reads++;
+        result->samples =
+            (uint32_t)((sps30_sim_time_ns() - start_ns) / interval_ns);
+        if (result->reads == PHASE_WARM_UP_SAMPLES)
+            polls_at_warm_up = phase->polls;
+
+        /* the sample may appear while the poll is on the bus */
+        sample_ns = start_ns + result->samples * interval_ns;
+        if (result->reads > PHASE_WARM_UP_SAMPLES && poll_ns > sample_ns &&
+            poll_ns - sample_ns > result->max_latency_ns)
+            result->max_latency_ns = poll_ns - sample_ns;
+    }
+    result->polls_after_warm_up = phase->polls - polls_at_warm_up;
+}
+
+TEST_GROUP (SPSPhaseTestGroup) {
+    struct sps30_phase phase;
+    struct phase_result result;
+
+    void setup() {
+    }
+
+    void teardown() {
+    }
+};
+
+TEST (SPSPhaseTestGroup, SPS30PhaseTest_nominal_clock) {
+    phase_run(&phase, 0, &result);
+
+    /* every sample is read exactly once */
+    CHECK_EQUAL(result.samples, result.reads);
+    CHECK_TRUE_TEXT(phase.period_us >= 999980 && phase.period_us <= 1000020,
+                    "period not learned");
+    CHECK_TRUE_TEXT(result.max_latency_ns < 10000000ULL,
+                    "latency to fresh data above 10ms");
+    CHECK_TRUE_TEXT(result.polls_after_warm_up <=
+                        5 * (PHASE_NUM_SAMPLES - PHASE_WARM_UP_SAMPLES) / 2,
+                    "more than 2.5 polls per sample");
+}
+
+TEST (SPSPhaseTestGroup, SPS30PhaseTest_drift) {
+    const int32_t drifts[] = {-2000, -300, 300, 2000};
+    uint32_t period_us;
+    uint16_t i;
+
+    for (i = 0; i < sizeof(drifts) / sizeof(drifts[0]); ++i) {
+        phase_run(&phase, drifts[i], &result);
+
+        CHECK_EQUAL(result.samples, result.reads);
+        period_us = (uint32_t)(1000000 + drifts[i]);
+        CHECK_TRUE_TEXT(phase.period_us + 20 >= period_us &&
+                            phase.period_us <= period_us + 20,
+                        "drift not compensated");
+        CHECK_TRUE_TEXT(result.max_latency_ns < 10000000ULL,
+                        "latency to fresh data above 10ms");
+    }
+}
+
+TEST (SPSPhaseTestGroup, SPS30PhaseTest_update) {
+    sps30_phase_init(&phase, 0);
+    CHECK_EQUAL(0, sps30_phase_next_poll_us(&phase));
+
+    /* stale data at the first poll carries no phase information */
+    sps30_phase_update(&phase, 0, 1);
+    CHECK_EQUAL(SPS30_PHASE_SEARCH_STEP_US, sps30_phase_next_poll_us(&phase));
+
+    /* transition between 300ms and 400ms */
+    sps30_phase_update(&phase, 300000, 0);
+    CHECK_EQUAL(400000, sps30_phase_next_poll_us(&phase));
+    sps30_phase_update(&phase, 400000, 1);
+    CHECK_EQUAL(1350000 - SPS30_PHASE_MAX_GUARD_US,
+                sps30_phase_next_poll_us(&phase));
+
+    /* a missed transition keeps the phase and widens the guard */
+    sps30_phase_update(&phase, 1400000, 1);
+    CHECK_EQUAL(1, phase.missed);
+    CHECK_EQUAL(SPS30_PHASE_MAX_GUARD_US, phase.guard_us);
+    CHECK_EQUAL(2350000 - SPS30_PHASE_MAX_GUARD_US,
+                sps30_phase_next_poll_us(&phase));
+}
+
+TEST (SPSPhaseTestGroup, SPS30PhaseTest_error_backoff) {
+    static const uint32_t retry_us[] = {2000,   4000,   8000,   16000,
+                                        32000,  64000,  128000, 256000,
+                                        512000, 1000000, 1000000};
+    struct sps30_measurement m;
+    struct sps30_dev dev;
+    uint32_t now_us;
+    uint8_t i;
+    int16_t ret;
+
+    sps30_sim_reset();
+    ret = sps30_sim_add_sensor(SIM_BUS, SPS30_I2C_ADDRESS);
+    CHECK_ZERO_TEXT(ret, "sps30_sim_add_sensor");
+    sps30_dev_init(&dev, SIM_BUS, SPS30_I2C_ADDRESS);
+    ret = sps30_dev_start_measurement(&dev);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_start_measurement");
+    sps30_phase_init(&phase, sps30_sim_time_us());
+
+    /* every failed poll doubles the wait, up to the period */
+    sps30_sim_inject_nacks(SIM_BUS, SPS30_I2C_ADDRESS,
+                           sizeof(retry_us) / sizeof(retry_us[0]));
+    for (i = 0; i < sizeof(retry_us) / sizeof(retry_us[0]); ++i) {
+        now_us = sps30_sim_time_us();
+        ret = sps30_phase_poll(&phase, &dev, now_us, &m);
+        CHECK_TRUE_TEXT(ret != NO_ERROR, "NACK not reported");
+        CHECK_EQUAL(now_us + retry_us[i], sps30_phase_next_poll_us(&phase));
+        sps30_sim_advance_us(retry_us[i]);
+    }
+
+    /* a successful poll resets the back-off */
+    ret = sps30_phase_poll(&phase, &dev, sps30_sim_time_us(), &m);
+    CHECK_TRUE_TEXT(ret == NO_ERROR || ret == SPS30_ERR_NOT_READY,
+                    "poll after the NACKs");
+    sps30_sim_inject_nacks(SIM_BUS, SPS30_I2C_ADDRESS, 1);
+    now_us = sps30_sim_time_us();
+    ret = sps30_phase_poll(&phase, &dev, now_us, &m);
+    CHECK_TRUE_TEXT(ret != NO_ERROR, "NACK not reported");
+    CHECK_EQUAL(now_us + SPS30_PHASE_MIN_GUARD_US,
+                sps30_phase_next_poll_us(&phase));
+}
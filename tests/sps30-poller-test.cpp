@@ -0,0 +1,158 @@
+#include <mutex>
+#include <unistd.h>  // close
+
+#include "sensirion_test_setup.h"
+#include "sps30_poller.h"
+#include "sps30_sim.h"
+
+#define PERIOD_US 1000000
+#define MAX_READS 16
+
+struct poller_log {
+    std::mutex lock;
+    uint32_t reads[3];
+    uint32_t errors[3];
+    uint64_t timestamps[3][MAX_READS];
+    uint32_t status_changes[3];
+    uint8_t faults[3];
+};
+
+static void poller_callback(void* context, uint8_t sensor, int16_t status,
+                            uint64_t timestamp_us,
+                            const struct sps30_measurement* measurement) {
+    struct poller_log* log = (struct poller_log*)context;
+    std::lock_guard<std::mutex> guard(log->lock);
+
+    if (status) {
+        CHECK_TRUE(measurement == NULL);
+        log->errors[sensor]++;
+        return;
+    }
+    CHECK_TRUE(measurement != NULL);
+    if (log->reads[sensor] < MAX_READS)
+        log->timestamps[sensor][log->reads[sensor]] = timestamp_us;
+    log->reads[sensor]++;
+}
+
+static void status_callback(void* context, uint8_t sensor, uint8_t faults,
+                            uint8_t changed, uint32_t device_status_flags) {
+    struct poller_log* log = (struct poller_log*)context;
+    std::lock_guard<std::mutex> guard(log->lock);
+
+    log->status_changes[sensor]++;
+    log->faults[sensor] = faults;
+}
+
+TEST_GROUP (SPSPollerTestGroup) {
+    struct sps30_poller poller;
+    struct poller_log log;
+
+    void setup() {
+        sps30_sim_reset();
+        CHECK_ZERO(sps30_sim_add_sensor(0, SPS30_I2C_ADDRESS));
+        CHECK_ZERO(sps30_sim_add_sensor(0, SPS30_I2C_ADDRESS + 1));
+        CHECK_ZERO(sps30_sim_add_sensor(1, SPS30_I2C_ADDRESS));
+        sensirion_i2c_init();
+        memset(log.reads, 0, sizeof(log.reads));
+        memset(log.errors, 0, sizeof(log.errors));
+        memset(log.status_changes, 0, sizeof(log.status_changes));
+        memset(log.faults, 0, sizeof(log.faults));
+        sps30_poller_init(&poller, PERIOD_US, poller_callback, &log);
+        CHECK_EQUAL(0, sps30_poller_add_sensor(&poller, 0, SPS30_I2C_ADDRESS));
+        CHECK_EQUAL(1,
+                    sps30_poller_add_sensor(&poller, 0, SPS30_I2C_ADDRESS + 1));
+        CHECK_EQUAL(2, sps30_poller_add_sensor(&poller, 1, SPS30_I2C_ADDRESS));
+    }
+
+    void teardown() {
+        sensirion_i2c_release();
+    }
+};
+
+TEST (SPSPollerTestGroup, SPS30PollerTest_staggered_reads) {
+    struct sps30_poller_jitter jitter;
+    uint8_t i;
+
+    CHECK_ZERO(sps30_poller_start(&poller));
+    CHECK_EQUAL(STATUS_FAIL,
+                sps30_poller_add_sensor(&poller, 2, SPS30_I2C_ADDRESS));
+    sensirion_sleep_usec(3 * PERIOD_US + PERIOD_US / 2);
+    sps30_poller_stop(&poller);
+
+    for (i = 0; i < 3; ++i) {
+        CHECK_TRUE(log.reads[i] >= 2);
+        CHECK_EQUAL(0, log.errors[i]);
+
+        sps30_poller_get_jitter(&poller, i, &jitter);
+        CHECK_EQUAL(log.reads[i], jitter.reads);
+        CHECK_EQUAL(0, jitter.missed);
+        CHECK_TRUE(jitter.jitter_min_us <= jitter.jitter_max_us);
+        CHECK_TRUE(jitter.jitter_max_us < PERIOD_US / 10);
+        printf("sensor %u: %u reads, jitter max %uus mean %lluus\n", i,
+               jitter.reads, jitter.jitter_max_us,
+               (unsigned long long)(jitter.jitter_sum_us / jitter.reads));
+    }
+
+    /* the sensors on bus 0 are read half a period apart */
+    DOUBLES_EQUAL(PERIOD_US / 2,
+                  (double)(log.timestamps[1][0] - log.timestamps[0][0]),
+                  PERIOD_US / 10);
+    DOUBLES_EQUAL(PERIOD_US,
+                  (double)(log.timestamps[0][1] - log.timestamps[0][0]),
+                  PERIOD_US / 10);
+    CHECK_EQUAL(SPS30_STATE_IDLE, sps30_sim_get_state(0, SPS30_I2C_ADDRESS));
+}
+
+TEST (SPSPollerTestGroup, SPS30PollerTest_errors_stay_on_their_bus) {
+    struct sps30_poller_jitter jitter;
+
+    CHECK_ZERO(sps30_poller_start(&poller));
+    sps30_sim_inject_nacks(1, SPS30_I2C_ADDRESS, 1000);
+    sensirion_sleep_usec(2 * PERIOD_US + PERIOD_US / 2);
+    sps30_poller_stop(&poller);
+
+    CHECK_TRUE(log.reads[0] >= 1);
+    CHECK_TRUE(log.reads[1] >= 1);
+    CHECK_EQUAL(0, log.reads[2]);
+    CHECK_TRUE(log.errors[2] >= 1);
+    sps30_poller_get_jitter(&poller, 2, &jitter);
+    CHECK_EQUAL(log.errors[2], jitter.errors);
+}
+
+TEST (SPSPollerTestGroup, SPS30PollerTest_stop_without_event) {
+    CHECK_ZERO(sps30_poller_start(&poller));
+    sensirion_sleep_usec(PERIOD_US + PERIOD_US / 2);
+
+    /* writing the stop event fails, the workers stop on their next slot */
+    close(poller.stop_fd);
+    poller.stop_fd = -1;
+    sps30_poller_stop(&poller);
+
+    CHECK_EQUAL(SPS30_STATE_IDLE, sps30_sim_get_state(0, SPS30_I2C_ADDRESS));
+    CHECK_EQUAL(SPS30_STATE_IDLE, sps30_sim_get_state(1, SPS30_I2C_ADDRESS));
+    CHECK_ZERO(sps30_poller_start(&poller));
+    sps30_poller_stop(&poller);
+}
+
+TEST (SPSPollerTestGroup, SPS30PollerTest_status_monitor) {
+    uint8_t i;
+
+    /* check after every read */
+    CHECK_ZERO(sps30_poller_set_status_monitor(&poller, 0, status_callback));
+    sps30_sim_set_device_status(1, SPS30_I2C_ADDRESS,
+                                SPS30_DEVICE_STATUS_LASER_ERROR_MASK);
+    CHECK_ZERO(sps30_poller_start(&poller));
+    CHECK_EQUAL(STATUS_FAIL,
+                sps30_poller_set_status_monitor(&poller, 0, status_callback));
+    sensirion_sleep_usec(3 * PERIOD_US + PERIOD_US / 2);
+    sps30_poller_stop(&poller);
+
+    for (i = 0; i < 3; ++i) {
+        CHECK_TRUE(log.reads[i] >= 2);
+        CHECK_EQUAL(0, log.errors[i]);
+    }
+    CHECK_EQUAL(0, log.status_changes[0]);
+    CHECK_EQUAL(0, log.status_changes[1]);
+    CHECK_EQUAL(1, log.status_changes[2]);
+    CHECK_EQUAL(SPS30_MONITOR_FAULT_LASER, log.faults[2]);
+}
@@ -0,0 +1,157 @@
+#include <atomic>
+#include <thread>
+
+#include "sensirion_test_setup.h"
+#include "sps30_ring.h"
+
+#define RING_CAPACITY 8
+
+static struct sps30_measurement ring_measurement(uint32_t i) {
+    struct sps30_measurement m;
+
+    memset(&m, 0, sizeof(m));
+    m.mc_1p0 = (float)i;
+    m.nc_10p0 = (float)i;
+    m.typical_particle_size = (float)i;
+    return m;
+}
+
+static void check_record(const struct sps30_record* r, uint32_t sequence) {
+    CHECK_EQUAL(sequence, r->sequence);
+    CHECK_EQUAL(sequence * 10, r->timestamp);
+    CHECK_EQUAL((float)sequence, r->measurement.mc_1p0);
+    CHECK_EQUAL((float)sequence, r->measurement.nc_10p0);
+    CHECK_EQUAL((float)sequence, r->measurement.typical_particle_size);
+}
+
+static int16_t ring_push(struct sps30_ring* ring, uint32_t i) {
+    struct sps30_measurement m = ring_measurement(i);
+
+    return sps30_ring_push(ring, i * 10, &m);
+}
+
+TEST_GROUP (SPSRingTestGroup) {
+    struct sps30_ring ring;
+    struct sps30_record records[RING_CAPACITY];
+
+    void setup() {
+        memset(records, 0, sizeof(records));
+    }
+
+    void teardown() {
+    }
+};
+
+TEST (SPSRingTestGroup, SPS30RingTest_init) {
+    CHECK_EQUAL(STATUS_FAIL, sps30_ring_init(&ring, records, 0,
+                                             SPS30_RING_DROP_NEWEST));
+    CHECK_EQUAL(STATUS_FAIL, sps30_ring_init(&ring, records, 6,
+                                             SPS30_RING_DROP_NEWEST));
+    CHECK_ZERO(sps30_ring_init(&ring, records, RING_CAPACITY,
+                               SPS30_RING_DROP_NEWEST));
+    CHECK_EQUAL(0, sps30_ring_count(&ring));
+    CHECK_EQUAL(0, sps30_ring_dropped(&ring));
+}
+
+TEST (SPSRingTestGroup, SPS30RingTest_push_pop) {
+    struct sps30_record r;
+    uint32_t i;
+
+    CHECK_ZERO(sps30_ring_init(&ring, records, RING_CAPACITY,
+                               SPS30_RING_DROP_NEWEST));
+    CHECK_EQUAL(STATUS_FAIL, sps30_ring_pop(&ring, &r));
+
+    /* wrap around the storage a few times */
+    for (i = 0; i < 3 * RING_CAPACITY; ++i) {
+        CHECK_ZERO(ring_push(&ring, i));
+        CHECK_EQUAL(1, sps30_ring_count(&ring));
+        CHECK_ZERO(sps30_ring_pop(&ring, &r));
+        check_record(&r, i);
+    }
+    CHECK_EQUAL(STATUS_FAIL, sps30_ring_pop(&ring, &r));
+    CHECK_EQUAL(0, sps30_ring_dropped(&ring));
+}
+
+TEST (SPSRingTestGroup, SPS30RingTest_drop_newest) {
+    struct sps30_record out[RING_CAPACITY];
+    uint32_t i;
+
+    CHECK_ZERO(sps30_ring_init(&ring, records, RING_CAPACITY,
+                               SPS30_RING_DROP_NEWEST));
+    for (i = 0; i < RING_CAPACITY; ++i)
+        CHECK_ZERO(ring_push(&ring, i));
+    CHECK_EQUAL(STATUS_FAIL, ring_push(&ring, RING_CAPACITY));
+    CHECK_EQUAL(STATUS_FAIL, ring_push(&ring, RING_CAPACITY + 1));
+    CHECK_EQUAL(RING_CAPACITY, sps30_ring_count(&ring));
+    CHECK_EQUAL(2, sps30_ring_dropped(&ring));
+
+    CHECK_EQUAL(RING_CAPACITY,
+                sps30_ring_pop_bulk(&ring, out, RING_CAPACITY));
+    for (i = 0; i < RING_CAPACITY; ++i)
+        check_record(&out[i], i);
+
+    /* the sequence number reveals the gap */
+    CHECK_ZERO(ring_push(&ring, RING_CAPACITY + 2));
+    CHECK_EQUAL(1, sps30_ring_pop_bulk(&ring, out, RING_CAPACITY));
+    check_record(&out[0], RING_CAPACITY + 2);
+}
+
+TEST (SPSRingTestGroup, SPS30RingTest_drop_oldest) {
+    struct sps30_record out[RING_CAPACITY];
+    uint32_t n;
+    uint32_t i;
+
+    CHECK_ZERO(sps30_ring_init(&ring, records, RING_CAPACITY,
+                               SPS30_RING_DROP_OLDEST));
+    for (i = 0; i < 3 * RING_CAPACITY; ++i)
+        CHECK_ZERO(ring_push(&ring, i));
+    CHECK_EQUAL(RING_CAPACITY, sps30_ring_count(&ring));
+
+    /* the slot to be written next is not handed out */
+    n = sps30_ring_pop_bulk(&ring, out, RING_CAPACITY);
+    CHECK_EQUAL(RING_CAPACITY - 1, n);
+    for (i = 0; i < n; ++i)
+        check_record(&out[i], 2 * RING_CAPACITY + 1 + i);
+    CHECK_EQUAL(2 * RING_CAPACITY + 1, sps30_ring_dropped(&ring));
+    CHECK_EQUAL(0, sps30_ring_count(&ring));
+}
+
+TEST (SPSRingTestGroup, SPS30RingTest_concurrent) {
+    const uint32_t total = 200000;
+    const uint8_t policies[] = {SPS30_RING_DROP_NEWEST,
+                                SPS30_RING_DROP_OLDEST};
+    struct sps30_record out[RING_CAPACITY / 2];
+    uint32_t p;
+
+    for (p = 0; p < sizeof(policies); ++p) {
+        std::atomic<bool> done(false);
+        uint32_t received = 0;
+        uint32_t next = 0;
+        uint32_t n;
+        uint32_t i;
+
+        CHECK_ZERO(sps30_ring_init(&ring, records, RING_CAPACITY,
+                                   policies[p]));
+        std::thread producer([this, total, &done]() {
+            for (uint32_t j = 0; j < total; ++j)
+                ring_push(&ring, j);
+            done = true;
+        });
+        for (;;) {
+            const bool finished = done;
+
+            n = sps30_ring_pop_bulk(&ring, out, RING_CAPACITY / 2);
+            for (i = 0; i < n; ++i) {
+                /* records arrive in order and are never torn */
+                CHECK_TRUE(out[i].sequence >= next);
+                check_record(&out[i], out[i].sequence);
+                next = out[i].sequence + 1;
+            }
+            received += n;
+            if (n == 0 && finished)
+                break;
+        }
+        producer.join();
+        CHECK_EQUAL(total, received + sps30_ring_dropped(&ring));
+    }
+}
@@ -0,0 +1,499 @@
+#include "sensirion_test_setup.h"
+#include "sps30.h"
+#include "sps30_sim.h"
+
+#define SIM_BUS 0
+
+#ifdef SPS30_I2C_WRITE_READ
+#define SIM_READ_CMD_TRANSACTIONS 1
+#else
+#define SIM_READ_CMD_TRANSACTIONS 2
+#endif
+
+static const struct sps30_measurement fixed = {
+    1.5f, 2.5f, 4.5f, 10.5f, 5.0f, 10.0f, 25.0f, 40.0f, 100.0f, 0.75f};
+
+static void sps30_sim_wait_data_ready(struct sps30_dev* dev) {
+    uint16_t data_ready = 0;
+    int16_t ret;
+    uint16_t polls;
+
+    for (polls = 0; polls < 20 && !data_ready; ++polls) {
+        sensirion_sleep_usec(100000);  // Sleep 100ms
+        ret = sps30_dev_read_data_ready(dev, &data_ready);
+        CHECK_ZERO_TEXT(ret, "sps30_dev_read_data_ready while polling");
+    }
+    CHECK_TRUE_TEXT(data_ready, "no data ready after 2s");
+}
+
+TEST_GROUP (SPSSimTestGroup) {
+    struct sps30_dev dev;
+
+    void setup() {
+        int16_t ret;
+
+        sps30_sim_reset();
+        ret = sps30_sim_add_sensor(SIM_BUS, SPS30_I2C_ADDRESS);
+        CHECK_ZERO_TEXT(ret, "sps30_sim_add_sensor");
+        sensirion_i2c_init();
+        sps30_dev_init(&dev, SIM_BUS, SPS30_I2C_ADDRESS);
+        ret = sps30_dev_probe(&dev);
+        CHECK_ZERO_TEXT(ret, "sps30_dev_probe");
+    }
+
+    void teardown() {
+        sensirion_i2c_release();
+    }
+};
+
+TEST (SPSSimTestGroup, SPS30SimTest_identity) {
+    char serial[SPS30_MAX_SERIAL_LEN];
+    uint8_t major;
+    uint8_t minor;
+    int16_t ret;
+
+    ret = sps30_dev_get_serial(&dev, serial);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_get_serial");
+    STRCMP_EQUAL("SIM0000000000001", serial);
+
+    ret = sps30_dev_read_firmware_version(&dev, &major, &minor);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_read_firmware_version");
+    CHECK_EQUAL(2, major);
+    CHECK_EQUAL(2, minor);
+}
+
+TEST (SPSSimTestGroup, SPS30SimTest_cache) {
+    char serial[SPS30_MAX_SERIAL_LEN];
+    struct sps30_sim_stats stats;
+    uint32_t interval;
+    uint8_t major;
+    uint8_t minor;
+    int16_t ret;
+
+    /* the serial was read by the probe */
+    sps30_sim_reset_stats();
+    ret = sps30_dev_get_serial(&dev, serial);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_get_serial");
+    STRCMP_EQUAL("SIM0000000000001", serial);
+    ret = sps30_dev_read_firmware_version(&dev, &major, &minor);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_read_firmware_version");
+    ret = sps30_dev_read_firmware_version(&dev, &major, &minor);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_read_firmware_version");
+    CHECK_EQUAL(2, major);
+    sps30_sim_get_stats(&stats);
+    CHECK_EQUAL(SIM_READ_CMD_TRANSACTIONS, stats.transactions);
+
+    ret = sps30_dev_get_fan_auto_cleaning_interval(&dev, &interval);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_get_fan_auto_cleaning_interval");
+    sps30_sim_reset_stats();
+    ret = sps30_dev_get_fan_auto_cleaning_interval(&dev, &interval);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_get_fan_auto_cleaning_interval");
+    CHECK_EQUAL(604800, interval);
+    sps30_sim_get_stats(&stats);
+    CHECK_EQUAL(0, stats.transactions);
+    CHECK_EQUAL(0, stats.sleeps);
+
+    /* setting the interval drops the cached value */
+    ret = sps30_dev_set_fan_auto_cleaning_interval(&dev, 3600);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_set_fan_auto_cleaning_interval");
+    ret = sps30_dev_get_fan_auto_cleaning_interval(&dev, &interval);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_get_fan_auto_cleaning_interval");
+    CHECK_EQUAL(3600, interval);
+
+    /* a reset drops everything */
+    ret = sps30_dev_reset(&dev);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_reset");
+    CHECK_EQUAL(0, dev.cached);
+    sps30_sim_advance_us(SPS30_RESET_DELAY_USEC);
+
+    sps30_sim_reset_stats();
+    ret = sps30_dev_refresh_cache(&dev);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_refresh_cache");
+    CHECK_EQUAL(SPS30_CACHED_SERIAL | SPS30_CACHED_FIRMWARE_VERSION |
+                    SPS30_CACHED_FAN_AUTO_CLEANING_INTERVAL,
+                dev.cached);
+    sps30_sim_get_stats(&stats);
+    /* the auto-cleaning interval is never read in a combined transfer */
+    CHECK_EQUAL(2 * SIM_READ_CMD_TRANSACTIONS + 2, stats.transactions);
+
+    /* a probe checks the presence without reading the serial again */
+    sps30_sim_reset_stats();
+    ret = sps30_dev_probe(&dev);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_probe");
+    sps30_sim_get_stats(&stats);
+    CHECK_EQUAL(3, stats.bytes_read);
+}
+
+TEST (SPSSimTestGroup, SPS30SimTest_float_measurement) {
+    struct sps30_measurement m;
+    struct sps30_sim_stats stats;
+    int16_t ret;
+
+    sps30_sim_set_measurement(SIM_BUS, SPS30_I2C_ADDRESS, &fixed);
+    ret = sps30_dev_start_measurement(&dev);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_start_measurement");
+    sps30_sim_wait_data_ready(&dev);
+
+    sps30_sim_reset_stats();
+    ret = sps30_dev_read_measurement(&dev, &m);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_read_measurement");
+    sps30_sim_get_stats(&stats);
+    CHECK_EQUAL(60, stats.bytes_read);
+    CHECK_EQUAL(SIM_READ_CMD_TRANSACTIONS, stats.transactions);
+    DOUBLES_EQUAL(fixed.mc_2p5, m.mc_2p5, 1e-6);
+    DOUBLES_EQUAL(fixed.nc_10p0, m.nc_10p0, 1e-6);
+    DOUBLES_EQUAL(fixed.typical_particle_size, m.typical_particle_size, 1e-6);
+
+    ret = sps30_dev_stop_measurement(&dev);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_stop_measurement");
+}
+
+TEST (SPSSimTestGroup, SPS30SimTest_uint16_measurement) {
+    struct sps30_measurement_u16 m16;
+    struct sps30_measurement m;
+    struct sps30_sim_stats stats;
+    int16_t ret;
+
+    sps30_sim_set_measurement(SIM_BUS, SPS30_I2C_ADDRESS, &fixed);
+    ret = sps30_dev_set_measurement_format(&dev, SPS30_FORMAT_UINT16);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_set_measurement_format");
+    ret = sps30_dev_start_measurement(&dev);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_start_measurement");
+    sps30_sim_wait_data_ready(&dev);
+
+    sps30_sim_reset_stats();
+    ret = sps30_dev_read_measurement_u16(&dev, &m16);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_read_measurement_u16");
+    sps30_sim_get_stats(&stats);
+    CHECK_EQUAL(30, stats.bytes_read);
+    CHECK_EQUAL(3, m16.mc_2p5);
+    CHECK_EQUAL(100, m16.nc_10p0);
+    CHECK_EQUAL(750, m16.typical_particle_size);
+
+    ret = sps30_dev_read_measurement(&dev, &m);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_read_measurement in uint16 format");
+    DOUBLES_EQUAL(0.75, m.typical_particle_size, 1e-6);
+}
+
+TEST (SPSSimTestGroup, SPS30SimTest_decode_measurement) {
+    uint8_t frame[SPS30_MEASUREMENT_FRAME_SIZE];
+    uint8_t cmd[SENSIRION_COMMAND_SIZE];
+    struct sps30_measurement m;
+    int16_t ret;
+
+    sps30_sim_set_measurement(SIM_BUS, SPS30_I2C_ADDRESS, &fixed);
+    ret = sps30_dev_start_measurement(&dev);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_start_measurement");
+    sps30_sim_wait_data_ready(&dev);
+    CHECK_EQUAL(SPS30_MEASUREMENT_FRAME_SIZE,
+                sps30_dev_measurement_frame_size(&dev));
+
+    sensirion_fill_cmd_send_buf(cmd, 0x0300, NULL, 0);
+    ret = sensirion_i2c_write(SPS30_I2C_ADDRESS, cmd, sizeof(cmd));
+    CHECK_ZERO_TEXT(ret, "sensirion_i2c_write read measurement command");
+    ret = sensirion_i2c_read(SPS30_I2C_ADDRESS, frame, sizeof(frame));
+    CHECK_ZERO_TEXT(ret, "sensirion_i2c_read measurement frame");
+
+    ret = sps30_dev_decode_measurement(&dev, frame, &m);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_decode_measurement");
+    DOUBLES_EQUAL(fixed.mc_1p0, m.mc_1p0, 1e-6);
+    DOUBLES_EQUAL(fixed.nc_4p0, m.nc_4p0, 1e-6);
+    DOUBLES_EQUAL(fixed.typical_particle_size, m.typical_particle_size, 1e-6);
+
+    frame[SPS30_MEASUREMENT_FRAME_SIZE - 1] ^= 0x01;
+    ret = sps30_dev_decode_measurement(&dev, frame, &m);
+    CHECK_EQUAL(SPS30_ERR_CRC, ret);
+}
+
+TEST (SPSSimTestGroup, SPS30SimTest_frame_decoder) {
+    uint8_t frame[SPS30_MEASUREMENT_FRAME_SIZE + 3];
+    uint8_t cmd[SENSIRION_COMMAND_SIZE];
+    struct sps30_frame_decoder decoder;
+    struct sps30_measurement_u16 m16;
+    struct sps30_measurement m;
+    uint16_t chunk;
+    uint16_t i;
+    int16_t ret;
+
+    sps30_sim_set_measurement(SIM_BUS, SPS30_I2C_ADDRESS, &fixed);
+    ret = sps30_dev_start_measurement(&dev);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_start_measurement");
+    sps30_sim_wait_data_ready(&dev);
+
+    sensirion_fill_cmd_send_buf(cmd, 0x0300, NULL, 0);
+    ret = sensirion_i2c_write(SPS30_I2C_ADDRESS, cmd, sizeof(cmd));
+    CHECK_ZERO_TEXT(ret, "sensirion_i2c_write read measurement command");
+    ret = sensirion_i2c_read(SPS30_I2C_ADDRESS, frame,
+                             SPS30_MEASUREMENT_FRAME_SIZE);
+    CHECK_ZERO_TEXT(ret, "sensirion_i2c_read measurement frame");
+    memset(&frame[SPS30_MEASUREMENT_FRAME_SIZE], 0, 3);
+
+    /* any chunking, bytes past the end of the frame are ignored */
+    for (chunk = 1; chunk <= sizeof(frame); ++chunk) {
+        sps30_frame_decoder_init(&decoder, &dev);
+        CHECK_EQUAL(SPS30_ERR_NOT_READY, sps30_frame_decoder_get(&decoder, &m));
+        ret = sps30_frame_decoder_feed(&decoder, frame, 0);
+        CHECK_EQUAL(SPS30_ERR_NOT_READY, ret);
+        for (i = 0; i < sizeof(frame); i += chunk) {
+            ret = sps30_frame_decoder_feed(
+                &decoder, &frame[i],
+                (uint16_t)(sizeof(frame) - i < chunk ? sizeof(frame) - i
+                                                     : chunk));
+            if (i + chunk < SPS30_MEASUREMENT_FRAME_SIZE)
+                CHECK_EQUAL(SPS30_ERR_NOT_READY, ret);
+        }
+        CHECK_ZERO_TEXT(ret, "sps30_frame_decoder_feed");
+        CHECK_EQUAL(SPS30_MEASUREMENT_FRAME_SIZE, decoder.received);
+        ret = sps30_frame_decoder_get(&decoder, &m);
+        CHECK_ZERO_TEXT(ret, "sps30_frame_decoder_get");
+        DOUBLES_EQUAL(fixed.mc_1p0, m.mc_1p0, 1e-6);
+        DOUBLES_EQUAL(fixed.nc_4p0, m.nc_4p0, 1e-6);
+        DOUBLES_EQUAL(fixed.typical_particle_size, m.typical_particle_size,
+                      1e-6);
+        CHECK_EQUAL(SPS30_ERR_FORMAT,
+                    sps30_frame_decoder_get_u16(&decoder, &m16));
+    }
+
+    /* the mismatch is reported with the corrupt word's CRC byte */
+    frame[3 * 7 + 1] ^= 0x10;
+    sps30_frame_decoder_init(&decoder, &dev);
+    ret = sps30_frame_decoder_feed(&decoder, frame, 3 * 7 + 2);
+    CHECK_EQUAL(SPS30_ERR_NOT_READY, ret);
+    ret = sps30_frame_decoder_feed(&decoder, &frame[3 * 7 + 2], 1);
+    CHECK_EQUAL(SPS30_ERR_CRC, ret);
+    ret = sps30_frame_decoder_feed(&decoder, &frame[3 * 8],
+                                   SPS30_MEASUREMENT_FRAME_SIZE - 3 * 8);
+    CHECK_EQUAL(SPS30_ERR_CRC, ret);
+    CHECK_EQUAL(3 * 8, decoder.received);
+    CHECK_EQUAL(SPS30_ERR_CRC, sps30_frame_decoder_get(&decoder, &m));
+}
+
+TEST (SPSSimTestGroup, SPS30SimTest_frame_decoder_u16) {
+    uint8_t frame[SPS30_MEASUREMENT_FRAME_SIZE / 2];
+    uint8_t cmd[SENSIRION_COMMAND_SIZE];
+    struct sps30_frame_decoder decoder;
+    struct sps30_measurement_u16 m16;
+    struct sps30_measurement m;
+    uint16_t i;
+    int16_t ret;
+
+    sps30_sim_set_measurement(SIM_BUS, SPS30_I2C_ADDRESS, &fixed);
+    ret = sps30_dev_set_measurement_format(&dev, SPS30_FORMAT_UINT16);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_set_measurement_format");
+    ret = sps30_dev_start_measurement(&dev);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_start_measurement");
+    sps30_sim_wait_data_ready(&dev);
+
+    sensirion_fill_cmd_send_buf(cmd, 0x0300, NULL, 0);
+    ret = sensirion_i2c_write(SPS30_I2C_ADDRESS, cmd, sizeof(cmd));
+    CHECK_ZERO_TEXT(ret, "sensirion_i2c_write read measurement command");
+    ret = sensirion_i2c_read(SPS30_I2C_ADDRESS, frame, sizeof(frame));
+    CHECK_ZERO_TEXT(ret, "sensirion_i2c_read measurement frame");
+
+    /* byte by byte, as from a receive interrupt */
+    sps30_frame_decoder_init(&decoder, &dev);
+    for (i = 0; i < sizeof(frame) - 1; ++i) {
+        ret = sps30_frame_decoder_feed(&decoder, &frame[i], 1);
+        CHECK_EQUAL(SPS30_ERR_NOT_READY, ret);
+    }
+    ret = sps30_frame_decoder_feed(&decoder, &frame[i], 1);
+    CHECK_ZERO_TEXT(ret, "sps30_frame_decoder_feed of the last byte");
+    ret = sps30_frame_decoder_get_u16(&decoder, &m16);
+    CHECK_ZERO_TEXT(ret, "sps30_frame_decoder_get_u16");
+    CHECK_EQUAL(3, m16.mc_2p5);
+    CHECK_EQUAL(750, m16.typical_particle_size);
+    ret = sps30_frame_decoder_get(&decoder, &m);
+    CHECK_ZERO_TEXT(ret, "sps30_frame_decoder_get in uint16 format");
+    DOUBLES_EQUAL(0.75, m.typical_particle_size, 1e-6);
+}
+
+TEST (SPSSimTestGroup, SPS30SimTest_format_mismatch) {
+    struct sps30_measurement_u16 m16;
+    int16_t ret;
+
+    ret = sps30_dev_start_measurement(&dev);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_start_measurement");
+    ret = sps30_dev_read_measurement_u16(&dev, &m16);
+    CHECK_EQUAL(SPS30_ERR_FORMAT, ret);
+}
+
+TEST (SPSSimTestGroup, SPS30SimTest_non_blocking) {
+    struct sps30_sim_stats stats;
+    uint32_t now = sps30_sim_time_us();
+    uint32_t flags;
+    int16_t ret;
+
+    sps30_sim_set_device_status(SIM_BUS, SPS30_I2C_ADDRESS,
+                                SPS30_DEVICE_STATUS_FAN_ERROR_MASK);
+    sps30_sim_reset_stats();
+    ret = sps30_dev_issue_start_measurement(&dev, now);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_issue_start_measurement");
+    CHECK_EQUAL(now + 20000, sps30_dev_ready_at(&dev));
+    CHECK_EQUAL(20000, sps30_dev_poll(&dev, now));
+
+    ret = sps30_dev_issue_read_device_status_register(&dev, now + 1000);
+    CHECK_EQUAL(SPS30_ERR_NOT_READY, ret);
+    ret = sps30_dev_complete_read_device_status_register(&dev, now, &flags);
+    CHECK_EQUAL(SPS30_ERR_NOT_ISSUED, ret);
+
+    sps30_sim_advance_us(20000);
+    now = sps30_sim_time_us();
+    CHECK_EQUAL(0, sps30_dev_poll(&dev, now));
+    ret = sps30_dev_issue_read_device_status_register(&dev, now);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_issue_read_device_status_register");
+    ret = sps30_dev_complete_read_device_status_register(&dev, now, &flags);
+    CHECK_EQUAL(SPS30_ERR_NOT_READY, ret);
+
+    sps30_sim_advance_us(5000);
+    now = sps30_sim_time_us();
+    ret = sps30_dev_complete_read_device_status_register(&dev, now, &flags);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_complete_read_device_status_register");
+    CHECK_EQUAL(SPS30_DEVICE_STATUS_FAN_ERROR_MASK, flags);
+
+    sps30_sim_get_stats(&stats);
+    CHECK_EQUAL(0, stats.sleeps);
+    CHECK_EQUAL(0, stats.nacks);
+}
+
+TEST (SPSSimTestGroup, SPS30SimTest_non_blocking_interleaved) {
+    uint32_t now = sps30_sim_time_us();
+    uint32_t flags;
+    uint16_t data_ready;
+    int16_t ret;
+
+    /* another command replaces the response of the pending read */
+    ret = sps30_dev_issue_read_device_status_register(&dev, now);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_issue_read_device_status_register");
+    sps30_sim_advance_us(5000);
+    now = sps30_sim_time_us();
+    ret = sps30_dev_read_data_ready(&dev, &data_ready);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_read_data_ready");
+    ret = sps30_dev_complete_read_device_status_register(&dev, now, &flags);
+    CHECK_EQUAL(SPS30_ERR_NOT_ISSUED, ret);
+
+    ret = sps30_dev_issue_read_device_status_register(&dev, now);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_issue_read_device_status_register");
+    sps30_sim_advance_us(5000);
+    now = sps30_sim_time_us();
+    ret = sps30_dev_issue_start_measurement(&dev, now);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_issue_start_measurement");
+    sps30_sim_advance_us(20000);
+    now = sps30_sim_time_us();
+    ret = sps30_dev_complete_read_device_status_register(&dev, now, &flags);
+    CHECK_EQUAL(SPS30_ERR_NOT_ISSUED, ret);
+}
+
+TEST (SPSSimTestGroup, SPS30SimTest_non_blocking_failed_issue) {
+    uint32_t now = sps30_sim_time_us();
+    int16_t ret;
+
+    /* a failed command does not block the retry */
+    sps30_sim_inject_nacks(SIM_BUS, SPS30_I2C_ADDRESS, 1);
+    ret = sps30_dev_issue_start_measurement(&dev, now);
+    CHECK_TRUE_TEXT(ret != 0, "NACK not reported");
+    CHECK_EQUAL(0, sps30_dev_poll(&dev, now));
+    ret = sps30_dev_issue_start_measurement(&dev, now);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_issue_start_measurement retry");
+    CHECK_EQUAL(20000, sps30_dev_poll(&dev, now));
+
+    sps30_sim_advance_us(20000);
+    now = sps30_sim_time_us();
+    sps30_sim_inject_nacks(SIM_BUS, SPS30_I2C_ADDRESS, 1);
+    ret = sps30_dev_issue_stop_measurement(&dev, now);
+    CHECK_TRUE_TEXT(ret != 0, "NACK not reported");
+    CHECK_EQUAL(0, sps30_dev_poll(&dev, now));
+}
+
+TEST (SPSSimTestGroup, SPS30SimTest_sleep_wake_up) {
+    int16_t ret;
+
+    ret = sps30_dev_sleep(&dev);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_sleep");
+    CHECK_EQUAL(SPS30_STATE_SLEEPING,
+                sps30_sim_get_state(SIM_BUS, SPS30_I2C_ADDRESS));
+    CHECK_EQUAL(SPS30_STATE_SLEEPING, dev.state);
+
+    ret = sps30_dev_start_measurement(&dev);
+    CHECK_TRUE_TEXT(ret != 0, "start measurement while sleeping succeeded");
+
+    ret = sps30_dev_wake_up(&dev);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_wake_up");
+    CHECK_EQUAL(SPS30_STATE_IDLE,
+                sps30_sim_get_state(SIM_BUS, SPS30_I2C_ADDRESS));
+}
+
+TEST (SPSSimTestGroup, SPS30SimTest_crc_error) {
+    uint16_t data_ready;
+    int16_t ret;
+
+    sps30_sim_inject_crc_errors(SIM_BUS, SPS30_I2C_ADDRESS, 1);
+    ret = sps30_dev_read_data_ready(&dev, &data_ready);
+    CHECK_TRUE_TEXT(ret != 0, "CRC error not detected");
+    ret = sps30_dev_read_data_ready(&dev, &data_ready);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_read_data_ready after CRC error");
+}
+
+TEST (SPSSimTestGroup, SPS30SimTest_multiple_buses) {
+    struct sps30_dev dev2;
+    char serial[SPS30_MAX_SERIAL_LEN];
+    int16_t ret;
+
+    ret = sps30_sim_add_sensor(SIM_BUS + 1, SPS30_I2C_ADDRESS);
+    CHECK_ZERO_TEXT(ret, "sps30_sim_add_sensor on second bus");
+    sps30_dev_init(&dev2, SIM_BUS + 1, SPS30_I2C_ADDRESS);
+
+    ret = sps30_dev_get_serial(&dev2, serial);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_get_serial on second bus");
+    STRCMP_EQUAL("SIM0000000000002", serial);
+
+    ret = sps30_dev_start_measurement(&dev2);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_start_measurement on second bus");
+    CHECK_EQUAL(SPS30_STATE_MEASURING,
+                sps30_sim_get_state(SIM_BUS + 1, SPS30_I2C_ADDRESS));
+    CHECK_EQUAL(SPS30_STATE_IDLE,
+                sps30_sim_get_state(SIM_BUS, SPS30_I2C_ADDRESS));
+}
+
+#ifdef SPS30_STATS
+TEST (SPSSimTestGroup, SPS30SimTest_stats) {
+    const struct sps30_cmd_stats* cs;
+    struct sps30_measurement m;
+    struct sps30_stats stats;
+    int16_t ret;
+    uint16_t i;
+
+    ret = sps30_dev_start_measurement(&dev);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_start_measurement");
+    sps30_dev_reset_stats(&dev);
+
+    for (i = 0; i < 10; ++i) {
+        ret = sps30_dev_read_measurement(&dev, &m);
+        CHECK_ZERO_TEXT(ret, "sps30_dev_read_measurement");
+    }
+    sps30_sim_inject_crc_errors(SIM_BUS, SPS30_I2C_ADDRESS, 1);
+    ret = sps30_dev_read_measurement(&dev, &m);
+    CHECK_EQUAL(SPS30_ERR_CRC, ret);
+    sps30_sim_inject_nacks(SIM_BUS, SPS30_I2C_ADDRESS, 1);
+    ret = sps30_dev_read_measurement(&dev, &m);
+    CHECK_TRUE_TEXT(ret != 0, "NACK not reported");
+    ret = sps30_dev_stop_measurement(&dev);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_stop_measurement");
+
+    sps30_dev_get_stats(&dev, &stats);
+    cs = &stats.cmd[SPS30_STATS_CMD_READ_MEASUREMENT];
+    CHECK_EQUAL(12, cs->calls);
+    CHECK_EQUAL(1, cs->crc_errors);
+    CHECK_EQUAL(1, cs->nacks);
+    /* 2 + 60 bytes at 100kHz */
+    CHECK_EQUAL(5800, cs->latency_max_us);
+    CHECK_EQUAL(5800, sps30_stats_latency_percentile(cs, 50));
+    CHECK_EQUAL(1, stats.cmd[SPS30_STATS_CMD_STOP_MEASUREMENT].calls);
+    CHECK_EQUAL(0, stats.cmd[SPS30_STATS_CMD_WAKE_UP].calls);
+    CHECK_EQUAL(0, stats.cmd[SPS30_STATS_CMD_OTHER].calls);
+    CHECK_EQUAL(20000, stats.sleep_time_us);
+
+    sps30_dev_reset_stats(&dev);
+    sps30_dev_get_stats(&dev, &stats);
+    CHECK_EQUAL(0, stats.cmd[SPS30_STATS_CMD_READ_MEASUREMENT].calls);
+}
+#endif /* SPS30_STATS */
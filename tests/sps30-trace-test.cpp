@@ -0,0 +1,280 @@
+#include "sensirion_test_setup.h"
+#include "sps30.h"
+#include "sps30_sim.h"
+#include "sps30_trace.h"
+
+#include <stdio.h>  // remove
+#include <time.h>   // clock_gettime
+
+/* with SPS30_TEST_TRACE_I2C, only the replay tests run, on sps30_trace_i2c.c */
+#define SIM_BUS 0
+#define TRACE_PATH "sps30-test-trace.trc"
+
+static const struct sps30_measurement fixed = {
+    1.5f, 2.5f, 4.5f, 10.5f, 5.0f, 10.0f, 25.0f, 40.0f, 100.0f, 0.75f};
+
+struct session {
+    int16_t probe;
+    char serial[SPS30_MAX_SERIAL_LEN];
+    int16_t read[3];
+    struct sps30_measurement m[3];
+};
+
+#ifndef SPS30_TEST_TRACE_I2C
+/* a fixed sequence of driver calls, recorded and replayed below */
+static void run_session(struct session* s) {
+    struct sps30_dev dev;
+    uint8_t i;
+
+    sps30_dev_init(&dev, SIM_BUS, SPS30_I2C_ADDRESS);
+    s->probe = sps30_dev_probe(&dev);
+    (void)sps30_dev_get_serial(&dev, s->serial);
+    (void)sps30_dev_start_measurement(&dev);
+    for (i = 0; i < 3; ++i) {
+        sensirion_sleep_usec(SPS30_MEASUREMENT_DURATION_USEC);
+        s->read[i] = sps30_dev_read_measurement(&dev, &s->m[i]);
+    }
+    (void)sps30_dev_stop_measurement(&dev);
+}
+#endif /* SPS30_TEST_TRACE_I2C */
+
+static uint64_t now_us() {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+TEST_GROUP (SPSTraceTestGroup) {
+    void setup() {
+        int16_t ret;
+
+        sps30_sim_reset();
+        ret = sps30_sim_add_sensor(SIM_BUS, SPS30_I2C_ADDRESS);
+        CHECK_ZERO_TEXT(ret, "sps30_sim_add_sensor");
+        sps30_sim_set_measurement(SIM_BUS, SPS30_I2C_ADDRESS, &fixed);
+        sensirion_i2c_init();
+    }
+
+    void teardown() {
+        sps30_trace_record_stop();
+        sps30_trace_replay_stop();
+        sensirion_i2c_release();
+        remove(TRACE_PATH);
+    }
+
+#ifndef SPS30_TEST_TRACE_I2C
+    void record(struct session * s) {
+        int16_t ret = sps30_trace_record_start(TRACE_PATH);
+
+        CHECK_ZERO_TEXT(ret, "sps30_trace_record_start");
+        run_session(s);
+        ret = sps30_trace_record_stop();
+        CHECK_ZERO_TEXT(ret, "sps30_trace_record_stop");
+    }
+#endif /* SPS30_TEST_TRACE_I2C */
+};
+
+#ifndef SPS30_TEST_TRACE_I2C
+TEST (SPSTraceTestGroup, SPS30TraceTest_record_replay) {
+    struct sps30_trace_stats trace_stats;
+    struct sps30_sim_stats sim_stats;
+    struct session recorded;
+    struct session replayed;
+    uint8_t i;
+    int16_t ret;
+
+    record(&recorded);
+    CHECK_ZERO_TEXT(recorded.probe, "probe while recording");
+    STRCMP_EQUAL("SIM0000000000001", recorded.serial);
+    CHECK_ZERO_TEXT(recorded.read[0], "read while recording");
+
+    ret = sps30_trace_replay_load(TRACE_PATH, 0);
+    CHECK_ZERO_TEXT(ret, "sps30_trace_replay_load");
+    sps30_sim_reset_stats();
+    run_session(&replayed);
+    sps30_sim_get_stats(&sim_stats);
+    CHECK_EQUAL(0, sim_stats.transactions);
+
+    CHECK_EQUAL(recorded.probe, replayed.probe);
+    STRCMP_EQUAL(recorded.serial, replayed.serial);
+    for (i = 0; i < 3; ++i) {
+        CHECK_EQUAL(recorded.read[i], replayed.read[i]);
+        DOUBLES_EQUAL(recorded.m[i].mc_2p5, replayed.m[i].mc_2p5, 0);
+        DOUBLES_EQUAL(recorded.m[i].typical_particle_size,
+                      replayed.m[i].typical_particle_size, 0);
+    }
+
+    sps30_trace_get_stats(&trace_stats);
+    CHECK_TRUE(trace_stats.records > 0);
+    CHECK_EQUAL(0, trace_stats.mismatches);
+    CHECK_EQUAL(0, trace_stats.exhausted);
+}
+
+TEST (SPSTraceTestGroup, SPS30TraceTest_crc_error) {
+    struct session recorded;
+    struct session replayed;
+    int16_t ret;
+
+    sps30_sim_inject_crc_errors(SIM_BUS, SPS30_I2C_ADDRESS, 1);
+    record(&recorded);
+    /* the CRC error hits the probe's serial read */
+    CHECK_EQUAL(SPS30_ERR_CRC, recorded.probe);
+
+    ret = sps30_trace_replay_load(TRACE_PATH, 0);
+    CHECK_ZERO_TEXT(ret, "sps30_trace_replay_load");
+    run_session(&replayed);
+    CHECK_EQUAL(SPS30_ERR_CRC, replayed.probe);
+}
+
+TEST (SPSTraceTestGroup, SPS30TraceTest_mismatch_and_end) {
+    struct sps30_trace_stats stats;
+    struct sps30_dev dev;
+    struct session recorded;
+    uint8_t major;
+    uint8_t minor;
+    int16_t ret;
+
+    record(&recorded);
+    ret = sps30_trace_replay_load(TRACE_PATH, 0);
+    CHECK_ZERO_TEXT(ret, "sps30_trace_replay_load");
+
+    /* the trace starts with the probe's wake-up, not a version read */
+    sps30_dev_init(&dev, SIM_BUS, SPS30_I2C_ADDRESS);
+    ret = sps30_dev_read_firmware_version(&dev, &major, &minor);
+    CHECK_TRUE(ret != 0);
+    sps30_trace_get_stats(&stats);
+    CHECK_TRUE(stats.mismatches > 0);
+
+    while (sps30_dev_read_firmware_version(&dev, &major, &minor) != 0) {
+        sps30_trace_get_stats(&stats);
+        if (stats.exhausted)
+            break;
+    }
+    CHECK_EQUAL(1, stats.exhausted);
+}
+
+TEST (SPSTraceTestGroup, SPS30TraceTest_loop) {
+    struct sps30_trace_stats stats;
+    struct sps30_measurement m;
+    struct sps30_dev dev;
+    uint32_t i;
+    int16_t ret;
+
+    sps30_dev_init(&dev, SIM_BUS, SPS30_I2C_ADDRESS);
+    ret = sps30_dev_start_measurement(&dev);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_start_measurement");
+    sensirion_sleep_usec(SPS30_MEASUREMENT_DURATION_USEC);
+
+    ret = sps30_trace_record_start(TRACE_PATH);
+    CHECK_ZERO_TEXT(ret, "sps30_trace_record_start");
+    ret = sps30_dev_read_measurement(&dev, &m);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_read_measurement");
+    sps30_trace_record_stop();
+
+    ret = sps30_trace_replay_load(TRACE_PATH, SPS30_TRACE_LOOP);
+    CHECK_ZERO_TEXT(ret, "sps30_trace_replay_load");
+    for (i = 0; i < 10000; ++i) {
+        ret = sps30_dev_read_measurement(&dev, &m);
+        CHECK_ZERO_TEXT(ret, "sps30_dev_read_measurement replayed");
+    }
+    DOUBLES_EQUAL(fixed.nc_10p0, m.nc_10p0, 1e-6);
+
+    sps30_trace_get_stats(&stats);
+    CHECK_EQUAL(9999, stats.loops);
+    CHECK_EQUAL(0, stats.mismatches);
+}
+
+TEST (SPSTraceTestGroup, SPS30TraceTest_write_error) {
+    struct session recorded;
+    int16_t ret;
+
+    /* the header fits the stdio buffer, the records fail on the flush */
+    ret = sps30_trace_record_start("/dev/full");
+    CHECK_ZERO_TEXT(ret, "sps30_trace_record_start");
+    run_session(&recorded);
+    CHECK_ZERO_TEXT(recorded.probe, "probe while recording");
+    ret = sps30_trace_record_stop();
+    CHECK_EQUAL(STATUS_FAIL, ret);
+
+    /* the error is not carried over to the next recording */
+    record(&recorded);
+}
+#endif /* SPS30_TEST_TRACE_I2C */
+
+TEST (SPSTraceTestGroup, SPS30TraceTest_real_time) {
+    /* data-ready read: write 20ms after the start, read 1ms later */
+    static const uint8_t trace[] = {
+        'S', 'P', 'S', '3', '0', 'T', 'R', 'C', SPS30_TRACE_VERSION,
+        SPS30_TRACE_OP_WRITE, 0xa0, 0x9c, 0x01, SPS30_I2C_ADDRESS, 2, 0x02,
+        0x02, SPS30_TRACE_OP_READ, 0xe8, 0x07, SPS30_I2C_ADDRESS, 3, 0x00,
+        0x01, 0xb0};
+    struct sps30_dev dev;
+    uint16_t data_ready = 0;
+    uint64_t start_us;
+    int16_t ret;
+
+    ret = sps30_trace_replay_start(trace, sizeof(trace), 0);
+    CHECK_ZERO_TEXT(ret, "sps30_trace_replay_start");
+    ret = sps30_trace_replay_start(trace, 5, 0);
+    CHECK_EQUAL(STATUS_FAIL, ret);
+
+    ret = sps30_trace_replay_start(trace, sizeof(trace),
+                                   SPS30_TRACE_REAL_TIME);
+    CHECK_ZERO_TEXT(ret, "sps30_trace_replay_start");
+    start_us = now_us();
+    sps30_dev_init(&dev, SIM_BUS, SPS30_I2C_ADDRESS);
+    dev.bus = SPS30_BUS_DEFAULT;
+    ret = sps30_dev_read_data_ready(&dev, &data_ready);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_read_data_ready");
+    CHECK_EQUAL(1, data_ready);
+    /* start_us is taken after the replay started */
+    CHECK_TRUE(now_us() - start_us >= 20000);
+}
+
+TEST (SPSTraceTestGroup, SPS30TraceTest_long_gap) {
+    /* data-ready read with a gap of 2^36us (19 hours) before the write */
+    static const uint8_t trace[] = {
+        'S', 'P', 'S', '3', '0', 'T', 'R', 'C', SPS30_TRACE_VERSION,
+        SPS30_TRACE_OP_WRITE, 0x80, 0x80, 0x80, 0x80, 0x80, 0x02,
+        SPS30_I2C_ADDRESS, 2, 0x02, 0x02, SPS30_TRACE_OP_READ, 0xe8, 0x07,
+        SPS30_I2C_ADDRESS, 3, 0x00, 0x01, 0xb0};
+    struct sps30_trace_stats stats;
+    struct sps30_dev dev;
+    uint16_t data_ready = 0;
+    int16_t ret;
+
+    ret = sps30_trace_replay_start(trace, sizeof(trace), 0);
+    CHECK_ZERO_TEXT(ret, "sps30_trace_replay_start");
+    sps30_dev_init(&dev, SIM_BUS, SPS30_I2C_ADDRESS);
+    dev.bus = SPS30_BUS_DEFAULT;
+    ret = sps30_dev_read_data_ready(&dev, &data_ready);
+    CHECK_ZERO_TEXT(ret, "sps30_dev_read_data_ready");
+    CHECK_EQUAL(1, data_ready);
+    sps30_trace_get_stats(&stats);
+    CHECK_EQUAL(2, stats.records);
+    CHECK_EQUAL(0, stats.mismatches);
+}
+
+TEST (SPSTraceTestGroup, SPS30TraceTest_select_bus_nack) {
+    /* data-ready read on bus 1, the read is not acknowledged */
+    static const uint8_t trace[] = {
+        'S', 'P', 'S', '3', '0', 'T', 'R', 'C', SPS30_TRACE_VERSION,
+        SPS30_TRACE_OP_SELECT_BUS, 0x10, 1, SPS30_TRACE_OP_WRITE, 0x10,
+        SPS30_I2C_ADDRESS, 2, 0x02, 0x02, SPS30_TRACE_OP_SELECT_BUS, 0x10, 1,
+        SPS30_TRACE_OP_READ | SPS30_TRACE_FAILED, 0x10, 0xfe,
+        SPS30_I2C_ADDRESS, 3, 0x00, 0x00, 0x00};
+    struct sps30_trace_stats stats;
+    struct sps30_dev dev;
+    uint16_t data_ready = 0;
+    int16_t ret;
+
+    ret = sps30_trace_replay_start(trace, sizeof(trace), 0);
+    CHECK_ZERO_TEXT(ret, "sps30_trace_replay_start");
+    sps30_dev_init(&dev, 1, SPS30_I2C_ADDRESS);
+    ret = sps30_dev_read_data_ready(&dev, &data_ready);
+    CHECK_EQUAL(-2, ret);
+    sps30_trace_get_stats(&stats);
+    CHECK_EQUAL(4, stats.records);
+    CHECK_EQUAL(0, stats.mismatches);
+}
@@ -0,0 +1,351 @@
+#include "sensirion_shdlc.h"
+#include "sensirion_test_setup.h"
+#include "sensirion_uart.h"
+#include "sps30.h"
+#include "sps30_linux_uart.h"
+#include "sps30_uart_emu.h"
+
+#include <time.h>  // nanosleep
+
+#define UART_PORT 0
+#define EMU_INTERVAL_US 50000
+
+/* 15.875f, 15.8125f, 9.0625f and 9.1875f encode as 0x41{7e,7d,11,13}0000 */
+static const struct sps30_measurement fixed = {
+    15.875f, 15.8125f, 9.0625f, 9.1875f, 5.0f,
+    10.0f,   25.0f,    40.0f,   100.0f,  0.75f};
+
+TEST_GROUP (SPSShdlcTestGroup) {
+    struct sensirion_shdlc_rx rx;
+
+    void setup() {
+        sensirion_shdlc_rx_init(&rx);
+    }
+};
+
+TEST (SPSShdlcTestGroup, SPS30ShdlcTest_build_frame) {
+    /* start measurement in float format as in the datasheet */
+    static const uint8_t start[] = {0x7e, 0x00, 0x00, 0x02, 0x01,
+                                    0x03, 0xf9, 0x7e};
+    static const uint8_t stuffed[] = {0x7e, 0x00, 0x80, 0x05, 0x7d, 0x5e,
+                                      0x7d, 0x5d, 0x7d, 0x31, 0x7d, 0x33,
+                                      0x00, 0x5b, 0x7e};
+    const uint8_t start_data[] = {0x01, 0x03};
+    const uint8_t special[] = {0x7e, 0x7d, 0x11, 0x13, 0x00};
+    uint8_t frame[SENSIRION_SHDLC_TX_FRAME_SIZE(sizeof(special))];
+    uint16_t len;
+
+    len = sensirion_shdlc_build_frame(0x00, 0x00, sizeof(start_data),
+                                      start_data, frame);
+    CHECK_EQUAL(sizeof(start), len);
+    CHECK_ZERO(memcmp(start, frame, len));
+
+    len = sensirion_shdlc_build_frame(0x00, 0x80, sizeof(special), special,
+                                      frame);
+    CHECK_EQUAL(sizeof(stuffed), len);
+    CHECK_ZERO(memcmp(stuffed, frame, len));
+}
+
+TEST (SPSShdlcTestGroup, SPS30ShdlcTest_partial_frames) {
+    /* response with state 0 and the data 0x7e 0x11, after noise */
+    static const uint8_t stream[] = {0x13, 0x00, 0x7e, 0x00, 0x03, 0x00,
+                                     0x02, 0x7d, 0x5e, 0x7d, 0x31, 0x6b,
+                                     0x7e, 0x7e};
+    uint16_t consumed;
+    uint16_t i;
+    int16_t ret = 0;
+
+    for (i = 0; i < sizeof(stream) && ret == 0; ++i) {
+        ret = sensirion_shdlc_rx_feed(&rx, 1, &stream[i], &consumed);
+        CHECK_EQUAL(1, consumed);
+    }
+    CHECK_EQUAL(1, ret);
+    CHECK_EQUAL(13, i);
+    CHECK_EQUAL(0x03, rx.cmd);
+    CHECK_EQUAL(0x00, rx.state);
+    CHECK_EQUAL(2, rx.data_len);
+    CHECK_EQUAL(0x7e, rx.data[0]);
+    CHECK_EQUAL(0x11, rx.data[1]);
+
+    /* all at once, the trailing byte is not consumed */
+    sensirion_shdlc_rx_init(&rx);
+    ret = sensirion_shdlc_rx_feed(&rx, sizeof(stream), stream, &consumed);
+    CHECK_EQUAL(1, ret);
+    CHECK_EQUAL(sizeof(stream) - 1, consumed);
+}
+
+TEST (SPSShdlcTestGroup, SPS30ShdlcTest_broken_frames) {
+    /* a wrong checksum, a wrong length and a good frame back to back */
+    static const uint8_t stream[] = {0x7e, 0x00, 0x03, 0x00, 0x00, 0xfd, 0x7e,
+                                     0x7e, 0x00, 0x03, 0x00, 0x01, 0xfc, 0x7e,
+                                     0x7e, 0x00, 0x03, 0x00, 0x00, 0xfc, 0x7e};
+    uint16_t offset = 0;
+    uint16_t consumed;
+    int16_t ret;
+
+    ret = sensirion_shdlc_rx_feed(&rx, sizeof(stream), stream, &consumed);
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_CHECKSUM, ret);
+    offset += consumed;
+    ret = sensirion_shdlc_rx_feed(&rx, sizeof(stream) - offset,
+                                  &stream[offset], &consumed);
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_FRAME, ret);
+    offset += consumed;
+    ret = sensirion_shdlc_rx_feed(&rx, sizeof(stream) - offset,
+                                  &stream[offset], &consumed);
+    CHECK_EQUAL(1, ret);
+    CHECK_EQUAL(sizeof(stream), offset + consumed);
+    CHECK_EQUAL(0, rx.data_len);
+}
+
+TEST_GROUP (SPSUartTestGroup) {
+    void setup() {
+        int16_t ret;
+
+        ret = sps30_uart_emu_start();
+        CHECK_ZERO_TEXT(ret, "sps30_uart_emu_start");
+        sps30_uart_emu_set_interval_us(EMU_INTERVAL_US);
+        sps30_uart_emu_set_measurement(&fixed);
+        sps30_linux_uart_set_port_path(UART_PORT, sps30_uart_emu_path());
+        sensirion_uart_select_port(UART_PORT);
+        ret = sensirion_uart_open();
+        CHECK_ZERO_TEXT(ret, "sensirion_uart_open");
+        ret = sps30_set_measurement_format(SPS30_FORMAT_FLOAT);
+        CHECK_ZERO_TEXT(ret, "sps30_set_measurement_format");
+    }
+
+    void teardown() {
+        sensirion_uart_close();
+        sps30_uart_emu_stop();
+    }
+
+    void wait_data_ready() {
+        uint16_t data_ready = 0;
+        uint16_t polls;
+        int16_t ret;
+
+        for (polls = 0; polls < 100 && !data_ready; ++polls) {
+            sleep_us(EMU_INTERVAL_US / 5);
+            ret = sps30_read_data_ready(&data_ready);
+            CHECK_ZERO_TEXT(ret, "sps30_read_data_ready");
+        }
+        CHECK_TRUE_TEXT(data_ready, "no data ready");
+    }
+
+    void sleep_us(uint32_t useconds) {
+        struct timespec ts = {0, (long)useconds * 1000};
+
+        nanosleep(&ts, NULL);
+    }
+
+    void check_fixed(const struct sps30_measurement* m) {
+        DOUBLES_EQUAL(fixed.mc_1p0, m->mc_1p0, 0);
+        DOUBLES_EQUAL(fixed.mc_2p5, m->mc_2p5, 0);
+        DOUBLES_EQUAL(fixed.mc_4p0, m->mc_4p0, 0);
+        DOUBLES_EQUAL(fixed.mc_10p0, m->mc_10p0, 0);
+        DOUBLES_EQUAL(fixed.nc_10p0, m->nc_10p0, 0);
+        DOUBLES_EQUAL(fixed.typical_particle_size, m->typical_particle_size,
+                      0);
+    }
+};
+
+TEST (SPSUartTestGroup, SPS30UartTest_identity) {
+    struct sps30_uart_emu_stats stats;
+    char serial[SPS30_MAX_SERIAL_LEN];
+    uint8_t major;
+    uint8_t minor;
+    int16_t ret;
+
+    ret = sps30_probe();
+    CHECK_ZERO_TEXT(ret, "sps30_probe");
+    ret = sps30_get_serial(serial);
+    CHECK_ZERO_TEXT(ret, "sps30_get_serial");
+    STRCMP_EQUAL(SPS30_UART_EMU_SERIAL, serial);
+    ret = sps30_read_firmware_version(&major, &minor);
+    CHECK_ZERO_TEXT(ret, "sps30_read_firmware_version");
+    CHECK_EQUAL(2, major);
+    CHECK_EQUAL(2, minor);
+
+    ret = sps30_start_measurement();
+    CHECK_ZERO_TEXT(ret, "sps30_start_measurement");
+    ret = sps30_reset();
+    CHECK_ZERO_TEXT(ret, "sps30_reset");
+    CHECK_EQUAL(SPS30_UART_EMU_STATE_IDLE, sps30_uart_emu_get_state());
+
+    sps30_uart_emu_get_stats(&stats);
+    CHECK_EQUAL(0, stats.bad_frames);
+}
+
+TEST (SPSUartTestGroup, SPS30UartTest_measurement) {
+    struct sps30_measurement m;
+    int16_t ret;
+
+    /* split responses with bytes ahead of the frame */
+    sps30_uart_emu_set_chunks(3, 1000);
+    sps30_uart_emu_set_noise(1);
+
+    ret = sps30_start_measurement();
+    CHECK_ZERO_TEXT(ret, "sps30_start_measurement");
+    CHECK_EQUAL(SPS30_UART_EMU_STATE_MEASURING, sps30_uart_emu_get_state());
+    ret = sps30_read_measurement(&m);
+    CHECK_EQUAL(SPS30_ERR_NO_DATA, ret);
+
+    wait_data_ready();
+    ret = sps30_read_measurement(&m);
+    CHECK_ZERO_TEXT(ret, "sps30_read_measurement");
+    check_fixed(&m);
+    /* no new measurement for a while */
+    sps30_uart_emu_set_interval_us(SPS30_MEASUREMENT_DURATION_USEC * 10);
+    ret = sps30_read_measurement(&m);
+    CHECK_EQUAL(SPS30_ERR_NO_DATA, ret);
+
+    ret = sps30_stop_measurement();
+    CHECK_ZERO_TEXT(ret, "sps30_stop_measurement");
+    CHECK_EQUAL(SPS30_UART_EMU_STATE_IDLE, sps30_uart_emu_get_state());
+}
+
+TEST (SPSUartTestGroup, SPS30UartTest_uint16_measurement) {
+    struct sps30_measurement_u16 m16;
+    struct sps30_measurement m;
+    int16_t ret;
+
+    CHECK_EQUAL(SPS30_ERR_FORMAT, sps30_set_measurement_format(0x1234));
+    ret = sps30_set_measurement_format(SPS30_FORMAT_UINT16);
+    CHECK_ZERO_TEXT(ret, "sps30_set_measurement_format");
+    ret = sps30_start_measurement();
+    CHECK_ZERO_TEXT(ret, "sps30_start_measurement");
+
+    wait_data_ready();
+    ret = sps30_read_measurement_u16(&m16);
+    CHECK_ZERO_TEXT(ret, "sps30_read_measurement_u16");
+    CHECK_EQUAL(16, m16.mc_1p0);
+    CHECK_EQUAL(100, m16.nc_10p0);
+    CHECK_EQUAL(750, m16.typical_particle_size);
+
+    wait_data_ready();
+    ret = sps30_read_measurement(&m);
+    CHECK_ZERO_TEXT(ret, "sps30_read_measurement in uint16 format");
+    DOUBLES_EQUAL(0.75, m.typical_particle_size, 1e-6);
+}
+
+TEST (SPSUartTestGroup, SPS30UartTest_async_read) {
+    struct sps30_measurement m;
+    uint16_t not_ready = 0;
+    int16_t ret;
+
+    CHECK_EQUAL(SPS30_ERR_NOT_ISSUED, sps30_complete_read_measurement(&m));
+    ret = sps30_start_measurement();
+    CHECK_ZERO_TEXT(ret, "sps30_start_measurement");
+    sleep_us(EMU_INTERVAL_US * 2);
+
+    sps30_uart_emu_set_chunks(4, 2000);
+    ret = sps30_issue_read_measurement();
+    CHECK_ZERO_TEXT(ret, "sps30_issue_read_measurement");
+    while ((ret = sps30_complete_read_measurement(&m)) == SPS30_ERR_NOT_READY)
+        not_ready++;
+    CHECK_ZERO_TEXT(ret, "sps30_complete_read_measurement");
+    CHECK_TRUE_TEXT(not_ready > 1, "response arrived in one piece");
+    check_fixed(&m);
+    CHECK_EQUAL(SPS30_ERR_NOT_ISSUED, sps30_complete_read_measurement(&m));
+}
+
+TEST (SPSUartTestGroup, SPS30UartTest_stale_frame) {
+    /* no byte stuffing, the response frame takes 47 bytes */
+    static const struct sps30_measurement plain = {
+        1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 10.0f, 0.5f};
+    struct sps30_measurement m;
+    int16_t ret;
+
+    sps30_uart_emu_set_measurement(&plain);
+    ret = sps30_start_measurement();
+    CHECK_ZERO_TEXT(ret, "sps30_start_measurement");
+    sleep_us(EMU_INTERVAL_US * 2);
+
+    /* the stale frame ends with the start of the response */
+    sps30_uart_emu_set_chunks(8, 2000);
+    sps30_uart_emu_inject_stale_frames(1);
+    ret = sps30_read_measurement(&m);
+    CHECK_ZERO_TEXT(ret, "sps30_read_measurement after a stale frame");
+    DOUBLES_EQUAL(10.0, m.nc_10p0, 1e-6);
+    DOUBLES_EQUAL(0.5, m.typical_particle_size, 1e-6);
+
+    sleep_us(EMU_INTERVAL_US * 2);
+    sps30_uart_emu_inject_stale_frames(1);
+    ret = sps30_issue_read_measurement();
+    CHECK_ZERO_TEXT(ret, "sps30_issue_read_measurement");
+    while ((ret = sps30_complete_read_measurement(&m)) == SPS30_ERR_NOT_READY)
+        sleep_us(500);
+    CHECK_ZERO_TEXT(ret, "sps30_complete_read_measurement after a stale frame");
+    DOUBLES_EQUAL(1.0, m.mc_1p0, 1e-6);
+    DOUBLES_EQUAL(0.5, m.typical_particle_size, 1e-6);
+}
+
+TEST (SPSUartTestGroup, SPS30UartTest_fan_and_status) {
+    uint32_t interval;
+    uint32_t flags;
+    int16_t ret;
+
+    ret = sps30_get_fan_auto_cleaning_interval(&interval);
+    CHECK_ZERO_TEXT(ret, "sps30_get_fan_auto_cleaning_interval");
+    CHECK_EQUAL(604800, interval);
+    /* 0x00137e11 is stuffed three times */
+    ret = sps30_set_fan_auto_cleaning_interval(0x00137e11);
+    CHECK_ZERO_TEXT(ret, "sps30_set_fan_auto_cleaning_interval");
+    ret = sps30_get_fan_auto_cleaning_interval(&interval);
+    CHECK_ZERO_TEXT(ret, "sps30_get_fan_auto_cleaning_interval");
+    CHECK_EQUAL(0x00137e11, interval);
+
+    /* only while measuring */
+    ret = sps30_start_manual_fan_cleaning();
+    CHECK_TRUE(SPS30_IS_ERR_STATE(ret));
+    CHECK_EQUAL(SPS30_STATE_NOT_ALLOWED, SPS30_GET_ERR_STATE(ret));
+    ret = sps30_start_measurement();
+    CHECK_ZERO_TEXT(ret, "sps30_start_measurement");
+    ret = sps30_start_manual_fan_cleaning();
+    CHECK_ZERO_TEXT(ret, "sps30_start_manual_fan_cleaning");
+    CHECK_EQUAL(1, sps30_uart_emu_get_cleanings());
+
+    /* the device error flag in the state byte does not fail commands */
+    sps30_uart_emu_set_device_status(SPS30_DEVICE_STATUS_FAN_ERROR_MASK);
+    ret = sps30_read_device_status_register(&flags);
+    CHECK_ZERO_TEXT(ret, "sps30_read_device_status_register");
+    CHECK_EQUAL(SPS30_DEVICE_STATUS_FAN_ERROR_MASK, flags);
+}
+
+TEST (SPSUartTestGroup, SPS30UartTest_sleep) {
+    struct sps30_uart_emu_stats stats;
+    int16_t ret;
+
+    ret = sps30_sleep();
+    CHECK_ZERO_TEXT(ret, "sps30_sleep");
+    CHECK_EQUAL(SPS30_UART_EMU_STATE_SLEEPING, sps30_uart_emu_get_state());
+
+    /* the UART is switched off */
+    ret = sps30_start_measurement();
+    CHECK_EQUAL(SENSIRION_SHDLC_ERR_NO_DATA, ret);
+
+    ret = sps30_wake_up();
+    CHECK_ZERO_TEXT(ret, "sps30_wake_up");
+    CHECK_EQUAL(SPS30_UART_EMU_STATE_IDLE, sps30_uart_emu_get_state());
+    sps30_uart_emu_get_stats(&stats);
+    CHECK_EQUAL(1, stats.wake_pulses);
+    CHECK_TRUE(stats.ignored_bytes > 0);
+
+    /* probing wakes a sleeping sensor up */
+    ret = sps30_sleep();
+    CHECK_ZERO_TEXT(ret, "sps30_sleep");
+    ret = sps30_probe();
+    CHECK_ZERO_TEXT(ret, "sps30_probe");
+    CHECK_EQUAL(SPS30_UART_EMU_STATE_IDLE, sps30_uart_emu_get_state());
+}
+
+TEST (SPSUartTestGroup, SPS30UartTest_checksum_error) {
+    uint8_t major;
+    uint8_t minor;
+    int16_t ret;
+
+    sps30_uart_emu_inject_checksum_errors(1);
+    ret = sps30_read_firmware_version(&major, &minor);
+    CHECK_EQUAL(SPS30_ERR_CRC, ret);
+    ret = sps30_read_firmware_version(&major, &minor);
+    CHECK_ZERO_TEXT(ret, "sps30_read_firmware_version after checksum error");
+}
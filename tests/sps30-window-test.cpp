@@ -0,0 +1,121 @@
+#include "sensirion_test_setup.h"
+#include "sps30_window.h"
+
+static struct sps30_measurement window_measurement(float v) {
+    struct sps30_measurement m;
+
+    m.mc_1p0 = v;
+    m.mc_2p5 = 2 * v;
+    m.mc_4p0 = 3 * v;
+    m.mc_10p0 = 4 * v;
+    m.nc_0p5 = 5 * v;
+    m.nc_1p0 = 6 * v;
+    m.nc_2p5 = 7 * v;
+    m.nc_4p0 = 8 * v;
+    m.nc_10p0 = 9 * v;
+    m.typical_particle_size = -v;
+    return m;
+}
+
+static void window_add(struct sps30_window* window, uint32_t t, float v) {
+    struct sps30_measurement m = window_measurement(v);
+
+    sps30_window_add(window, t, &m);
+}
+
+TEST_GROUP (SPSWindowTestGroup) {
+    struct sps30_window window;
+    struct sps30_window_bucket buckets[60];
+    struct sps30_window_result result;
+
+    void setup() {
+    }
+
+    void teardown() {
+    }
+};
+
+TEST (SPSWindowTestGroup, SPS30WindowTest_init) {
+    CHECK_EQUAL(STATUS_FAIL, sps30_window_init(&window, buckets, 0, 1));
+    CHECK_EQUAL(STATUS_FAIL, sps30_window_init(&window, buckets, 60, 0));
+    CHECK_ZERO(sps30_window_init(&window, buckets, 60, 1));
+    CHECK_EQUAL(STATUS_FAIL, sps30_window_get(&window, &result));
+    CHECK_EQUAL(0, result.count);
+}
+
+TEST (SPSWindowTestGroup, SPS30WindowTest_all_fields) {
+    CHECK_ZERO(sps30_window_init(&window, buckets, 60, 1));
+    window_add(&window, 100, 1.0f);
+    window_add(&window, 101, 3.0f);
+    window_add(&window, 102, 2.0f);
+
+    CHECK_ZERO(sps30_window_get(&window, &result));
+    CHECK_EQUAL(3, result.count);
+    DOUBLES_EQUAL(2.0, result.mean.mc_1p0, 1e-6);
+    DOUBLES_EQUAL(1.0, result.min.mc_1p0, 1e-6);
+    DOUBLES_EQUAL(3.0, result.max.mc_1p0, 1e-6);
+    DOUBLES_EQUAL(18.0, result.mean.nc_10p0, 1e-6);
+    DOUBLES_EQUAL(9.0, result.min.nc_10p0, 1e-6);
+    DOUBLES_EQUAL(27.0, result.max.nc_10p0, 1e-6);
+    DOUBLES_EQUAL(-2.0, result.mean.typical_particle_size, 1e-6);
+    DOUBLES_EQUAL(-3.0, result.min.typical_particle_size, 1e-6);
+    DOUBLES_EQUAL(-1.0, result.max.typical_particle_size, 1e-6);
+}
+
+TEST (SPSWindowTestGroup, SPS30WindowTest_sliding_1min) {
+    uint32_t t;
+
+    /* 1 minute at 1Hz with 1s buckets slides exactly */
+    CHECK_ZERO(sps30_window_init(&window, buckets, 60, 1));
+    for (t = 0; t < 120; ++t)
+        window_add(&window, t, (float)t);
+
+    CHECK_ZERO(sps30_window_get(&window, &result));
+    CHECK_EQUAL(60, result.count);
+    DOUBLES_EQUAL(60.0, result.min.mc_1p0, 1e-6);
+    DOUBLES_EQUAL(119.0, result.max.mc_1p0, 1e-6);
+    DOUBLES_EQUAL(89.5, result.mean.mc_1p0, 1e-4);
+}
+
+TEST (SPSWindowTestGroup, SPS30WindowTest_coarse_buckets) {
+    uint32_t t;
+
+    /* 15 minutes in 60 buckets of 15s */
+    CHECK_ZERO(sps30_window_init(&window, buckets, 60, 15));
+    for (t = 0; t < 2 * 900; ++t)
+        window_add(&window, t, t < 900 ? 100.0f : 1.0f);
+
+    CHECK_ZERO(sps30_window_get(&window, &result));
+    CHECK_EQUAL(900, result.count);
+    DOUBLES_EQUAL(1.0, result.max.mc_1p0, 1e-6);
+    DOUBLES_EQUAL(1.0, result.mean.mc_1p0, 1e-6);
+
+    /* a spike shows up as the maximum until it leaves the window */
+    window_add(&window, 1800, 50.0f);
+    for (t = 1801; t < 1800 + 885; ++t)
+        window_add(&window, t, 1.0f);
+    CHECK_ZERO(sps30_window_get(&window, &result));
+    DOUBLES_EQUAL(50.0, result.max.mc_1p0, 1e-6);
+    window_add(&window, 1800 + 900, 1.0f);
+    CHECK_ZERO(sps30_window_get(&window, &result));
+    DOUBLES_EQUAL(1.0, result.max.mc_1p0, 1e-6);
+}
+
+TEST (SPSWindowTestGroup, SPS30WindowTest_expire) {
+    CHECK_ZERO(sps30_window_init(&window, buckets, 60, 1));
+    window_add(&window, 0xfffffff0u, 1.0f);
+    window_add(&window, 0xfffffffau, 1.0f);
+
+    /* wraps around the 32 bit timestamp */
+    sps30_window_expire(&window, 0x20u);
+    CHECK_ZERO(sps30_window_get(&window, &result));
+    CHECK_EQUAL(2, result.count);
+
+    /* a gap longer than the window empties it */
+    sps30_window_expire(&window, 0x20u + 3600);
+    CHECK_EQUAL(STATUS_FAIL, sps30_window_get(&window, &result));
+    window_add(&window, 0x20u + 3601, 4.0f);
+    CHECK_ZERO(sps30_window_get(&window, &result));
+    CHECK_EQUAL(1, result.count);
+    DOUBLES_EQUAL(4.0, result.mean.mc_1p0, 1e-6);
+}
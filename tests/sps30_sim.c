@@ -0,0 +1,901 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>   // snprintf
+#include <string.h>  // memcpy, memset
+#ifdef SPS30_SIM_REAL_TIME
+#include <pthread.h>  // pthread_mutex_*
+#include <time.h>     // clock_gettime, nanosleep
+#endif
+
+#include "sensirion_arch_config.h"
+#include "sensirion_common.h"
+#include "sensirion_i2c.h"
+#include "sps30_sim.h"
+
+#define SIM_CMD_START_MEASUREMENT 0x0010
+#define SIM_CMD_STOP_MEASUREMENT 0x0104
+#define SIM_CMD_READ_MEASUREMENT 0x0300
+#define SIM_CMD_GET_DATA_READY 0x0202
+#define SIM_CMD_AUTOCLEAN_INTERVAL 0x8004
+#define SIM_CMD_GET_FIRMWARE_VERSION 0xd100
+#define SIM_CMD_GET_SERIAL 0xd033
+#define SIM_CMD_RESET 0xd304
+#define SIM_CMD_SLEEP 0x1001
+#define SIM_CMD_READ_DEVICE_STATUS_REG 0xd206
+#define SIM_CMD_START_MANUAL_FAN_CLEANING 0x5607
+#define SIM_CMD_WAKE_UP 0x1103
+
+#define SIM_FIRMWARE_VERSION 0x0202
+#define SIM_DEFAULT_AUTOCLEAN_INTERVAL 604800
+#define SIM_MAX_RESPONSE_WORDS 20
+#define SIM_MAX_ARGS 2
+
+/* processing times of the sensor */
+#define SIM_MEASUREMENT_INTERVAL_NS 1000000000ULL
+#define SIM_START_STOP_NS 20000000ULL
+#define SIM_CMD_NS 5000000ULL
+#define SIM_FLASH_WRITE_NS 20000000ULL
+#define SIM_RESET_NS 100000000ULL
+/* the fan runs at maximum speed for 10s when cleaning */
+#define SIM_CLEANING_NS 10000000000ULL
+/* the i2c interface stays awake for 100ms after the first wake-up pulse */
+#define SIM_WAKE_UP_WINDOW_NS 100000000ULL
+
+/* start + stop condition in bit times */
+#define SIM_START_STOP_BITS 2
+/* 8 data bits + ACK */
+#define SIM_BITS_PER_BYTE 9
+
+struct sim_mux {
+    uint8_t bus;
+    uint8_t address;
+    uint8_t channels;
+};
+
+struct sim_sensor {
+    uint8_t bus;
+    uint8_t address;
+    struct sim_mux* mux;
+    uint8_t channel;
+    uint8_t state;
+    uint16_t format;
+    uint8_t data_ready;
+    uint8_t response_is_measurement;
+    uint16_t response[SIM_MAX_RESPONSE_WORDS];
+    uint16_t response_len;
+    uint64_t busy_until_ns;
+    uint64_t interface_awake_until_ns;
+    uint64_t woken_up_ns;
+    uint64_t response_at_ns;
+    uint64_t next_sample_ns;
+    uint64_t interval_ns;
+    struct sps30_measurement values;
+    struct sps30_measurement fixed_values;
+    uint8_t use_fixed_values;
+    uint32_t rng;
+    uint32_t serial_no;
+    uint32_t autoclean_interval;
+    uint64_t autoclean_elapsed_ns;
+    uint64_t autoclean_counted_ns;
+    uint64_t cleaning_until_ns;
+    uint32_t cleanings;
+    uint32_t device_status;
+    uint16_t nacks_to_inject;
+    uint16_t crc_errors_to_inject;
+};
+
+static struct {
+    struct sim_sensor sensors[SPS30_SIM_MAX_SENSORS];
+    uint16_t num_sensors;
+    struct sim_mux muxes[SPS30_SIM_MAX_MUXES];
+    uint8_t num_muxes;
+    uint8_t bus;
+    uint32_t bus_hz;
+    uint64_t now_ns;
+    uint64_t origin_ns;
+    struct sps30_sim_stats stats;
+} sim;
+
+#ifdef SPS30_SIM_REAL_TIME
+static pthread_mutex_t sim_lock = PTHREAD_MUTEX_INITIALIZER;
+static __thread uint8_t sim_thread_bus;
+#define SIM_BUS sim_thread_bus
+
+static uint64_t sim_monotonic_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void sim_enter(void) {
+    pthread_mutex_lock(&sim_lock);
+    sim.now_ns = sim_monotonic_ns() - sim.origin_ns;
+}
+
+static void sim_leave(void) {
+    pthread_mutex_unlock(&sim_lock);
+}
+
+static void sim_wall_sleep(uint32_t useconds) {
+    struct timespec ts;
+
+    ts.tv_sec = (time_t)(useconds / 1000000);
+    ts.tv_nsec = (long)(useconds % 1000000) * 1000;
+    nanosleep(&ts, NULL);
+}
+#else
+#define SIM_BUS sim.bus
+
+static void sim_enter(void) {
+}
+
+static void sim_leave(void) {
+}
+#endif
+
+/**
+ * sim_find() - sensor of the per-sensor functions, see SPS30_SIM_MUX_BUS()
+ */
+static struct sim_sensor* sim_find(uint8_t bus, uint8_t address) {
+    struct sim_sensor* s;
+    uint16_t i;
+
+    for (i = 0; i < sim.num_sensors; ++i) {
+        s = &sim.sensors[i];
+        if (s->address != address)
+            continue;
+        if (s->mux ? SPS30_SIM_MUX_BUS(s->mux->address, s->channel) == bus
+                   : s->bus == bus)
+            return s;
+    }
+    return NULL;
+}
+
+static struct sim_mux* sim_find_mux(uint8_t bus, uint8_t address) {
+    uint8_t i;
+
+    for (i = 0; i < sim.num_muxes; ++i) {
+        if (sim.muxes[i].bus == bus && sim.muxes[i].address == address)
+            return &sim.muxes[i];
+    }
+    return NULL;
+}
+
+/**
+ * sim_connected() - sensor answering a transfer to @address on @bus
+ *
+ * Return:  The sensor, NULL if none or several sensors are connected
+ */
+static struct sim_sensor* sim_connected(uint8_t bus, uint8_t address) {
+    struct sim_sensor* found = NULL;
+    struct sim_sensor* s;
+    uint16_t i;
+
+    for (i = 0; i < sim.num_sensors; ++i) {
+        s = &sim.sensors[i];
+        if (s->bus != bus || s->address != address ||
+            (s->mux && !(s->mux->channels & (1 << s->channel))))
+            continue;
+        if (found) {
+            sim.stats.collisions++;
+            return NULL;
+        }
+        found = s;
+    }
+    return found;
+}
+
+static uint32_t sim_rand(struct sim_sensor* s) {
+    s->rng = s->rng * 1103515245u + 12345u;
+    return (s->rng >> 16) & 0x7fff;
+}
+
+/**
+ * sim_frand() - pseudo-random float in [lo, hi)
+ */
+static float sim_frand(struct sim_sensor* s, float lo, float hi) {
+    return lo + (hi - lo) * (float)sim_rand(s) / 32768.0f;
+}
+
+static void sim_scale_sample(struct sps30_measurement* m, float factor) {
+    m->mc_1p0 *= factor;
+    m->mc_2p5 *= factor;
+    m->mc_4p0 *= factor;
+    m->mc_10p0 *= factor;
+    m->nc_0p5 *= factor;
+    m->nc_1p0 *= factor;
+    m->nc_2p5 *= factor;
+    m->nc_4p0 *= factor;
+    m->nc_10p0 *= factor;
+}
+
+static void sim_generate_sample(struct sim_sensor* s) {
+    struct sps30_measurement* m = &s->values;
+
+    if (s->use_fixed_values) {
+        *m = s->fixed_values;
+        if (sim.now_ns < s->cleaning_until_ns)
+            sim_scale_sample(m, SPS30_SIM_CLEANING_FACTOR);
+        return;
+    }
+
+    /* concentrations are cumulative and thus increasing with the size bin */
+    m->mc_1p0 = sim_frand(s, 2.0f, 30.0f);
+    m->mc_2p5 = m->mc_1p0 * sim_frand(s, 1.0f, 1.2f);
+    m->mc_4p0 = m->mc_2p5 * sim_frand(s, 1.0f, 1.1f);
+    m->mc_10p0 = m->mc_4p0 * sim_frand(s, 1.0f, 1.1f);
+    m->nc_0p5 = m->mc_1p0 * sim_frand(s, 6.0f, 7.0f);
+    m->nc_1p0 = m->nc_0p5 * sim_frand(s, 1.1f, 1.2f);
+    m->nc_2p5 = m->nc_1p0 * sim_frand(s, 1.0f, 1.02f);
+    m->nc_4p0 = m->nc_2p5 * sim_frand(s, 1.0f, 1.005f);
+    m->nc_10p0 = m->nc_4p0 * sim_frand(s, 1.0f, 1.002f);
+    m->typical_particle_size = sim_frand(s, 0.4f, 0.8f);
+    if (sim.now_ns < s->cleaning_until_ns)
+        sim_scale_sample(m, SPS30_SIM_CLEANING_FACTOR);
+}
+
+/**
+ * sim_count_autoclean() - count the measuring time towards the automatic
+ * cleaning interval and start the cleaning when it is reached
+ */
+static void sim_count_autoclean(struct sim_sensor* s) {
+    const uint64_t interval_ns =
+        (uint64_t)s->autoclean_interval * 1000000000ULL;
+
+    s->autoclean_elapsed_ns += sim.now_ns - s->autoclean_counted_ns;
+    s->autoclean_counted_ns = sim.now_ns;
+    if (!interval_ns || s->autoclean_elapsed_ns < interval_ns)
+        return;
+
+    s->autoclean_elapsed_ns -= interval_ns;
+    s->cleaning_until_ns =
+        sim.now_ns - s->autoclean_elapsed_ns + SIM_CLEANING_NS;
+    s->cleanings++;
+}
+
+/**
+ * sim_update() - bring the measurement state of a sensor up to date
+ */
+static void sim_update(struct sim_sensor* s) {
+    uint64_t missed;
+
+    if (s->state != SPS30_STATE_MEASURING)
+        return;
+
+    sim_count_autoclean(s);
+    if (sim.now_ns < s->next_sample_ns)
+        return;
+
+    /* only the latest of several missed samples is observable */
+    missed = (sim.now_ns - s->next_sample_ns) / s->interval_ns;
+    s->next_sample_ns += (missed + 1) * s->interval_ns;
+    sim_generate_sample(s);
+    s->data_ready = 1;
+}
+
+static void sim_charge_bus(uint16_t count) {
+    uint64_t bits;
+
+    if (!sim.bus_hz)
+        return;
+
+    bits = SIM_START_STOP_BITS + (uint64_t)(count + 1) * SIM_BITS_PER_BYTE;
+#ifndef SPS30_SIM_REAL_TIME
+    sim.now_ns += bits * 1000000000ULL / sim.bus_hz;
+#endif
+    sim.stats.bus_time_ns += bits * 1000000000ULL / sim.bus_hz;
+}
+
+static int8_t sim_nack(void) {
+    sim_charge_bus(0);
+    sim.stats.nacks++;
+    return STATUS_FAIL;
+}
+
+static void sim_respond(struct sim_sensor* s, const uint16_t* words,
+                        uint16_t num_words, uint64_t delay_ns) {
+    memcpy(s->response, words, num_words * sizeof(*words));
+    s->response_len = num_words;
+    s->response_is_measurement = 0;
+    s->response_at_ns = sim.now_ns + delay_ns;
+}
+
+static uint16_t sim_u16(float value) {
+    if (value <= 0.0f)
+        return 0;
+    if (value >= 65535.0f)
+        return 0xffff;
+    return (uint16_t)(value + 0.5f);
+}
+
+static void sim_respond_measurement(struct sim_sensor* s) {
+    const struct sps30_measurement* m = &s->values;
+    const float v[10] = {m->mc_1p0,  m->mc_2p5, m->mc_4p0, m->mc_10p0,
+                         m->nc_0p5,  m->nc_1p0, m->nc_2p5, m->nc_4p0,
+                         m->nc_10p0, m->typical_particle_size};
+    uint16_t words[SIM_MAX_RESPONSE_WORDS];
+    uint32_t raw;
+    uint16_t i;
+
+    if (s->format == SPS30_FORMAT_UINT16) {
+        for (i = 0; i < 9; ++i)
+            words[i] = sim_u16(v[i]);
+        /* typical particle size in nm */
+        words[9] = sim_u16(v[9] * 1000.0f);
+        sim_respond(s, words, 10, 0);
+    } else {
+        for (i = 0; i < 10; ++i) {
+            memcpy(&raw, &v[i], sizeof(raw));
+            words[2 * i] = (uint16_t)(raw >> 16);
+            words[2 * i + 1] = (uint16_t)(raw & 0xffff);
+        }
+        sim_respond(s, words, 20, 0);
+    }
+    s->response_is_measurement = 1;
+}
+
+static void sim_respond_serial(struct sim_sensor* s) {
+    char serial[SPS30_MAX_SERIAL_LEN];
+    uint16_t words[SPS30_MAX_SERIAL_LEN / 2];
+    uint16_t i;
+
+    memset(serial, 0, sizeof(serial));
+    (void)snprintf(serial, sizeof(serial), SPS30_SIM_SERIAL_FMT, s->serial_no);
+    for (i = 0; i < SPS30_MAX_SERIAL_LEN / 2; ++i) {
+        words[i] = (uint16_t)(((uint8_t)serial[2 * i] << 8) |
+                              (uint8_t)serial[2 * i + 1]);
+    }
+    sim_respond(s, words, SPS30_MAX_SERIAL_LEN / 2, 0);
+}
+
+/**
+ * sim_execute() - execute a command with its CRC-checked arguments
+ * Return:  0 if the command was accepted, STATUS_FAIL to NACK it
+ */
+static int8_t sim_execute(struct sim_sensor* s, uint16_t cmd,
+                          const uint16_t* args, uint16_t num_args) {
+    uint16_t words[2];
+
+    switch (cmd) {
+        case SIM_CMD_START_MEASUREMENT:
+            if (num_args != 1 || (args[0] != SPS30_FORMAT_FLOAT &&
+                                  args[0] != SPS30_FORMAT_UINT16))
+                return STATUS_FAIL;
+            if (s->state == SPS30_STATE_MEASURING)
+                return NO_ERROR;
+            s->state = SPS30_STATE_MEASURING;
+            s->format = args[0];
+            s->data_ready = 0;
+            memset(&s->values, 0, sizeof(s->values));
+            s->next_sample_ns = sim.now_ns + s->interval_ns;
+            s->autoclean_counted_ns = sim.now_ns;
+            s->busy_until_ns = sim.now_ns + SIM_START_STOP_NS;
+            return NO_ERROR;
+
+        case SIM_CMD_STOP_MEASUREMENT:
+            if (s->state == SPS30_STATE_MEASURING)
+                sim_count_autoclean(s);
+            s->cleaning_until_ns = 0;
+            s->state = SPS30_STATE_IDLE;
+            s->data_ready = 0;
+            s->busy_until_ns = sim.now_ns + SIM_START_STOP_NS;
+            return NO_ERROR;
+
+        case SIM_CMD_READ_MEASUREMENT:
+            sim_respond_measurement(s);
+            return NO_ERROR;
+
+        case SIM_CMD_GET_DATA_READY:
+            words[0] = s->data_ready;
+            sim_respond(s, words, 1, 0);
+            return NO_ERROR;
+
+        case SIM_CMD_AUTOCLEAN_INTERVAL:
+            if (num_args == 2) {
+                s->autoclean_interval = ((uint32_t)args[0] << 16) | args[1];
+                s->busy_until_ns = sim.now_ns + SIM_FLASH_WRITE_NS;
+                return NO_ERROR;
+            }
+            words[0] = (uint16_t)(s->autoclean_interval >> 16);
+            words[1] = (uint16_t)(s->autoclean_interval & 0xffff);
+            sim_respond(s, words, 2, SIM_CMD_NS);
+            return NO_ERROR;
+
+        case SIM_CMD_GET_FIRMWARE_VERSION:
+            words[0] = SIM_FIRMWARE_VERSION;
+            sim_respond(s, words, 1, 0);
+            return NO_ERROR;
+
+        case SIM_CMD_GET_SERIAL:
+            sim_respond_serial(s);
+            return NO_ERROR;
+
+        case SIM_CMD_RESET:
+            s->state = SPS30_STATE_IDLE;
+            s->format = SPS30_FORMAT_FLOAT;
+            s->data_ready = 0;
+            s->response_len = 0;
+            s->autoclean_elapsed_ns = 0;
+            s->cleaning_until_ns = 0;
+            s->busy_until_ns = sim.now_ns + SIM_RESET_NS;
+            return NO_ERROR;
+
+        case SIM_CMD_SLEEP:
+            if (s->state != SPS30_STATE_IDLE)
+                return STATUS_FAIL;
+            s->state = SPS30_STATE_SLEEPING;
+            s->interface_awake_until_ns = 0;
+            s->busy_until_ns = sim.now_ns + SIM_CMD_NS;
+            return NO_ERROR;
+
+        case SIM_CMD_WAKE_UP:
+            /* a repeated wake-up is accepted, in idle mode it fails */
+            if (s->state != SPS30_STATE_SLEEPING)
+                return sim.now_ns - s->woken_up_ns < SIM_WAKE_UP_WINDOW_NS
+                           ? NO_ERROR
+                           : STATUS_FAIL;
+            s->state = SPS30_STATE_IDLE;
+            s->woken_up_ns = sim.now_ns;
+            s->busy_until_ns = sim.now_ns + SIM_CMD_NS;
+            return NO_ERROR;
+
+        case SIM_CMD_READ_DEVICE_STATUS_REG:
+            words[0] = (uint16_t)(s->device_status >> 16);
+            words[1] = (uint16_t)(s->device_status & 0xffff);
+            sim_respond(s, words, 2, SIM_CMD_NS);
+            return NO_ERROR;
+
+        case SIM_CMD_START_MANUAL_FAN_CLEANING:
+            if (s->state != SPS30_STATE_MEASURING)
+                return STATUS_FAIL;
+            s->cleaning_until_ns = sim.now_ns + SIM_CLEANING_NS;
+            s->cleanings++;
+            s->busy_until_ns = sim.now_ns + SIM_CMD_NS;
+            return NO_ERROR;
+
+        default:
+            return STATUS_FAIL;
+    }
+}
+
+/**
+ * sim_accepts() - whether the sensor acknowledges its address
+ *
+ * @ignore_busy:    Acknowledge even if the sensor is processing a command
+ */
+static int sim_accepts(struct sim_sensor* s, int ignore_busy) {
+    if (!s)
+        return 0;
+
+    if (s->nacks_to_inject) {
+        s->nacks_to_inject--;
+        return 0;
+    }
+
+    return ignore_busy || sim.now_ns >= s->busy_until_ns;
+}
+
+/**
+ * sim_is_repeated_wake_up() - whether a write is the second of the two wake-up
+ * commands sent by the driver
+ */
+static int sim_is_repeated_wake_up(const struct sim_sensor* s,
+                                   const uint8_t* data, uint16_t count) {
+    return s && count == SENSIRION_COMMAND_SIZE &&
+           ((data[0] << 8) | data[1]) == SIM_CMD_WAKE_UP &&
+           s->state == SPS30_STATE_IDLE &&
+           sim.now_ns - s->woken_up_ns < SIM_WAKE_UP_WINDOW_NS;
+}
+
+static int8_t sim_read(uint8_t address, uint8_t* data, uint16_t count) {
+    struct sim_mux* mux = sim_find_mux(SIM_BUS, address);
+    struct sim_sensor* s;
+    uint16_t i;
+    uint16_t word;
+
+    sim.stats.transactions++;
+    if (mux) {
+        sim_charge_bus(count);
+        sim.stats.bytes_read += count;
+        for (i = 0; i < count; ++i)
+            data[i] = mux->channels;
+        return NO_ERROR;
+    }
+
+    s = sim_connected(SIM_BUS, address);
+    if (!sim_accepts(s, 0) || s->state == SPS30_STATE_SLEEPING ||
+        sim.now_ns < s->response_at_ns)
+        return sim_nack();
+
+    sim_charge_bus(count);
+    sim.stats.bytes_read += count;
+    sim_update(s);
+
+    for (i = 0; i < count; ++i) {
+        if (i % 3 == 2) {
+            data[i] = sensirion_common_generate_crc(&data[i - 2], 2);
+            continue;
+        }
+        word = (i / 3) < s->response_len ? s->response[i / 3] : 0xffff;
+        data[i] = (uint8_t)(i % 3 == 0 ? word >> 8 : word & 0xff);
+    }
+
+    if (s->crc_errors_to_inject && count >= 3) {
+        s->crc_errors_to_inject--;
+        data[2] ^= 0xff;
+    }
+
+    if (s->response_is_measurement)
+        s->data_ready = 0;
+
+    return NO_ERROR;
+}
+
+static int8_t sim_write(uint8_t address, const uint8_t* data,
+                        uint16_t count) {
+    struct sim_mux* mux = sim_find_mux(SIM_BUS, address);
+    struct sim_sensor* s;
+    uint16_t args[SIM_MAX_ARGS];
+    uint16_t num_args = 0;
+    uint16_t cmd;
+    uint16_t i;
+
+    sim.stats.transactions++;
+    if (mux) {
+        /* the control register is the last byte written */
+        sim_charge_bus(count);
+        sim.stats.bytes_written += count;
+        if (count) {
+            mux->channels = data[count - 1];
+            sim.stats.mux_switches++;
+        }
+        return NO_ERROR;
+    }
+
+    s = sim_connected(SIM_BUS, address);
+    if (!sim_accepts(s, sim_is_repeated_wake_up(s, data, count)))
+        return sim_nack();
+
+    if (s->state == SPS30_STATE_SLEEPING &&
+        sim.now_ns >= s->interface_awake_until_ns) {
+        /* the first transfer only wakes up the i2c interface */
+        s->interface_awake_until_ns = sim.now_ns + SIM_WAKE_UP_WINDOW_NS;
+        return sim_nack();
+    }
+
+    sim_charge_bus(count);
+    sim.stats.bytes_written += count;
+    sim_update(s);
+
+    if (count < SENSIRION_COMMAND_SIZE ||
+        (count - SENSIRION_COMMAND_SIZE) % 3 != 0 ||
+        (count - SENSIRION_COMMAND_SIZE) / 3 > SIM_MAX_ARGS) {
+        sim.stats.nacks++;
+        return STATUS_FAIL;
+    }
+
+    cmd = (uint16_t)((data[0] << 8) | data[1]);
+    for (i = SENSIRION_COMMAND_SIZE; i < count; i += 3) {
+        if (sensirion_common_check_crc(&data[i], 2, data[i + 2]) != NO_ERROR) {
+            sim.stats.nacks++;
+            return STATUS_FAIL;
+        }
+        args[num_args++] = (uint16_t)((data[i] << 8) | data[i + 1]);
+    }
+
+    if (s->state == SPS30_STATE_SLEEPING && cmd != SIM_CMD_WAKE_UP) {
+        sim.stats.nacks++;
+        return STATUS_FAIL;
+    }
+
+    if (sim_execute(s, cmd, args, num_args) != NO_ERROR) {
+        sim.stats.nacks++;
+        return STATUS_FAIL;
+    }
+
+    return NO_ERROR;
+}
+
+int8_t sps30_sim_read(uint8_t bus, uint8_t address, uint8_t* data,
+                      uint16_t count) {
+    uint8_t selected;
+    int8_t ret;
+
+    sim_enter();
+    selected = SIM_BUS;
+    SIM_BUS = bus;
+    ret = sim_read(address, data, count);
+    SIM_BUS = selected;
+    sim_leave();
+    return ret;
+}
+
+int8_t sps30_sim_write(uint8_t bus, uint8_t address, const uint8_t* data,
+                       uint16_t count) {
+    uint8_t selected;
+    int8_t ret;
+
+    sim_enter();
+    selected = SIM_BUS;
+    SIM_BUS = bus;
+    ret = sim_write(address, data, count);
+    SIM_BUS = selected;
+    sim_leave();
+    return ret;
+}
+
+#ifndef SPS30_SIM_NO_I2C
+
+int16_t sensirion_i2c_select_bus(uint8_t bus_idx) {
+    SIM_BUS = bus_idx;
+    return NO_ERROR;
+}
+
+void sensirion_i2c_init(void) {
+}
+
+void sensirion_i2c_release(void) {
+}
+
+int8_t sensirion_i2c_read(uint8_t address, uint8_t* data, uint16_t count) {
+    int8_t ret;
+
+    sim_enter();
+    ret = sim_read(address, data, count);
+    sim_leave();
+    return ret;
+}
+
+int8_t sensirion_i2c_write(uint8_t address, const uint8_t* data,
+                           uint16_t count) {
+    int8_t ret;
+
+    sim_enter();
+    ret = sim_write(address, data, count);
+    sim_leave();
+    return ret;
+}
+
+#ifdef SPS30_I2C_WRITE_READ
+int8_t sps30_i2c_write_read(uint8_t address, const uint8_t* tx,
+                            uint16_t tx_count, uint8_t* rx, uint16_t rx_count) {
+    int8_t ret;
+
+    sim_enter();
+    ret = sim_write(address, tx, tx_count);
+    if (ret == NO_ERROR) {
+        /* the read follows with a repeated start in the same transaction */
+        sim.stats.transactions--;
+        ret = sim_read(address, rx, rx_count);
+    }
+    sim_leave();
+    return ret;
+}
+#endif
+
+void sensirion_sleep_usec(uint32_t useconds) {
+    sim_enter();
+    sim.stats.sleeps++;
+    sim.stats.sleep_time_us += useconds;
+#ifdef SPS30_SIM_REAL_TIME
+    sim_leave();
+    sim_wall_sleep(useconds);
+#else
+    sim.now_ns += (uint64_t)useconds * 1000;
+    sim_leave();
+#endif
+}
+
+#endif /* SPS30_SIM_NO_I2C */
+
+void sps30_sim_reset(void) {
+    memset(&sim, 0, sizeof(sim));
+    sim.bus_hz = SPS30_SIM_DEFAULT_BUS_HZ;
+#ifdef SPS30_SIM_REAL_TIME
+    sim.origin_ns = sim_monotonic_ns();
+#endif
+}
+
+static struct sim_sensor* sim_add_sensor(uint8_t bus, uint8_t address) {
+    struct sim_sensor* s;
+
+    if (sim.num_sensors >= SPS30_SIM_MAX_SENSORS)
+        return NULL;
+
+    s = &sim.sensors[sim.num_sensors++];
+    memset(s, 0, sizeof(*s));
+    s->bus = bus;
+    s->address = address;
+    s->state = SPS30_STATE_IDLE;
+    s->format = SPS30_FORMAT_FLOAT;
+    s->serial_no = sim.num_sensors;
+    s->rng = sim.num_sensors * 2654435761u;
+    s->autoclean_interval = SIM_DEFAULT_AUTOCLEAN_INTERVAL;
+    s->interval_ns = SIM_MEASUREMENT_INTERVAL_NS;
+    return s;
+}
+
+int16_t sps30_sim_add_sensor(uint8_t bus, uint8_t address) {
+    if (sim_find(bus, address) || sim_find_mux(bus, address) ||
+        !sim_add_sensor(bus, address))
+        return STATUS_FAIL;
+
+    return NO_ERROR;
+}
+
+int16_t sps30_sim_add_mux(uint8_t bus, uint8_t address) {
+    struct sim_mux* mux;
+
+    if (sim.num_muxes >= SPS30_SIM_MAX_MUXES || sim_find_mux(bus, address) ||
+        sim_find(bus, address))
+        return STATUS_FAIL;
+
+    mux = &sim.muxes[sim.num_muxes++];
+    mux->bus = bus;
+    mux->address = address;
+    mux->channels = 0;
+    return NO_ERROR;
+}
+
+int16_t sps30_sim_add_mux_sensor(uint8_t bus, uint8_t mux_address,
+                                 uint8_t channel, uint8_t address) {
+    struct sim_mux* mux = sim_find_mux(bus, mux_address);
+    struct sim_sensor* s;
+
+    if (!mux || channel >= 8 ||
+        sim_find(SPS30_SIM_MUX_BUS(mux_address, channel), address))
+        return STATUS_FAIL;
+
+    s = sim_add_sensor(bus, address);
+    if (!s)
+        return STATUS_FAIL;
+
+    s->mux = mux;
+    s->channel = channel;
+    return NO_ERROR;
+}
+
+uint8_t sps30_sim_get_mux_channels(uint8_t bus, uint8_t address) {
+    struct sim_mux* mux = sim_find_mux(bus, address);
+
+    return mux ? mux->channels : 0;
+}
+
+void sps30_sim_set_bus_speed(uint32_t hz) {
+    sim.bus_hz = hz;
+}
+
+uint64_t sps30_sim_time_ns(void) {
+    return sim.now_ns;
+}
+
+uint32_t sps30_sim_time_us(void) {
+    return (uint32_t)(sim.now_ns / 1000);
+}
+
+uint32_t sps30_stats_get_time_usec(void) {
+    return sps30_sim_time_us();
+}
+
+void sps30_sim_advance_us(uint32_t useconds) {
+    sim.now_ns += (uint64_t)useconds * 1000;
+}
+
+void sps30_sim_get_stats(struct sps30_sim_stats* stats) {
+    *stats = sim.stats;
+}
+
+void sps30_sim_reset_stats(void) {
+    memset(&sim.stats, 0, sizeof(sim.stats));
+}
+
+int16_t sps30_sim_set_measurement(uint8_t bus, uint8_t address,
+                                  const struct sps30_measurement* measurement) {
+    struct sim_sensor* s = sim_find(bus, address);
+
+    if (!s)
+        return STATUS_FAIL;
+
+    s->use_fixed_values = measurement != NULL;
+    if (measurement)
+        s->fixed_values = *measurement;
+    return NO_ERROR;
+}
+
+int16_t sps30_sim_set_clock_drift(uint8_t bus, uint8_t address,
+                                  int32_t ppm) {
+    struct sim_sensor* s = sim_find(bus, address);
+
+    if (!s || ppm <= -1000000)
+        return STATUS_FAIL;
+
+    /* 1ppm of 1s is 1us */
+    s->interval_ns =
+        SIM_MEASUREMENT_INTERVAL_NS + (uint64_t)((int64_t)ppm * 1000);
+    return NO_ERROR;
+}
+
+int16_t sps30_sim_set_device_status(uint8_t bus, uint8_t address,
+                                    uint32_t device_status_flags) {
+    struct sim_sensor* s = sim_find(bus, address);
+
+    if (!s)
+        return STATUS_FAIL;
+
+    s->device_status = device_status_flags;
+    return NO_ERROR;
+}
+
+int16_t sps30_sim_inject_nacks(uint8_t bus, uint8_t address, uint16_t count) {
+    struct sim_sensor* s = sim_find(bus, address);
+
+    if (!s)
+        return STATUS_FAIL;
+
+    s->nacks_to_inject = count;
+    return NO_ERROR;
+}
+
+int16_t sps30_sim_inject_crc_errors(uint8_t bus, uint8_t address,
+                                    uint16_t count) {
+    struct sim_sensor* s = sim_find(bus, address);
+
+    if (!s)
+        return STATUS_FAIL;
+
+    s->crc_errors_to_inject = count;
+    return NO_ERROR;
+}
+
+uint8_t sps30_sim_get_state(uint8_t bus, uint8_t address) {
+    struct sim_sensor* s = sim_find(bus, address);
+
+    if (!s)
+        return SPS30_STATE_UNKNOWN;
+
+    return s->state;
+}
+
+uint32_t sps30_sim_get_cleanings(uint8_t bus, uint8_t address) {
+    struct sim_sensor* s = sim_find(bus, address);
+    uint32_t cleanings;
+
+    if (!s)
+        return 0;
+
+    sim_enter();
+    sim_update(s);
+    cleanings = s->cleanings;
+    sim_leave();
+    return cleanings;
+}
@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SPS30_SIM_H
+#define SPS30_SIM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "sensirion_arch_config.h"
+#include "sps30.h"
+
+/*
+ * Simulated SPS30 sensors behind the sensirion_i2c.h interface
+ *
+ * Linking sps30_sim.c instead of a hw_i2c/sw_i2c implementation runs the
+ * driver against one or more simulated sensors on a virtual clock. The model
+ * covers the command set used by sps30.c including command processing times
+ * (the sensor NACKs while busy), the 1s measurement interval with data-ready
+ * flag, float and uint16 output formats, sleep/wake-up, fan cleaning and
+ * CRCs.
+ *
+ * sensirion_sleep_usec() does not sleep but advances the virtual clock. Every
+ * transfer is charged the time it takes on a bus running at the configured
+ * clock speed, so that the virtual clock reflects the wall time the driver
+ * would need on real hardware. The virtual clock is also the time source of
+ * the driver statistics (sps30_stats_get_time_usec()).
+ *
+ * Sensors may be connected through TCA9548A-style multiplexers: such a sensor
+ * answers while its channel is selected in the multiplexer's control register.
+ * Transfers to an address which is connected more than once fail and are
+ * counted as collisions. The per-sensor sps30_sim_*() functions address a
+ * sensor behind a multiplexer with SPS30_SIM_MUX_BUS() instead of its bus.
+ *
+ * Built with SPS30_SIM_NO_I2C, the simulation leaves sensirion_i2c.h and
+ * sensirion_sleep_usec() to another implementation, such as the Linux i2c-dev
+ * backend on top of a fake device, which passes the transfers on to
+ * sps30_sim_read() and sps30_sim_write().
+ *
+ * Built with SPS30_SIM_REAL_TIME, the simulation follows CLOCK_MONOTONIC
+ * instead, sensirion_sleep_usec() sleeps, and the sensors may be accessed from
+ * several threads, each with its own selected bus. This serves tests of code
+ * driven by real timers, such as the Linux poller.
+ */
+
+#define SPS30_SIM_MAX_SENSORS 64
+#define SPS30_SIM_MAX_MUXES 8
+/**
+ * Bus argument of the per-sensor functions for a sensor behind a multiplexer,
+ * unique as long as the multiplexer addresses differ in the lower three bits
+ */
+#define SPS30_SIM_MUX_BUS(mux_address, channel) \
+    ((uint8_t)(0x80 | ((mux_address)&0x07) << 3 | (channel)))
+/** Default bus clock of the simulation */
+#define SPS30_SIM_DEFAULT_BUS_HZ 100000
+/**
+ * Samples produced while the fan is cleaned, manually or after the automatic
+ * cleaning interval of measuring time, are scaled by this factor
+ */
+#define SPS30_SIM_CLEANING_FACTOR 4.0f
+/** Serial number of the first simulated sensor, later ones count up */
+#define SPS30_SIM_SERIAL_FMT "SIM%013u"
+
+/**
+ * struct sps30_sim_stats - bus activity since the last sps30_sim_reset_stats()
+ *
+ * @transactions:   Number of sensirion_i2c_read/write calls
+ * @nacks:          Transactions which were not acknowledged
+ * @bytes_written:  Payload bytes written, without address byte
+ * @bytes_read:     Payload bytes read, without address byte
+ * @bus_time_ns:    Time spent on the bus including address bytes, start and
+ *                  stop conditions
+ * @sleeps:         Number of sensirion_sleep_usec calls
+ * @sleep_time_us:  Sum of the durations passed to sensirion_sleep_usec
+ * @mux_switches:   Writes to the control register of a multiplexer
+ * @collisions:     Transfers to an address connected more than once
+ */
+struct sps30_sim_stats {
+    uint32_t transactions;
+    uint32_t nacks;
+    uint64_t bytes_written;
+    uint64_t bytes_read;
+    uint64_t bus_time_ns;
+    uint32_t sleeps;
+    uint64_t sleep_time_us;
+    uint32_t mux_switches;
+    uint32_t collisions;
+};
+
+/**
+ * sps30_sim_reset() - remove all sensors, reset clock, statistics and bus
+ * speed
+ *
+ * Must be called before the simulation is used.
+ */
+void sps30_sim_reset(void);
+
+/**
+ * sps30_sim_add_sensor() - add a sensor in idle mode
+ *
+ * @bus:        Bus index as passed to sensirion_i2c_select_bus()
+ * @address:    I2C address of the sensor
+ * Return:      0 on success, STATUS_FAIL if no more sensors can be added
+ */
+int16_t sps30_sim_add_sensor(uint8_t bus, uint8_t address);
+
+/**
+ * sps30_sim_add_mux() - add a multiplexer with all channels disconnected
+ *
+ * @bus:        Bus index as passed to sensirion_i2c_select_bus()
+ * @address:    I2C address of the multiplexer
+ * Return:      0 on success, STATUS_FAIL if no more multiplexers can be added
+ */
+int16_t sps30_sim_add_mux(uint8_t bus, uint8_t address);
+
+/**
+ * sps30_sim_add_mux_sensor() - add a sensor in idle mode behind a multiplexer
+ *
+ * @bus:            Bus index of the multiplexer
+ * @mux_address:    I2C address of the multiplexer
+ * @channel:        Channel of the sensor on the multiplexer, 0 to 7
+ * @address:        I2C address of the sensor
+ * Return:          0 on success, STATUS_FAIL if there is no such multiplexer
+ *                  or no more sensors can be added
+ */
+int16_t sps30_sim_add_mux_sensor(uint8_t bus, uint8_t mux_address,
+                                 uint8_t channel, uint8_t address);
+
+/**
+ * sps30_sim_get_mux_channels() - control register of a multiplexer
+ *
+ * Return:  Bit mask of the connected channels, 0 if there is no such
+ *          multiplexer
+ */
+uint8_t sps30_sim_get_mux_channels(uint8_t bus, uint8_t address);
+
+/**
+ * sps30_sim_set_bus_speed() - set the simulated bus clock
+ *
+ * @hz:     Bus clock in Hz, 0 to make transfers take no time
+ */
+void sps30_sim_set_bus_speed(uint32_t hz);
+
+/**
+ * sps30_sim_time_ns() - current time of the virtual clock
+ */
+uint64_t sps30_sim_time_ns(void);
+
+/**
+ * sps30_sim_time_us() - current time of the virtual clock, wrapping
+ *
+ * Suitable as @now_us for the non-blocking driver API.
+ */
+uint32_t sps30_sim_time_us(void);
+
+/**
+ * sps30_sim_advance_us() - let time pass outside of the driver
+ *
+ * Unlike sensirion_sleep_usec() this is not counted in the statistics.
+ */
+void sps30_sim_advance_us(uint32_t useconds);
+
+/**
+ * sps30_sim_read() - read transfer on a bus, independent of the selected bus
+ *
+ * Return:  0 on success, STATUS_FAIL if not acknowledged
+ */
+int8_t sps30_sim_read(uint8_t bus, uint8_t address, uint8_t* data,
+                      uint16_t count);
+
+/**
+ * sps30_sim_write() - write transfer on a bus, independent of the selected bus
+ *
+ * Return:  0 on success, STATUS_FAIL if not acknowledged
+ */
+int8_t sps30_sim_write(uint8_t bus, uint8_t address, const uint8_t* data,
+                       uint16_t count);
+
+void sps30_sim_get_stats(struct sps30_sim_stats* stats);
+void sps30_sim_reset_stats(void);
+
+/**
+ * sps30_sim_set_measurement() - fix the values of all following measurements
+ *
+ * By default every sensor produces a reproducible pseudo-random sequence of
+ * plausible measurements.
+ *
+ * @measurement:    Values to report, NULL to return to generated values
+ */
+int16_t sps30_sim_set_measurement(uint8_t bus, uint8_t address,
+                                  const struct sps30_measurement* measurement);
+
+/**
+ * sps30_sim_set_clock_drift() - make the sensor's clock run fast or slow
+ *
+ * @ppm:    Deviation of the measurement interval from 1s in parts per
+ *          million, positive for a slow clock
+ */
+int16_t sps30_sim_set_clock_drift(uint8_t bus, uint8_t address, int32_t ppm);
+
+/**
+ * sps30_sim_set_device_status() - set the device status register
+ */
+int16_t sps30_sim_set_device_status(uint8_t bus, uint8_t address,
+                                    uint32_t device_status_flags);
+
+/**
+ * sps30_sim_inject_nacks() - do not acknowledge the next @count transfers
+ */
+int16_t sps30_sim_inject_nacks(uint8_t bus, uint8_t address, uint16_t count);
+
+/**
+ * sps30_sim_inject_crc_errors() - corrupt a CRC in the next @count reads
+ */
+int16_t sps30_sim_inject_crc_errors(uint8_t bus, uint8_t address,
+                                    uint16_t count);
+
+/**
+ * sps30_sim_get_state() - operating state of a simulated sensor
+ *
+ * Return:  One of SPS30_STATE_IDLE, SPS30_STATE_MEASURING,
+ *          SPS30_STATE_SLEEPING or SPS30_STATE_UNKNOWN if there is no such
+ *          sensor
+ */
+uint8_t sps30_sim_get_state(uint8_t bus, uint8_t address);
+
+/**
+ * sps30_sim_get_cleanings() - number of fan cleanings a sensor started, manual
+ * and automatic
+ */
+uint32_t sps30_sim_get_cleanings(uint8_t bus, uint8_t address);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPS30_SIM_H */
@@ -0,0 +1,587 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* posix_openpt and cfmakeraw when built as C */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <errno.h>    // errno
+#include <fcntl.h>    // open, O_*
+#include <poll.h>     // poll
+#include <pthread.h>  // pthread_*
+#include <stdlib.h>   // posix_openpt, grantpt, unlockpt, ptsname
+#include <string.h>   // memset, strncpy, strlen
+#include <termios.h>  // tcgetattr, tcsetattr, cfmakeraw
+#include <time.h>     // clock_gettime, nanosleep
+#include <unistd.h>   // read, write, close
+
+#include "sensirion_arch_config.h"
+#include "sensirion_common.h"
+#include "sps30.h"
+#include "sps30_uart_emu.h"
+
+#define EMU_FLAG 0x7e
+#define EMU_ESCAPE 0x7d
+#define EMU_WAKE_UP_PULSE 0xff
+#define EMU_MAX_FRAME 300
+#define EMU_POLL_MS 5
+
+#define EMU_CMD_START_MEASUREMENT 0x00
+#define EMU_CMD_STOP_MEASUREMENT 0x01
+#define EMU_CMD_READ_MEASUREMENT 0x03
+#define EMU_CMD_SLEEP 0x10
+#define EMU_CMD_WAKE_UP 0x11
+#define EMU_CMD_START_FAN_CLEANING 0x56
+#define EMU_CMD_AUTOCLEAN_INTERVAL 0x80
+#define EMU_CMD_DEVICE_INFORMATION 0xd0
+#define EMU_CMD_READ_VERSION 0xd1
+#define EMU_CMD_READ_DEVICE_STATUS_REG 0xd2
+#define EMU_CMD_RESET 0xd3
+
+#define EMU_DEFAULT_AUTOCLEAN_INTERVAL_S 604800
+
+struct emu {
+    pthread_t thread;
+    int master;
+    int slave;
+    volatile int running;
+    char path[64];
+
+    /* settings */
+    uint32_t interval_us;
+    struct sps30_measurement measurement;
+    uint32_t device_status;
+    uint16_t chunk_size;
+    uint32_t chunk_delay_us;
+    uint8_t noise;
+    uint16_t checksum_errors;
+    uint16_t stale_frames;
+
+    /* sensor */
+    uint8_t state;
+    uint8_t uart_on;
+    uint16_t format;
+    uint64_t measuring_since_us;
+    uint64_t samples_read;
+    uint32_t autoclean_interval_s;
+    uint32_t cleanings;
+
+    /* receiver */
+    uint8_t frame[EMU_MAX_FRAME];
+    uint16_t frame_len;
+    uint8_t in_frame;
+    uint8_t escaped;
+
+    struct sps30_uart_emu_stats stats;
+};
+
+static struct emu emu;
+static pthread_mutex_t emu_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static uint64_t emu_now_us(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+static void emu_sleep_us(uint32_t useconds) {
+    struct timespec ts;
+
+    ts.tv_sec = (time_t)(useconds / 1000000);
+    ts.tv_nsec = (long)(useconds % 1000000) * 1000;
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR)
+        ;
+}
+
+static void emu_write(const uint8_t* data, uint16_t len) {
+    ssize_t ret;
+
+    while (len > 0) {
+        ret = write(emu.master, data, len);
+        if (ret < 0) {
+            if (errno == EINTR || errno == EAGAIN)
+                continue;
+            return;
+        }
+        data += ret;
+        len = (uint16_t)(len - ret);
+    }
+}
+
+static uint16_t emu_stuff(uint8_t b, uint8_t* out) {
+    if (b == EMU_FLAG || b == EMU_ESCAPE || b == 0x11 || b == 0x13) {
+        out[0] = EMU_ESCAPE;
+        out[1] = b ^ 0x20;
+        return 2;
+    }
+    out[0] = b;
+    return 1;
+}
+
+/* called with the lock held, releases it while writing delayed chunks */
+static void emu_respond(uint8_t cmd, uint8_t state, uint8_t data_len,
+                        const uint8_t* data) {
+    uint8_t frame[2 + (5 + 255) * 2 + 2];
+    uint8_t header[] = {0x00, cmd, state, data_len};
+    uint16_t chunk_size;
+    uint32_t chunk_delay_us;
+    uint16_t len = 0;
+    uint16_t offset;
+    uint16_t n;
+    uint8_t sum = 0;
+    uint8_t i;
+
+    if (emu.noise) {
+        frame[len++] = 0x00;
+        frame[len++] = 0x13;
+    }
+    if (emu.stale_frames) {
+        /* the start of an earlier response whose end got lost */
+        emu.stale_frames--;
+        frame[len++] = EMU_FLAG;
+        frame[len++] = 0x00;
+        frame[len++] = cmd;
+    }
+    frame[len++] = EMU_FLAG;
+    for (i = 0; i < sizeof(header); ++i) {
+        sum = (uint8_t)(sum + header[i]);
+        len += emu_stuff(header[i], &frame[len]);
+    }
+    for (i = 0; i < data_len; ++i) {
+        sum = (uint8_t)(sum + data[i]);
+        len += emu_stuff(data[i], &frame[len]);
+    }
+    sum = (uint8_t)~sum;
+    if (emu.checksum_errors) {
+        emu.checksum_errors--;
+        sum ^= 0x01;
+    }
+    len += emu_stuff(sum, &frame[len]);
+    frame[len++] = EMU_FLAG;
+
+    chunk_size = emu.chunk_size ? emu.chunk_size : len;
+    chunk_delay_us = emu.chunk_delay_us;
+    pthread_mutex_unlock(&emu_lock);
+    for (offset = 0; offset < len; offset += n) {
+        n = len - offset < chunk_size ? len - offset : chunk_size;
+        if (offset > 0)
+            emu_sleep_us(chunk_delay_us);
+        emu_write(&frame[offset], n);
+    }
+    pthread_mutex_lock(&emu_lock);
+}
+
+static void emu_put_u16(uint8_t* out, uint16_t v) {
+    out[0] = (uint8_t)(v >> 8);
+    out[1] = (uint8_t)v;
+}
+
+static void emu_put_u32(uint8_t* out, uint32_t v) {
+    out[0] = (uint8_t)(v >> 24);
+    out[1] = (uint8_t)(v >> 16);
+    out[2] = (uint8_t)(v >> 8);
+    out[3] = (uint8_t)v;
+}
+
+static void emu_put_float(uint8_t* out, float f) {
+    uint32_t v;
+
+    memcpy(&v, &f, sizeof(v));
+    emu_put_u32(out, v);
+}
+
+static uint16_t emu_round(float f) {
+    return (uint16_t)(f + 0.5f);
+}
+
+static uint8_t emu_encode_measurement(uint8_t* out) {
+    const struct sps30_measurement* m = &emu.measurement;
+    const float values[] = {m->mc_1p0, m->mc_2p5, m->mc_4p0, m->mc_10p0,
+                            m->nc_0p5, m->nc_1p0, m->nc_2p5, m->nc_4p0,
+                            m->nc_10p0};
+    uint8_t i;
+
+    if (emu.format == SPS30_FORMAT_UINT16) {
+        for (i = 0; i < 9; ++i)
+            emu_put_u16(&out[i * 2], emu_round(values[i]));
+        emu_put_u16(&out[18], emu_round(m->typical_particle_size * 1000.0f));
+        return 20;
+    }
+    for (i = 0; i < 9; ++i)
+        emu_put_float(&out[i * 4], values[i]);
+    emu_put_float(&out[36], m->typical_particle_size);
+    return 40;
+}
+
+static void emu_read_measurement(void) {
+    uint8_t data[40];
+    uint64_t samples;
+
+    if (emu.state != SPS30_UART_EMU_STATE_MEASURING) {
+        emu_respond(EMU_CMD_READ_MEASUREMENT, SPS30_STATE_NOT_ALLOWED, 0,
+                    NULL);
+        return;
+    }
+
+    samples = (emu_now_us() - emu.measuring_since_us) / emu.interval_us;
+    if (samples <= emu.samples_read) {
+        emu_respond(EMU_CMD_READ_MEASUREMENT, 0, 0, NULL);
+        return;
+    }
+    emu.samples_read = samples;
+    emu_respond(EMU_CMD_READ_MEASUREMENT, 0, emu_encode_measurement(data),
+                data);
+}
+
+static void emu_reset_sensor(void) {
+    emu.state = SPS30_UART_EMU_STATE_IDLE;
+    emu.uart_on = 1;
+    emu.format = SPS30_FORMAT_FLOAT;
+}
+
+static void emu_handle(uint8_t cmd, uint8_t len, const uint8_t* data) {
+    const char* product_type = "00080000";
+    const char* info;
+    uint8_t out[40];
+    uint8_t state = 0;
+    uint8_t out_len = 0;
+
+    switch (cmd) {
+        case EMU_CMD_START_MEASUREMENT:
+            if (len != 2 || data[0] != 0x01)
+                state = SPS30_STATE_WRONG_DATA_LENGTH;
+            else if (data[1] != 0x03 && data[1] != 0x05)
+                state = SPS30_STATE_ILLEGAL_PARAMETER;
+            else if (emu.state != SPS30_UART_EMU_STATE_IDLE)
+                state = SPS30_STATE_NOT_ALLOWED;
+            else {
+                emu.state = SPS30_UART_EMU_STATE_MEASURING;
+                emu.format = (uint16_t)(data[1] << 8);
+                emu.measuring_since_us = emu_now_us();
+                emu.samples_read = 0;
+            }
+            break;
+        case EMU_CMD_STOP_MEASUREMENT:
+            if (emu.state == SPS30_UART_EMU_STATE_SLEEPING)
+                state = SPS30_STATE_NOT_ALLOWED;
+            else
+                emu.state = SPS30_UART_EMU_STATE_IDLE;
+            break;
+        case EMU_CMD_READ_MEASUREMENT:
+            emu_read_measurement();
+            return;
+        case EMU_CMD_SLEEP:
+            if (emu.state != SPS30_UART_EMU_STATE_IDLE) {
+                state = SPS30_STATE_NOT_ALLOWED;
+                break;
+            }
+            /* the UART switches off after the response */
+            emu.state = SPS30_UART_EMU_STATE_SLEEPING;
+            emu_respond(cmd, 0, 0, NULL);
+            emu.uart_on = 0;
+            return;
+        case EMU_CMD_WAKE_UP:
+            if (emu.state != SPS30_UART_EMU_STATE_SLEEPING)
+                state = SPS30_STATE_NOT_ALLOWED;
+            else
+                emu.state = SPS30_UART_EMU_STATE_IDLE;
+            break;
+        case EMU_CMD_START_FAN_CLEANING:
+            if (emu.state != SPS30_UART_EMU_STATE_MEASURING)
+                state = SPS30_STATE_NOT_ALLOWED;
+            else
+                emu.cleanings++;
+            break;
+        case EMU_CMD_AUTOCLEAN_INTERVAL:
+            if (len == 1 && data[0] == 0x00) {
+                emu_put_u32(out, emu.autoclean_interval_s);
+                out_len = 4;
+            } else if (len == 5 && data[0] == 0x00) {
+                emu.autoclean_interval_s =
+                    (uint32_t)data[1] << 24 | (uint32_t)data[2] << 16 |
+                    (uint32_t)data[3] << 8 | data[4];
+            } else {
+                state = SPS30_STATE_WRONG_DATA_LENGTH;
+            }
+            break;
+        case EMU_CMD_DEVICE_INFORMATION:
+            info = NULL;
+            if (len == 1 && data[0] == 0x00)
+                info = product_type;
+            else if (len == 1 && data[0] == 0x03)
+                info = SPS30_UART_EMU_SERIAL;
+            if (!info) {
+                state = SPS30_STATE_ILLEGAL_PARAMETER;
+                break;
+            }
+            /* with the terminating zero */
+            out_len = (uint8_t)(strlen(info) + 1);
+            memcpy(out, info, out_len);
+            break;
+        case EMU_CMD_READ_VERSION:
+            out[0] = 2;  // firmware major
+            out[1] = 2;  // firmware minor
+            out[2] = 0;
+            out[3] = 7;  // hardware revision
+            out[4] = 0;
+            out[5] = 2;  // SHDLC major
+            out[6] = 0;  // SHDLC minor
+            out_len = 7;
+            break;
+        case EMU_CMD_READ_DEVICE_STATUS_REG:
+            if (len != 1) {
+                state = SPS30_STATE_WRONG_DATA_LENGTH;
+                break;
+            }
+            emu_put_u32(out, emu.device_status);
+            out[4] = 0;
+            out_len = 5;
+            if (data[0] == 0x01)
+                emu.device_status = 0;
+            break;
+        case EMU_CMD_RESET:
+            emu_reset_sensor();
+            break;
+        default:
+            state = SPS30_STATE_UNKNOWN_COMMAND;
+            break;
+    }
+    if (emu.device_status)
+        state |= SPS30_STATE_DEVICE_ERROR;
+    emu_respond(cmd, state, out_len, out);
+}
+
+/* frame: address, command, length, data, checksum */
+static void emu_frame_end(void) {
+    uint8_t sum = 0;
+    uint16_t i;
+
+    if (emu.frame_len < 4 || emu.frame_len != 4 + emu.frame[2]) {
+        emu.stats.bad_frames++;
+        return;
+    }
+    for (i = 0; i < emu.frame_len; ++i)
+        sum = (uint8_t)(sum + emu.frame[i]);
+    if (sum != 0xff) {
+        emu.stats.bad_frames++;
+        return;
+    }
+    emu.stats.frames++;
+    if (emu.frame[0] == 0x00)
+        emu_handle(emu.frame[1], emu.frame[2], &emu.frame[3]);
+}
+
+static void emu_receive(uint8_t b) {
+    if (!emu.uart_on) {
+        if (b == EMU_WAKE_UP_PULSE) {
+            emu.uart_on = 1;
+            emu.stats.wake_pulses++;
+        } else {
+            emu.stats.ignored_bytes++;
+        }
+        return;
+    }
+
+    if (b == EMU_FLAG) {
+        if (emu.in_frame && emu.frame_len > 0) {
+            emu.in_frame = 0;
+            emu_frame_end();
+            return;
+        }
+        emu.in_frame = 1;
+        emu.frame_len = 0;
+        emu.escaped = 0;
+        return;
+    }
+    if (!emu.in_frame)
+        return;
+    if (b == EMU_ESCAPE) {
+        emu.escaped = 1;
+        return;
+    }
+    if (emu.escaped) {
+        b ^= 0x20;
+        emu.escaped = 0;
+    }
+    if (emu.frame_len < EMU_MAX_FRAME)
+        emu.frame[emu.frame_len++] = b;
+}
+
+static void* emu_run(void* arg) {
+    struct pollfd pfd;
+    uint8_t buf[64];
+    ssize_t len;
+    ssize_t i;
+
+    (void)arg;
+    pfd.fd = emu.master;
+    pfd.events = POLLIN;
+    while (emu.running) {
+        if (poll(&pfd, 1, EMU_POLL_MS) <= 0)
+            continue;
+        len = read(emu.master, buf, sizeof(buf));
+        if (len <= 0)
+            continue;
+        pthread_mutex_lock(&emu_lock);
+        for (i = 0; i < len; ++i)
+            emu_receive(buf[i]);
+        pthread_mutex_unlock(&emu_lock);
+    }
+    return NULL;
+}
+
+int16_t sps30_uart_emu_start(void) {
+    struct termios tio;
+    const char* name;
+
+    memset(&emu.stats, 0, sizeof(emu.stats));
+    emu.interval_us = SPS30_MEASUREMENT_DURATION_USEC;
+    memset(&emu.measurement, 0, sizeof(emu.measurement));
+    emu.device_status = 0;
+    emu.chunk_size = 0;
+    emu.chunk_delay_us = 0;
+    emu.noise = 0;
+    emu.checksum_errors = 0;
+    emu.stale_frames = 0;
+    emu.autoclean_interval_s = EMU_DEFAULT_AUTOCLEAN_INTERVAL_S;
+    emu.cleanings = 0;
+    emu.in_frame = 0;
+    emu_reset_sensor();
+
+    emu.master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (emu.master < 0)
+        return STATUS_FAIL;
+    if (grantpt(emu.master) != 0 || unlockpt(emu.master) != 0 ||
+        !(name = ptsname(emu.master))) {
+        close(emu.master);
+        return STATUS_FAIL;
+    }
+    strncpy(emu.path, name, sizeof(emu.path) - 1);
+
+    /* keeps the slave side open and raw, also before the driver opens it */
+    emu.slave = open(emu.path, O_RDWR | O_NOCTTY);
+    if (emu.slave < 0 || tcgetattr(emu.slave, &tio) != 0) {
+        close(emu.master);
+        return STATUS_FAIL;
+    }
+    cfmakeraw(&tio);
+    tcsetattr(emu.slave, TCSANOW, &tio);
+
+    emu.running = 1;
+    if (pthread_create(&emu.thread, NULL, emu_run, NULL) != 0) {
+        close(emu.slave);
+        close(emu.master);
+        return STATUS_FAIL;
+    }
+    return NO_ERROR;
+}
+
+void sps30_uart_emu_stop(void) {
+    if (!emu.running)
+        return;
+    emu.running = 0;
+    pthread_join(emu.thread, NULL);
+    close(emu.slave);
+    close(emu.master);
+}
+
+const char* sps30_uart_emu_path(void) {
+    return emu.path;
+}
+
+void sps30_uart_emu_set_interval_us(uint32_t interval_us) {
+    pthread_mutex_lock(&emu_lock);
+    emu.interval_us = interval_us;
+    pthread_mutex_unlock(&emu_lock);
+}
+
+void sps30_uart_emu_set_measurement(const struct sps30_measurement* m) {
+    pthread_mutex_lock(&emu_lock);
+    emu.measurement = *m;
+    pthread_mutex_unlock(&emu_lock);
+}
+
+void sps30_uart_emu_set_device_status(uint32_t device_status_flags) {
+    pthread_mutex_lock(&emu_lock);
+    emu.device_status = device_status_flags;
+    pthread_mutex_unlock(&emu_lock);
+}
+
+void sps30_uart_emu_set_chunks(uint16_t chunk_size, uint32_t delay_us) {
+    pthread_mutex_lock(&emu_lock);
+    emu.chunk_size = chunk_size;
+    emu.chunk_delay_us = delay_us;
+    pthread_mutex_unlock(&emu_lock);
+}
+
+void sps30_uart_emu_set_noise(uint8_t enable) {
+    pthread_mutex_lock(&emu_lock);
+    emu.noise = enable;
+    pthread_mutex_unlock(&emu_lock);
+}
+
+void sps30_uart_emu_inject_checksum_errors(uint16_t count) {
+    pthread_mutex_lock(&emu_lock);
+    emu.checksum_errors = count;
+    pthread_mutex_unlock(&emu_lock);
+}
+
+void sps30_uart_emu_inject_stale_frames(uint16_t count) {
+    pthread_mutex_lock(&emu_lock);
+    emu.stale_frames = count;
+    pthread_mutex_unlock(&emu_lock);
+}
+
+uint8_t sps30_uart_emu_get_state(void) {
+    uint8_t state;
+
+    pthread_mutex_lock(&emu_lock);
+    state = emu.state;
+    pthread_mutex_unlock(&emu_lock);
+    return state;
+}
+
+uint32_t sps30_uart_emu_get_cleanings(void) {
+    uint32_t cleanings;
+
+    pthread_mutex_lock(&emu_lock);
+    cleanings = emu.cleanings;
+    pthread_mutex_unlock(&emu_lock);
+    return cleanings;
+}
+
+void sps30_uart_emu_get_stats(struct sps30_uart_emu_stats* stats) {
+    pthread_mutex_lock(&emu_lock);
+    *stats = emu.stats;
+    pthread_mutex_unlock(&emu_lock);
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2026, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SPS30_UART_EMU_H
+#define SPS30_UART_EMU_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "sensirion_arch_config.h"
+#include "sps30.h"
+
+/*
+ * Emulated SPS30 on the master side of a pseudo-terminal
+ *
+ * The UART driver opens the slave side (sps30_uart_emu_path()) through the
+ * Linux termios implementation like a serial adapter. A thread decodes the
+ * command frames and answers them in real time. The model covers the SHDLC
+ * command set used by sps30-uart/sps30.c: measurement in float and uint16
+ * format, sleep with the UART switched off until a wake-up pulse, fan
+ * cleaning, the auto-cleaning interval, identity and status register.
+ * Responses may be split into delayed chunks, preceded by noise or sent with
+ * a broken checksum to exercise the receiver.
+ */
+
+/** Serial number, contains bytes which are stuffed on the wire */
+#define SPS30_UART_EMU_SERIAL "EMU~}00000000001"
+
+#define SPS30_UART_EMU_STATE_IDLE 1
+#define SPS30_UART_EMU_STATE_MEASURING 2
+#define SPS30_UART_EMU_STATE_SLEEPING 3
+
+/**
+ * struct sps30_uart_emu_stats - traffic since sps30_uart_emu_start()
+ *
+ * @frames:         Command frames received
+ * @bad_frames:     Command frames dropped for a wrong length or checksum
+ * @wake_pulses:    Wake-up pulses which switched the UART on
+ * @ignored_bytes:  Bytes received while the UART was switched off
+ */
+struct sps30_uart_emu_stats {
+    uint32_t frames;
+    uint32_t bad_frames;
+    uint32_t wake_pulses;
+    uint32_t ignored_bytes;
+};
+
+/**
+ * sps30_uart_emu_start() - create the pseudo-terminal and start answering
+ *
+ * The emulated sensor starts idle with default settings.
+ *
+ * Return:  0 on success, STATUS_FAIL otherwise
+ */
+int16_t sps30_uart_emu_start(void);
+
+/** sps30_uart_emu_stop() - stop the emulation and close the terminal */
+void sps30_uart_emu_stop(void);
+
+/** sps30_uart_emu_path() - device path of the slave side */
+const char* sps30_uart_emu_path(void);
+
+/**
+ * sps30_uart_emu_set_interval_us() - set the measurement interval, by default
+ * SPS30_MEASUREMENT_DURATION_USEC
+ */
+void sps30_uart_emu_set_interval_us(uint32_t interval_us);
+
+/** sps30_uart_emu_set_measurement() - set the values of all measurements */
+void sps30_uart_emu_set_measurement(const struct sps30_measurement* m);
+
+/** sps30_uart_emu_set_device_status() - set the device status register */
+void sps30_uart_emu_set_device_status(uint32_t device_status_flags);
+
+/**
+ * sps30_uart_emu_set_chunks() - split responses
+ *
+ * @chunk_size: Bytes written at once, 0 to write responses at once
+ * @delay_us:   Delay between chunks
+ */
+void sps30_uart_emu_set_chunks(uint16_t chunk_size, uint32_t delay_us);
+
+/**
+ * sps30_uart_emu_set_noise() - precede responses with bytes outside of a
+ * frame
+ */
+void sps30_uart_emu_set_noise(uint8_t enable);
+
+/**
+ * sps30_uart_emu_inject_checksum_errors() - send the next @count responses
+ * with a broken checksum
+ */
+void sps30_uart_emu_inject_checksum_errors(uint16_t count);
+
+/**
+ * sps30_uart_emu_inject_stale_frames() - precede the next @count responses
+ * with the cut off start of a frame
+ */
+void sps30_uart_emu_inject_stale_frames(uint16_t count);
+
+/** sps30_uart_emu_get_state() - SPS30_UART_EMU_STATE_* */
+uint8_t sps30_uart_emu_get_state(void);
+
+/** sps30_uart_emu_get_cleanings() - number of manual fan cleanings */
+uint32_t sps30_uart_emu_get_cleanings(void);
+
+void sps30_uart_emu_get_stats(struct sps30_uart_emu_stats* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPS30_UART_EMU_H */